@@ -0,0 +1,115 @@
+#include "ANG/Engine.hpp"
+
+#include <chrono>
+#include <iostream>
+
+#include "Core/Strings/StringId.hpp"
+
+namespace ang
+{
+	Engine::Engine()
+		: m_game(makeHostApi(m_host))
+	{
+		m_host.assets = &m_assets;
+	}
+
+	bool Engine::openAssets(const char *path)
+	{
+		return m_assets.open(path);
+	}
+
+	bool Engine::loadGame(const char *path)
+	{
+		return m_game.load(path);
+	}
+
+	bool Engine::record(const char *path)
+	{
+		return m_recording.open(path);
+	}
+
+	void Engine::run()
+	{
+		do
+		{
+			tick();
+		} while (!m_host.exitRequested || m_files.hasPendingWork());
+
+		if (m_recording.isOpen() && !m_recording.close())
+			std::cerr << "[Replay] The recording could not be written in full.\n";
+	}
+
+	bool Engine::replay(const char *path)
+	{
+		core::replay::ReplayReader reader;
+		if (!reader.open(path))
+		{
+			std::cerr << "[Replay] " << path << " is not a replay.\n";
+			return false;
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		m_host.isReplaying = true;
+		core::replay::ReplayTick tick;
+		while (reader.next(tick))
+		{
+			m_host.input.assign(tick.input, tick.input + tick.inputSize);
+			m_game.update();
+			if (tick.hasChecksum && tick.checksum != stateChecksum())
+			{
+				std::cerr << "[Replay] Desync at tick " << reader.tickIndex() - 1 << ".\n";
+				return false;
+			}
+		}
+
+		if (reader.isCorrupt())
+		{
+			std::cerr << "[Replay] The log is damaged after tick " << reader.tickIndex() << ".\n";
+			return false;
+		}
+
+		const f64 seconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "[Replay] " << reader.tickIndex() << " ticks matched in " << seconds << " s." << std::endl;
+		return true;
+	}
+
+	void Engine::tick()
+	{
+		// Streaming callbacks run here, on the main thread, at a known point in the frame.
+		m_files.drainCompletions();
+
+		// Swapping the game in before it runs keeps a frame from mixing two builds. A recording holds one build's
+		// ticks: a reload would change both the code it replays against and the state it checksums.
+		if (!m_recording.isOpen())
+			m_game.reloadIfChanged();
+		m_host.beginTick();
+		m_game.update();
+
+		if (m_recording.isOpen())
+		{
+			const bool isWritten = (m_frameIndex + 1) % k_checksumInterval == 0
+				? m_recording.writeTick(m_host.input.data(), m_host.input.size(), stateChecksum())
+				: m_recording.writeTick(m_host.input.data(), m_host.input.size());
+
+			// A log missing a tick would desync on playback, so it stops at the last tick it holds.
+			if (!isWritten)
+			{
+				std::cerr << "[Replay] Tick " << m_frameIndex << " has " << m_host.input.size() << " bytes of input, past the "
+					<< core::replay::k_maxTickInputSize << " a replay holds. Recording stopped.\n";
+				m_recording.close();
+			}
+		}
+
+		m_frameGraph.compile();
+		m_frameGraph.execute(m_jobs);
+		m_frameGraph.reset();
+
+		++m_frameIndex;
+	}
+
+	u64 Engine::stateChecksum() const
+	{
+		// The state is all the game keeps across ticks, so two runs that agree on it agree on the simulation.
+		return core::hashString(static_cast<const char *>(m_game.state()), m_game.stateSize());
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Core/Types.hpp"
+#include "Core/Assets/AssetPack.hpp"
+#include "Core/IO/FileService.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Modules/HotModule.hpp"
+#include "Core/Render/FrameGraph.hpp"
+#include "Core/Replay/ReplayLog.hpp"
+
+#include "ANG/ModuleHost.hpp"
+
+namespace ang
+{
+	// Owns the Core services and drives the frame loop.
+	class Engine
+	{
+	public:
+		Engine();
+
+		// Mapped read only, and handed to the game in place. Returns false when the pack cannot be opened.
+		bool openAssets(const char *path);
+		// Loads the gameplay module, which is reloaded whenever it is rebuilt. Returns false when it cannot be loaded.
+		bool loadGame(const char *path);
+
+		// Records the game's input from the next frame on, with a checksum of its state every k_checksumInterval frames.
+		// The game is not reloaded while a recording is open.
+		bool record(const char *path);
+
+		// Runs frames until an exit is requested and no streamed read is left to deliver.
+		void run();
+
+		// Plays a recording back on a game loaded but not run yet. Ticks run back to back with nothing else in between:
+		// no frame pacing, streaming, rendering or reloading. Returns false at the first checksum that does not match,
+		// or when the log is damaged.
+		bool replay(const char *path);
+
+		void requestExit() { m_host.exitRequested = true; }
+
+		core::jobs::JobSystem &jobs() { return m_jobs; }
+		core::io::FileService &files() { return m_files; }
+		// Systems add this frame's passes here before the frame ticks.
+		core::render::FrameGraph &frameGraph() { return m_frameGraph; }
+		u64 frameIndex() const { return m_frameIndex; }
+
+		static constexpr u64 k_checksumInterval = 60;
+
+	private:
+		void tick();
+		u64 stateChecksum() const;
+
+		core::jobs::JobSystem m_jobs;
+		core::io::FileService m_files;
+		core::render::FrameGraph m_frameGraph;
+		core::assets::AssetPack m_assets;
+		ModuleHost m_host;
+		core::modules::HotModule m_game;
+		core::replay::ReplayWriter m_recording;
+		u64 m_frameIndex = 0;
+	};
+}
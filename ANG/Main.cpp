@@ -1,8 +1,134 @@
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
-int main()
+#include "Core/Memory/Memory.hpp"
+
+#include "ANG/Engine.hpp"
+#include "ANG/Server.hpp"
+
+namespace
 {
-	std::cout << "Hello World" << std::endl;
+	struct Options
+	{
+		const char *gamePath = nullptr;
+		const char *packPath = nullptr;
+		const char *recordPath = nullptr;
+		const char *replayPath = nullptr;
+		// Zero runs the engine; anything else a headless server with that many instances.
+		u32 serverInstances = 0;
+		u32 tickRate = 60;
+	};
+
+	// A whole positive number and nothing after it.
+	bool parseCount(const char *text, u32 &count)
+	{
+		// strtoull() would take leading spaces and a sign, and wrap negative numbers around.
+		if (text[0] < '0' || text[0] > '9')
+			return false;
+
+		char *end = nullptr;
+		const unsigned long long value = std::strtoull(text, &end, 10);
+		if (*end != '\0' || value == 0 || value > 0xffffffffull)
+			return false;
+
+		count = static_cast<u32>(value);
+		return true;
+	}
+
+	bool parseOptions(int argumentCount, char **arguments, Options &options)
+	{
+		for (int i = 1; i < argumentCount; ++i)
+		{
+			const bool hasValue = i + 1 < argumentCount;
+			if (std::strcmp(arguments[i], "--server") == 0 && hasValue)
+			{
+				if (!parseCount(arguments[++i], options.serverInstances))
+					return false;
+			}
+			else if (std::strcmp(arguments[i], "--tick-rate") == 0 && hasValue)
+			{
+				if (!parseCount(arguments[++i], options.tickRate))
+					return false;
+			}
+			else if (std::strcmp(arguments[i], "--pack") == 0 && hasValue)
+				options.packPath = arguments[++i];
+			else if (std::strcmp(arguments[i], "--record") == 0 && hasValue)
+				options.recordPath = arguments[++i];
+			else if (std::strcmp(arguments[i], "--replay") == 0 && hasValue)
+				options.replayPath = arguments[++i];
+			else if (arguments[i][0] != '-' && options.gamePath == nullptr)
+				options.gamePath = arguments[i];
+			else
+				return false;
+		}
+		// A replay feeds the game its recorded input, so there is nothing to record and no server to run it.
+		// A server runs several instances with no single input stream, so it neither records nor replays.
+		if (options.serverInstances > 0)
+			return options.recordPath == nullptr && options.replayPath == nullptr;
+		return options.replayPath == nullptr || options.recordPath == nullptr;
+	}
+
+	bool runEngine(const Options &options)
+	{
+		ang::Engine engine;
+		if (options.packPath != nullptr && !engine.openAssets(options.packPath))
+			std::cerr << "[ANG] Cannot open " << options.packPath << ".\n";
+
+		if (options.replayPath != nullptr)
+		{
+			if (options.gamePath == nullptr || !engine.loadGame(options.gamePath))
+			{
+				std::cerr << "[ANG] A replay needs the game module it was recorded with.\n";
+				return false;
+			}
+			return engine.replay(options.replayPath);
+		}
+
+		if (options.recordPath != nullptr && !engine.record(options.recordPath))
+			std::cerr << "[ANG] Cannot record to " << options.recordPath << ".\n";
+
+		// The game module, when given, runs until it asks to exit. Without one the loop only flushes outstanding work.
+		if (options.gamePath == nullptr || !engine.loadGame(options.gamePath))
+			engine.requestExit();
+		engine.run();
+		return true;
+	}
+
+	bool runServer(const Options &options)
+	{
+		ang::ServerConfig config;
+		config.instanceCount = options.serverInstances;
+		config.tickRate = options.tickRate;
+
+		ang::Server server(config);
+		if (options.packPath != nullptr && !server.openAssets(options.packPath))
+			std::cerr << "[ANG] Cannot open " << options.packPath << ".\n";
+
+		if (options.gamePath == nullptr || !server.loadGame(options.gamePath))
+		{
+			std::cerr << "[ANG] A server needs a game module to run.\n";
+			return false;
+		}
+		server.run();
+		return true;
+	}
+}
+
+int main(int argumentCount, char **arguments)
+{
+	Options options;
+	if (!parseOptions(argumentCount, arguments, options))
+	{
+		std::cerr << "Usage: ANG [--server <instances>] [--tick-rate <ticks per second>] [--pack <asset pack>]"
+			" [--record <replay> | --replay <replay>] [game module]\n";
+		return 1;
+	}
+
+	const bool succeeded = options.serverInstances > 0 ? runServer(options) : runEngine(options);
+
+	// Anything still attributed to a memory tag at this point is a leak.
+	core::memory::reportLeaks(std::cerr);
 
-	return 0;
-}
\ No newline at end of file
+	return succeeded ? 0 : 1;
+}
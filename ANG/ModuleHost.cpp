@@ -0,0 +1,52 @@
+#include "ANG/ModuleHost.hpp"
+
+#include "Core/Memory/Memory.hpp"
+
+namespace ang
+{
+	namespace
+	{
+		void *allocateForModule(void *, usize size, usize alignment)
+		{
+			return core::memory::allocate(size, core::memory::Tag::General, alignment);
+		}
+
+		void deallocateForModule(void *, void *pointer, usize size, usize alignment)
+		{
+			core::memory::deallocate(pointer, size, core::memory::Tag::General, alignment);
+		}
+
+		void requestExitFromModule(void *context)
+		{
+			static_cast<ModuleHost *>(context)->exitRequested = true;
+		}
+
+		const void *findAssetForModule(void *context, u64 id, usize *size)
+		{
+			const core::assets::AssetPack *assets = static_cast<ModuleHost *>(context)->assets;
+			const core::assets::AssetView view = assets != nullptr && assets->isOpen() ? assets->find(id) : core::assets::AssetView();
+			if (view)
+				*size = view.size;
+			return view.data;
+		}
+
+		void submitInputFromModule(void *context, const void *data, usize size)
+		{
+			ModuleHost &host = *static_cast<ModuleHost *>(context);
+			if (!host.isReplaying)
+				host.nextInput.insert(host.nextInput.end(), static_cast<const u8 *>(data), static_cast<const u8 *>(data) + size);
+		}
+
+		const void *inputForModule(void *context, usize *size)
+		{
+			const ModuleHost &host = *static_cast<ModuleHost *>(context);
+			*size = host.input.size();
+			return host.input.empty() ? nullptr : host.input.data();
+		}
+	}
+
+	AngHostApi makeHostApi(ModuleHost &host)
+	{
+		return { &host, &allocateForModule, &deallocateForModule, &requestExitFromModule, &findAssetForModule, &submitInputFromModule, &inputForModule };
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Assets/AssetPack.hpp"
+#include "Core/Memory/Memory.hpp"
+#include "Core/Modules/ModuleApi.hpp"
+
+namespace ang
+{
+	// What a module instance's calls into the engine reach. The engine has one; a server has one per instance.
+	struct ModuleHost
+	{
+		// Shared by every instance, which only ever reads it.
+		const core::assets::AssetPack *assets = nullptr;
+		bool exitRequested = false;
+
+		// What the module reads this tick, and what it submitted for the next.
+		std::vector<u8, core::memory::TaggedAllocator<u8, core::memory::Tag::General>> input;
+		std::vector<u8, core::memory::TaggedAllocator<u8, core::memory::Tag::General>> nextInput;
+		// Input comes from a replay; submissions are dropped.
+		bool isReplaying = false;
+
+		// Hands the input submitted during the last tick to this one.
+		void beginTick()
+		{
+			input.swap(nextInput);
+			nextInput.clear();
+		}
+	};
+
+	// The host must outlive the module instance it is handed to.
+	AngHostApi makeHostApi(ModuleHost &host);
+}
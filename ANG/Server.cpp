@@ -0,0 +1,114 @@
+#include "ANG/Server.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace ang
+{
+	namespace
+	{
+		// Runs in the initializer list, ahead of the first instance being looked up. Release builds get one instance.
+		ServerConfig checkConfig(const ServerConfig &config)
+		{
+			assert(config.instanceCount > 0 && "A server runs at least one instance.");
+			ServerConfig checked = config;
+			checked.instanceCount = std::max(config.instanceCount, 1u);
+			return checked;
+		}
+
+		core::jobs::JobSystemConfig makeJobConfig(const ServerConfig &config)
+		{
+			core::jobs::JobSystemConfig jobs;
+			jobs.workerCount = config.workerCount;
+			jobs.pinWorkers = config.pinWorkers;
+			return jobs;
+		}
+	}
+
+	Server::Server(const ServerConfig &config)
+		: m_config(checkConfig(config))
+		, m_jobs(makeJobConfig(m_config))
+		, m_instances(m_config.instanceCount)
+		, m_game(makeHostApi(m_instances[0].host))
+	{
+		for (u32 i = 0; i < m_instances.size(); ++i)
+		{
+			m_instances[i].host.assets = &m_assets;
+			m_instances[i].server = this;
+			m_instances[i].index = i;
+			if (i > 0)
+				m_game.addInstance(makeHostApi(m_instances[i].host));
+		}
+	}
+
+	bool Server::openAssets(const char *path)
+	{
+		return m_assets.open(path);
+	}
+
+	bool Server::loadGame(const char *path)
+	{
+		return m_game.load(path);
+	}
+
+	void Server::run()
+	{
+		using Clock = std::chrono::steady_clock;
+		const Clock::duration tickLength = m_config.tickRate > 0 ? Clock::duration(std::chrono::seconds(1)) / m_config.tickRate : Clock::duration::zero();
+
+		const Clock::time_point start = Clock::now();
+		Clock::time_point nextTick = start;
+		while (liveInstanceCount() > 0)
+		{
+			tick();
+
+			// A late tick starts the next one right away, without trying to catch up on the time it lost.
+			nextTick += tickLength;
+			const Clock::time_point now = Clock::now();
+			if (nextTick > now)
+				std::this_thread::sleep_until(nextTick);
+			else
+				nextTick = now;
+		}
+
+		const f64 seconds = std::chrono::duration<f64>(Clock::now() - start).count();
+		std::cout << "[Server] " << m_instances.size() << " instances ran " << m_tickIndex << " ticks in " << seconds << " s on "
+			<< m_jobs.workerCount() << " workers." << std::endl;
+	}
+
+	void Server::tick()
+	{
+		// Swapped in while no instance runs, so every instance ticks the same build.
+		m_game.reloadIfChanged();
+
+		m_tickJobs.clear();
+		for (Instance &instance : m_instances)
+		{
+			if (!instance.host.exitRequested)
+				m_tickJobs.push_back({ &Server::tickInstance, &instance });
+		}
+
+		core::jobs::Counter counter;
+		m_jobs.run(m_tickJobs.data(), m_tickJobs.size(), &counter);
+		m_jobs.wait(counter);
+		++m_tickIndex;
+	}
+
+	u32 Server::liveInstanceCount() const
+	{
+		u32 count = 0;
+		for (const Instance &instance : m_instances)
+			count += instance.host.exitRequested ? 0 : 1;
+		return count;
+	}
+
+	void Server::tickInstance(void *data)
+	{
+		Instance &instance = *static_cast<Instance *>(data);
+		instance.host.beginTick();
+		instance.server->m_game.update(instance.index);
+	}
+}
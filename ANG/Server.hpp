@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Assets/AssetPack.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Memory/Memory.hpp"
+#include "Core/Modules/HotModule.hpp"
+
+#include "ANG/ModuleHost.hpp"
+
+namespace ang
+{
+	struct ServerConfig
+	{
+		// At least one.
+		u32 instanceCount = 1;
+		// Ticks per second. Zero runs ticks back to back.
+		u32 tickRate = 60;
+		// Zero picks one worker per hardware thread, minus the main thread.
+		u32 workerCount = 0;
+		bool pinWorkers = true;
+	};
+
+	// Headless dedicated server running several game instances in one process.
+	// Instances share the job system, one copy of the game module's code and the read only asset pack; each owns only
+	// its module state, so an instance costs a fraction of a process. Instances never see each other's state.
+	// Every tick updates the live instances in parallel, one job each, and the game is reloaded between ticks.
+	class Server
+	{
+	public:
+		explicit Server(const ServerConfig &config);
+
+		Server(const Server &) = delete;
+		Server &operator=(const Server &) = delete;
+
+		// Mapped once, read in place by every instance. Returns false when the pack cannot be opened.
+		bool openAssets(const char *path);
+		// Starts every instance. Returns false when the module cannot be loaded.
+		bool loadGame(const char *path);
+
+		// Runs ticks until every instance asked to exit.
+		void run();
+		void tick();
+
+		u32 instanceCount() const { return m_config.instanceCount; }
+		u32 liveInstanceCount() const;
+		u64 tickIndex() const { return m_tickIndex; }
+
+	private:
+		struct Instance
+		{
+			ModuleHost host;
+			Server *server;
+			u32 index;
+		};
+
+		static void tickInstance(void *data);
+
+		ServerConfig m_config;
+		core::jobs::JobSystem m_jobs;
+		core::assets::AssetPack m_assets;
+		// Sized once: module hosts point into it.
+		std::vector<Instance, core::memory::TaggedAllocator<Instance, core::memory::Tag::General>> m_instances;
+		core::modules::HotModule m_game;
+
+		std::vector<core::jobs::Job, core::memory::TaggedAllocator<core::jobs::Job, core::memory::Tag::General>> m_tickJobs;
+		u64 m_tickIndex = 0;
+	};
+}
@@ -0,0 +1,272 @@
+#include "Core/Assets/AssetPack.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+#include "Core/Compression/Lz4.hpp"
+
+namespace core::assets
+{
+	namespace
+	{
+		struct BlockJob
+		{
+			const AssetPack *pack;
+			const PackEntry *entry;
+			u8 *destination;
+			u32 firstBlock;
+			u32 blockCount;
+			std::atomic<bool> *failed;
+		};
+
+		constexpr usize alignToAsset(usize value)
+		{
+			return (value + k_assetAlignment - 1) & ~(k_assetAlignment - 1);
+		}
+
+		// Whether the entry's bytes, and for Lz4 its block table, lie inside a file of fileSize bytes.
+		bool isInside(const PackEntry &entry, u64 fileSize)
+		{
+			if (entry.offset > fileSize || entry.storedSize > fileSize - entry.offset)
+				return false;
+
+			switch (entry.compression)
+			{
+			case Compression::None:
+				return entry.storedSize == entry.size;
+			case Compression::Lz4:
+				return entry.blockSize != 0 && (u64(entry.blockCount()) + 1) * sizeof(u64) <= entry.storedSize;
+			}
+			return false;
+		}
+	}
+
+	bool AssetPack::open(const char *path)
+	{
+		close();
+		if (!m_file.open(path))
+			return false;
+
+		PackHeader header;
+		if (m_file.size() < sizeof(header))
+		{
+			close();
+			return false;
+		}
+
+		std::memcpy(&header, m_file.data(), sizeof(header));
+		const bool tableFits = header.tableOffset <= m_file.size()
+			&& header.entryCount <= (m_file.size() - header.tableOffset) / sizeof(PackEntry);
+		if (header.magic != PackHeader::k_magic || header.version != PackHeader::k_version || !tableFits
+			|| header.tableOffset % alignof(PackEntry) != 0)
+		{
+			close();
+			return false;
+		}
+
+		m_entries = reinterpret_cast<const PackEntry *>(m_file.data() + header.tableOffset);
+		m_entryCount = static_cast<usize>(header.entryCount);
+
+		// Checked once here, so lookups and loads never read past the file, even from a pack cut short.
+		for (usize i = 0; i < m_entryCount; ++i)
+		{
+			if (!isInside(m_entries[i], m_file.size()))
+			{
+				close();
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void AssetPack::close()
+	{
+		m_file.close();
+		m_entries = nullptr;
+		m_entryCount = 0;
+	}
+
+	const PackEntry *AssetPack::findEntry(AssetId id) const
+	{
+		const PackEntry *end = m_entries + m_entryCount;
+		const PackEntry *entry = std::lower_bound(m_entries, end, id, [](const PackEntry &candidate, AssetId key)
+		{
+			return candidate.id < key;
+		});
+
+		return entry != end && entry->id == id ? entry : nullptr;
+	}
+
+	AssetView AssetPack::find(AssetId id) const
+	{
+		const PackEntry *entry = findEntry(id);
+		if (entry == nullptr || entry->compression != Compression::None)
+			return {};
+		return { m_file.data() + entry->offset, static_cast<usize>(entry->size) };
+	}
+
+	bool AssetPack::load(const PackEntry &entry, void *destination) const
+	{
+		if (entry.compression == Compression::None)
+		{
+			std::memcpy(destination, m_file.data() + entry.offset, static_cast<usize>(entry.size));
+			return true;
+		}
+
+		for (u32 block = 0; block < entry.blockCount(); ++block)
+		{
+			if (!loadBlock(entry, block, static_cast<u8 *>(destination)))
+				return false;
+		}
+
+		return true;
+	}
+
+	bool AssetPack::load(const PackEntry &entry, void *destination, jobs::JobSystem &jobs) const
+	{
+		const u32 blockCount = entry.blockCount();
+		if (entry.compression == Compression::None || blockCount <= 1)
+			return load(entry, destination);
+
+		// A few blocks per job keeps the scheduling cost small next to the decompression.
+		const u32 jobCount = std::min(blockCount, std::max(1u, jobs.workerCount() * 4));
+		const u32 blocksPerJob = (blockCount + jobCount - 1) / jobCount;
+
+		std::atomic<bool> failed{ false };
+		BlockJob *blockJobs = static_cast<BlockJob *>(memory::allocate(sizeof(BlockJob) * jobCount, memory::Tag::Assets, alignof(BlockJob)));
+		jobs::Job *work = static_cast<jobs::Job *>(memory::allocate(sizeof(jobs::Job) * jobCount, memory::Tag::Assets, alignof(jobs::Job)));
+
+		u32 submitted = 0;
+		for (u32 first = 0; first < blockCount; first += blocksPerJob)
+		{
+			blockJobs[submitted] = { this, &entry, static_cast<u8 *>(destination), first, std::min(blocksPerJob, blockCount - first), &failed };
+			work[submitted] = { [](void *data)
+			{
+				const BlockJob &job = *static_cast<const BlockJob *>(data);
+				for (u32 block = job.firstBlock; block < job.firstBlock + job.blockCount; ++block)
+				{
+					if (!job.pack->loadBlock(*job.entry, block, job.destination))
+						job.failed->store(true, std::memory_order_relaxed);
+				}
+			}, &blockJobs[submitted] };
+			++submitted;
+		}
+
+		jobs::Counter counter;
+		jobs.run(work, submitted, &counter);
+		jobs.wait(counter);
+
+		memory::deallocate(work, sizeof(jobs::Job) * jobCount, memory::Tag::Assets, alignof(jobs::Job));
+		memory::deallocate(blockJobs, sizeof(BlockJob) * jobCount, memory::Tag::Assets, alignof(BlockJob));
+		return !failed.load(std::memory_order_relaxed);
+	}
+
+	bool AssetPack::loadBlock(const PackEntry &entry, u32 block, u8 *destination) const
+	{
+		assert(entry.compression == Compression::Lz4);
+
+		const u8 *stored = m_file.data() + entry.offset;
+		u64 begin;
+		u64 end;
+		std::memcpy(&begin, stored + sizeof(u64) * block, sizeof(begin));
+		std::memcpy(&end, stored + sizeof(u64) * (block + 1), sizeof(end));
+		const u64 tableSize = (u64(entry.blockCount()) + 1) * sizeof(u64);
+		if (begin < tableSize || begin > end || end > entry.storedSize)
+			return false;
+
+		const u64 blockStart = u64(block) * entry.blockSize;
+		const usize blockSize = static_cast<usize>(std::min<u64>(entry.blockSize, entry.size - blockStart));
+		const usize storedSize = static_cast<usize>(end - begin);
+		u8 *out = destination + blockStart;
+
+		if (storedSize == blockSize)
+		{
+			std::memcpy(out, stored + begin, blockSize);
+			return true;
+		}
+
+		return lz4::decompress(stored + begin, storedSize, out, blockSize);
+	}
+
+	void AssetPackWriter::add(AssetId id, const void *data, usize size, Compression compression, u32 blockSize)
+	{
+		// Data offsets are relative to the end of the header until write() lays the file out.
+		const usize offset = alignToAsset(m_data.size());
+		PackEntry entry = { id, offset, size, size, compression, 0 };
+
+		if (compression == Compression::None)
+		{
+			m_data.resize(offset + size);
+			std::memcpy(m_data.data() + offset, data, size);
+			m_entries.push_back(entry);
+			return;
+		}
+
+		assert(blockSize >= k_minBlockSize && blockSize <= k_maxBlockSize);
+		entry.blockSize = blockSize;
+		const u32 blockCount = entry.blockCount();
+		const usize tableSize = sizeof(u64) * (blockCount + 1);
+
+		const u8 *in = static_cast<const u8 *>(data);
+		m_data.resize(offset + tableSize + lz4::compressBound(blockSize) * blockCount);
+		u64 stored = tableSize;
+		for (u32 block = 0; block < blockCount; ++block)
+		{
+			std::memcpy(m_data.data() + offset + sizeof(u64) * block, &stored, sizeof(stored));
+
+			const usize blockStart = usize(block) * blockSize;
+			const usize rawSize = std::min<usize>(blockSize, size - blockStart);
+			u8 *out = m_data.data() + offset + stored;
+			usize compressedSize = lz4::compress(in + blockStart, rawSize, out, rawSize - 1);
+			if (compressedSize == 0)
+			{
+				std::memcpy(out, in + blockStart, rawSize);
+				compressedSize = rawSize;
+			}
+			stored += compressedSize;
+		}
+		std::memcpy(m_data.data() + offset + sizeof(u64) * blockCount, &stored, sizeof(stored));
+
+		m_data.resize(offset + static_cast<usize>(stored));
+		entry.storedSize = stored;
+		m_entries.push_back(entry);
+	}
+
+	bool AssetPackWriter::write(const char *path) const
+	{
+		static_assert(sizeof(PackHeader) <= k_assetAlignment, "The header must fit in front of the first asset.");
+
+		auto entries = m_entries;
+		std::sort(entries.begin(), entries.end(), [](const PackEntry &a, const PackEntry &b)
+		{
+			return a.id < b.id;
+		});
+		assert(std::adjacent_find(entries.begin(), entries.end(), [](const PackEntry &a, const PackEntry &b) { return a.id == b.id; }) == entries.end());
+
+		const u64 dataStart = k_assetAlignment;
+		const u64 tableOffset = (dataStart + m_data.size() + alignof(PackEntry) - 1) & ~u64(alignof(PackEntry) - 1);
+		for (PackEntry &entry : entries)
+			entry.offset += dataStart;
+
+		PackHeader header = {};
+		header.magic = PackHeader::k_magic;
+		header.version = PackHeader::k_version;
+		header.entryCount = entries.size();
+		header.tableOffset = tableOffset;
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+			return false;
+
+		const char padding[k_assetAlignment] = {};
+		out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		out.write(padding, static_cast<std::streamsize>(dataStart - sizeof(header)));
+		out.write(reinterpret_cast<const char *>(m_data.data()), static_cast<std::streamsize>(m_data.size()));
+		out.write(padding, static_cast<std::streamsize>(tableOffset - dataStart - m_data.size()));
+		out.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PackEntry)));
+		return static_cast<bool>(out);
+	}
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/IO/MappedFile.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::assets
+{
+	using AssetId = u64;
+
+	// On disk layout: PackHeader, then every asset's bytes, then the entry table sorted by id.
+	struct PackHeader
+	{
+		static constexpr u32 k_magic = 0x504e4741;	// "ANGP"
+		static constexpr u32 k_version = 2;
+
+		u32 magic;
+		u32 version;
+		u64 entryCount;
+		u64 tableOffset;
+	};
+
+	enum class Compression : u32
+	{
+		None,
+		// Independent LZ4 blocks, stored after a table of blockCount + 1 u64 offsets relative to the asset's offset.
+		// A block whose stored size equals its decompressed size did not compress and is stored raw.
+		Lz4,
+	};
+
+	struct PackEntry
+	{
+		AssetId id;
+		u64 offset;
+		// Decompressed size.
+		u64 size;
+		// Bytes the asset takes in the file.
+		u64 storedSize;
+		Compression compression;
+		// Decompressed bytes per block; every block but the last is full.
+		u32 blockSize;
+
+		u32 blockCount() const { return blockSize == 0 ? 0 : static_cast<u32>((size + blockSize - 1) / blockSize); }
+	};
+
+	struct AssetView
+	{
+		const u8 *data = nullptr;
+		usize size = 0;
+
+		explicit operator bool() const { return data != nullptr; }
+	};
+
+	// Every asset starts on this boundary, so assets can be read in place as arrays of any basic type.
+	constexpr usize k_assetAlignment = 64;
+
+	// Block sizes large enough to compress well and small enough to spread one asset over every worker.
+	constexpr u32 k_minBlockSize = 64 * 1024;
+	constexpr u32 k_maxBlockSize = 256 * 1024;
+	constexpr u32 k_defaultBlockSize = 128 * 1024;
+
+	// Asset pack mapped into memory. Looking an asset up costs a binary search and no I/O;
+	// the bytes are paged in when first touched.
+	class AssetPack
+	{
+	public:
+		// Returns false when the file is missing, is not a pack of this version, or has an entry reaching past its end.
+		bool open(const char *path);
+		void close();
+		bool isOpen() const { return m_file.isOpen(); }
+
+		// Nullptr when the pack has no such asset.
+		const PackEntry *findEntry(AssetId id) const;
+
+		// The asset's bytes in place. Empty when the pack has no such asset or stores it compressed.
+		AssetView find(AssetId id) const;
+
+		// Decompresses or copies an asset into destination, which must hold entry.size bytes.
+		// With a job system, blocks are decompressed in parallel; inside a job the wait parks the fiber.
+		// Returns false when the stored data is corrupt.
+		bool load(const PackEntry &entry, void *destination) const;
+		bool load(const PackEntry &entry, void *destination, jobs::JobSystem &jobs) const;
+
+		// Byte offset of view's start in the pack file.
+		usize offsetOf(const AssetView &view) const { return static_cast<usize>(view.data - m_file.data()); }
+
+		usize assetCount() const { return m_entryCount; }
+		const io::MappedFile &file() const { return m_file; }
+
+	private:
+		bool loadBlock(const PackEntry &entry, u32 block, u8 *destination) const;
+
+		io::MappedFile m_file;
+		const PackEntry *m_entries = nullptr;
+		usize m_entryCount = 0;
+	};
+
+	// Builds pack files, for tools and tests.
+	class AssetPackWriter
+	{
+	public:
+		// Ids must be unique. The bytes are copied, and compressed right away.
+		void add(AssetId id, const void *data, usize size, Compression compression = Compression::None, u32 blockSize = k_defaultBlockSize);
+		bool write(const char *path) const;
+
+	private:
+		std::vector<PackEntry, memory::TaggedAllocator<PackEntry, memory::Tag::Assets>> m_entries;
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Assets>> m_data;
+	};
+}
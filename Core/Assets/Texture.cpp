@@ -0,0 +1,32 @@
+#include "Core/Assets/Texture.hpp"
+
+#include <cstring>
+
+#include "Core/Assets/AssetPack.hpp"
+
+namespace core::assets
+{
+	TextureBytes buildTextureAsset(u32 width, u32 height, u32 bytesPerTexel, u32 mipCount, const u8 *const *mips)
+	{
+		const auto align = [](usize value) { return (value + k_assetAlignment - 1) & ~(k_assetAlignment - 1); };
+
+		usize offset = align(sizeof(TextureHeader) + sizeof(TextureMip) * mipCount);
+		TextureBytes bytes(offset);
+
+		TextureHeader header = { TextureHeader::k_magic, width, height, mipCount, bytesPerTexel, 0 };
+		std::memcpy(bytes.data(), &header, sizeof(header));
+
+		for (u32 mip = 0; mip < mipCount; ++mip)
+		{
+			const usize size = mipSize(width, height, bytesPerTexel, mip);
+			const TextureMip record = { offset, size };
+			std::memcpy(bytes.data() + sizeof(TextureHeader) + sizeof(TextureMip) * mip, &record, sizeof(record));
+
+			bytes.resize(offset + size);
+			std::memcpy(bytes.data() + offset, mips[mip], size);
+			offset = align(offset + size);
+		}
+
+		return bytes;
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::assets
+{
+	// Texture asset layout: TextureHeader, one TextureMip per level, then the level data, finest level first.
+	// Every level starts on a 64 byte boundary, so a single level can be streamed without touching the others.
+	struct TextureHeader
+	{
+		static constexpr u32 k_magic = 0x54474e41;	// "ANGT"
+
+		u32 magic;
+		u32 width;
+		u32 height;
+		u32 mipCount;
+		u32 bytesPerTexel;
+		u32 reserved;
+	};
+
+	struct TextureMip
+	{
+		// From the start of the texture asset.
+		u64 offset;
+		u64 size;
+	};
+
+	constexpr u32 mipExtent(u32 extent, u32 mip)
+	{
+		return (extent >> mip) > 0 ? (extent >> mip) : 1;
+	}
+
+	constexpr usize mipSize(u32 width, u32 height, u32 bytesPerTexel, u32 mip)
+	{
+		return usize(mipExtent(width, mip)) * mipExtent(height, mip) * bytesPerTexel;
+	}
+
+	using TextureBytes = std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Assets>>;
+
+	// Lays out a texture asset from its levels, finest first, each mipSize bytes. For tools and tests.
+	TextureBytes buildTextureAsset(u32 width, u32 height, u32 bytesPerTexel, u32 mipCount, const u8 *const *mips);
+}
@@ -0,0 +1,311 @@
+#include "Core/Assets/TextureStreamer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace core::assets
+{
+	namespace
+	{
+		constexpr usize k_mipAlignment = 64;
+		// Extents are u32, so no texture has more levels than this.
+		constexpr u32 k_maxMipCount = 32;
+	}
+
+	TextureStreamer::TextureStreamer(const AssetPack &pack, jobs::JobSystem &jobs, const TextureStreamerConfig &config)
+		: m_pack(pack)
+		, m_jobs(jobs)
+		, m_loadCount(config.maxLoadsInFlight)
+		, m_budgetBytes(config.budgetBytes)
+	{
+		assert(m_loadCount > 0);
+		m_loads = static_cast<Load *>(memory::allocate(sizeof(Load) * m_loadCount, memory::Tag::Assets, alignof(Load)));
+		for (u32 i = 0; i < m_loadCount; ++i)
+			new (&m_loads[i]) Load();
+	}
+
+	TextureStreamer::~TextureStreamer()
+	{
+		m_jobs.wait(m_loadCounter);
+
+		for (const Texture &texture : m_textures)
+		{
+			for (u32 level = 0; level < texture.mipCount; ++level)
+			{
+				Mip &mip = m_mips[texture.firstMip + level];
+				if (mip.data != nullptr)
+					memory::deallocate(mip.data, mipBytes(texture, level), memory::Tag::Assets, k_mipAlignment);
+			}
+		}
+
+		for (u32 i = 0; i < m_loadCount; ++i)
+			m_loads[i].~Load();
+		memory::deallocate(m_loads, sizeof(Load) * m_loadCount, memory::Tag::Assets, alignof(Load));
+	}
+
+	TextureHandle TextureStreamer::addTexture(AssetId id)
+	{
+		const AssetView view = m_pack.find(id);
+		if (!view || view.size < sizeof(TextureHeader))
+			return {};
+
+		TextureHeader header;
+		std::memcpy(&header, view.data, sizeof(header));
+		if (header.magic != TextureHeader::k_magic || header.mipCount == 0 || header.mipCount > k_maxMipCount
+			|| view.size < sizeof(TextureHeader) + sizeof(TextureMip) * header.mipCount)
+			return {};
+
+		// Levels are sized and read from these records later, so a corrupt one must not get that far.
+		for (u32 mip = 0; mip < header.mipCount; ++mip)
+		{
+			TextureMip record;
+			std::memcpy(&record, view.data + sizeof(TextureHeader) + sizeof(TextureMip) * mip, sizeof(record));
+			if (record.offset > view.size || record.size > view.size - record.offset
+				|| record.size != mipSize(header.width, header.height, header.bytesPerTexel, mip))
+				return {};
+		}
+
+		Texture texture = {};
+		texture.asset = view.data;
+		texture.width = header.width;
+		texture.height = header.height;
+		texture.bytesPerTexel = header.bytesPerTexel;
+		texture.mipCount = header.mipCount;
+		texture.firstMip = static_cast<u32>(m_mips.size());
+		texture.residentMip = header.mipCount;
+		texture.requestedMip = header.mipCount;
+		texture.requestedFrame = 0;
+		texture.isLoading = false;
+
+		const TextureHandle handle = { static_cast<u32>(m_textures.size()) };
+		m_textures.push_back(texture);
+		for (u32 mip = 0; mip < header.mipCount; ++mip)
+		{
+			Mip state;
+			state.texture = handle.index;
+			m_mips.push_back(state);
+		}
+
+		return handle;
+	}
+
+	void TextureStreamer::request(TextureHandle handle, f32 screenSize)
+	{
+		Texture &texture = m_textures[handle.index];
+
+		// The coarsest level that still has at least one texel per pixel.
+		const u32 extent = std::max(texture.width, texture.height);
+		u32 mip = 0;
+		while (mip + 1 < texture.mipCount && static_cast<f32>(mipExtent(extent, mip + 1)) >= screenSize)
+			++mip;
+
+		if (texture.requestedFrame != m_frame)
+		{
+			texture.requestedFrame = m_frame;
+			texture.requestedMip = mip;
+			m_requested.push_back(handle.index);
+		}
+		else
+		{
+			texture.requestedMip = std::min(texture.requestedMip, mip);
+		}
+	}
+
+	void TextureStreamer::update()
+	{
+		finishLoads();
+
+		// Marking the coarse levels last keeps them more recent than the fine ones, so eviction always finds
+		// a texture's finest level first and resident runs stay contiguous.
+		m_candidates.clear();
+		for (u32 index : m_requested)
+		{
+			const Texture &texture = m_textures[index];
+			for (u32 mip = std::max(texture.requestedMip, texture.residentMip); mip < texture.mipCount; ++mip)
+				touch(texture.firstMip + mip);
+
+			if (texture.requestedMip < texture.residentMip && !texture.isLoading)
+				m_candidates.push_back(index);
+		}
+
+		// Textures furthest from what they need go first.
+		std::sort(m_candidates.begin(), m_candidates.end(), [this](u32 a, u32 b)
+		{
+			const Texture &first = m_textures[a];
+			const Texture &second = m_textures[b];
+			return first.residentMip - first.requestedMip > second.residentMip - second.requestedMip;
+		});
+
+		u32 freeLoad = 0;
+		for (u32 index : m_candidates)
+		{
+			while (freeLoad < m_loadCount && m_loads[freeLoad].mip != k_none)
+				++freeLoad;
+			if (freeLoad == m_loadCount)
+				break;
+
+			Texture &texture = m_textures[index];
+			const u32 level = texture.residentMip - 1;
+			const usize bytes = mipBytes(texture, level);
+			if (!makeRoom(bytes))
+				continue;
+
+			const u32 mip = texture.firstMip + level;
+			m_mips[mip].data = static_cast<u8 *>(memory::allocate(bytes, memory::Tag::Assets, k_mipAlignment));
+			m_usedBytes += bytes;
+			texture.isLoading = true;
+
+			const TextureMip &record = mipRecord(texture, level);
+			const u8 *source = texture.asset + record.offset;
+			m_pack.file().prefetch(m_pack.offsetOf({ source, bytes }), bytes);
+
+			Load &load = m_loads[freeLoad];
+			load.source = source;
+			load.destination = m_mips[mip].data;
+			load.size = bytes;
+			load.mip = mip;
+			load.isDone.store(false, std::memory_order_relaxed);
+			m_jobs.run(jobs::Job{ &TextureStreamer::loadMip, &load }, &m_loadCounter);
+		}
+
+		// A lowered budget is honoured even on frames that load nothing.
+		makeRoom(0);
+
+		m_requested.clear();
+		++m_frame;
+	}
+
+	const u8 *TextureStreamer::mipData(TextureHandle handle, u32 mip) const
+	{
+		const Texture &texture = m_textures[handle.index];
+		return mip >= texture.residentMip && mip < texture.mipCount ? m_mips[texture.firstMip + mip].data : nullptr;
+	}
+
+	void TextureStreamer::loadMip(void *data)
+	{
+		Load &load = *static_cast<Load *>(data);
+		std::memcpy(load.destination, load.source, load.size);
+		load.isDone.store(true, std::memory_order_release);
+	}
+
+	const TextureMip &TextureStreamer::mipRecord(const Texture &texture, u32 mip) const
+	{
+		return reinterpret_cast<const TextureMip *>(texture.asset + sizeof(TextureHeader))[mip];
+	}
+
+	usize TextureStreamer::mipBytes(const Texture &texture, u32 mip) const
+	{
+		return static_cast<usize>(mipRecord(texture, mip).size);
+	}
+
+	void TextureStreamer::finishLoads()
+	{
+		for (u32 i = 0; i < m_loadCount; ++i)
+		{
+			Load &load = m_loads[i];
+			if (load.mip == k_none || !load.isDone.load(std::memory_order_acquire))
+				continue;
+
+			Texture &texture = m_textures[m_mips[load.mip].texture];
+			const u32 level = load.mip - texture.firstMip;
+
+			// Queued right behind the next coarser level, so it is evicted before it whether or not it gets requested.
+			if (level + 1 < texture.mipCount)
+				insertAfter(load.mip, load.mip + 1);
+			else
+				pushFront(load.mip);
+
+			texture.residentMip = level;
+			texture.isLoading = false;
+			load.mip = k_none;
+		}
+	}
+
+	void TextureStreamer::touch(u32 mip)
+	{
+		m_mips[mip].lastUsedFrame = m_frame;
+		unlink(mip);
+		pushFront(mip);
+	}
+
+	void TextureStreamer::unlink(u32 mip)
+	{
+		Mip &state = m_mips[mip];
+		if (state.previous != k_none)
+			m_mips[state.previous].next = state.next;
+		else
+			m_lruHead = state.next;
+
+		if (state.next != k_none)
+			m_mips[state.next].previous = state.previous;
+		else
+			m_lruTail = state.previous;
+
+		state.previous = k_none;
+		state.next = k_none;
+	}
+
+	void TextureStreamer::pushFront(u32 mip)
+	{
+		Mip &state = m_mips[mip];
+		state.lastUsedFrame = std::max(state.lastUsedFrame, m_frame);
+		state.previous = k_none;
+		state.next = m_lruHead;
+		if (m_lruHead != k_none)
+			m_mips[m_lruHead].previous = mip;
+		else
+			m_lruTail = mip;
+		m_lruHead = mip;
+	}
+
+	void TextureStreamer::insertAfter(u32 mip, u32 position)
+	{
+		Mip &state = m_mips[mip];
+		Mip &before = m_mips[position];
+		state.lastUsedFrame = before.lastUsedFrame;
+		state.previous = position;
+		state.next = before.next;
+		if (before.next != k_none)
+			m_mips[before.next].previous = mip;
+		else
+			m_lruTail = mip;
+		before.next = mip;
+	}
+
+	bool TextureStreamer::makeRoom(usize bytes)
+	{
+		// Levels used this frame are never evicted, so a frame that needs more than the budget stops loading
+		// instead of thrashing. Textures with a load in flight keep their levels until it lands.
+		u32 candidate = m_lruTail;
+		while (m_usedBytes + bytes > m_budgetBytes)
+		{
+			while (candidate != k_none && m_textures[m_mips[candidate].texture].isLoading)
+				candidate = m_mips[candidate].previous;
+
+			if (candidate == k_none || m_mips[candidate].lastUsedFrame >= m_frame)
+				return false;
+
+			const u32 previous = m_mips[candidate].previous;
+			evict(candidate);
+			candidate = previous;
+		}
+
+		return true;
+	}
+
+	void TextureStreamer::evict(u32 mip)
+	{
+		Mip &state = m_mips[mip];
+		Texture &texture = m_textures[state.texture];
+		const u32 level = mip - texture.firstMip;
+		assert(level == texture.residentMip && "Only a texture's finest resident level can be evicted.");
+
+		unlink(mip);
+		const usize bytes = mipBytes(texture, level);
+		memory::deallocate(state.data, bytes, memory::Tag::Assets, k_mipAlignment);
+		state.data = nullptr;
+		m_usedBytes -= bytes;
+		texture.residentMip = level + 1;
+	}
+}
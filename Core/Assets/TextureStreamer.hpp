@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Assets/AssetPack.hpp"
+#include "Core/Assets/Texture.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::assets
+{
+	struct TextureHandle
+	{
+		static constexpr u32 k_invalid = ~0u;
+
+		u32 index = k_invalid;
+
+		bool isValid() const { return index != k_invalid; }
+	};
+
+	struct TextureStreamerConfig
+	{
+		usize budgetBytes = 256 * 1024 * 1024;
+		u32 maxLoadsInFlight = 32;
+	};
+
+	// Keeps only the mip levels that recent frames asked for in memory, within a byte budget.
+	// Each frame, rendering requests textures at the size they cover on screen; update() then loads missing levels
+	// one at a time from coarse to fine, and evicts the least recently used levels when the budget runs out.
+	// A texture's resident levels are always a contiguous run ending at its coarsest level.
+	// Levels are copied out of the mapped pack on job workers, so page faults never hit the frame.
+	class TextureStreamer
+	{
+	public:
+		TextureStreamer(const AssetPack &pack, jobs::JobSystem &jobs, const TextureStreamerConfig &config = TextureStreamerConfig());
+		// Waits for loads in flight.
+		~TextureStreamer();
+
+		TextureStreamer(const TextureStreamer &) = delete;
+		TextureStreamer &operator=(const TextureStreamer &) = delete;
+
+		// Reads the texture's header from the pack; no level is loaded until it is requested.
+		// Returns an invalid handle when the pack has no texture with this id, or its header or level records are corrupt.
+		TextureHandle addTexture(AssetId id);
+
+		// Asks for the texture to be sharp when drawn screenSize pixels across. Requests last one frame.
+		void request(TextureHandle texture, f32 screenSize);
+
+		// Finishes loads, starts loads for this frame's requests and evicts under the budget. Call once per frame.
+		void update();
+
+		void setBudget(usize bytes) { m_budgetBytes = bytes; }
+		usize budgetBytes() const { return m_budgetBytes; }
+		// Resident levels plus levels being loaded.
+		usize usedBytes() const { return m_usedBytes; }
+
+		// Finest resident level, or the level count when none is resident.
+		u32 residentMip(TextureHandle texture) const { return m_textures[texture.index].residentMip; }
+		// Level the latest request asked for, or the level count when the texture was not requested.
+		u32 requestedMip(TextureHandle texture) const { return m_textures[texture.index].requestedMip; }
+		u32 mipCount(TextureHandle texture) const { return m_textures[texture.index].mipCount; }
+		// Nullptr unless the level is resident.
+		const u8 *mipData(TextureHandle texture, u32 mip) const;
+
+	private:
+		static constexpr u32 k_none = ~0u;
+
+		struct Texture
+		{
+			const u8 *asset;
+			u32 width;
+			u32 height;
+			u32 bytesPerTexel;
+			u32 mipCount;
+			u32 firstMip;
+			u32 residentMip;
+			u32 requestedMip;
+			u64 requestedFrame;
+			bool isLoading;
+		};
+
+		// Resident levels form an intrusive list, most recently used first.
+		struct Mip
+		{
+			u8 *data = nullptr;
+			u32 texture = 0;
+			u32 previous = k_none;
+			u32 next = k_none;
+			u64 lastUsedFrame = 0;
+		};
+
+		// Jobs only see their own load, so textures can be added while loads run.
+		struct Load
+		{
+			const u8 *source = nullptr;
+			u8 *destination = nullptr;
+			usize size = 0;
+			u32 mip = k_none;
+			std::atomic<bool> isDone{ false };
+		};
+
+		static void loadMip(void *data);
+
+		const TextureMip &mipRecord(const Texture &texture, u32 mip) const;
+		usize mipBytes(const Texture &texture, u32 mip) const;
+
+		void finishLoads();
+		void touch(u32 mip);
+		void unlink(u32 mip);
+		void pushFront(u32 mip);
+		void insertAfter(u32 mip, u32 position);
+		bool makeRoom(usize bytes);
+		void evict(u32 mip);
+
+		const AssetPack &m_pack;
+		jobs::JobSystem &m_jobs;
+		jobs::Counter m_loadCounter;
+
+		std::vector<Texture, memory::TaggedAllocator<Texture, memory::Tag::Assets>> m_textures;
+		std::vector<Mip, memory::TaggedAllocator<Mip, memory::Tag::Assets>> m_mips;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Assets>> m_requested;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Assets>> m_candidates;
+
+		Load *m_loads = nullptr;
+		u32 m_loadCount = 0;
+
+		u32 m_lruHead = k_none;
+		u32 m_lruTail = k_none;
+		u64 m_frame = 1;
+		usize m_budgetBytes;
+		usize m_usedBytes = 0;
+	};
+}
@@ -0,0 +1,177 @@
+#include "Core/Audio/AudioStreamer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+#include "Core/Audio/SoundAsset.hpp"
+
+namespace core::audio
+{
+	namespace
+	{
+		constexpr usize k_ringAlignment = 64;
+		// Rings hold stereo frames, the most any sound has.
+		constexpr u32 k_maxChannels = 2;
+	}
+
+	u32 AudioStream::bufferedFrames() const
+	{
+		const u64 write = m_writeFrame.load(std::memory_order_acquire);
+		const u64 read = m_readFrame.load(std::memory_order_acquire);
+		return write > read ? static_cast<u32>(write - read) : 0;
+	}
+
+	bool AudioStream::isPrimed() const
+	{
+		const u64 write = m_writeFrame.load(std::memory_order_acquire);
+		return write >= m_ringFrames / 2 || (!m_loops && write >= m_frameCount);
+	}
+
+	u32 AudioStream::read(u64 first, f32 *destination, u32 count)
+	{
+		const u64 write = m_writeFrame.load(std::memory_order_acquire);
+		const u32 available = write > first ? static_cast<u32>(std::min<u64>(count, write - first)) : 0;
+
+		// At most two pieces: up to the end of the ring, then from its start.
+		const u32 position = static_cast<u32>(first % m_ringFrames);
+		const u32 head = std::min(available, m_ringFrames - position);
+		std::memcpy(destination, m_ring + usize(position) * m_channelCount, usize(head) * m_channelCount * sizeof(f32));
+		std::memcpy(destination + usize(head) * m_channelCount, m_ring, usize(available - head) * m_channelCount * sizeof(f32));
+
+		// Coming up short past the end of a sound that does not loop is expected; anywhere else decoding fell behind.
+		if (available < count && (m_loops || first + available < m_frameCount))
+			m_underrunCount.fetch_add(1, std::memory_order_relaxed);
+		return available;
+	}
+
+	void AudioStream::refill(void *data)
+	{
+		AudioStream &stream = *static_cast<AudioStream *>(data);
+		const u64 read = stream.m_readFrame.load(std::memory_order_acquire);
+		u64 write = stream.m_writeFrame.load(std::memory_order_relaxed);
+
+		// After an underrun the mixer is past what was decoded; frames it skipped are not worth decoding.
+		if (read > write)
+			write = read;
+
+		const u64 end = stream.m_loops ? ~0ull : stream.m_frameCount;
+		while (write < end && write - read < stream.m_ringFrames)
+		{
+			const u32 position = static_cast<u32>(write % stream.m_ringFrames);
+			const u64 sourceFrame = write % stream.m_frameCount;
+			const u64 free = stream.m_ringFrames - (write - read);
+			const u32 count = static_cast<u32>(std::min({ free, u64(stream.m_ringFrames - position), stream.m_frameCount - sourceFrame }));
+
+			decodePcm16(stream.m_source + sourceFrame * stream.m_channelCount, stream.m_ring + usize(position) * stream.m_channelCount,
+				usize(count) * stream.m_channelCount);
+			write += count;
+		}
+
+		stream.m_writeFrame.store(write, std::memory_order_release);
+		stream.m_isRefilling.store(false, std::memory_order_release);
+	}
+
+	AudioStreamer::AudioStreamer(const assets::AssetPack &pack, jobs::JobSystem &jobs, const AudioStreamerConfig &config)
+		: m_pack(pack)
+		, m_jobs(jobs)
+		, m_streamCount(config.maxStreams)
+		, m_ringFrames(config.ringFrames)
+		, m_ringBytes(usize(config.maxStreams) * config.ringFrames * k_maxChannels * sizeof(f32))
+	{
+		assert(m_streamCount > 0 && m_ringFrames >= 4);
+		m_streams = static_cast<AudioStream *>(memory::allocate(sizeof(AudioStream) * m_streamCount, memory::Tag::Audio, alignof(AudioStream)));
+		m_rings = static_cast<f32 *>(memory::allocate(m_ringBytes, memory::Tag::Audio, k_ringAlignment));
+		for (u32 i = 0; i < m_streamCount; ++i)
+		{
+			AudioStream *stream = new (&m_streams[i]) AudioStream();
+			stream->m_ring = m_rings + usize(i) * m_ringFrames * k_maxChannels;
+			stream->m_ringFrames = m_ringFrames;
+		}
+	}
+
+	AudioStreamer::~AudioStreamer()
+	{
+		m_jobs.wait(m_refillCounter);
+
+		for (u32 i = 0; i < m_streamCount; ++i)
+			m_streams[i].~AudioStream();
+		memory::deallocate(m_streams, sizeof(AudioStream) * m_streamCount, memory::Tag::Audio, alignof(AudioStream));
+		memory::deallocate(m_rings, m_ringBytes, memory::Tag::Audio, k_ringAlignment);
+	}
+
+	AudioStream *AudioStreamer::open(assets::AssetId id, bool loops)
+	{
+		const assets::AssetView view = m_pack.find(id);
+		if (!view || view.size < sizeof(SoundHeader))
+			return nullptr;
+
+		SoundHeader header;
+		std::memcpy(&header, view.data, sizeof(header));
+		if (header.magic != SoundHeader::k_magic || header.channelCount == 0 || header.channelCount > k_maxChannels
+			|| header.sampleRate == 0 || header.frameCount == 0 || view.size < sizeof(SoundHeader) + usize(header.frameCount) * header.channelCount * sizeof(i16))
+			return nullptr;
+
+		AudioStream *stream = std::find_if(m_streams, m_streams + m_streamCount, [](const AudioStream &candidate) { return !candidate.m_isOpen; });
+		if (stream == m_streams + m_streamCount)
+			return nullptr;
+
+		// Closed streams have no refill running and no voice playing them, so nothing else reads these.
+		stream->m_source = reinterpret_cast<const i16 *>(view.data + sizeof(SoundHeader));
+		stream->m_channelCount = header.channelCount;
+		stream->m_sampleRate = header.sampleRate;
+		stream->m_frameCount = header.frameCount;
+		stream->m_loops = loops;
+		stream->m_writeFrame.store(0, std::memory_order_relaxed);
+		stream->m_readFrame.store(0, std::memory_order_relaxed);
+		stream->m_underrunCount.store(0, std::memory_order_relaxed);
+		stream->m_isOpen = true;
+		stream->m_isClosing = false;
+		++m_openCount;
+
+		update();
+		return stream;
+	}
+
+	void AudioStreamer::close(AudioStream *stream)
+	{
+		assert(stream->m_isOpen);
+		stream->m_isClosing = true;
+	}
+
+	void AudioStreamer::update()
+	{
+		for (u32 i = 0; i < m_streamCount; ++i)
+		{
+			AudioStream &stream = m_streams[i];
+			if (!stream.m_isOpen || stream.m_isRefilling.load(std::memory_order_acquire))
+				continue;
+
+			if (stream.m_isClosing)
+			{
+				if (!stream.m_isAttached.load(std::memory_order_acquire))
+				{
+					stream.m_isOpen = false;
+					--m_openCount;
+				}
+				continue;
+			}
+
+			const u64 write = stream.m_writeFrame.load(std::memory_order_relaxed);
+			if (!stream.m_loops && write >= stream.m_frameCount)
+				continue;
+			if (stream.bufferedFrames() > m_ringFrames - m_ringFrames / 4)
+				continue;
+
+			// The pages the refill is about to decode, read ahead while the job waits for a worker.
+			const u64 sourceFrame = write % stream.m_frameCount;
+			const usize frames = static_cast<usize>(std::min<u64>(m_ringFrames, stream.m_frameCount - sourceFrame));
+			const u8 *source = reinterpret_cast<const u8 *>(stream.m_source + sourceFrame * stream.m_channelCount);
+			m_pack.file().prefetch(m_pack.offsetOf({ source, frames * stream.m_channelCount * sizeof(i16) }), frames * stream.m_channelCount * sizeof(i16));
+
+			stream.m_isRefilling.store(true, std::memory_order_relaxed);
+			m_jobs.run(jobs::Job{ &AudioStream::refill, &stream }, &m_refillCounter);
+		}
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Assets/AssetPack.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::audio
+{
+	// A sound asset decoded a little ahead of where it plays, into a ring of fixed size. The refill jobs write frames
+	// and the mixer reads and releases them; frames are numbered from the start of the stream and keep counting
+	// through loops.
+	class AudioStream
+	{
+	public:
+		u32 channelCount() const { return m_channelCount; }
+		u32 sampleRate() const { return m_sampleRate; }
+		u32 frameCount() const { return m_frameCount; }
+		bool loops() const { return m_loops; }
+
+		// Decoded frames the mixer has not released yet.
+		u32 bufferedFrames() const;
+		// Enough is decoded to start playing: half a ring, or the whole sound when it is shorter.
+		bool isPrimed() const;
+		// Blocks the mixer had to fill partly with silence because decoding fell behind.
+		u32 underrunCount() const { return m_underrunCount.load(std::memory_order_relaxed); }
+
+		// Audio thread. Copies up to count interleaved frames from the first one on, and returns how many were decoded.
+		u32 read(u64 first, f32 *destination, u32 count);
+		// Audio thread. Frames before this one will not be read again, and their space can be refilled.
+		void release(u64 frame) { m_readFrame.store(frame, std::memory_order_release); }
+
+	private:
+		friend class AudioStreamer;
+		friend class Mixer;
+
+		// Job side: decodes into the free part of the ring.
+		static void refill(void *data);
+
+		const i16 *m_source = nullptr;
+		f32 *m_ring = nullptr;
+		u32 m_ringFrames = 0;
+		u32 m_channelCount = 0;
+		u32 m_sampleRate = 0;
+		u32 m_frameCount = 0;
+		bool m_loops = false;
+
+		// Written by the refill job only.
+		std::atomic<u64> m_writeFrame{ 0 };
+		// Written by the audio thread only.
+		std::atomic<u64> m_readFrame{ 0 };
+		std::atomic<u32> m_underrunCount{ 0 };
+
+		// Set by the game thread when it starts a refill or a voice plays the stream; cleared when they are done.
+		std::atomic<bool> m_isRefilling{ false };
+		std::atomic<bool> m_isAttached{ false };
+
+		// Game thread.
+		bool m_isOpen = false;
+		bool m_isClosing = false;
+	};
+
+	struct AudioStreamerConfig
+	{
+		u32 maxStreams = 16;
+		// Frames of each ring. A third of a second at 48 kHz, plenty for refills started once a frame.
+		u32 ringFrames = 16384;
+	};
+
+	// Streams sound assets for music and long ambience, which are never decoded whole. Every stream gets a ring of
+	// the same size when the streamer is made, so memory stays the same however long the sounds are. update() starts
+	// a job for each ring that has room for a quarter of itself; jobs decode from the mapped pack, so page faults
+	// never reach the game or the audio thread.
+	class AudioStreamer
+	{
+	public:
+		AudioStreamer(const assets::AssetPack &pack, jobs::JobSystem &jobs, const AudioStreamerConfig &config = AudioStreamerConfig());
+		// Waits for refills in flight.
+		~AudioStreamer();
+
+		AudioStreamer(const AudioStreamer &) = delete;
+		AudioStreamer &operator=(const AudioStreamer &) = delete;
+
+		// Starts decoding the sound asset. Play it once it isPrimed(). Nullptr when the pack has no valid mono or stereo
+		// sound with this id, or when every stream is open.
+		AudioStream *open(assets::AssetId id, bool loops = false);
+		// The stream is reused once no voice plays it and no refill runs; stop the voice first.
+		void close(AudioStream *stream);
+
+		// Starts refills and reclaims closed streams. Call once per frame.
+		void update();
+
+		u32 openCount() const { return m_openCount; }
+		// Bytes of every ring, open or not.
+		usize ringBytes() const { return m_ringBytes; }
+
+	private:
+		const assets::AssetPack &m_pack;
+		jobs::JobSystem &m_jobs;
+		jobs::Counter m_refillCounter;
+
+		AudioStream *m_streams = nullptr;
+		f32 *m_rings = nullptr;
+		u32 m_streamCount = 0;
+		u32 m_ringFrames = 0;
+		usize m_ringBytes = 0;
+		u32 m_openCount = 0;
+	};
+}
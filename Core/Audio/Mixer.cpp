@@ -0,0 +1,510 @@
+#include "Core/Audio/Mixer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "Core/Audio/AudioStreamer.hpp"
+#include "Core/Math/Simd.hpp"
+
+namespace core::audio
+{
+	namespace
+	{
+		using math::F32x4;
+
+		constexpr f32 k_quarterPi = 0.785398163397448309616f;
+
+		// NaN fails the comparison and lands on the minimum too.
+		f32 clampPitch(f32 pitch)
+		{
+			return pitch > Mixer::k_minPitch ? std::min(pitch, Mixer::k_maxPitch) : Mixer::k_minPitch;
+		}
+
+		// Samples at offsets frac + k * step from the start of the run, with gains ramping from start by step per frame.
+		// Every offset must leave a sample after it to interpolate with.
+		struct Run
+		{
+			const f32 *samples;
+			f32 frac;
+			f32 step;
+			usize count;
+			f32 leftGain;
+			f32 leftStep;
+			f32 rightGain;
+			f32 rightStep;
+		};
+
+		void mixMono(const Run &run, f32 *left, f32 *right)
+		{
+			const bool isContiguous = run.frac == 0.0f && run.step == 1.0f;
+			const F32x4 lanes(0.0f, 1.0f, 2.0f, 3.0f);
+
+			usize k = 0;
+			for (; k + F32x4::k_width <= run.count; k += F32x4::k_width)
+			{
+				F32x4 value;
+				if (isContiguous)
+				{
+					value = F32x4::load(run.samples + k);
+				}
+				else
+				{
+					// No gathers in SSE2: the two neighbours of each lane are fetched one by one, the blend runs four wide.
+					f32 a[4], b[4], t[4];
+					for (usize lane = 0; lane < 4; ++lane)
+					{
+						const f32 offset = run.frac + static_cast<f32>(k + lane) * run.step;
+						const usize index = static_cast<usize>(offset);
+						a[lane] = run.samples[index];
+						b[lane] = run.samples[index + 1];
+						t[lane] = offset - static_cast<f32>(index);
+					}
+					const F32x4 first = F32x4::load(a);
+					value = first + (F32x4::load(b) - first) * F32x4::load(t);
+				}
+
+				const F32x4 frame = F32x4(static_cast<f32>(k)) + lanes;
+				const F32x4 leftGain = F32x4(run.leftGain) + frame * F32x4(run.leftStep);
+				const F32x4 rightGain = F32x4(run.rightGain) + frame * F32x4(run.rightStep);
+				(F32x4::load(left + k) + value * leftGain).store(left + k);
+				(F32x4::load(right + k) + value * rightGain).store(right + k);
+			}
+
+			for (; k < run.count; ++k)
+			{
+				const f32 offset = run.frac + static_cast<f32>(k) * run.step;
+				const usize index = static_cast<usize>(offset);
+				const f32 t = offset - static_cast<f32>(index);
+				const f32 value = run.samples[index] + (run.samples[index + 1] - run.samples[index]) * t;
+				left[k] += value * (run.leftGain + static_cast<f32>(k) * run.leftStep);
+				right[k] += value * (run.rightGain + static_cast<f32>(k) * run.rightStep);
+			}
+		}
+
+		// Interleaved pairs. The left channel goes left and the right channel right, each at its own gain.
+		void mixStereo(const Run &run, f32 *left, f32 *right)
+		{
+			const F32x4 lanes(0.0f, 1.0f, 2.0f, 3.0f);
+
+			usize k = 0;
+			for (; k + F32x4::k_width <= run.count; k += F32x4::k_width)
+			{
+				f32 a[2][4], b[2][4], t[4];
+				for (usize lane = 0; lane < 4; ++lane)
+				{
+					const f32 offset = run.frac + static_cast<f32>(k + lane) * run.step;
+					const usize index = static_cast<usize>(offset);
+					a[0][lane] = run.samples[index * 2];
+					a[1][lane] = run.samples[index * 2 + 1];
+					b[0][lane] = run.samples[index * 2 + 2];
+					b[1][lane] = run.samples[index * 2 + 3];
+					t[lane] = offset - static_cast<f32>(index);
+				}
+				const F32x4 blend = F32x4::load(t);
+				const F32x4 firstLeft = F32x4::load(a[0]);
+				const F32x4 firstRight = F32x4::load(a[1]);
+				const F32x4 valueLeft = firstLeft + (F32x4::load(b[0]) - firstLeft) * blend;
+				const F32x4 valueRight = firstRight + (F32x4::load(b[1]) - firstRight) * blend;
+
+				const F32x4 frame = F32x4(static_cast<f32>(k)) + lanes;
+				const F32x4 leftGain = F32x4(run.leftGain) + frame * F32x4(run.leftStep);
+				const F32x4 rightGain = F32x4(run.rightGain) + frame * F32x4(run.rightStep);
+				(F32x4::load(left + k) + valueLeft * leftGain).store(left + k);
+				(F32x4::load(right + k) + valueRight * rightGain).store(right + k);
+			}
+
+			for (; k < run.count; ++k)
+			{
+				const f32 offset = run.frac + static_cast<f32>(k) * run.step;
+				const usize index = static_cast<usize>(offset);
+				const f32 t = offset - static_cast<f32>(index);
+				const f32 *a = run.samples + index * 2;
+				left[k] += (a[0] + (a[2] - a[0]) * t) * (run.leftGain + static_cast<f32>(k) * run.leftStep);
+				right[k] += (a[1] + (a[3] - a[1]) * t) * (run.rightGain + static_cast<f32>(k) * run.rightStep);
+			}
+		}
+	}
+
+	Mixer::Mixer(const MixerConfig &config)
+		: m_config(config)
+		, m_commands(config.commandCapacity, memory::Tag::Audio)
+		, m_slots(config.maxVoices)
+		, m_finished(config.maxVoices)
+		, m_voices(config.maxVoices)
+		, m_left(k_blockFrames)
+		, m_right(k_blockFrames)
+		, m_streamFrames((static_cast<usize>(k_blockFrames * k_maxStreamStep) + 2) * 2)
+	{
+		// Lowest slots first, so few voices stay packed at the front of the voice array.
+		m_freeSlots.reserve(config.maxVoices);
+		for (u32 slot = config.maxVoices; slot-- > 0;)
+			m_freeSlots.push_back(slot);
+	}
+
+	VoiceHandle Mixer::play(const Sound &sound, const VoiceParams &params)
+	{
+		assert(sound.channelCount == 1 || sound.channelCount == 2);
+		assert(sound.sampleRate > 0);
+		if (sound.frameCount == 0)
+			return {};
+
+		return start({ Command::Type::Play, params.isPositional, params.loops, 0, 0, params.gain, clampPitch(params.pitch), params.position,
+			sound, nullptr });
+	}
+
+	VoiceHandle Mixer::playStream(AudioStream &stream, const VoiceParams &params)
+	{
+		assert(!stream.m_isAttached.load(std::memory_order_relaxed) && "The stream already plays on a voice.");
+
+		// Attached before the command is queued, so the streamer cannot reclaim the stream under the voice.
+		stream.m_isAttached.store(true, std::memory_order_relaxed);
+		const Sound sound = { nullptr, stream.frameCount(), stream.channelCount(), stream.sampleRate() };
+		const VoiceHandle voice = start({ Command::Type::Play, params.isPositional, stream.loops(), 0, 0, params.gain,
+			clampPitch(params.pitch), params.position, sound, &stream });
+		if (!voice.isValid())
+			stream.m_isAttached.store(false, std::memory_order_relaxed);
+		return voice;
+	}
+
+	VoiceHandle Mixer::start(const Command &command)
+	{
+		if (m_freeSlots.empty())
+			return {};
+
+		const u32 slot = m_freeSlots.back();
+		Command play = command;
+		play.slot = slot;
+		play.generation = m_slots[slot].generation;
+		if (!push(play))
+			return {};
+
+		m_freeSlots.pop_back();
+		m_slots[slot].isPlaying = true;
+		++m_playingCount;
+		return { slot, m_slots[slot].generation };
+	}
+
+	bool Mixer::stop(VoiceHandle voice)
+	{
+		if (!isPlaying(voice))
+			return true;
+
+		// A dropped stop never reaches the audio thread, so the slot stays with the voice still playing in it.
+		if (!send(Command::Type::Stop, voice, 0.0f, math::Vec2f::zero()))
+			return false;
+
+		// The slot can play again right away: the audio thread applies the stop before any later play.
+		Slot &slot = m_slots[voice.index];
+		++slot.generation;
+		slot.isPlaying = false;
+		m_freeSlots.push_back(voice.index);
+		--m_playingCount;
+		return true;
+	}
+
+	void Mixer::setGain(VoiceHandle voice, f32 gain)
+	{
+		send(Command::Type::SetGain, voice, gain, math::Vec2f::zero());
+	}
+
+	void Mixer::setPitch(VoiceHandle voice, f32 pitch)
+	{
+		send(Command::Type::SetPitch, voice, clampPitch(pitch), math::Vec2f::zero());
+	}
+
+	void Mixer::setPosition(VoiceHandle voice, math::Vec2f position)
+	{
+		send(Command::Type::SetPosition, voice, 0.0f, position);
+	}
+
+	void Mixer::setListener(math::Vec2f position)
+	{
+		push({ Command::Type::SetListener, false, false, 0, 0, 0.0f, 0.0f, position, {}, nullptr });
+	}
+
+	void Mixer::update()
+	{
+		for (u32 index = 0; index < m_slots.size(); ++index)
+		{
+			Slot &slot = m_slots[index];
+			if (slot.isPlaying && m_finished[index].load(std::memory_order_acquire) == slot.generation)
+			{
+				++slot.generation;
+				slot.isPlaying = false;
+				m_freeSlots.push_back(index);
+				--m_playingCount;
+			}
+		}
+	}
+
+	bool Mixer::isPlaying(VoiceHandle voice) const
+	{
+		return voice.index < m_slots.size() && m_slots[voice.index].generation == voice.generation && m_slots[voice.index].isPlaying;
+	}
+
+	bool Mixer::push(const Command &command)
+	{
+		if (m_commands.tryPush(command))
+			return true;
+
+		++m_droppedCommandCount;
+		return false;
+	}
+
+	bool Mixer::send(Command::Type type, VoiceHandle voice, f32 value, math::Vec2f position)
+	{
+		return isPlaying(voice) && push({ type, false, false, voice.index, voice.generation, value, 0.0f, position, {}, nullptr });
+	}
+
+	void Mixer::render(f32 *output, usize frameCount)
+	{
+		Command command;
+		while (m_commands.tryPop(command))
+			apply(command);
+
+		m_mixedVoiceCount = 0;
+		for (const Voice &voice : m_voices)
+			m_mixedVoiceCount += voice.isActive ? 1 : 0;
+
+		for (usize done = 0; done < frameCount;)
+		{
+			const usize count = std::min(k_blockFrames, frameCount - done);
+			std::fill(m_left.begin(), m_left.begin() + count, 0.0f);
+			std::fill(m_right.begin(), m_right.begin() + count, 0.0f);
+
+			for (u32 slot = 0; slot < m_voices.size(); ++slot)
+			{
+				Voice &voice = m_voices[slot];
+				if (voice.isActive && !mixVoice(voice, count))
+				{
+					voice.isActive = false;
+					release(voice);
+					m_finished[slot].store(voice.generation, std::memory_order_release);
+				}
+			}
+
+			f32 *out = output + done * 2;
+			for (usize i = 0; i < count; ++i)
+			{
+				out[i * 2] = std::clamp(m_left[i], -1.0f, 1.0f);
+				out[i * 2 + 1] = std::clamp(m_right[i], -1.0f, 1.0f);
+			}
+			done += count;
+		}
+	}
+
+	void Mixer::apply(const Command &command)
+	{
+		if (command.type == Command::Type::SetListener)
+		{
+			m_listener = command.position;
+			return;
+		}
+
+		Voice &voice = m_voices[command.slot];
+		if (command.type == Command::Type::Play)
+		{
+			release(voice);
+			voice = Voice();
+			voice.sound = command.sound;
+			voice.stream = command.stream;
+			voice.generation = command.generation;
+			voice.isActive = true;
+			voice.isPositional = command.isPositional;
+			voice.loops = command.loops;
+			voice.gain = command.value;
+			// A pitch that is not positive would read before the cursor, or never move it.
+			assert(command.pitch >= k_minPitch && command.pitch <= k_maxPitch);
+			voice.pitch = command.pitch;
+			voice.position = command.position;
+			return;
+		}
+
+		// Commands for a play that has since ended, or been replaced, are stale.
+		if (!voice.isActive || voice.generation != command.generation)
+			return;
+
+		switch (command.type)
+		{
+		case Command::Type::Stop:
+			voice.isActive = false;
+			release(voice);
+			break;
+		case Command::Type::SetGain:
+			voice.gain = command.value;
+			break;
+		case Command::Type::SetPitch:
+			assert(command.value >= k_minPitch && command.value <= k_maxPitch);
+			voice.pitch = command.value;
+			break;
+		case Command::Type::SetPosition:
+			voice.position = command.position;
+			break;
+		default:
+			break;
+		}
+	}
+
+	void Mixer::targetGains(const Voice &voice, f32 &left, f32 &right) const
+	{
+		if (!voice.isPositional)
+		{
+			left = voice.gain;
+			right = voice.gain;
+			return;
+		}
+
+		const math::Vec2f offset = voice.position - m_listener;
+		const f32 distance = offset.length();
+		if (distance >= m_config.maxDistance)
+		{
+			left = 0.0f;
+			right = 0.0f;
+			return;
+		}
+
+		// Inverse distance past the reference, with a linear fade so it reaches silence at the maximum distance.
+		const f32 clamped = std::max(distance, m_config.referenceDistance);
+		const f32 attenuation = m_config.referenceDistance / clamped * (1.0f - distance / m_config.maxDistance);
+
+		// Constant power panning: the sum of the squared gains, the loudness, is the same across the field.
+		const f32 pan = std::clamp(offset.x / clamped, -1.0f, 1.0f);
+		const f32 angle = (pan + 1.0f) * k_quarterPi;
+		left = voice.gain * attenuation * std::cos(angle);
+		right = voice.gain * attenuation * std::sin(angle);
+	}
+
+	bool Mixer::mixVoice(Voice &voice, usize frameCount)
+	{
+		f32 leftGain, rightGain;
+		targetGains(voice, leftGain, rightGain);
+		if (!voice.hasGains)
+		{
+			voice.leftGain = leftGain;
+			voice.rightGain = rightGain;
+			voice.hasGains = true;
+		}
+
+		const Sound &sound = voice.sound;
+		const f64 step = static_cast<f64>(voice.pitch) * sound.sampleRate / m_config.sampleRate;
+		if (voice.stream != nullptr)
+			return mixStream(voice, frameCount, step, leftGain, rightGain);
+		const f64 length = sound.frameCount;
+		const u32 last = sound.frameCount - 1;
+
+		// Silent voices keep their place in the sound without being mixed.
+		if (leftGain == 0.0f && rightGain == 0.0f && voice.leftGain == 0.0f && voice.rightGain == 0.0f)
+		{
+			voice.cursor += step * static_cast<f64>(frameCount);
+			if (voice.cursor < length)
+				return true;
+			voice.cursor = std::fmod(voice.cursor, length);
+			return voice.loops;
+		}
+
+		Run run;
+		run.leftStep = (leftGain - voice.leftGain) / static_cast<f32>(frameCount);
+		run.rightStep = (rightGain - voice.rightGain) / static_cast<f32>(frameCount);
+		run.step = static_cast<f32>(step);
+
+		bool isPlaying = true;
+		usize done = 0;
+		while (done < frameCount && isPlaying)
+		{
+			const f32 leftStart = voice.leftGain + static_cast<f32>(done) * run.leftStep;
+			const f32 rightStart = voice.rightGain + static_cast<f32>(done) * run.rightStep;
+
+			// Frames whose two samples are both inside the sound run through the kernels. The margin covers
+			// the rounding of their f32 offsets.
+			const f64 room = static_cast<f64>(last) - voice.cursor - 0.01;
+			const usize runCount = room > 0.0 ? std::min(frameCount - done, static_cast<usize>(room / step) + 1) : 0;
+			if (runCount > 0)
+			{
+				const f64 base = std::floor(voice.cursor);
+				run.samples = sound.samples + static_cast<usize>(base) * sound.channelCount;
+				run.frac = static_cast<f32>(voice.cursor - base);
+				run.count = runCount;
+				run.leftGain = leftStart;
+				run.rightGain = rightStart;
+				if (sound.channelCount == 1)
+					mixMono(run, m_left.data() + done, m_right.data() + done);
+				else
+					mixStereo(run, m_left.data() + done, m_right.data() + done);
+
+				voice.cursor += step * static_cast<f64>(runCount);
+				done += runCount;
+				continue;
+			}
+
+			// A frame across the end, blending into the start when the voice loops and into silence when it does not.
+			const u32 index = static_cast<u32>(voice.cursor);
+			const f32 t = static_cast<f32>(voice.cursor - index);
+			const u32 channel = sound.channelCount - 1;
+			const f32 *a = sound.samples + index * sound.channelCount;
+			const f32 *b = sound.samples + (index < last ? index + 1 : 0) * sound.channelCount;
+			const f32 weight = index < last || voice.loops ? t : 0.0f;
+			const f32 fade = index < last || voice.loops ? 1.0f : 1.0f - t;
+			m_left[done] += (a[0] * fade + (b[0] - a[0]) * weight) * leftStart;
+			m_right[done] += (a[channel] * fade + (b[channel] - a[channel]) * weight) * rightStart;
+
+			voice.cursor += step;
+			++done;
+			if (voice.cursor >= length)
+			{
+				voice.cursor = std::fmod(voice.cursor, length);
+				isPlaying = voice.loops;
+			}
+		}
+
+		voice.leftGain = leftGain;
+		voice.rightGain = rightGain;
+		return isPlaying;
+	}
+
+	bool Mixer::mixStream(Voice &voice, usize frameCount, f64 step, f32 leftGain, f32 rightGain)
+	{
+		// The frames the block spans, plus the one after for the last interpolation, copied into one run so the
+		// kernels never see the ring wrap. Frames the stream has not decoded, or that lie past its end, are silent.
+		// Bounded both ways so needed stays within m_streamFrames and the cursor keeps moving, even for a NaN step.
+		step = step > k_minPitch ? std::min(step, k_maxStreamStep) : k_minPitch;
+		const f64 base = std::floor(voice.cursor);
+		const f32 frac = static_cast<f32>(voice.cursor - base);
+		const u32 needed = static_cast<u32>(frac + static_cast<f64>(frameCount - 1) * step) + 2;
+		const u32 channelCount = voice.sound.channelCount;
+		const u32 decoded = voice.stream->read(static_cast<u64>(base), m_streamFrames.data(), needed);
+		std::fill(m_streamFrames.begin() + usize(decoded) * channelCount, m_streamFrames.begin() + usize(needed) * channelCount, 0.0f);
+
+		if (leftGain != 0.0f || rightGain != 0.0f || voice.leftGain != 0.0f || voice.rightGain != 0.0f)
+		{
+			Run run;
+			run.samples = m_streamFrames.data();
+			run.frac = frac;
+			run.step = static_cast<f32>(step);
+			run.count = frameCount;
+			run.leftGain = voice.leftGain;
+			run.leftStep = (leftGain - voice.leftGain) / static_cast<f32>(frameCount);
+			run.rightGain = voice.rightGain;
+			run.rightStep = (rightGain - voice.rightGain) / static_cast<f32>(frameCount);
+			if (channelCount == 1)
+				mixMono(run, m_left.data(), m_right.data());
+			else
+				mixStereo(run, m_left.data(), m_right.data());
+		}
+
+		voice.cursor += step * static_cast<f64>(frameCount);
+		voice.stream->release(static_cast<u64>(voice.cursor));
+		voice.leftGain = leftGain;
+		voice.rightGain = rightGain;
+		return voice.loops || voice.cursor < static_cast<f64>(voice.sound.frameCount);
+	}
+
+	void Mixer::release(Voice &voice)
+	{
+		if (voice.stream == nullptr)
+			return;
+
+		voice.stream->m_isAttached.store(false, std::memory_order_release);
+		voice.stream = nullptr;
+	}
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Audio/Sound.hpp"
+#include "Core/Containers/MpmcQueue.hpp"
+#include "Core/Containers/SlotMap.hpp"
+#include "Core/Math/Vec2.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::audio
+{
+	class AudioStream;
+
+	// Stops resolving once the voice ended or was stopped, even after its slot plays something else.
+	using VoiceHandle = SlotHandle;
+
+	struct MixerConfig
+	{
+		u32 sampleRate = 48000;
+		u32 maxVoices = 256;
+		// Commands the game can queue between two renders. A power of two.
+		u32 commandCapacity = 1024;
+		// Positional voices play at full volume up to this distance from the listener, then fall off with
+		// the inverse of the distance, down to silence at maxDistance.
+		f32 referenceDistance = 8.0f;
+		f32 maxDistance = 512.0f;
+	};
+
+	struct VoiceParams
+	{
+		f32 gain = 1.0f;
+		// Playback rate, on top of the conversion from the sound's rate to the mixer's.
+		// Clamped to [Mixer::k_minPitch, Mixer::k_maxPitch]; zero, negative and NaN pitches play at the minimum.
+		f32 pitch = 1.0f;
+		// Positional voices are panned and attenuated by where they are relative to the listener;
+		// the others, such as music, play centred at their gain.
+		bool isPositional = true;
+		math::Vec2f position = math::Vec2f::zero();
+		bool loops = false;
+	};
+
+	// Mixes voices into stereo float samples. The game thread starts and steers voices through a lock free command
+	// queue, which never blocks it: commands that find the queue full are dropped and counted. The audio thread
+	// renders blocks on its own schedule, applying the commands queued since the last one.
+	// Voices are resampled with linear interpolation and mixed four frames at a time. Gains ramp over each block
+	// instead of jumping, so moving voices do not click.
+	class Mixer
+	{
+	public:
+		explicit Mixer(const MixerConfig &config = {});
+
+		Mixer(const Mixer &) = delete;
+		Mixer &operator=(const Mixer &) = delete;
+
+		// Game thread.
+
+		// An invalid handle when every voice is busy or the command queue is full.
+		VoiceHandle play(const Sound &sound, const VoiceParams &params = {});
+		// Plays a stream as it decodes; whether it loops is up to the stream. A stream plays on one voice at a time,
+		// and reads at most k_maxStreamStep of its frames per frame mixed, whatever the pitch asks for.
+		VoiceHandle playStream(AudioStream &stream, const VoiceParams &params = {});
+		// False when the command queue is full: the voice keeps playing and its handle keeps resolving, so the stop
+		// can be tried again. True once the voice is stopped, or when the handle no longer resolves.
+		bool stop(VoiceHandle voice);
+		void setGain(VoiceHandle voice, f32 gain);
+		void setPitch(VoiceHandle voice, f32 pitch);
+		void setPosition(VoiceHandle voice, math::Vec2f position);
+		void setListener(math::Vec2f position);
+
+		// Frees the voices the audio thread finished, so their handles stop resolving and their slots play again.
+		void update();
+		// As of the last update().
+		bool isPlaying(VoiceHandle voice) const;
+		u32 playingCount() const { return m_playingCount; }
+		u32 droppedCommandCount() const { return m_droppedCommandCount; }
+
+		// Audio thread.
+
+		// Interleaved stereo, overwriting the output.
+		void render(f32 *output, usize frameCount);
+		// Voices the last render mixed.
+		u32 mixedVoiceCount() const { return m_mixedVoiceCount; }
+
+		u32 sampleRate() const { return m_config.sampleRate; }
+
+		// Frames mixed at once. Longer renders are split.
+		static constexpr usize k_blockFrames = 512;
+		static constexpr f64 k_maxStreamStep = 4.0;
+		// Voices always move forward through their sound.
+		static constexpr f32 k_minPitch = 1.0f / 64.0f;
+		static constexpr f32 k_maxPitch = 64.0f;
+
+	private:
+		struct Command
+		{
+			enum class Type : u8
+			{
+				Play,
+				Stop,
+				SetGain,
+				SetPitch,
+				SetPosition,
+				SetListener,
+			};
+
+			Type type;
+			bool isPositional;
+			bool loops;
+			u32 slot;
+			u32 generation;
+			f32 value;
+			f32 pitch;
+			math::Vec2f position;
+			Sound sound;
+			AudioStream *stream;
+		};
+
+		struct Voice
+		{
+			Sound sound;
+			AudioStream *stream = nullptr;
+			u32 generation = 0;
+			bool isActive = false;
+			bool isPositional = false;
+			bool loops = false;
+			f32 gain = 0.0f;
+			f32 pitch = 1.0f;
+			math::Vec2f position = math::Vec2f::zero();
+			// In frames of the sound.
+			f64 cursor = 0.0;
+			// Gains reached by the end of the last block, where the next block's ramp starts.
+			f32 leftGain = 0.0f;
+			f32 rightGain = 0.0f;
+			bool hasGains = false;
+		};
+
+		// Game thread view of a voice slot.
+		struct Slot
+		{
+			u32 generation = 1;
+			bool isPlaying = false;
+		};
+
+		VoiceHandle start(const Command &command);
+		bool push(const Command &command);
+		bool send(Command::Type type, VoiceHandle voice, f32 value, math::Vec2f position);
+
+		void apply(const Command &command);
+		void targetGains(const Voice &voice, f32 &left, f32 &right) const;
+		// Adds the voice to the block. Returns false once a voice that does not loop has played to its end.
+		bool mixVoice(Voice &voice, usize frameCount);
+		bool mixStream(Voice &voice, usize frameCount, f64 step, f32 leftGain, f32 rightGain);
+		void release(Voice &voice);
+
+		MixerConfig m_config;
+		MpmcQueue<Command> m_commands;
+
+		std::vector<Slot, memory::TaggedAllocator<Slot, memory::Tag::Audio>> m_slots;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Audio>> m_freeSlots;
+		u32 m_playingCount = 0;
+		u32 m_droppedCommandCount = 0;
+
+		// Generation of the play each slot last finished on its own, written by the audio thread.
+		std::vector<std::atomic<u32>, memory::TaggedAllocator<std::atomic<u32>, memory::Tag::Audio>> m_finished;
+
+		std::vector<Voice, memory::TaggedAllocator<Voice, memory::Tag::Audio>> m_voices;
+		std::vector<f32, memory::TaggedAllocator<f32, memory::Tag::Audio>> m_left;
+		std::vector<f32, memory::TaggedAllocator<f32, memory::Tag::Audio>> m_right;
+		// Stream frames a block reads, copied out of the ring in one piece.
+		std::vector<f32, memory::TaggedAllocator<f32, memory::Tag::Audio>> m_streamFrames;
+		math::Vec2f m_listener = math::Vec2f::zero();
+		u32 m_mixedVoiceCount = 0;
+	};
+}
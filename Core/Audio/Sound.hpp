@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+namespace core::audio
+{
+	// Decoded samples, interleaved when there are two channels. The mixer reads them in place, so they must stay
+	// valid while any voice plays them.
+	struct Sound
+	{
+		const f32 *samples = nullptr;
+		u32 frameCount = 0;
+		// One or two.
+		u32 channelCount = 1;
+		u32 sampleRate = 48000;
+	};
+}
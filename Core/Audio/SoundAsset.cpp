@@ -0,0 +1,32 @@
+#include "Core/Audio/SoundAsset.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace core::audio
+{
+	SoundBytes buildSoundAsset(const f32 *samples, u32 frameCount, u32 channelCount, u32 sampleRate)
+	{
+		const usize sampleCount = usize(frameCount) * channelCount;
+		SoundBytes bytes(sizeof(SoundHeader) + sampleCount * sizeof(i16));
+
+		const SoundHeader header = { SoundHeader::k_magic, sampleRate, frameCount, static_cast<u16>(channelCount), 0 };
+		std::memcpy(bytes.data(), &header, sizeof(header));
+
+		for (usize i = 0; i < sampleCount; ++i)
+		{
+			const i16 sample = static_cast<i16>(std::lround(std::clamp(samples[i], -1.0f, 1.0f) * 32767.0f));
+			std::memcpy(bytes.data() + sizeof(SoundHeader) + i * sizeof(i16), &sample, sizeof(sample));
+		}
+		return bytes;
+	}
+
+	void decodePcm16(const i16 *source, f32 *destination, usize sampleCount)
+	{
+		// A plain loop: compilers turn it into widening conversions several samples at a time.
+		constexpr f32 k_scale = 1.0f / 32767.0f;
+		for (usize i = 0; i < sampleCount; ++i)
+			destination[i] = static_cast<f32>(source[i]) * k_scale;
+	}
+}
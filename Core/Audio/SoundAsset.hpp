@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::audio
+{
+	// Sound asset layout: SoundHeader, then the frames as interleaved 16 bit PCM.
+	// Stored uncompressed, so any frame can be decoded straight from the mapped pack without reading what comes before.
+	struct SoundHeader
+	{
+		static constexpr u32 k_magic = 0x53474e41;	// "ANGS"
+
+		u32 magic;
+		u32 sampleRate;
+		u32 frameCount;
+		u16 channelCount;
+		u16 reserved;
+	};
+
+	using SoundBytes = std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Audio>>;
+
+	// Encodes interleaved float frames, clamped to [-1, 1]. For tools and tests.
+	SoundBytes buildSoundAsset(const f32 *samples, u32 frameCount, u32 channelCount, u32 sampleRate);
+
+	// Converts 16 bit PCM samples back to floats, the inverse of the encoding above.
+	void decodePcm16(const i16 *source, f32 *destination, usize sampleCount);
+}
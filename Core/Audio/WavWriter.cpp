@@ -0,0 +1,86 @@
+#include "Core/Audio/WavWriter.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace core::audio
+{
+	namespace
+	{
+		// The canonical 44 byte header: a RIFF chunk holding a fmt chunk and a data chunk. Little endian, like every
+		// platform the engine runs on.
+		struct WavHeader
+		{
+			char riff[4];
+			u32 riffSize;
+			char wave[4];
+			char fmt[4];
+			u32 fmtSize;
+			u16 format;
+			u16 channelCount;
+			u32 sampleRate;
+			u32 byteRate;
+			u16 blockAlign;
+			u16 bitsPerSample;
+			char data[4];
+			u32 dataSize;
+		};
+		static_assert(sizeof(WavHeader) == 44, "WAV headers are 44 bytes.");
+
+		constexpr u16 k_formatPcm = 1;
+	}
+
+	bool WavWriter::open(const char *path, u32 channelCount, u32 sampleRate)
+	{
+		close();
+
+		m_out.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_out)
+			return false;
+
+		m_channelCount = channelCount;
+		m_sampleRate = sampleRate;
+		m_frameCount = 0;
+		writeHeader();
+		return static_cast<bool>(m_out);
+	}
+
+	bool WavWriter::close()
+	{
+		if (!m_out.is_open())
+			return true;
+
+		m_out.seekp(0);
+		writeHeader();
+		const bool isWritten = static_cast<bool>(m_out);
+		m_out.close();
+		return isWritten;
+	}
+
+	void WavWriter::write(const f32 *samples, usize frameCount)
+	{
+		assert(m_out.is_open());
+
+		const usize count = frameCount * m_channelCount;
+		m_converted.resize(count);
+		for (usize i = 0; i < count; ++i)
+			m_converted[i] = static_cast<i16>(std::lround(std::clamp(samples[i], -1.0f, 1.0f) * 32767.0f));
+
+		m_out.write(reinterpret_cast<const char *>(m_converted.data()), static_cast<std::streamsize>(count * sizeof(i16)));
+		m_frameCount += frameCount;
+	}
+
+	void WavWriter::writeHeader()
+	{
+		const u32 blockAlign = m_channelCount * sizeof(i16);
+		const u32 dataSize = static_cast<u32>(std::min<u64>(m_frameCount * blockAlign, ~0u - sizeof(WavHeader)));
+		const WavHeader header = {
+			{ 'R', 'I', 'F', 'F' }, static_cast<u32>(sizeof(WavHeader) - 8 + dataSize), { 'W', 'A', 'V', 'E' },
+			{ 'f', 'm', 't', ' ' }, 16, k_formatPcm, static_cast<u16>(m_channelCount), m_sampleRate,
+			m_sampleRate * blockAlign, static_cast<u16>(blockAlign), 16,
+			{ 'd', 'a', 't', 'a' }, dataSize,
+		};
+		m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	}
+}
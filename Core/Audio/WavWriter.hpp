@@ -0,0 +1,41 @@
+#pragma once
+
+#include <fstream>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::audio
+{
+	// Writes float samples to a 16 bit PCM WAV file, a sink for audio rendered without a device, as tests and
+	// headless runs do. Samples are clamped to [-1, 1]. The sizes in the header are filled in by close().
+	class WavWriter
+	{
+	public:
+		WavWriter() = default;
+		~WavWriter() { close(); }
+
+		WavWriter(const WavWriter &) = delete;
+		WavWriter &operator=(const WavWriter &) = delete;
+
+		bool open(const char *path, u32 channelCount, u32 sampleRate);
+		// Returns false when any write failed.
+		bool close();
+		bool isOpen() const { return m_out.is_open(); }
+
+		// Interleaved frames of the channel count given to open().
+		void write(const f32 *samples, usize frameCount);
+
+		u64 frameCount() const { return m_frameCount; }
+
+	private:
+		void writeHeader();
+
+		std::ofstream m_out;
+		std::vector<i16, memory::TaggedAllocator<i16, memory::Tag::Audio>> m_converted;
+		u32 m_channelCount = 0;
+		u32 m_sampleRate = 0;
+		u64 m_frameCount = 0;
+	};
+}
@@ -0,0 +1,210 @@
+#include "Core/Compression/Lz4.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace core::lz4
+{
+	namespace
+	{
+		constexpr usize k_minMatch = 4;
+		// The format requires the last 5 bytes to be literals and the last match to start 12 bytes before the end.
+		constexpr usize k_lastLiterals = 5;
+		constexpr usize k_matchFindLimit = 12;
+		constexpr usize k_maxOffset = 65535;
+		constexpr u32 k_hashLog = 12;
+		constexpr u32 k_noPosition = ~0u;
+		// Skips ahead faster the longer nothing matches, like the reference implementation.
+		constexpr u32 k_skipTrigger = 6;
+
+		u32 read32(const u8 *pointer)
+		{
+			u32 value;
+			std::memcpy(&value, pointer, sizeof(value));
+			return value;
+		}
+
+		u32 hash(u32 sequence)
+		{
+			return (sequence * 2654435761u) >> (32 - k_hashLog);
+		}
+
+		// Writes the 255 run extension of a length whose nibble overflowed.
+		u8 *writeLength(u8 *out, usize length)
+		{
+			for (; length >= 255; length -= 255)
+				*out++ = 255;
+			*out++ = static_cast<u8>(length);
+			return out;
+		}
+
+		usize sequenceBound(usize literals, usize matchLength)
+		{
+			return 1 + literals / 255 + 1 + literals + 2 + matchLength / 255 + 1;
+		}
+	}
+
+	usize compress(const void *source, usize sourceSize, void *destination, usize capacity)
+	{
+		const u8 *in = static_cast<const u8 *>(source);
+		u8 *out = static_cast<u8 *>(destination);
+		u8 *const outEnd = out + capacity;
+
+		usize anchor = 0;
+		if (sourceSize > k_matchFindLimit)
+		{
+			u32 table[1u << k_hashLog];
+			for (u32 &position : table)
+				position = k_noPosition;
+
+			const usize matchLimit = sourceSize - k_lastLiterals;
+			const usize findLimit = sourceSize - k_matchFindLimit;
+			usize position = 0;
+			u32 misses = 1u << k_skipTrigger;
+
+			while (position < findLimit)
+			{
+				const u32 sequence = read32(in + position);
+				const u32 slot = hash(sequence);
+				const u32 candidate = table[slot];
+				table[slot] = static_cast<u32>(position);
+
+				if (candidate == k_noPosition || position - candidate > k_maxOffset || read32(in + candidate) != sequence)
+				{
+					position += misses++ >> k_skipTrigger;
+					continue;
+				}
+
+				usize match = candidate;
+				while (position > anchor && match > 0 && in[position - 1] == in[match - 1])
+				{
+					--position;
+					--match;
+				}
+
+				usize length = k_minMatch;
+				while (position + length < matchLimit && in[position + length] == in[match + length])
+					++length;
+
+				const usize literals = position - anchor;
+				if (static_cast<usize>(outEnd - out) < sequenceBound(literals, length))
+					return 0;
+
+				u8 *token = out++;
+				*token = static_cast<u8>((literals >= 15 ? 15 : literals) << 4);
+				if (literals >= 15)
+					out = writeLength(out, literals - 15);
+				std::memcpy(out, in + anchor, literals);
+				out += literals;
+
+				const usize offset = position - match;
+				*out++ = static_cast<u8>(offset);
+				*out++ = static_cast<u8>(offset >> 8);
+
+				const usize extra = length - k_minMatch;
+				*token |= static_cast<u8>(extra >= 15 ? 15 : extra);
+				if (extra >= 15)
+					out = writeLength(out, extra - 15);
+
+				position += length;
+				anchor = position;
+				misses = 1u << k_skipTrigger;
+
+				// Seeding the table inside the match finds more of the repeats that follow it.
+				if (position - 2 < findLimit)
+					table[hash(read32(in + position - 2))] = static_cast<u32>(position - 2);
+			}
+		}
+
+		const usize literals = sourceSize - anchor;
+		if (static_cast<usize>(outEnd - out) < 1 + literals / 255 + 1 + literals)
+			return 0;
+
+		*out++ = static_cast<u8>((literals >= 15 ? 15 : literals) << 4);
+		if (literals >= 15)
+			out = writeLength(out, literals - 15);
+		// Empty input may come with null pointers, which memcpy does not accept even for zero bytes.
+		if (literals > 0)
+			std::memcpy(out, in + anchor, literals);
+		out += literals;
+
+		return static_cast<usize>(out - static_cast<u8 *>(destination));
+	}
+
+	bool decompress(const void *source, usize sourceSize, void *destination, usize destinationSize)
+	{
+		const u8 *in = static_cast<const u8 *>(source);
+		const u8 *const inEnd = in + sourceSize;
+		u8 *const outStart = static_cast<u8 *>(destination);
+		u8 *out = outStart;
+		u8 *const outEnd = out + destinationSize;
+
+		const auto readLength = [&in, inEnd](usize &length)
+		{
+			u8 byte;
+			do
+			{
+				if (in == inEnd)
+					return false;
+				byte = *in++;
+				length += byte;
+			} while (byte == 255);
+			return true;
+		};
+
+		for (;;)
+		{
+			if (in == inEnd)
+				return false;
+			const u8 token = *in++;
+
+			usize literals = token >> 4;
+			if (literals == 15 && !readLength(literals))
+				return false;
+			if (literals > static_cast<usize>(inEnd - in) || literals > static_cast<usize>(outEnd - out))
+				return false;
+
+			if (literals > 0)
+				std::memcpy(out, in, literals);
+			in += literals;
+			out += literals;
+
+			// Only the last sequence has no match.
+			if (in == inEnd)
+				return out == outEnd;
+
+			if (inEnd - in < 2)
+				return false;
+			const usize offset = in[0] | (usize(in[1]) << 8);
+			in += 2;
+			if (offset == 0 || offset > static_cast<usize>(out - outStart))
+				return false;
+
+			usize length = token & 15;
+			if (length == 15 && !readLength(length))
+				return false;
+			length += k_minMatch;
+			if (length > static_cast<usize>(outEnd - out))
+				return false;
+
+			const u8 *match = out - offset;
+			if (offset >= length)
+			{
+				std::memcpy(out, match, length);
+				out += length;
+			}
+			else
+			{
+				// An overlapping match repeats its first offset bytes. Copying from the match's start in chunks as long
+				// as everything written so far doubles the repeated run each time, and never reads unwritten bytes.
+				u8 *const end = out + length;
+				while (out < end)
+				{
+					const usize chunk = std::min(static_cast<usize>(out - match), static_cast<usize>(end - out));
+					std::memcpy(out, match, chunk);
+					out += chunk;
+				}
+			}
+		}
+	}
+}
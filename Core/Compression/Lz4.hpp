@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+// Compressor and decompressor for the LZ4 block format, so Core reads data written by standard LZ4 tools
+// and the other way around, without taking on the library as a dependency.
+// The compressor is the simple greedy one: good ratio for the speed, well below lz4 -9.
+namespace core::lz4
+{
+	// Largest compressed size for an input of this many bytes.
+	constexpr usize compressBound(usize size)
+	{
+		return size + size / 255 + 16;
+	}
+
+	// Returns the compressed size, or 0 when the output does not fit in capacity.
+	usize compress(const void *source, usize sourceSize, void *destination, usize capacity);
+
+	// Decompresses a whole block, which must expand to exactly destinationSize bytes.
+	// Returns false for malformed input without reading or writing out of bounds.
+	bool decompress(const void *source, usize sourceSize, void *destination, usize destinationSize);
+}
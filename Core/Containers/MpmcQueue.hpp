@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <new>
+#include <utility>
+
+#include "Core/Types.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core
+{
+	// Bounded lock free queue for any number of producers and consumers (Dmitry Vyukov's design).
+	// Every cell carries a sequence number, so producers and consumers only contend on their own index.
+	template<typename T>
+	class MpmcQueue
+	{
+	public:
+		// Capacity must be a power of two.
+		explicit MpmcQueue(usize capacity, memory::Tag tag = memory::Tag::Containers)
+			: m_mask(capacity - 1)
+			, m_tag(tag)
+		{
+			assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+			m_cells = static_cast<Cell *>(memory::allocate(sizeof(Cell) * capacity, m_tag, alignof(Cell)));
+			for (usize i = 0; i < capacity; ++i)
+				new (&m_cells[i]) Cell(i);
+		}
+
+		~MpmcQueue()
+		{
+			T discarded;
+			while (tryPop(discarded)) {}
+
+			for (usize i = 0; i <= m_mask; ++i)
+				m_cells[i].~Cell();
+			memory::deallocate(m_cells, sizeof(Cell) * (m_mask + 1), m_tag, alignof(Cell));
+		}
+
+		MpmcQueue(const MpmcQueue &) = delete;
+		MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+		// Returns false when the queue is full.
+		bool tryPush(T value)
+		{
+			usize position = m_enqueuePosition.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				Cell &cell = m_cells[position & m_mask];
+				const usize sequence = cell.sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+				if (difference == 0)
+				{
+					if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						cell.value = std::move(value);
+						cell.sequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0)
+				{
+					return false;
+				}
+				else
+				{
+					position = m_enqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// Returns false when the queue is empty.
+		bool tryPop(T &value)
+		{
+			usize position = m_dequeuePosition.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				Cell &cell = m_cells[position & m_mask];
+				const usize sequence = cell.sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+				if (difference == 0)
+				{
+					if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						value = std::move(cell.value);
+						cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0)
+				{
+					return false;
+				}
+				else
+				{
+					position = m_dequeuePosition.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		usize capacity() const { return m_mask + 1; }
+
+	private:
+		struct Cell
+		{
+			explicit Cell(usize initialSequence) : sequence(initialSequence) {}
+
+			std::atomic<usize> sequence;
+			T value{};
+		};
+
+		Cell *m_cells = nullptr;
+		usize m_mask;
+		memory::Tag m_tag;
+		alignas(64) std::atomic<usize> m_enqueuePosition{ 0 };
+		alignas(64) std::atomic<usize> m_dequeuePosition{ 0 };
+	};
+}
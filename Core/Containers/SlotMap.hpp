@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cassert>
+#include <new>
+#include <utility>
+
+#include "Core/Types.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core
+{
+	// Reference to a SlotMap element. The generation tells a live element from one that was removed
+	// and whose slot was reused, so stale handles fail to resolve instead of reaching the wrong element.
+	struct SlotHandle
+	{
+		static constexpr u32 k_invalid = ~0u;
+
+		u32 index = k_invalid;
+		u32 generation = 0;
+
+		bool isValid() const { return index != k_invalid; }
+
+		bool operator==(const SlotHandle &other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const SlotHandle &other) const { return !(*this == other); }
+	};
+
+	// Elements addressed by handles, stored packed so iterating touches no gaps.
+	// Insertion, removal and lookup are O(1); removal moves the last element into the hole,
+	// so pointers into the map are only valid until the next insertion or removal. Hold handles instead.
+	template<typename T>
+	class SlotMap
+	{
+	public:
+		explicit SlotMap(memory::Tag tag = memory::Tag::Containers)
+			: m_tag(tag)
+		{}
+
+		~SlotMap()
+		{
+			clear();
+			release();
+		}
+
+		SlotMap(const SlotMap &) = delete;
+		SlotMap &operator=(const SlotMap &) = delete;
+
+		// The arguments must not refer to elements of this map, which may move when it grows.
+		template<typename... Args>
+		SlotHandle emplace(Args &&...args)
+		{
+			if (m_size == m_capacity)
+				reserve(m_capacity == 0 ? 16 : m_capacity * 2);
+
+			u32 index;
+			if (m_freeHead != k_end)
+			{
+				index = m_freeHead;
+				m_freeHead = m_slots[index].position;
+			}
+			else
+			{
+				if (m_slotCount == m_slotCapacity)
+					growSlots();
+				index = m_slotCount++;
+				m_slots[index].generation = 1;
+			}
+
+			new (&m_values[m_size]) T(std::forward<Args>(args)...);
+			m_owners[m_size] = index;
+			m_slots[index].position = m_size;
+			++m_size;
+			return { index, m_slots[index].generation };
+		}
+
+		SlotHandle insert(const T &value) { return emplace(value); }
+		SlotHandle insert(T &&value) { return emplace(std::move(value)); }
+
+		// Returns false when the handle is stale.
+		bool erase(SlotHandle handle)
+		{
+			if (!contains(handle))
+				return false;
+
+			const u32 position = m_slots[handle.index].position;
+			const u32 last = m_size - 1;
+			if (position != last)
+			{
+				m_values[position] = std::move(m_values[last]);
+				m_owners[position] = m_owners[last];
+				m_slots[m_owners[position]].position = position;
+			}
+			m_values[last].~T();
+			--m_size;
+
+			// A slot whose generation would wrap is retired, so no old handle can ever match it again.
+			Slot &slot = m_slots[handle.index];
+			if (++slot.generation != 0)
+			{
+				slot.position = m_freeHead;
+				m_freeHead = handle.index;
+			}
+			return true;
+		}
+
+		bool contains(SlotHandle handle) const
+		{
+			return handle.index < m_slotCount && m_slots[handle.index].generation == handle.generation
+				&& m_slots[handle.index].position < m_size && m_owners[m_slots[handle.index].position] == handle.index;
+		}
+
+		// Nullptr when the handle is stale.
+		T *get(SlotHandle handle) { return contains(handle) ? &m_values[m_slots[handle.index].position] : nullptr; }
+		const T *get(SlotHandle handle) const { return contains(handle) ? &m_values[m_slots[handle.index].position] : nullptr; }
+
+		void clear()
+		{
+			while (m_size > 0)
+				erase(handleAt(m_size - 1));
+		}
+
+		void reserve(usize capacity)
+		{
+			if (capacity <= m_capacity)
+				return;
+
+			assert(capacity < k_end);
+			T *values = static_cast<T *>(memory::allocate(sizeof(T) * capacity, m_tag, alignof(T)));
+			u32 *owners = static_cast<u32 *>(memory::allocate(sizeof(u32) * capacity, m_tag, alignof(u32)));
+			for (u32 i = 0; i < m_size; ++i)
+			{
+				new (&values[i]) T(std::move(m_values[i]));
+				m_values[i].~T();
+				owners[i] = m_owners[i];
+			}
+
+			if (m_capacity > 0)
+			{
+				memory::deallocate(m_values, sizeof(T) * m_capacity, m_tag, alignof(T));
+				memory::deallocate(m_owners, sizeof(u32) * m_capacity, m_tag, alignof(u32));
+			}
+			m_values = values;
+			m_owners = owners;
+			m_capacity = static_cast<u32>(capacity);
+		}
+
+		usize size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+
+		// Packed elements, in no particular order.
+		T *begin() { return m_values; }
+		T *end() { return m_values + m_size; }
+		const T *begin() const { return m_values; }
+		const T *end() const { return m_values + m_size; }
+
+		T &operator[](usize position) { return m_values[position]; }
+		const T &operator[](usize position) const { return m_values[position]; }
+
+		// Handle of the element at a position of the packed array.
+		SlotHandle handleAt(usize position) const
+		{
+			const u32 index = m_owners[position];
+			return { index, m_slots[index].generation };
+		}
+
+	private:
+		static constexpr u32 k_end = ~0u;
+
+		// Live slots hold their element's position; free slots hold the next free slot.
+		struct Slot
+		{
+			u32 position;
+			u32 generation;
+		};
+
+		// Slots outnumber elements once slots retire, so they grow on their own.
+		void growSlots()
+		{
+			const u32 capacity = m_slotCapacity == 0 ? 16 : m_slotCapacity * 2;
+			assert(capacity > m_slotCapacity && "Out of slot indices.");
+			Slot *slots = static_cast<Slot *>(memory::allocate(sizeof(Slot) * capacity, m_tag, alignof(Slot)));
+			for (u32 i = 0; i < m_slotCount; ++i)
+				slots[i] = m_slots[i];
+
+			if (m_slotCapacity > 0)
+				memory::deallocate(m_slots, sizeof(Slot) * m_slotCapacity, m_tag, alignof(Slot));
+			m_slots = slots;
+			m_slotCapacity = capacity;
+		}
+
+		void release()
+		{
+			if (m_capacity > 0)
+			{
+				memory::deallocate(m_values, sizeof(T) * m_capacity, m_tag, alignof(T));
+				memory::deallocate(m_owners, sizeof(u32) * m_capacity, m_tag, alignof(u32));
+			}
+			if (m_slotCapacity > 0)
+				memory::deallocate(m_slots, sizeof(Slot) * m_slotCapacity, m_tag, alignof(Slot));
+		}
+
+		T *m_values = nullptr;
+		u32 *m_owners = nullptr;
+		Slot *m_slots = nullptr;
+		u32 m_size = 0;
+		u32 m_capacity = 0;
+		u32 m_slotCount = 0;
+		u32 m_slotCapacity = 0;
+		u32 m_freeHead = k_end;
+		memory::Tag m_tag;
+	};
+}
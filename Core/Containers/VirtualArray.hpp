@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cassert>
+#include <new>
+#include <utility>
+
+#include "Core/Types.hpp"
+#include "Core/Memory/Memory.hpp"
+#include "Core/Memory/VirtualMemory.hpp"
+
+namespace core
+{
+	// Growable array that reserves address space for its maximum size up front and commits pages as it grows.
+	// Elements never move, so pointers and references stay valid until the element is removed,
+	// and growing never copies or transiently doubles memory.
+	template<typename T>
+	class VirtualArray
+	{
+	public:
+		// Pages are committed at least this many bytes at a time, to keep system calls off the push path.
+		static constexpr usize k_minCommitBytes = 64 * 1024;
+
+		// Throws std::bad_alloc when maxSize elements do not fit in the address space or cannot be reserved.
+		// A maxSize of zero reserves nothing and makes an array that stays empty.
+		explicit VirtualArray(usize maxSize, memory::Tag tag = memory::Tag::Containers)
+			: m_reservedBytes(reservationFor(maxSize))
+			, m_maxSize(maxSize)
+			, m_tag(tag)
+		{
+			if (m_reservedBytes == 0)
+				return;
+
+			m_data = static_cast<T *>(memory::reserveAddressSpace(m_reservedBytes));
+			if (m_data == nullptr)
+				throw std::bad_alloc();
+		}
+
+		VirtualArray(const VirtualArray &) = delete;
+		VirtualArray &operator=(const VirtualArray &) = delete;
+
+		VirtualArray(VirtualArray &&other) noexcept
+			: m_data(std::exchange(other.m_data, nullptr))
+			, m_size(std::exchange(other.m_size, 0))
+			, m_committedBytes(std::exchange(other.m_committedBytes, 0))
+			, m_reservedBytes(std::exchange(other.m_reservedBytes, 0))
+			, m_maxSize(std::exchange(other.m_maxSize, 0))
+			, m_tag(other.m_tag)
+		{}
+
+		VirtualArray &operator=(VirtualArray &&other) noexcept
+		{
+			if (this != &other)
+			{
+				destroy();
+				m_data = std::exchange(other.m_data, nullptr);
+				m_size = std::exchange(other.m_size, 0);
+				m_committedBytes = std::exchange(other.m_committedBytes, 0);
+				m_reservedBytes = std::exchange(other.m_reservedBytes, 0);
+				m_maxSize = std::exchange(other.m_maxSize, 0);
+				m_tag = other.m_tag;
+			}
+
+			return *this;
+		}
+
+		~VirtualArray() { destroy(); }
+
+		template<typename... Args>
+		T &emplaceBack(Args &&...args)
+		{
+			reserve(m_size + 1);
+			T *element = new (m_data + m_size) T(std::forward<Args>(args)...);
+			++m_size;
+			return *element;
+		}
+
+		T &pushBack(const T &value) { return emplaceBack(value); }
+		T &pushBack(T &&value) { return emplaceBack(std::move(value)); }
+
+		void popBack()
+		{
+			assert(m_size > 0);
+			--m_size;
+			m_data[m_size].~T();
+		}
+
+		// New elements are value initialized.
+		void resize(usize size)
+		{
+			reserve(size);
+			for (; m_size < size; ++m_size)
+				new (m_data + m_size) T();
+			while (m_size > size)
+				popBack();
+		}
+
+		// Commits the pages backing count elements. Throws std::bad_alloc past the maximum size.
+		void reserve(usize count)
+		{
+			if (count > m_maxSize)
+				throw std::bad_alloc();
+
+			const usize requiredBytes = count * sizeof(T);
+			if (requiredBytes <= m_committedBytes)
+				return;
+
+			usize newCommittedBytes = memory::alignToPage(requiredBytes);
+			if (newCommittedBytes - m_committedBytes < k_minCommitBytes)
+				newCommittedBytes = memory::alignToPage(m_committedBytes + k_minCommitBytes);
+			if (newCommittedBytes > m_reservedBytes)
+				newCommittedBytes = m_reservedBytes;
+
+			u8 *commitStart = reinterpret_cast<u8 *>(m_data) + m_committedBytes;
+			if (!memory::commitPages(commitStart, newCommittedBytes - m_committedBytes))
+				throw std::bad_alloc();
+
+			memory::trackAllocation(newCommittedBytes - m_committedBytes, m_tag);
+			m_committedBytes = newCommittedBytes;
+		}
+
+		void clear()
+		{
+			while (m_size > 0)
+				popBack();
+		}
+
+		// Returns the pages past the last element to the system.
+		void shrinkToFit()
+		{
+			const usize usedBytes = memory::alignToPage(m_size * sizeof(T));
+			if (usedBytes >= m_committedBytes)
+				return;
+
+			memory::decommitPages(reinterpret_cast<u8 *>(m_data) + usedBytes, m_committedBytes - usedBytes);
+			memory::trackDeallocation(m_committedBytes - usedBytes, m_tag);
+			m_committedBytes = usedBytes;
+		}
+
+		T &operator[](usize index) { assert(index < m_size); return m_data[index]; }
+		const T &operator[](usize index) const { assert(index < m_size); return m_data[index]; }
+
+		T &back() { assert(m_size > 0); return m_data[m_size - 1]; }
+		const T &back() const { assert(m_size > 0); return m_data[m_size - 1]; }
+
+		T *data() { return m_data; }
+		const T *data() const { return m_data; }
+
+		T *begin() { return m_data; }
+		T *end() { return m_data + m_size; }
+		const T *begin() const { return m_data; }
+		const T *end() const { return m_data + m_size; }
+
+		usize size() const { return m_size; }
+		bool empty() const { return m_size == 0; }
+		usize capacity() const { return m_committedBytes / sizeof(T); }
+		usize maxSize() const { return m_maxSize; }
+		usize committedBytes() const { return m_committedBytes; }
+
+	private:
+		// Checked before multiplying, so a huge maxSize cannot wrap around into a small reservation.
+		static usize reservationFor(usize maxSize)
+		{
+			if (maxSize > (~usize(0) - memory::pageSize()) / sizeof(T))
+				throw std::bad_alloc();
+			return memory::alignToPage(maxSize * sizeof(T));
+		}
+
+		void destroy()
+		{
+			if (m_data == nullptr)
+				return;
+
+			clear();
+			memory::trackDeallocation(m_committedBytes, m_tag);
+			memory::releaseAddressSpace(m_data, m_reservedBytes);
+			m_data = nullptr;
+			m_committedBytes = 0;
+		}
+
+		T *m_data = nullptr;
+		usize m_size = 0;
+		usize m_committedBytes = 0;
+		usize m_reservedBytes = 0;
+		usize m_maxSize = 0;
+		memory::Tag m_tag;
+	};
+}
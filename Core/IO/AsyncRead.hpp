@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+
+#if CORE_HAS_COROUTINES
+
+#include <coroutine>
+
+#include "Core/Types.hpp"
+#include "Core/IO/File.hpp"
+#include "Core/IO/FileService.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Jobs/Task.hpp"
+
+namespace core::io
+{
+	// co_await readAsync(...) suspends the coroutine while an I/O thread reads, then resumes it as a job on a worker.
+	// Evaluates to the number of bytes read, or -1 on failure.
+	class ReadAwaiter
+	{
+	public:
+		ReadAwaiter(FileService &service, jobs::JobSystem &system, const File &file, u64 offset, void *buffer, usize size)
+			: m_service(service)
+			, m_system(system)
+		{
+			m_request.file = &file;
+			m_request.offset = offset;
+			m_request.buffer = buffer;
+			m_request.size = size;
+			m_request.onComplete = &ReadAwaiter::complete;
+			m_request.userData = this;
+			m_request.context = CompletionContext::IoThread;
+		}
+
+		bool await_ready() const noexcept { return false; }
+
+		void await_suspend(std::coroutine_handle<> handle)
+		{
+			m_handle = handle;
+			m_service.submit(m_request);
+		}
+
+		i64 await_resume() const noexcept { return m_bytesRead; }
+
+	private:
+		static void complete(const ReadRequest &request, i64 bytesRead)
+		{
+			ReadAwaiter *self = static_cast<ReadAwaiter *>(request.userData);
+			self->m_bytesRead = bytesRead;
+			self->m_system.run(jobs::Job{ &jobs::detail::resumeCoroutine, self->m_handle.address() });
+		}
+
+		FileService &m_service;
+		jobs::JobSystem &m_system;
+		ReadRequest m_request;
+		std::coroutine_handle<> m_handle;
+		i64 m_bytesRead = -1;
+	};
+
+	inline ReadAwaiter readAsync(FileService &service, jobs::JobSystem &system, const File &file, u64 offset, void *buffer, usize size)
+	{
+		return ReadAwaiter(service, system, file, offset, buffer, size);
+	}
+}
+
+#endif
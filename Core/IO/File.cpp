@@ -0,0 +1,153 @@
+#include "Core/IO/File.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#if CORE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace core::io
+{
+#if CORE_PLATFORM_WINDOWS
+	File::File(File &&other) noexcept
+		: m_handle(std::exchange(other.m_handle, nullptr))
+	{}
+
+	File &File::operator=(File &&other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			m_handle = std::exchange(other.m_handle, nullptr);
+		}
+
+		return *this;
+	}
+
+	bool File::open(const char *path)
+	{
+		close();
+		HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			return false;
+
+		m_handle = handle;
+		return true;
+	}
+
+	void File::close()
+	{
+		if (m_handle != nullptr)
+			CloseHandle(m_handle);
+		m_handle = nullptr;
+	}
+
+	bool File::isOpen() const
+	{
+		return m_handle != nullptr;
+	}
+
+	u64 File::size() const
+	{
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(m_handle, &size))
+			return 0;
+		return static_cast<u64>(size.QuadPart);
+	}
+
+	i64 File::read(u64 offset, void *buffer, usize size) const
+	{
+		u8 *destination = static_cast<u8 *>(buffer);
+		usize total = 0;
+		while (total < size)
+		{
+			// Passing the offset in an OVERLAPPED keeps reads independent of the handle's file pointer.
+			OVERLAPPED overlapped = {};
+			const u64 position = offset + total;
+			overlapped.Offset = static_cast<DWORD>(position);
+			overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+
+			const DWORD chunk = static_cast<DWORD>(std::min<usize>(size - total, 1u << 30));
+			DWORD bytesRead = 0;
+			if (!ReadFile(m_handle, destination + total, chunk, &bytesRead, &overlapped))
+				return GetLastError() == ERROR_HANDLE_EOF ? static_cast<i64>(total) : -1;
+			if (bytesRead == 0)
+				break;
+			total += bytesRead;
+		}
+
+		return static_cast<i64>(total);
+	}
+#else
+	File::File(File &&other) noexcept
+		: m_descriptor(std::exchange(other.m_descriptor, -1))
+	{}
+
+	File &File::operator=(File &&other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			m_descriptor = std::exchange(other.m_descriptor, -1);
+		}
+
+		return *this;
+	}
+
+	bool File::open(const char *path)
+	{
+		close();
+		m_descriptor = ::open(path, O_RDONLY | O_CLOEXEC);
+		return m_descriptor >= 0;
+	}
+
+	void File::close()
+	{
+		if (m_descriptor >= 0)
+			::close(m_descriptor);
+		m_descriptor = -1;
+	}
+
+	bool File::isOpen() const
+	{
+		return m_descriptor >= 0;
+	}
+
+	u64 File::size() const
+	{
+		struct stat info;
+		if (fstat(m_descriptor, &info) != 0)
+			return 0;
+		return static_cast<u64>(info.st_size);
+	}
+
+	i64 File::read(u64 offset, void *buffer, usize size) const
+	{
+		u8 *destination = static_cast<u8 *>(buffer);
+		usize total = 0;
+		while (total < size)
+		{
+			const ssize_t bytesRead = pread(m_descriptor, destination + total, size - total, static_cast<off_t>(offset + total));
+			if (bytesRead < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return -1;
+			}
+			if (bytesRead == 0)
+				break;
+			total += static_cast<usize>(bytesRead);
+		}
+
+		return static_cast<i64>(total);
+	}
+#endif
+}
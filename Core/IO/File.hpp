@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+#include "Core/Types.hpp"
+
+namespace core::io
+{
+	// Read only file accessed by offset, so any number of threads can read from one handle at once.
+	class File
+	{
+	public:
+		File() = default;
+		~File() { close(); }
+
+		File(File &&other) noexcept;
+		File &operator=(File &&other) noexcept;
+		File(const File &) = delete;
+		File &operator=(const File &) = delete;
+
+		// Returns false when the file cannot be opened for reading.
+		bool open(const char *path);
+		void close();
+		bool isOpen() const;
+
+		u64 size() const;
+
+		// Blocks until size bytes are read or the end of the file is reached.
+		// Returns the number of bytes read, or -1 on failure.
+		i64 read(u64 offset, void *buffer, usize size) const;
+
+#if CORE_PLATFORM_WINDOWS
+		void *nativeHandle() const { return m_handle; }
+#else
+		int nativeHandle() const { return m_descriptor; }
+#endif
+
+	private:
+#if CORE_PLATFORM_WINDOWS
+		void *m_handle = nullptr;
+#else
+		int m_descriptor = -1;
+#endif
+	};
+}
@@ -0,0 +1,166 @@
+#include "Core/IO/FileService.hpp"
+
+#include <cassert>
+
+#include "Core/IO/IoUring.hpp"
+
+namespace core::io
+{
+	FileService::FileService(const FileServiceConfig &config)
+		: m_requests(config.queueCapacity, memory::Tag::IO)
+		, m_completions(config.completionCapacity, memory::Tag::IO)
+	{
+		if (config.backend != FileBackend::ThreadPool)
+		{
+			m_uring = detail::createUring(*this, config.ringEntries);
+			if (m_uring != nullptr)
+				return;
+		}
+
+		assert(config.threadCount > 0);
+		m_threads.reserve(config.threadCount);
+		for (u32 i = 0; i < config.threadCount; ++i)
+			m_threads.emplace_back(&FileService::threadMain, this);
+	}
+
+	FileService::~FileService()
+	{
+		// Completions are drained while waiting, so a full completion queue cannot stall the I/O threads.
+		while (hasPendingWork())
+		{
+			if (drainCompletions() == 0)
+				std::this_thread::yield();
+		}
+
+		if (m_uring != nullptr)
+		{
+			detail::destroyUring(m_uring);
+			m_uring = nullptr;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_running.store(false, std::memory_order_release);
+		}
+		m_condition.notify_all();
+
+		for (std::thread &thread : m_threads)
+			thread.join();
+	}
+
+	void FileService::submit(const ReadRequest *requests, usize count)
+	{
+		if (count == 0)
+			return;
+
+		m_hasSubmitted.store(true, std::memory_order_relaxed);
+		m_outstanding.fetch_add(static_cast<i64>(count), std::memory_order_relaxed);
+		for (usize i = 0; i < count; ++i)
+		{
+			const ReadRequest &request = requests[i];
+			assert(request.file != nullptr && request.file->isOpen());
+			assert(request.onComplete != nullptr);
+			assert(request.registeredBuffer < static_cast<i32>(m_registeredBuffers.size()));
+
+			while (!m_requests.tryPush(request))
+				std::this_thread::yield();
+		}
+
+		if (m_uring != nullptr)
+		{
+			// One wake up for the whole batch; the ring thread then submits it with a single system call.
+			m_queued.fetch_add(static_cast<i32>(count), std::memory_order_release);
+			detail::wakeUring(*m_uring);
+			return;
+		}
+
+		// Counting under the lock pairs with the predicate check in threadMain, so no wake up is lost.
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_queued.fetch_add(static_cast<i32>(count), std::memory_order_relaxed);
+		}
+
+		if (count > 1)
+			m_condition.notify_all();
+		else
+			m_condition.notify_one();
+	}
+
+	bool FileService::registerBuffers(const RegisteredBuffer *buffers, u32 count)
+	{
+		assert(!m_hasSubmitted.load(std::memory_order_relaxed) && "Buffers must be registered before the first read.");
+		m_registeredBuffers.assign(buffers, buffers + count);
+
+		// The thread pool reads straight into the buffer either way, so only io_uring needs to know.
+		return m_uring == nullptr || detail::registerUringBuffers(*m_uring, buffers, count);
+	}
+
+	usize FileService::drainCompletions(usize maxCount)
+	{
+		usize count = 0;
+		Completion completion;
+		while (count < maxCount && m_completions.tryPop(completion))
+		{
+			completion.request.onComplete(completion.request, completion.bytesRead);
+			m_outstanding.fetch_sub(1, std::memory_order_release);
+			++count;
+		}
+
+		return count;
+	}
+
+	void FileService::threadMain()
+	{
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_condition.wait(lock, [this]()
+				{
+					return m_queued.load(std::memory_order_relaxed) > 0 || !m_running.load(std::memory_order_relaxed);
+				});
+
+				if (m_queued.load(std::memory_order_relaxed) == 0)
+					return;
+				m_queued.fetch_sub(1, std::memory_order_relaxed);
+			}
+
+			// A request counted here is fully pushed, but the slot at the head may still belong to a producer mid push.
+			ReadRequest request;
+			while (!m_requests.tryPop(request))
+				std::this_thread::yield();
+
+			const i64 bytesRead = request.file->read(request.offset, request.buffer, request.size);
+			complete(request, bytesRead);
+		}
+	}
+
+	bool FileService::popRequest(ReadRequest &request)
+	{
+		i32 queued = m_queued.load(std::memory_order_acquire);
+		while (queued > 0 && !m_queued.compare_exchange_weak(queued, queued - 1, std::memory_order_acquire))
+		{
+		}
+
+		if (queued <= 0)
+			return false;
+
+		while (!m_requests.tryPop(request))
+			std::this_thread::yield();
+		return true;
+	}
+
+	void FileService::complete(const ReadRequest &request, i64 bytesRead)
+	{
+		if (request.context == CompletionContext::IoThread)
+		{
+			request.onComplete(request, bytesRead);
+			m_outstanding.fetch_sub(1, std::memory_order_release);
+			return;
+		}
+
+		// A full queue means nobody is draining; hold the I/O thread rather than drop the result.
+		while (!m_completions.tryPush(Completion{ request, bytesRead }))
+			std::this_thread::yield();
+	}
+}
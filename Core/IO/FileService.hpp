@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Containers/MpmcQueue.hpp"
+#include "Core/IO/File.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::io
+{
+	namespace detail
+	{
+		struct UringBackend;
+	}
+
+	struct ReadRequest;
+
+	// bytesRead is -1 when the read failed.
+	using ReadCallback = void (*)(const ReadRequest &request, i64 bytesRead);
+
+	enum class CompletionContext : u8
+	{
+		// The callback runs from FileService::drainCompletions, typically once per frame on the main thread.
+		Drain,
+		// The callback runs on the I/O thread as soon as the read finishes. Keep it to handing the result off.
+		IoThread,
+	};
+
+	struct ReadRequest
+	{
+		const File *file = nullptr;
+		u64 offset = 0;
+		void *buffer = nullptr;
+		usize size = 0;
+		ReadCallback onComplete = nullptr;
+		void *userData = nullptr;
+		// Index passed to registerBuffers that contains buffer, or -1.
+		i32 registeredBuffer = -1;
+		CompletionContext context = CompletionContext::Drain;
+	};
+
+	struct RegisteredBuffer
+	{
+		void *data = nullptr;
+		usize size = 0;
+	};
+
+	enum class FileBackend : u8
+	{
+		// io_uring where the kernel provides it, the thread pool everywhere else.
+		Automatic,
+		ThreadPool,
+		IoUring,
+	};
+
+	struct FileServiceConfig
+	{
+		FileBackend backend = FileBackend::Automatic;
+		// Blocking reader threads, when running on the thread pool.
+		u32 threadCount = 2;
+		// Reads in flight in the kernel at once, when running on io_uring.
+		u32 ringEntries = 128;
+		// Both powers of two. A full completion queue stalls the I/O threads until the next drain,
+		// so size it for the reads one frame can finish.
+		usize queueCapacity = 1024;
+		usize completionCapacity = 1024;
+	};
+
+	// Performs file reads off the calling thread, so neither job workers nor the frame loop block on the disk.
+	// On Linux reads go through io_uring, which submits a whole batch per system call from a single thread;
+	// elsewhere, or when io_uring is unavailable, a pool of threads issues blocking reads.
+	class FileService
+	{
+	public:
+		explicit FileService(const FileServiceConfig &config = FileServiceConfig());
+		// Finishes every submitted read and delivers any completions still waiting to be drained.
+		~FileService();
+
+		FileService(const FileService &) = delete;
+		FileService &operator=(const FileService &) = delete;
+
+		// The file and buffer must stay valid until the callback runs.
+		void submit(const ReadRequest &request) { submit(&request, 1); }
+		void submit(const ReadRequest *requests, usize count);
+
+		// Pins buffers that are reused for many reads, so the kernel does not map them on every read.
+		// Call once, before the first submit.
+		bool registerBuffers(const RegisteredBuffer *buffers, u32 count);
+
+		// Runs the callbacks of finished Drain reads on the calling thread. Returns how many ran.
+		usize drainCompletions(usize maxCount = ~usize(0));
+
+		// True while a read is queued, in flight or waiting to be drained.
+		bool hasPendingWork() const { return m_outstanding.load(std::memory_order_acquire) > 0; }
+
+		FileBackend backend() const { return m_uring != nullptr ? FileBackend::IoUring : FileBackend::ThreadPool; }
+
+	private:
+		friend struct detail::UringBackend;
+
+		struct Completion
+		{
+			ReadRequest request;
+			i64 bytesRead = 0;
+		};
+
+		void threadMain();
+		bool popRequest(ReadRequest &request);
+		void complete(const ReadRequest &request, i64 bytesRead);
+
+		MpmcQueue<ReadRequest> m_requests;
+		MpmcQueue<Completion> m_completions;
+		detail::UringBackend *m_uring = nullptr;
+		std::vector<RegisteredBuffer, memory::TaggedAllocator<RegisteredBuffer, memory::Tag::IO>> m_registeredBuffers;
+
+		std::vector<std::thread, memory::TaggedAllocator<std::thread, memory::Tag::IO>> m_threads;
+		std::atomic<bool> m_running{ true };
+		std::atomic<bool> m_hasSubmitted{ false };
+		std::atomic<i32> m_queued{ 0 };
+		std::atomic<i64> m_outstanding{ 0 };
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+	};
+}
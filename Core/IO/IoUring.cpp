@@ -0,0 +1,423 @@
+#include "Core/IO/IoUring.hpp"
+
+#include "Core/IO/FileService.hpp"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace core::io
+{
+	namespace
+	{
+		// Completions with this tag come from the doorbell eventfd, not from a read.
+		constexpr u64 k_doorbellTag = 0;
+		constexpr usize k_maxReadBytes = 1u << 30;
+
+		int uringSetup(u32 entries, io_uring_params *params)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+		}
+
+		int uringEnter(int ring, u32 toSubmit, u32 minComplete, u32 flags)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_enter, ring, toSubmit, minComplete, flags, nullptr, 0));
+		}
+
+		int uringRegister(int ring, u32 opcode, const void *arguments, u32 count)
+		{
+			return static_cast<int>(syscall(__NR_io_uring_register, ring, opcode, arguments, count));
+		}
+
+		u32 loadAcquire(const u32 *value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+		void storeRelease(u32 *value, u32 newValue) { __atomic_store_n(value, newValue, __ATOMIC_RELEASE); }
+	}
+
+	namespace detail
+	{
+		// The ring has a single owner thread, which fills the submission queue from FileService's request queue,
+		// hands the whole batch to the kernel in one io_uring_enter and reaps completions from the same call.
+		// A read on an eventfd is always in flight, so submitters can wake the thread while it waits on the kernel.
+		struct UringBackend
+		{
+			struct InflightRead
+			{
+				ReadRequest request;
+				usize bytesDone = 0;
+				iovec vector = {};
+			};
+
+			bool setup(u32 entries);
+			void teardown();
+			void threadMain();
+
+			void fillSubmissions();
+			io_uring_sqe &nextSqe();
+			void prepareRead(u32 slot);
+			void armDoorbell();
+			void reapCompletions();
+
+			FileService *service = nullptr;
+			// Started by the first wake up, so buffers can be registered while the ring is still idle.
+			std::thread thread;
+			std::once_flag threadStarted;
+			std::atomic<bool> running{ true };
+
+			int ring = -1;
+			int doorbell = -1;
+			u64 doorbellValue = 0;
+			iovec doorbellVector = {};
+			bool doorbellArmed = false;
+
+			void *sqRing = nullptr;
+			usize sqRingBytes = 0;
+			void *cqRing = nullptr;
+			usize cqRingBytes = 0;
+			io_uring_sqe *sqes = nullptr;
+			usize sqesBytes = 0;
+
+			u32 *sqHead = nullptr;
+			u32 *sqTail = nullptr;
+			u32 *sqArray = nullptr;
+			u32 sqMask = 0;
+			u32 sqEntries = 0;
+			u32 *cqHead = nullptr;
+			u32 *cqTail = nullptr;
+			io_uring_cqe *cqes = nullptr;
+			u32 cqMask = 0;
+
+			u32 unsubmitted = 0;
+
+			// Owned by the ring thread only. One slot per read the kernel holds at once.
+			InflightRead *slots = nullptr;
+			u32 *freeSlots = nullptr;
+			u32 freeSlotCount = 0;
+			u32 slotCount = 0;
+		};
+
+		bool UringBackend::setup(u32 entries)
+		{
+			io_uring_params params = {};
+			ring = uringSetup(entries, &params);
+			if (ring < 0)
+				return false;
+
+			sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(u32);
+			cqRingBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			const bool singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (singleMapping)
+				sqRingBytes = cqRingBytes = std::max(sqRingBytes, cqRingBytes);
+
+			sqRing = mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+			if (sqRing == MAP_FAILED)
+			{
+				sqRing = nullptr;
+				return false;
+			}
+
+			if (singleMapping)
+			{
+				cqRing = sqRing;
+			}
+			else
+			{
+				cqRing = mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+				if (cqRing == MAP_FAILED)
+				{
+					cqRing = nullptr;
+					return false;
+				}
+			}
+
+			sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+			void *sqeMemory = mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+			if (sqeMemory == MAP_FAILED)
+				return false;
+			sqes = static_cast<io_uring_sqe *>(sqeMemory);
+
+			u8 *sq = static_cast<u8 *>(sqRing);
+			sqHead = reinterpret_cast<u32 *>(sq + params.sq_off.head);
+			sqTail = reinterpret_cast<u32 *>(sq + params.sq_off.tail);
+			sqArray = reinterpret_cast<u32 *>(sq + params.sq_off.array);
+			sqMask = *reinterpret_cast<u32 *>(sq + params.sq_off.ring_mask);
+			sqEntries = params.sq_entries;
+
+			u8 *cq = static_cast<u8 *>(cqRing);
+			cqHead = reinterpret_cast<u32 *>(cq + params.cq_off.head);
+			cqTail = reinterpret_cast<u32 *>(cq + params.cq_off.tail);
+			cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+			cqMask = *reinterpret_cast<u32 *>(cq + params.cq_off.ring_mask);
+
+			doorbell = eventfd(0, EFD_CLOEXEC);
+			if (doorbell < 0)
+				return false;
+
+			// One submission entry stays free for the doorbell, so reads never hold the whole queue.
+			slotCount = sqEntries - 1;
+			slots = static_cast<InflightRead *>(memory::allocate(sizeof(InflightRead) * slotCount, memory::Tag::IO, alignof(InflightRead)));
+			freeSlots = static_cast<u32 *>(memory::allocate(sizeof(u32) * slotCount, memory::Tag::IO, alignof(u32)));
+			for (u32 i = 0; i < slotCount; ++i)
+			{
+				new (&slots[i]) InflightRead();
+				freeSlots[i] = slotCount - 1 - i;
+			}
+			freeSlotCount = slotCount;
+
+			return true;
+		}
+
+		void UringBackend::teardown()
+		{
+			if (slots != nullptr)
+			{
+				memory::deallocate(slots, sizeof(InflightRead) * slotCount, memory::Tag::IO, alignof(InflightRead));
+				memory::deallocate(freeSlots, sizeof(u32) * slotCount, memory::Tag::IO, alignof(u32));
+			}
+			if (doorbell >= 0)
+				close(doorbell);
+			if (sqes != nullptr)
+				munmap(sqes, sqesBytes);
+			if (cqRing != nullptr && cqRing != sqRing)
+				munmap(cqRing, cqRingBytes);
+			if (sqRing != nullptr)
+				munmap(sqRing, sqRingBytes);
+			if (ring >= 0)
+				close(ring);
+		}
+
+		void UringBackend::threadMain()
+		{
+			for (;;)
+			{
+				fillSubmissions();
+
+				const bool stopping = !running.load(std::memory_order_acquire);
+				if (stopping && freeSlotCount == slotCount && !doorbellArmed && service->m_queued.load(std::memory_order_acquire) == 0)
+					return;
+				if (!stopping && !doorbellArmed)
+					armDoorbell();
+
+				// Submits everything prepared above and sleeps until at least one read or the doorbell completes.
+				const u32 minComplete = (freeSlotCount < slotCount || doorbellArmed) ? 1 : 0;
+				const int submitted = uringEnter(ring, unsubmitted, minComplete, IORING_ENTER_GETEVENTS);
+				if (submitted >= 0)
+					unsubmitted -= static_cast<u32>(submitted);
+				else
+					assert(errno == EINTR || errno == EAGAIN || errno == EBUSY);
+
+				reapCompletions();
+			}
+		}
+
+		void UringBackend::fillSubmissions()
+		{
+			ReadRequest request;
+			while (freeSlotCount > 0 && service->popRequest(request))
+			{
+				const u32 slot = freeSlots[--freeSlotCount];
+				slots[slot].request = request;
+				slots[slot].bytesDone = 0;
+				prepareRead(slot);
+			}
+		}
+
+		io_uring_sqe &UringBackend::nextSqe()
+		{
+			const u32 tail = *sqTail;
+			assert(tail - loadAcquire(sqHead) < sqEntries);
+
+			const u32 index = tail & sqMask;
+			io_uring_sqe &sqe = sqes[index];
+			std::memset(&sqe, 0, sizeof(sqe));
+			sqArray[index] = index;
+
+			// Without SQPOLL the kernel only reads entries inside io_uring_enter, so the tail can move before the entry is filled in.
+			storeRelease(sqTail, tail + 1);
+			++unsubmitted;
+			return sqe;
+		}
+
+		void UringBackend::prepareRead(u32 slot)
+		{
+			InflightRead &read = slots[slot];
+			const ReadRequest &request = read.request;
+			u8 *destination = static_cast<u8 *>(request.buffer) + read.bytesDone;
+			const u32 length = static_cast<u32>(std::min(request.size - read.bytesDone, k_maxReadBytes));
+
+			io_uring_sqe &sqe = nextSqe();
+			sqe.fd = request.file->nativeHandle();
+			sqe.off = request.offset + read.bytesDone;
+			sqe.user_data = static_cast<u64>(slot) + 1;
+
+			if (request.registeredBuffer >= 0)
+			{
+				sqe.opcode = IORING_OP_READ_FIXED;
+				sqe.addr = reinterpret_cast<u64>(destination);
+				sqe.len = length;
+				sqe.buf_index = static_cast<u16>(request.registeredBuffer);
+			}
+			else
+			{
+				read.vector.iov_base = destination;
+				read.vector.iov_len = length;
+				sqe.opcode = IORING_OP_READV;
+				sqe.addr = reinterpret_cast<u64>(&read.vector);
+				sqe.len = 1;
+			}
+		}
+
+		void UringBackend::armDoorbell()
+		{
+			doorbellVector.iov_base = &doorbellValue;
+			doorbellVector.iov_len = sizeof(doorbellValue);
+
+			io_uring_sqe &sqe = nextSqe();
+			sqe.opcode = IORING_OP_READV;
+			sqe.fd = doorbell;
+			sqe.addr = reinterpret_cast<u64>(&doorbellVector);
+			sqe.len = 1;
+			sqe.user_data = k_doorbellTag;
+			doorbellArmed = true;
+		}
+
+		void UringBackend::reapCompletions()
+		{
+			u32 head = *cqHead;
+			const u32 tail = loadAcquire(cqTail);
+			for (; head != tail; ++head)
+			{
+				const io_uring_cqe &cqe = cqes[head & cqMask];
+				if (cqe.user_data == k_doorbellTag)
+				{
+					doorbellArmed = false;
+					continue;
+				}
+
+				const u32 slot = static_cast<u32>(cqe.user_data - 1);
+				InflightRead &read = slots[slot];
+				const int result = cqe.res;
+
+				if (result == -EINTR || result == -EAGAIN)
+				{
+					prepareRead(slot);
+					continue;
+				}
+
+				if (result > 0)
+				{
+					read.bytesDone += static_cast<usize>(result);
+					// Short reads before the end of the file continue where they stopped.
+					if (read.bytesDone < read.request.size)
+					{
+						prepareRead(slot);
+						continue;
+					}
+				}
+
+				const i64 bytesRead = result < 0 ? -1 : static_cast<i64>(read.bytesDone);
+				const ReadRequest request = read.request;
+				freeSlots[freeSlotCount++] = slot;
+				service->complete(request, bytesRead);
+			}
+
+			storeRelease(cqHead, head);
+		}
+
+		UringBackend *createUring(FileService &service, u32 entries)
+		{
+			UringBackend *backend = memory::create<UringBackend>(memory::Tag::IO);
+			backend->service = &service;
+			if (!backend->setup(std::max<u32>(entries, 2)))
+			{
+				backend->teardown();
+				memory::destroy(backend, memory::Tag::IO);
+				return nullptr;
+			}
+
+			return backend;
+		}
+
+		void destroyUring(UringBackend *backend)
+		{
+			backend->running.store(false, std::memory_order_release);
+			if (backend->thread.joinable())
+			{
+				wakeUring(*backend);
+				backend->thread.join();
+			}
+
+			backend->teardown();
+			memory::destroy(backend, memory::Tag::IO);
+		}
+
+		void wakeUring(UringBackend &backend)
+		{
+			std::call_once(backend.threadStarted, [&backend]()
+			{
+				backend.thread = std::thread(&UringBackend::threadMain, &backend);
+			});
+
+			const u64 one = 1;
+			[[maybe_unused]] const ssize_t written = write(backend.doorbell, &one, sizeof(one));
+		}
+
+		bool registerUringBuffers(UringBackend &backend, const RegisteredBuffer *buffers, u32 count)
+		{
+			uringRegister(backend.ring, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+			if (count == 0)
+				return true;
+
+			iovec *vectors = static_cast<iovec *>(memory::allocate(sizeof(iovec) * count, memory::Tag::IO, alignof(iovec)));
+			for (u32 i = 0; i < count; ++i)
+			{
+				vectors[i].iov_base = buffers[i].data;
+				vectors[i].iov_len = buffers[i].size;
+			}
+
+			const bool registered = uringRegister(backend.ring, IORING_REGISTER_BUFFERS, vectors, count) == 0;
+			memory::deallocate(vectors, sizeof(iovec) * count, memory::Tag::IO, alignof(iovec));
+			return registered;
+		}
+	}
+}
+
+#else
+
+namespace core::io::detail
+{
+	struct UringBackend
+	{
+	};
+
+	UringBackend *createUring(FileService &, u32)
+	{
+		return nullptr;
+	}
+
+	void destroyUring(UringBackend *)
+	{
+	}
+
+	void wakeUring(UringBackend &)
+	{
+	}
+
+	bool registerUringBuffers(UringBackend &, const RegisteredBuffer *, u32)
+	{
+		return false;
+	}
+}
+
+#endif
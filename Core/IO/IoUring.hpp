@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+namespace core::io
+{
+	class FileService;
+	struct RegisteredBuffer;
+
+	namespace detail
+	{
+		struct UringBackend;
+
+		// Sets up a ring with its submission thread. Returns nullptr when the platform or kernel has no io_uring,
+		// so the caller can fall back to blocking threads.
+		UringBackend *createUring(FileService &service, u32 entries);
+		// Waits for every read in flight, then tears the ring down.
+		void destroyUring(UringBackend *backend);
+
+		// Tells the ring thread that new requests were queued.
+		void wakeUring(UringBackend &backend);
+		bool registerUringBuffers(UringBackend &backend, const RegisteredBuffer *buffers, u32 count);
+	}
+}
@@ -0,0 +1,131 @@
+#include "Core/IO/MappedFile.hpp"
+
+#include <cassert>
+#include <utility>
+
+#include "Core/Platform.hpp"
+#include "Core/Memory/VirtualMemory.hpp"
+
+#if CORE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace core::io
+{
+	MappedFile::MappedFile(MappedFile &&other) noexcept
+		: m_data(std::exchange(other.m_data, nullptr))
+		, m_size(std::exchange(other.m_size, 0))
+	{}
+
+	MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+		}
+
+		return *this;
+	}
+
+#if CORE_PLATFORM_WINDOWS
+	bool MappedFile::open(const char *path)
+	{
+		close();
+
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// The view keeps the mapping and the file alive, so both handles can be closed straight away.
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (mapping == nullptr)
+			return false;
+
+		void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (view == nullptr)
+			return false;
+
+		m_data = static_cast<const u8 *>(view);
+		m_size = static_cast<usize>(size.QuadPart);
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data != nullptr)
+			UnmapViewOfFile(m_data);
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	void MappedFile::prefetch(usize offset, usize size) const
+	{
+		assert(offset + size <= m_size);
+		WIN32_MEMORY_RANGE_ENTRY range;
+		range.VirtualAddress = const_cast<u8 *>(m_data) + offset;
+		range.NumberOfBytes = size;
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+#else
+	bool MappedFile::open(const char *path)
+	{
+		close();
+
+		const int descriptor = ::open(path, O_RDONLY | O_CLOEXEC);
+		if (descriptor < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(descriptor, &info) != 0 || info.st_size == 0)
+		{
+			::close(descriptor);
+			return false;
+		}
+
+		// The mapping keeps the file alive, so the descriptor can be closed straight away.
+		void *view = mmap(nullptr, static_cast<usize>(info.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+		::close(descriptor);
+		if (view == MAP_FAILED)
+			return false;
+
+		m_data = static_cast<const u8 *>(view);
+		m_size = static_cast<usize>(info.st_size);
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data != nullptr)
+			munmap(const_cast<u8 *>(m_data), m_size);
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	void MappedFile::prefetch(usize offset, usize size) const
+	{
+		assert(offset + size <= m_size);
+		// madvise wants a page aligned start.
+		const usize pageMask = memory::pageSize() - 1;
+		const usize start = offset & ~pageMask;
+		madvise(const_cast<u8 *>(m_data) + start, offset + size - start, MADV_WILLNEED);
+	}
+#endif
+}
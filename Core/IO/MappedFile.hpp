@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+namespace core::io
+{
+	// Read only view of a whole file through the virtual memory system.
+	// Pages are loaded on first touch and can be dropped by the OS under memory pressure.
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile() { close(); }
+
+		MappedFile(MappedFile &&other) noexcept;
+		MappedFile &operator=(MappedFile &&other) noexcept;
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		// Returns false when the file cannot be opened or mapped. Empty files cannot be mapped.
+		bool open(const char *path);
+		void close();
+		bool isOpen() const { return m_data != nullptr; }
+
+		const u8 *data() const { return m_data; }
+		usize size() const { return m_size; }
+
+		// Asks the OS to start reading a range in the background, so touching it later does not stall on the disk.
+		void prefetch(usize offset, usize size) const;
+
+	private:
+		const u8 *m_data = nullptr;
+		usize m_size = 0;
+	};
+}
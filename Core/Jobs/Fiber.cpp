@@ -0,0 +1,123 @@
+#include "Core/Jobs/Fiber.hpp"
+
+#include <cassert>
+#include <cstdint>
+
+#include "Core/Memory/Memory.hpp"
+
+#if CORE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+namespace core::jobs
+{
+	Fiber::~Fiber()
+	{
+		destroy();
+	}
+
+#if CORE_PLATFORM_WINDOWS
+	void Fiber::create(EntryPoint entryPoint, void *userData, usize stackSize)
+	{
+		assert(!isValid());
+		m_handle = CreateFiber(stackSize, reinterpret_cast<LPFIBER_START_ROUTINE>(entryPoint), userData);
+		assert(m_handle != nullptr);
+		m_isThread = false;
+	}
+
+	void Fiber::convertCurrentThread()
+	{
+		assert(!isValid());
+		m_handle = ConvertThreadToFiber(nullptr);
+		assert(m_handle != nullptr);
+		m_isThread = true;
+	}
+
+	void Fiber::revertCurrentThread()
+	{
+		assert(m_isThread);
+		ConvertFiberToThread();
+		m_handle = nullptr;
+		m_isThread = false;
+	}
+
+	void Fiber::switchTo(Fiber &target)
+	{
+		assert(GetCurrentFiber() == m_handle);
+		SwitchToFiber(target.m_handle);
+	}
+
+	bool Fiber::isValid() const
+	{
+		return m_handle != nullptr;
+	}
+
+	void Fiber::destroy()
+	{
+		assert(!m_isThread && "Revert the thread before destroying its fiber.");
+		if (m_handle != nullptr)
+			DeleteFiber(m_handle);
+		m_handle = nullptr;
+	}
+#else
+	void Fiber::create(EntryPoint entryPoint, void *userData, usize stackSize)
+	{
+		assert(!isValid());
+		m_stack = memory::allocate(stackSize, memory::Tag::Jobs, 16);
+		m_stackSize = stackSize;
+		m_entryPoint = entryPoint;
+		m_userData = userData;
+
+		getcontext(&m_context);
+		m_context.uc_stack.ss_sp = m_stack;
+		m_context.uc_stack.ss_size = stackSize;
+		m_context.uc_link = nullptr;
+
+		// makecontext only forwards int arguments, so the fiber pointer travels in two halves.
+		const std::uintptr_t self = reinterpret_cast<std::uintptr_t>(this);
+		makecontext(&m_context, reinterpret_cast<void (*)()>(&Fiber::trampoline), 2,
+			static_cast<u32>(static_cast<u64>(self) >> 32), static_cast<u32>(self & 0xffffffffu));
+		m_valid = true;
+	}
+
+	void Fiber::convertCurrentThread()
+	{
+		assert(!isValid());
+		m_valid = true;
+	}
+
+	void Fiber::revertCurrentThread()
+	{
+		assert(isValid() && m_stack == nullptr);
+		m_valid = false;
+	}
+
+	void Fiber::switchTo(Fiber &target)
+	{
+		assert(target.isValid());
+		swapcontext(&m_context, &target.m_context);
+	}
+
+	bool Fiber::isValid() const
+	{
+		return m_valid;
+	}
+
+	void Fiber::trampoline(u32 high, u32 low)
+	{
+		Fiber *fiber = reinterpret_cast<Fiber *>(static_cast<std::uintptr_t>((static_cast<u64>(high) << 32) | low));
+		fiber->m_entryPoint(fiber->m_userData);
+		assert(false && "Fiber entry points must not return.");
+	}
+
+	void Fiber::destroy()
+	{
+		if (m_stack != nullptr)
+			memory::deallocate(m_stack, m_stackSize, memory::Tag::Jobs, 16);
+		m_stack = nullptr;
+		m_valid = false;
+	}
+#endif
+}
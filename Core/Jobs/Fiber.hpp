@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+#include "Core/Types.hpp"
+
+#if CORE_PLATFORM_POSIX
+#include <ucontext.h>
+#endif
+
+namespace core::jobs
+{
+	// Cooperatively scheduled execution context with its own stack.
+	// Fibers run until they explicitly switch to another fiber on the same thread.
+	class Fiber
+	{
+	public:
+		using EntryPoint = void (*)(void *userData);
+
+		Fiber() = default;
+		~Fiber();
+
+		Fiber(const Fiber &) = delete;
+		Fiber &operator=(const Fiber &) = delete;
+
+		// Creates a fiber that calls entryPoint the first time it is switched to. The entry point must never return.
+		void create(EntryPoint entryPoint, void *userData, usize stackSize);
+
+		// Turns the calling thread into a fiber, so it can switch to other fibers and be switched back to.
+		void convertCurrentThread();
+		// Undoes convertCurrentThread. Must be called on the same thread, while running on this fiber.
+		void revertCurrentThread();
+
+		// Suspends this fiber, which must be the one running, and resumes target.
+		void switchTo(Fiber &target);
+
+		bool isValid() const;
+
+	private:
+		void destroy();
+
+#if CORE_PLATFORM_WINDOWS
+		void *m_handle = nullptr;
+		bool m_isThread = false;
+#else
+		static void trampoline(u32 high, u32 low);
+
+		ucontext_t m_context{};
+		void *m_stack = nullptr;
+		usize m_stackSize = 0;
+		EntryPoint m_entryPoint = nullptr;
+		void *m_userData = nullptr;
+		bool m_valid = false;
+#endif
+	};
+}
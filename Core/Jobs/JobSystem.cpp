@@ -0,0 +1,368 @@
+#include "Core/Jobs/JobSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "Core/Platform.hpp"
+
+#if CORE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace core::jobs
+{
+	namespace
+	{
+		struct WorkerState
+		{
+			u32 index = JobSystem::k_notAWorker;
+			JobSystem *system = nullptr;
+			Fiber threadFiber;
+			detail::FiberSlot *currentSlot = nullptr;
+			detail::FiberSlot *previousSlot = nullptr;
+			detail::AfterSwitch afterSwitch = detail::AfterSwitch::None;
+			Counter *waitCounter = nullptr;
+		};
+
+		constexpr u32 k_idleSpins = 256;
+
+		thread_local WorkerState *t_worker = nullptr;
+
+		// A parked fiber may resume on another thread. Reading the thread local through a call the optimizer
+		// does not inline keeps it from reusing the previous thread's address after a switch.
+		CORE_NOINLINE WorkerState *currentWorker()
+		{
+			return t_worker;
+		}
+
+		CORE_NOINLINE void setCurrentWorker(WorkerState *worker)
+		{
+			t_worker = worker;
+		}
+
+		// Best effort: a core the process may not use leaves the thread where it was.
+		void pinThread(std::thread &thread, u32 core)
+		{
+#if CORE_PLATFORM_WINDOWS
+			SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << (core % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+			cpu_set_t cores;
+			CPU_ZERO(&cores);
+			CPU_SET(core, &cores);
+			pthread_setaffinity_np(thread.native_handle(), sizeof(cores), &cores);
+#else
+			(void)thread;
+			(void)core;
+#endif
+		}
+
+		usize nextPowerOfTwo(usize value)
+		{
+			usize result = 2;
+			while (result < value)
+				result <<= 1;
+			return result;
+		}
+	}
+
+	JobSystem::JobSystem(const JobSystemConfig &config)
+		: m_jobs(config.queueCapacity, memory::Tag::Jobs)
+		, m_readyFibers(nextPowerOfTwo(config.fiberCount), memory::Tag::Jobs)
+		, m_freeFibers(nextPowerOfTwo(config.fiberCount), memory::Tag::Jobs)
+		, m_fiberCount(config.fiberCount)
+	{
+		const u32 hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		u32 workerCount = config.workerCount;
+		if (workerCount == 0)
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		assert(m_fiberCount > workerCount && "Every worker needs a fiber, plus spares for jobs that wait.");
+
+		m_fiberSlots = static_cast<detail::FiberSlot *>(memory::allocate(sizeof(detail::FiberSlot) * m_fiberCount, memory::Tag::Jobs, alignof(detail::FiberSlot)));
+		for (u32 i = 0; i < m_fiberCount; ++i)
+		{
+			detail::FiberSlot *slot = new (&m_fiberSlots[i]) detail::FiberSlot();
+			slot->fiber.create(&JobSystem::fiberEntry, this, config.fiberStackSize);
+			m_freeFibers.tryPush(slot);
+		}
+
+		m_threads.reserve(workerCount);
+		for (u32 i = 0; i < workerCount; ++i)
+		{
+			m_threads.emplace_back(&JobSystem::workerMain, this, i);
+			if (config.pinWorkers)
+				pinThread(m_threads.back(), (i + 1) % hardwareThreads);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		m_running.store(false, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(m_idleMutex);
+		}
+		m_idleCondition.notify_all();
+
+		for (std::thread &thread : m_threads)
+			thread.join();
+
+		for (u32 i = 0; i < m_fiberCount; ++i)
+			m_fiberSlots[i].~FiberSlot();
+		memory::deallocate(m_fiberSlots, sizeof(detail::FiberSlot) * m_fiberCount, memory::Tag::Jobs, alignof(detail::FiberSlot));
+	}
+
+	void JobSystem::run(const Job *jobs, usize count, Counter *counter)
+	{
+		if (count == 0)
+			return;
+
+		if (counter != nullptr)
+			increment(*counter, static_cast<i32>(count));
+
+		m_pendingWork.fetch_add(static_cast<i32>(count), std::memory_order_release);
+		for (usize i = 0; i < count; ++i)
+		{
+			assert(jobs[i].function != nullptr);
+			const QueuedJob queued = { jobs[i], counter };
+			while (!m_jobs.tryPush(queued))
+			{
+				// The queue is full. Drain it from here instead of waiting on workers that may all be submitting too.
+				QueuedJob other;
+				if (m_jobs.tryPop(other))
+				{
+					m_pendingWork.fetch_sub(1, std::memory_order_relaxed);
+					execute(other);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		wake(count);
+	}
+
+	void JobSystem::wait(Counter &counter)
+	{
+		if (counter.isDone())
+			return;
+
+		WorkerState *worker = currentWorker();
+		if (worker == nullptr || worker->system != this)
+		{
+			while (!counter.isDone())
+				std::this_thread::yield();
+			return;
+		}
+
+		// Park this fiber on the counter and keep the worker busy on a fresh one. The fiber switched to does
+		// the registration, so decrement cannot resume this fiber before it has actually stopped running.
+		detail::FiberSlot *next = acquireFreeFiber();
+		currentWorker()->waitCounter = &counter;
+		switchFiber(next, detail::AfterSwitch::WaitOnCounter);
+	}
+
+	void JobSystem::increment(Counter &counter, i32 count)
+	{
+		assert(count > 0);
+		SpinLockGuard guard(counter.m_lock);
+		counter.m_value += count;
+	}
+
+	u32 JobSystem::currentWorkerIndex()
+	{
+		const WorkerState *worker = currentWorker();
+		return worker != nullptr ? worker->index : k_notAWorker;
+	}
+
+	void JobSystem::fiberEntry(void *data)
+	{
+		static_cast<JobSystem *>(data)->fiberLoop();
+	}
+
+	void JobSystem::workerMain(u32 index)
+	{
+		WorkerState state;
+		state.index = index;
+		state.system = this;
+		setCurrentWorker(&state);
+
+		state.threadFiber.convertCurrentThread();
+		state.currentSlot = acquireFreeFiber();
+		state.threadFiber.switchTo(state.currentSlot->fiber);
+
+		// Only reached once a loop fiber hands the thread back on shutdown.
+		state.threadFiber.revertCurrentThread();
+		setCurrentWorker(nullptr);
+	}
+
+	void JobSystem::fiberLoop()
+	{
+		for (;;)
+		{
+			completeSwitch();
+
+			if (!m_running.load(std::memory_order_acquire))
+			{
+				WorkerState *worker = currentWorker();
+				detail::FiberSlot *slot = std::exchange(worker->currentSlot, nullptr);
+				slot->fiber.switchTo(worker->threadFiber);
+			}
+
+			// Resuming parked fibers first finishes older work before starting new work.
+			detail::FiberSlot *ready = nullptr;
+			if (m_readyFibers.tryPop(ready))
+			{
+				m_pendingWork.fetch_sub(1, std::memory_order_relaxed);
+				switchFiber(ready, detail::AfterSwitch::ReturnToPool);
+				continue;
+			}
+
+			QueuedJob queued;
+			if (m_jobs.tryPop(queued))
+			{
+				m_pendingWork.fetch_sub(1, std::memory_order_relaxed);
+				execute(queued);
+				continue;
+			}
+
+			idle();
+		}
+	}
+
+	void JobSystem::execute(const QueuedJob &queued)
+	{
+		queued.job.function(queued.job.data);
+		if (queued.counter != nullptr)
+			decrement(*queued.counter);
+	}
+
+	void JobSystem::switchFiber(detail::FiberSlot *target, detail::AfterSwitch action)
+	{
+		WorkerState *worker = currentWorker();
+		detail::FiberSlot *current = worker->currentSlot;
+		worker->previousSlot = current;
+		worker->afterSwitch = action;
+		worker->currentSlot = target;
+		current->fiber.switchTo(target->fiber);
+
+		// Possibly on another thread by now.
+		completeSwitch();
+	}
+
+	void JobSystem::completeSwitch()
+	{
+		WorkerState *worker = currentWorker();
+		detail::FiberSlot *previous = worker->previousSlot;
+
+		switch (worker->afterSwitch)
+		{
+		case detail::AfterSwitch::None:
+			break;
+
+		case detail::AfterSwitch::ReturnToPool:
+		{
+			const bool pushed = m_freeFibers.tryPush(previous);
+			assert(pushed);
+			(void)pushed;
+			break;
+		}
+
+		case detail::AfterSwitch::WaitOnCounter:
+		{
+			Counter &counter = *worker->waitCounter;
+			bool isDone;
+			{
+				SpinLockGuard guard(counter.m_lock);
+				isDone = counter.m_value == 0;
+				if (!isDone)
+				{
+					previous->nextWaiter = counter.m_waiters;
+					counter.m_waiters = previous;
+				}
+			}
+
+			if (isDone)
+				pushReady(previous);
+			break;
+		}
+		}
+
+		worker->afterSwitch = detail::AfterSwitch::None;
+		worker->previousSlot = nullptr;
+		worker->waitCounter = nullptr;
+	}
+
+	detail::FiberSlot *JobSystem::acquireFreeFiber()
+	{
+		// Only empty when more jobs are waiting than the pool was sized for, until one of them finishes.
+		detail::FiberSlot *slot = nullptr;
+		while (!m_freeFibers.tryPop(slot))
+			std::this_thread::yield();
+		return slot;
+	}
+
+	void JobSystem::decrement(Counter &counter)
+	{
+		detail::FiberSlot *waiters = nullptr;
+		{
+			SpinLockGuard guard(counter.m_lock);
+			assert(counter.m_value > 0);
+			if (--counter.m_value == 0)
+				waiters = std::exchange(counter.m_waiters, nullptr);
+		}
+
+		// The counter may be gone once the lock is released; only the detached waiter list is touched from here.
+		while (waiters != nullptr)
+		{
+			detail::FiberSlot *next = std::exchange(waiters->nextWaiter, nullptr);
+			pushReady(waiters);
+			waiters = next;
+		}
+	}
+
+	void JobSystem::pushReady(detail::FiberSlot *slot)
+	{
+		m_pendingWork.fetch_add(1, std::memory_order_release);
+		const bool pushed = m_readyFibers.tryPush(slot);
+		assert(pushed && "The ready queue holds every fiber, so it cannot fill up.");
+		(void)pushed;
+		wake(1);
+	}
+
+	void JobSystem::wake(usize count)
+	{
+		if (m_sleepingWorkers.load(std::memory_order_acquire) == 0)
+			return;
+
+		if (count > 1)
+			m_idleCondition.notify_all();
+		else
+			m_idleCondition.notify_one();
+	}
+
+	void JobSystem::idle()
+	{
+		for (u32 spin = 0; spin < k_idleSpins; ++spin)
+		{
+			if (m_pendingWork.load(std::memory_order_acquire) > 0 || !m_running.load(std::memory_order_relaxed))
+				return;
+			std::this_thread::yield();
+		}
+
+		// Sleeping is bounded, so a wake up that races with going to sleep only costs a millisecond.
+		std::unique_lock<std::mutex> lock(m_idleMutex);
+		m_sleepingWorkers.fetch_add(1, std::memory_order_acq_rel);
+		m_idleCondition.wait_for(lock, std::chrono::milliseconds(1), [this]()
+		{
+			return m_pendingWork.load(std::memory_order_acquire) > 0 || !m_running.load(std::memory_order_acquire);
+		});
+		m_sleepingWorkers.fetch_sub(1, std::memory_order_acq_rel);
+	}
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Containers/MpmcQueue.hpp"
+#include "Core/Jobs/Fiber.hpp"
+#include "Core/Jobs/SpinLock.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::jobs
+{
+	class JobSystem;
+
+	namespace detail
+	{
+		struct FiberSlot
+		{
+			Fiber fiber;
+			FiberSlot *nextWaiter = nullptr;
+		};
+
+		// What the fiber that was switched to does on behalf of the fiber that was switched away from.
+		enum class AfterSwitch : u8
+		{
+			None,
+			ReturnToPool,
+			WaitOnCounter,
+		};
+	}
+
+	struct Job
+	{
+		void (*function)(void *data) = nullptr;
+		void *data = nullptr;
+	};
+
+	// Number of unfinished jobs in a batch. Waiting on a counter from inside a job parks the job's fiber
+	// instead of blocking the worker, which goes on to run other jobs until the counter reaches zero.
+	// Only wait once every job the counter tracks has been submitted.
+	class Counter
+	{
+	public:
+		Counter() = default;
+		Counter(const Counter &) = delete;
+		Counter &operator=(const Counter &) = delete;
+
+		~Counter() { assert(m_waiters == nullptr); }
+
+		i32 value() const
+		{
+			SpinLockGuard guard(m_lock);
+			return m_value;
+		}
+
+		bool isDone() const { return value() == 0; }
+
+	private:
+		friend class JobSystem;
+
+		// The value only changes under the lock, so a waiter that sees zero knows the last job is done touching the counter.
+		mutable SpinLock m_lock;
+		i32 m_value = 0;
+		detail::FiberSlot *m_waiters = nullptr;
+	};
+
+	struct JobSystemConfig
+	{
+		// Zero picks one worker per hardware thread, minus the one that submits the work.
+		u32 workerCount = 0;
+		// Upper bound on jobs that can be running or parked in wait at the same time.
+		u32 fiberCount = 128;
+		usize fiberStackSize = 64 * 1024;
+		// Power of two.
+		usize queueCapacity = 4096;
+		// Keeps worker i on core i + 1, leaving core 0 to the thread that submits the work, so a worker's caches
+		// stay warm. Only worth it when the process has the machine to itself.
+		bool pinWorkers = false;
+	};
+
+	// Runs jobs on a pool of fibers spread over one worker thread per core.
+	// Jobs that wait on a counter yield their fiber, so dependencies never leave a core idle.
+	class JobSystem
+	{
+	public:
+		static constexpr u32 k_notAWorker = ~0u;
+
+		explicit JobSystem(const JobSystemConfig &config = JobSystemConfig());
+		// Jobs still queued are dropped. Wait on their counters first.
+		~JobSystem();
+
+		JobSystem(const JobSystem &) = delete;
+		JobSystem &operator=(const JobSystem &) = delete;
+
+		// Queues the jobs. When a counter is given it goes up by count now and down by one as each job finishes.
+		void run(const Job *jobs, usize count, Counter *counter = nullptr);
+		void run(const Job &job, Counter *counter = nullptr) { run(&job, 1, counter); }
+
+		// Returns once the counter reaches zero. Inside a job the fiber is parked and the worker keeps running other work;
+		// on any other thread the caller spins and yields.
+		void wait(Counter &counter);
+
+		// For work that finishes outside a job, such as coroutines and I/O: raise the counter when the work starts
+		// and decrement it once per finished piece, which resumes anything waiting on it.
+		void increment(Counter &counter, i32 count = 1);
+		void decrement(Counter &counter);
+
+		u32 workerCount() const { return static_cast<u32>(m_threads.size()); }
+
+		// Index of the calling worker thread, or k_notAWorker.
+		static u32 currentWorkerIndex();
+
+	private:
+		struct QueuedJob
+		{
+			Job job;
+			Counter *counter = nullptr;
+		};
+
+		static void fiberEntry(void *data);
+		void workerMain(u32 index);
+		[[noreturn]] void fiberLoop();
+
+		void execute(const QueuedJob &queued);
+		void switchFiber(detail::FiberSlot *target, detail::AfterSwitch action);
+		void completeSwitch();
+		detail::FiberSlot *acquireFreeFiber();
+		void pushReady(detail::FiberSlot *slot);
+		void wake(usize count);
+		void idle();
+
+		MpmcQueue<QueuedJob> m_jobs;
+		MpmcQueue<detail::FiberSlot *> m_readyFibers;
+		MpmcQueue<detail::FiberSlot *> m_freeFibers;
+		detail::FiberSlot *m_fiberSlots = nullptr;
+		u32 m_fiberCount = 0;
+
+		std::vector<std::thread, memory::TaggedAllocator<std::thread, memory::Tag::Jobs>> m_threads;
+		std::atomic<bool> m_running{ true };
+
+		// Work that is queued but not picked up yet, so idle workers know when to sleep.
+		std::atomic<i32> m_pendingWork{ 0 };
+		std::atomic<u32> m_sleepingWorkers{ 0 };
+		std::mutex m_idleMutex;
+		std::condition_variable m_idleCondition;
+	};
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace core::jobs
+{
+	// Lock for critical sections that are a handful of instructions long.
+	// Safe to hold across nothing that can block or switch fibers.
+	class SpinLock
+	{
+	public:
+		void lock()
+		{
+			for (;;)
+			{
+				if (!m_locked.exchange(true, std::memory_order_acquire))
+					return;
+
+				// Spin on a plain load so waiting cores do not keep stealing the cache line.
+				for (unsigned spins = 0; m_locked.load(std::memory_order_relaxed); ++spins)
+				{
+					if (spins < 64)
+						pause();
+					else
+						std::this_thread::yield();
+				}
+			}
+		}
+
+		bool tryLock() { return !m_locked.load(std::memory_order_relaxed) && !m_locked.exchange(true, std::memory_order_acquire); }
+		void unlock() { m_locked.store(false, std::memory_order_release); }
+
+	private:
+		static void pause()
+		{
+#if defined(_M_X64) || defined(__SSE2__)
+			_mm_pause();
+#endif
+		}
+
+		std::atomic<bool> m_locked{ false };
+	};
+
+	// Scoped lock for SpinLock, so it also works with std::lock_guard style code.
+	class SpinLockGuard
+	{
+	public:
+		explicit SpinLockGuard(SpinLock &lock) : m_lock(lock) { m_lock.lock(); }
+		~SpinLockGuard() { m_lock.unlock(); }
+
+		SpinLockGuard(const SpinLockGuard &) = delete;
+		SpinLockGuard &operator=(const SpinLockGuard &) = delete;
+
+	private:
+		SpinLock &m_lock;
+	};
+}
@@ -0,0 +1,224 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+
+#if CORE_HAS_COROUTINES
+
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "Core/Types.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::jobs
+{
+	template<typename T>
+	class Task;
+
+	namespace detail
+	{
+		inline void resumeCoroutine(void *address)
+		{
+			std::coroutine_handle<>::from_address(address).resume();
+		}
+
+		// Hands control to whoever awaited the task, or signals the counter of a task started with start().
+		struct FinalAwaiter
+		{
+			bool await_ready() const noexcept { return false; }
+
+			template<typename Promise>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+			{
+				auto &promise = handle.promise();
+				if (promise.continuation)
+					return promise.continuation;
+
+				// The frame may be destroyed as soon as the counter drops, so nothing touches it afterwards.
+				if (promise.counter != nullptr)
+					promise.system->decrement(*promise.counter);
+				return std::noop_coroutine();
+			}
+
+			void await_resume() const noexcept {}
+		};
+
+		struct PromiseBase
+		{
+			// Coroutine frames are attributed to the job system like fiber stacks.
+			static void *operator new(usize size) { return memory::allocate(size, memory::Tag::Jobs); }
+			static void operator delete(void *pointer, usize size) { memory::deallocate(pointer, size, memory::Tag::Jobs); }
+
+			std::suspend_always initial_suspend() const noexcept { return {}; }
+			FinalAwaiter final_suspend() const noexcept { return {}; }
+			void unhandled_exception() { exception = std::current_exception(); }
+
+			void rethrowIfFailed() const
+			{
+				if (exception)
+					std::rethrow_exception(exception);
+			}
+
+			std::coroutine_handle<> continuation;
+			JobSystem *system = nullptr;
+			Counter *counter = nullptr;
+			std::exception_ptr exception;
+		};
+
+		template<typename T>
+		struct Promise : PromiseBase
+		{
+			Task<T> get_return_object();
+
+			template<typename U>
+			void return_value(U &&result) { value.emplace(std::forward<U>(result)); }
+
+			T result()
+			{
+				rethrowIfFailed();
+				return std::move(*value);
+			}
+
+			std::optional<T> value;
+		};
+
+		template<>
+		struct Promise<void> : PromiseBase
+		{
+			Task<void> get_return_object();
+
+			void return_void() {}
+			void result() { rethrowIfFailed(); }
+		};
+	}
+
+	// Lazily started coroutine. Awaiting a task runs it on the awaiting thread and resumes the awaiter once it
+	// finishes; co_await schedule() inside it to continue on a worker instead.
+	template<typename T = void>
+	class [[nodiscard]] Task
+	{
+	public:
+		using promise_type = detail::Promise<T>;
+		using Handle = std::coroutine_handle<promise_type>;
+
+		Task() = default;
+		explicit Task(Handle handle) : m_handle(handle) {}
+
+		Task(Task &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+		Task &operator=(Task &&other) noexcept
+		{
+			if (this != &other)
+			{
+				if (m_handle)
+					m_handle.destroy();
+				m_handle = std::exchange(other.m_handle, nullptr);
+			}
+
+			return *this;
+		}
+
+		Task(const Task &) = delete;
+		Task &operator=(const Task &) = delete;
+
+		~Task()
+		{
+			if (m_handle)
+				m_handle.destroy();
+		}
+
+		bool isValid() const { return static_cast<bool>(m_handle); }
+		bool isDone() const { return m_handle && m_handle.done(); }
+
+		// Value of a finished task. Rethrows the exception the coroutine exited with.
+		T result()
+		{
+			assert(isDone());
+			return m_handle.promise().result();
+		}
+
+		auto operator co_await() noexcept
+		{
+			struct Awaiter
+			{
+				Handle handle;
+
+				bool await_ready() const noexcept { return !handle || handle.done(); }
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+				{
+					handle.promise().continuation = awaiting;
+					return handle;
+				}
+
+				T await_resume() { return handle.promise().result(); }
+			};
+
+			return Awaiter{ m_handle };
+		}
+
+	private:
+		template<typename U>
+		friend void start(JobSystem &system, Task<U> &task, Counter &counter);
+
+		Handle m_handle;
+	};
+
+	template<typename T>
+	Task<T> detail::Promise<T>::get_return_object()
+	{
+		return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+	}
+
+	inline Task<void> detail::Promise<void>::get_return_object()
+	{
+		return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+	}
+
+	// co_await schedule(system) suspends the coroutine and resumes it as a job on one of the system's workers.
+	class ScheduleAwaiter
+	{
+	public:
+		explicit ScheduleAwaiter(JobSystem &system) : m_system(system) {}
+
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> handle) { m_system.run(Job{ &detail::resumeCoroutine, handle.address() }); }
+		void await_resume() const noexcept {}
+
+	private:
+		JobSystem &m_system;
+	};
+
+	inline ScheduleAwaiter schedule(JobSystem &system)
+	{
+		return ScheduleAwaiter(system);
+	}
+
+	// Runs the task on a worker. The counter drops once the task finishes; keep the task alive until then.
+	template<typename T>
+	void start(JobSystem &system, Task<T> &task, Counter &counter)
+	{
+		assert(task.m_handle && !task.m_handle.done());
+		detail::PromiseBase &promise = task.m_handle.promise();
+		promise.system = &system;
+		promise.counter = &counter;
+
+		system.increment(counter);
+		system.run(Job{ &detail::resumeCoroutine, task.m_handle.address() });
+	}
+
+	// Runs the task on a worker and returns its result. Inside a job this parks the fiber like JobSystem::wait.
+	template<typename T>
+	T syncWait(JobSystem &system, Task<T> task)
+	{
+		Counter counter;
+		start(system, task, counter);
+		system.wait(counter);
+		return task.result();
+	}
+}
+
+#endif
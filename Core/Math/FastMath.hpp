@@ -0,0 +1,285 @@
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+#include "Core/Types.hpp"
+#include "Core/Math/Simd.hpp"
+#include "Core/Math/Vec2.hpp"
+
+namespace core::math
+{
+	// Error budget of the fast math functions.
+	// Relative error for rsqrt and exp, absolute error for sin, cos and atan2.
+	enum class Accuracy
+	{
+		Exact,	// Forwards to the standard library.
+		High,	// Within 1e-5.
+		Low		// Within 1e-3.
+	};
+
+	namespace fast
+	{
+		namespace detail
+		{
+			constexpr f32 k_pi = 3.14159265358979323846f;
+			constexpr f32 k_halfPi = 1.57079632679489661923f;
+			constexpr f32 k_invTwoPi = 0.15915494309189533577f;
+			// 2 * pi split in two, so the range reduction keeps the bits the first product rounds away.
+			constexpr f32 k_twoPiHigh = 6.28125f;
+			constexpr f32 k_twoPiLow = 0.0019353071795864769253f;
+			// sin and cos keep their error budget up to this many radians either way; further out the split above
+			// runs out of bits. Inputs are clamped to it, so the turn count always fits in an i32.
+			constexpr f32 k_maxAngle = 262144.0f;
+			constexpr f32 k_log2e = 1.44269504088896340736f;
+			// ln(2) split the same way for the exp reduction.
+			constexpr f32 k_ln2High = 0.693145751953125f;
+			constexpr f32 k_ln2Low = 1.42860682030941723212e-6f;
+			constexpr f32 k_expMin = -87.0f;
+			constexpr f32 k_expMax = 88.0f;
+
+			template<typename V>
+			constexpr bool k_isLane = std::is_same_v<V, f32> || std::is_same_v<V, F32x4>;
+
+			template<typename V, typename Op>
+			V perLane(V value, Op op)
+			{
+				if constexpr (std::is_same_v<V, f32>)
+				{
+					return op(value);
+				}
+				else
+				{
+					alignas(16) f32 lanes[4];
+					value.store(lanes);
+					for (f32 &lane : lanes)
+						lane = op(lane);
+					return F32x4::load(lanes);
+				}
+			}
+
+			template<typename V, typename Op>
+			V perLane(V a, V b, Op op)
+			{
+				if constexpr (std::is_same_v<V, f32>)
+				{
+					return op(a, b);
+				}
+				else
+				{
+					alignas(16) f32 lanesA[4];
+					alignas(16) f32 lanesB[4];
+					a.store(lanesA);
+					b.store(lanesB);
+					for (usize i = 0; i < 4; ++i)
+						lanesA[i] = op(lanesA[i], lanesB[i]);
+					return F32x4::load(lanesA);
+				}
+			}
+
+			// Runs a lane kernel over arrays, four elements at a time with a scalar tail.
+			template<typename Kernel>
+			void forEach(const f32 *input, f32 *output, usize count, Kernel kernel)
+			{
+				usize i = 0;
+				for (; i + F32x4::k_width <= count; i += F32x4::k_width)
+					kernel(F32x4::load(input + i)).store(output + i);
+				for (; i < count; ++i)
+					output[i] = kernel(input[i]);
+			}
+
+			template<Accuracy A, typename V>
+			constexpr V sinKernel(V x)
+			{
+				// Fold [-pi, pi] into [-pi/2, pi/2], where sin(x) = sin(pi - x) keeps the odd polynomial accurate.
+				x = select(greaterThan(x, V(k_halfPi)), V(k_pi) - x, x);
+				x = select(lessThan(x, V(-k_halfPi)), V(-k_pi) - x, x);
+
+				const V x2 = x * x;
+				if constexpr (A == Accuracy::Low)
+					return x * (V(0.9996968025564247f) + x2 * (V(-0.1656731196897013f) + x2 * V(0.007514389228329303f)));
+
+				return x * (V(0.9999966163752232f) + x2 * (V(-0.16664828505544121f) + x2 * (V(0.008306326127471862f) + x2 * V(-0.00018363673471799582f))));
+			}
+
+			template<typename V>
+			constexpr V reduceAngle(V x)
+			{
+				const V clamped = min(max(x, V(-k_maxAngle)), V(k_maxAngle));
+				const V turns = toFloat(roundToInt(clamped * V(k_invTwoPi)));
+				return (clamped - turns * V(k_twoPiHigh)) - turns * V(k_twoPiLow);
+			}
+
+			template<Accuracy A, typename V>
+			constexpr V atanKernel(V z)
+			{
+				const V z2 = z * z;
+				if constexpr (A == Accuracy::Low)
+					return z * (V(0.999213830662424f) + z2 * (V(-0.32117498677188405f) + z2 * (V(0.1462643778109247f) + z2 * V(-0.03898642430720553f))));
+
+				return z * (V(0.9999772205733248f) + z2 * (V(-0.3326228423321453f) + z2 * (V(0.19354041486456078f) + z2 * (V(-0.11642651202825384f)
+					+ z2 * (V(0.05264734162891311f) + z2 * V(-0.011719121575602055f))))));
+			}
+
+			// 2^f for f in [-0.5, 0.5].
+			template<Accuracy A, typename V>
+			constexpr V exp2Kernel(V f)
+			{
+				if constexpr (A == Accuracy::Low)
+					return V(0.9999280744953816f) + f * (V(0.6932610041358379f) + f * (V(0.2426111144280137f) + f * V(0.055171567875878576f)));
+
+				return V(0.9999992613587761f) + f * (V(0.6931218149080498f) + f * (V(0.2402474511668386f) + f * (V(0.05591785940052436f) + f * V(0.009570090215167528f))));
+			}
+		}
+
+		// The lane functions accept f32 or F32x4. Tiers are picked at compile time so the hot path has no branches.
+		// The approximate tiers are constexpr for f32, Exact is only available at run time.
+
+		template<Accuracy A = Accuracy::High, typename V>
+		constexpr V rsqrt(V x)
+		{
+			static_assert(detail::k_isLane<V>, "Fast math only supports f32 and F32x4.");
+			if constexpr (A == Accuracy::Exact)
+			{
+				return detail::perLane(x, [](f32 value) { return 1.0f / std::sqrt(value); });
+			}
+			else
+			{
+				const V estimate = rsqrtApprox(x);
+				if constexpr (A == Accuracy::Low)
+					return estimate;
+				else
+					return estimate * (V(1.5f) - V(0.5f) * x * estimate * estimate);
+			}
+		}
+
+		// Within the tier's budget for |x| up to detail::k_maxAngle. Larger angles, infinities and NaN are clamped to
+		// it, so the approximate tiers always return a value in [-1, 1].
+		template<Accuracy A = Accuracy::High, typename V>
+		constexpr V sin(V x)
+		{
+			static_assert(detail::k_isLane<V>, "Fast math only supports f32 and F32x4.");
+			if constexpr (A == Accuracy::Exact)
+				return detail::perLane(x, [](f32 value) { return std::sin(value); });
+			else
+				return detail::sinKernel<A>(detail::reduceAngle(x));
+		}
+
+		// Same range as sin.
+		template<Accuracy A = Accuracy::High, typename V>
+		constexpr V cos(V x)
+		{
+			static_assert(detail::k_isLane<V>, "Fast math only supports f32 and F32x4.");
+			if constexpr (A == Accuracy::Exact)
+				return detail::perLane(x, [](f32 value) { return std::cos(value); });
+			else
+				return detail::sinKernel<A>(V(detail::k_halfPi) - abs(detail::reduceAngle(x)));
+		}
+
+		template<Accuracy A = Accuracy::High, typename V>
+		constexpr V atan2(V y, V x)
+		{
+			static_assert(detail::k_isLane<V>, "Fast math only supports f32 and F32x4.");
+			if constexpr (A == Accuracy::Exact)
+			{
+				return detail::perLane(y, x, [](f32 a, f32 b) { return std::atan2(a, b); });
+			}
+			else
+			{
+				const V absX = abs(x);
+				const V absY = abs(y);
+				const V larger = max(absX, absY);
+				const V ratio = select(greaterThan(larger, V(0.0f)), min(absX, absY) / larger, V(0.0f));
+
+				V angle = detail::atanKernel<A>(ratio);
+				angle = select(greaterThan(absY, absX), V(detail::k_halfPi) - angle, angle);
+				angle = select(lessThan(x, V(0.0f)), V(detail::k_pi) - angle, angle);
+				return select(lessThan(y, V(0.0f)), -angle, angle);
+			}
+		}
+
+		// Inputs are clamped to the normal float range, so results never turn into infinities or denormals.
+		template<Accuracy A = Accuracy::High, typename V>
+		constexpr V exp(V x)
+		{
+			static_assert(detail::k_isLane<V>, "Fast math only supports f32 and F32x4.");
+			if constexpr (A == Accuracy::Exact)
+			{
+				return detail::perLane(x, [](f32 value) { return std::exp(value); });
+			}
+			else
+			{
+				const V clamped = min(max(x, V(detail::k_expMin)), V(detail::k_expMax));
+				const auto whole = roundToInt(clamped * V(detail::k_log2e));
+				const V wholeFloat = toFloat(whole);
+				const V remainder = (clamped - wholeFloat * V(detail::k_ln2High)) - wholeFloat * V(detail::k_ln2Low);
+				const V scale = asFloat(shiftLeft<23>(whole + decltype(whole)(127)));
+				return detail::exp2Kernel<A>(remainder * V(detail::k_log2e)) * scale;
+			}
+		}
+
+		// Array versions, vectorized four lanes at a time. Input and output may alias.
+
+		template<Accuracy A = Accuracy::High>
+		void rsqrt(const f32 *input, f32 *output, usize count)
+		{
+			detail::forEach(input, output, count, [](auto x) { return rsqrt<A>(x); });
+		}
+
+		template<Accuracy A = Accuracy::High>
+		void sin(const f32 *input, f32 *output, usize count)
+		{
+			detail::forEach(input, output, count, [](auto x) { return sin<A>(x); });
+		}
+
+		template<Accuracy A = Accuracy::High>
+		void cos(const f32 *input, f32 *output, usize count)
+		{
+			detail::forEach(input, output, count, [](auto x) { return cos<A>(x); });
+		}
+
+		template<Accuracy A = Accuracy::High>
+		void exp(const f32 *input, f32 *output, usize count)
+		{
+			detail::forEach(input, output, count, [](auto x) { return exp<A>(x); });
+		}
+
+		template<Accuracy A = Accuracy::High>
+		void atan2(const f32 *y, const f32 *x, f32 *output, usize count)
+		{
+			usize i = 0;
+			for (; i + F32x4::k_width <= count; i += F32x4::k_width)
+				atan2<A>(F32x4::load(y + i), F32x4::load(x + i)).store(output + i);
+			for (; i < count; ++i)
+				output[i] = atan2<A>(y[i], x[i]);
+		}
+
+		// Vec2f helpers for the hot loops that motivated this header.
+
+		// Returns the zero vector when the length is zero.
+		template<Accuracy A = Accuracy::High>
+		constexpr Vec2f normalized(const Vec2f &vec)
+		{
+			const f32 lengthSquared = vec.lengthSquared();
+			if (lengthSquared == 0.0f)
+				return Vec2f::zero();
+
+			return vec * rsqrt<A>(lengthSquared);
+		}
+
+		template<Accuracy A = Accuracy::High>
+		constexpr Vec2f rotated(const Vec2f &vec, f32 angle)
+		{
+			const f32 s = sin<A>(angle);
+			const f32 c = cos<A>(angle);
+			return Vec2f(vec.x * c - vec.y * s, vec.x * s + vec.y * c);
+		}
+
+		// Angle of the vector relative to the positive x axis, in [-pi, pi].
+		template<Accuracy A = Accuracy::High>
+		constexpr f32 angle(const Vec2f &vec)
+		{
+			return atan2<A>(vec.y, vec.x);
+		}
+	}
+}
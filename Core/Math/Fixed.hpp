@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cassert>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#include "Core/Platform.hpp"
+#include "Core/Types.hpp"
+
+namespace core::math
+{
+	namespace detail
+	{
+		// Portable 128 bit fallbacks for compilers without __int128, used during constant evaluation.
+
+		constexpr u64 magnitude(i64 value) { return value < 0 ? 0 - static_cast<u64>(value) : static_cast<u64>(value); }
+
+		constexpr i64 mulShiftPortable(i64 a, i64 b, u32 shift)
+		{
+			const u64 x = magnitude(a);
+			const u64 y = magnitude(b);
+			const u64 crossLow = (x & 0xffffffffu) * (y >> 32);
+			const u64 crossHigh = (x >> 32) * (y & 0xffffffffu);
+			const u64 lowLow = (x & 0xffffffffu) * (y & 0xffffffffu);
+			const u64 middle = (lowLow >> 32) + (crossLow & 0xffffffffu) + (crossHigh & 0xffffffffu);
+			u64 low = (middle << 32) | (lowLow & 0xffffffffu);
+			u64 high = (x >> 32) * (y >> 32) + (crossLow >> 32) + (crossHigh >> 32) + (middle >> 32);
+
+			if ((a < 0) != (b < 0))
+			{
+				low = ~low + 1;
+				high = ~high + (low == 0 ? 1 : 0);
+			}
+
+			return static_cast<i64>((low >> shift) | (high << (64 - shift)));
+		}
+
+		constexpr i64 shiftDivPortable(i64 a, i64 b, u32 shift)
+		{
+			const u64 divisor = magnitude(b);
+			u64 high = magnitude(a) >> (64 - shift);
+			u64 low = magnitude(a) << shift;
+			u64 remainder = 0;
+			u64 quotient = 0;
+			for (u32 bit = 0; bit < 128; ++bit)
+			{
+				const bool carry = (remainder >> 63) != 0;
+				remainder = (remainder << 1) | (high >> 63);
+				high = (high << 1) | (low >> 63);
+				low <<= 1;
+				quotient <<= 1;
+				if (carry || remainder >= divisor)
+				{
+					remainder -= divisor;
+					quotient |= 1;
+				}
+			}
+
+			return (a < 0) != (b < 0) ? static_cast<i64>(0 - quotient) : static_cast<i64>(quotient);
+		}
+
+		// (a * b) >> shift, computed with a 128 bit intermediate.
+		constexpr i64 mulShift(i64 a, i64 b, u32 shift)
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			if (CORE_IS_CONSTANT_EVALUATED())
+				return mulShiftPortable(a, b, shift);
+
+			i64 high = 0;
+			const u64 low = static_cast<u64>(_mul128(a, b, &high));
+			return static_cast<i64>(__shiftright128(low, static_cast<u64>(high), static_cast<unsigned char>(shift)));
+#else
+			return static_cast<i64>((static_cast<__int128>(a) * b) >> shift);
+#endif
+		}
+
+		// (a << shift) / b, computed with a 128 bit intermediate. Truncates towards zero.
+		constexpr i64 shiftDiv(i64 a, i64 b, u32 shift)
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			if (CORE_IS_CONSTANT_EVALUATED())
+				return shiftDivPortable(a, b, shift);
+
+			const i64 high = a >> (64 - shift);
+			const i64 low = static_cast<i64>(static_cast<u64>(a) << shift);
+			i64 remainder = 0;
+			return _div128(high, low, b, &remainder);
+#else
+			return static_cast<i64>((static_cast<__int128>(a) * (static_cast<__int128>(1) << shift)) / b);
+#endif
+		}
+
+		constexpr i32 mulShift(i32 a, i32 b, u32 shift)
+		{
+			return static_cast<i32>((static_cast<i64>(a) * b) >> shift);
+		}
+
+		constexpr i32 shiftDiv(i32 a, i32 b, u32 shift)
+		{
+			return static_cast<i32>((static_cast<i64>(a) * (i64(1) << shift)) / b);
+		}
+	}
+
+	// Signed fixed point number with FractionBits bits of fraction.
+	// Every operation is integer only, so results are bit identical on every platform and compiler.
+	// Multiplication rounds towards negative infinity, division truncates towards zero.
+	template<typename Storage, u32 FractionBits>
+	class Fixed
+	{
+		static_assert(std::is_same_v<Storage, i32> || std::is_same_v<Storage, i64>, "Fixed only supports i32 and i64 storage.");
+		static_assert(FractionBits > 0 && FractionBits < sizeof(Storage) * 8 - 1, "Invalid amount of fraction bits.");
+
+	public:
+		using StorageType = Storage;
+
+		static constexpr u32 k_fractionBits = FractionBits;
+		static constexpr Storage k_oneRaw = Storage(1) << FractionBits;
+
+		Fixed() = default;
+		constexpr explicit Fixed(i32 value) : m_raw(static_cast<Storage>(value) * k_oneRaw) {}
+
+		static constexpr Fixed fromRaw(Storage raw)
+		{
+			Fixed result{};
+			result.m_raw = raw;
+			return result;
+		}
+
+		// Float conversions are meant for tooling and presentation only, never for simulation input.
+		static constexpr Fixed fromFloat(f64 value)
+		{
+			const f64 scaled = value * static_cast<f64>(k_oneRaw);
+			return fromRaw(static_cast<Storage>(scaled + (scaled >= 0.0 ? 0.5 : -0.5)));
+		}
+
+		constexpr Storage raw() const { return m_raw; }
+		constexpr f32 toFloat() const { return static_cast<f32>(m_raw) / static_cast<f32>(k_oneRaw); }
+		constexpr f64 toDouble() const { return static_cast<f64>(m_raw) / static_cast<f64>(k_oneRaw); }
+
+		constexpr Fixed operator-() const { return fromRaw(-m_raw); }
+
+		constexpr Fixed operator+(Fixed other) const { return fromRaw(m_raw + other.m_raw); }
+		constexpr Fixed operator-(Fixed other) const { return fromRaw(m_raw - other.m_raw); }
+		constexpr Fixed operator*(Fixed other) const { return fromRaw(detail::mulShift(m_raw, other.m_raw, FractionBits)); }
+		constexpr Fixed operator/(Fixed other) const
+		{
+			assert(other.m_raw != 0);
+			return fromRaw(detail::shiftDiv(m_raw, other.m_raw, FractionBits));
+		}
+
+		constexpr Fixed &operator+=(Fixed other) { m_raw += other.m_raw; return *this; }
+		constexpr Fixed &operator-=(Fixed other) { m_raw -= other.m_raw; return *this; }
+		constexpr Fixed &operator*=(Fixed other) { return *this = *this * other; }
+		constexpr Fixed &operator/=(Fixed other) { return *this = *this / other; }
+
+		constexpr bool operator==(Fixed other) const { return m_raw == other.m_raw; }
+		constexpr bool operator!=(Fixed other) const { return m_raw != other.m_raw; }
+		constexpr bool operator<(Fixed other) const { return m_raw < other.m_raw; }
+		constexpr bool operator<=(Fixed other) const { return m_raw <= other.m_raw; }
+		constexpr bool operator>(Fixed other) const { return m_raw > other.m_raw; }
+		constexpr bool operator>=(Fixed other) const { return m_raw >= other.m_raw; }
+
+		friend constexpr Fixed abs(Fixed value) { return value.m_raw < 0 ? -value : value; }
+
+		// Newton-Raphson on the raw integer, starting above the root so it converges monotonically.
+		// Returns the largest representable value that is not greater than the real square root.
+		friend constexpr Fixed sqrt(Fixed value)
+		{
+			assert(value.m_raw >= 0);
+			if (value.m_raw <= 0)
+				return Fixed(0);
+
+			u32 bitCount = 0;
+			for (Storage bits = value.m_raw; bits != 0; bits >>= 1)
+				++bitCount;
+
+			Storage current = Storage(1) << ((bitCount + FractionBits + 1) / 2);
+			Storage next = (current + detail::shiftDiv(value.m_raw, current, FractionBits)) / 2;
+			while (next < current)
+			{
+				current = next;
+				next = (current + detail::shiftDiv(value.m_raw, current, FractionBits)) / 2;
+			}
+
+			return fromRaw(current);
+		}
+
+	private:
+		Storage m_raw;
+	};
+
+	using Q16_16 = Fixed<i32, 16>;
+	using Q32_32 = Fixed<i64, 32>;
+}
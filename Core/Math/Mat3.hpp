@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Core/Types.hpp"
+#include "Core/Math/Vec2.hpp"
+
+namespace core::math
+{
+	// Row major 3x3 matrix, used as a 2D affine transform acting on column vectors.
+	// Points transform with an implicit w of one, vectors with a w of zero.
+	template<typename T>
+	struct Mat3
+	{
+		T m[3][3];
+
+		static constexpr Mat3 identity()
+		{
+			return Mat3{ { { T(1), T(0), T(0) }, { T(0), T(1), T(0) }, { T(0), T(0), T(1) } } };
+		}
+
+		static constexpr Mat3 translation(const Vec2<T> &offset)
+		{
+			return Mat3{ { { T(1), T(0), offset.x }, { T(0), T(1), offset.y }, { T(0), T(0), T(1) } } };
+		}
+
+		static constexpr Mat3 scale(const Vec2<T> &factors)
+		{
+			return Mat3{ { { factors.x, T(0), T(0) }, { T(0), factors.y, T(0) }, { T(0), T(0), T(1) } } };
+		}
+
+		// Counter clockwise rotation. Takes the cosine and sine so fixed point callers stay deterministic.
+		static constexpr Mat3 rotation(T cosine, T sine)
+		{
+			return Mat3{ { { cosine, -sine, T(0) }, { sine, cosine, T(0) }, { T(0), T(0), T(1) } } };
+		}
+
+		// Scale, then rotate, then translate.
+		static constexpr Mat3 transform(const Vec2<T> &position, T cosine, T sine, const Vec2<T> &factors)
+		{
+			return Mat3{ {
+				{ cosine * factors.x, -sine * factors.y, position.x },
+				{ sine * factors.x, cosine * factors.y, position.y },
+				{ T(0), T(0), T(1) } } };
+		}
+
+		constexpr T operator()(usize row, usize column) const { return m[row][column]; }
+		constexpr T &operator()(usize row, usize column) { return m[row][column]; }
+
+		constexpr Mat3 operator*(const Mat3 &other) const
+		{
+			Mat3 result{};
+			for (usize row = 0; row < 3; ++row)
+				for (usize column = 0; column < 3; ++column)
+					result.m[row][column] = m[row][0] * other.m[0][column] + m[row][1] * other.m[1][column] + m[row][2] * other.m[2][column];
+
+			return result;
+		}
+
+		constexpr Mat3 &operator*=(const Mat3 &other) { return *this = *this * other; }
+
+		constexpr bool operator==(const Mat3 &other) const
+		{
+			for (usize row = 0; row < 3; ++row)
+				for (usize column = 0; column < 3; ++column)
+					if (m[row][column] != other.m[row][column])
+						return false;
+
+			return true;
+		}
+
+		constexpr bool operator!=(const Mat3 &other) const { return !(*this == other); }
+
+		constexpr Vec2<T> transformPoint(const Vec2<T> &point) const
+		{
+			return Vec2<T>(m[0][0] * point.x + m[0][1] * point.y + m[0][2], m[1][0] * point.x + m[1][1] * point.y + m[1][2]);
+		}
+
+		constexpr Vec2<T> transformVector(const Vec2<T> &vector) const
+		{
+			return Vec2<T>(m[0][0] * vector.x + m[0][1] * vector.y, m[1][0] * vector.x + m[1][1] * vector.y);
+		}
+
+		constexpr Mat3 transposed() const
+		{
+			Mat3 result{};
+			for (usize row = 0; row < 3; ++row)
+				for (usize column = 0; column < 3; ++column)
+					result.m[row][column] = m[column][row];
+
+			return result;
+		}
+
+		constexpr T determinant() const
+		{
+			return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+				- m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+				+ m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+		}
+
+		// The matrix must be invertible.
+		constexpr Mat3 inverse() const
+		{
+			const T invDeterminant = T(1) / determinant();
+
+			Mat3 result{};
+			result.m[0][0] = (m[1][1] * m[2][2] - m[1][2] * m[2][1]) * invDeterminant;
+			result.m[0][1] = (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * invDeterminant;
+			result.m[0][2] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * invDeterminant;
+			result.m[1][0] = (m[1][2] * m[2][0] - m[1][0] * m[2][2]) * invDeterminant;
+			result.m[1][1] = (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * invDeterminant;
+			result.m[1][2] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * invDeterminant;
+			result.m[2][0] = (m[1][0] * m[2][1] - m[1][1] * m[2][0]) * invDeterminant;
+			result.m[2][1] = (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * invDeterminant;
+			result.m[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * invDeterminant;
+			return result;
+		}
+	};
+
+	using Mat3f = Mat3<f32>;
+	using Mat3Q16 = Mat3<Q16_16>;
+	using Mat3Q32 = Mat3<Q32_32>;
+}
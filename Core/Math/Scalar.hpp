@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+#include "Core/Platform.hpp"
+#include "Core/Types.hpp"
+
+namespace core::math
+{
+	namespace detail
+	{
+		constexpr f64 sqrtNewton(f64 value)
+		{
+			if (value != value || value < 0.0)
+				return std::numeric_limits<f64>::quiet_NaN();
+			if (value == 0.0 || value == std::numeric_limits<f64>::infinity())
+				return value;
+
+			// Newton-Raphson until the estimate stops changing or starts to oscillate between two neighbours.
+			f64 current = value > 1.0 ? value : 1.0;
+			f64 previous = 0.0;
+			while (current != previous)
+			{
+				const f64 next = 0.5 * (current + value / current);
+				if (next == previous)
+					return current < next ? current : next;
+
+				previous = current;
+				current = next;
+			}
+
+			return current;
+		}
+	}
+
+	// Scalar helpers usable in constant expressions. At run time they map to the C runtime and intrinsics.
+
+	constexpr f64 sqrt(f64 value)
+	{
+		if (CORE_IS_CONSTANT_EVALUATED())
+			return detail::sqrtNewton(value);
+
+		return std::sqrt(value);
+	}
+
+	constexpr f32 sqrt(f32 value)
+	{
+		if (CORE_IS_CONSTANT_EVALUATED())
+			return static_cast<f32>(detail::sqrtNewton(value));
+
+		return std::sqrt(value);
+	}
+
+	constexpr f32 min(f32 a, f32 b) { return a < b ? a : b; }
+	constexpr f32 max(f32 a, f32 b) { return a > b ? a : b; }
+	constexpr f32 abs(f32 a) { return a < 0.0f ? -a : a; }
+
+	constexpr bool lessThan(f32 a, f32 b) { return a < b; }
+	constexpr bool greaterThan(f32 a, f32 b) { return a > b; }
+	constexpr f32 select(bool mask, f32 a, f32 b) { return mask ? a : b; }
+
+	// Rounds to nearest, ties to even, matching the SIMD conversion. The result must fit in an i32.
+	constexpr i32 roundToInt(f32 a)
+	{
+		if (CORE_IS_CONSTANT_EVALUATED())
+		{
+			const i32 truncated = static_cast<i32>(a);
+			const f32 fraction = a - static_cast<f32>(truncated);
+			const i32 away = a < 0.0f ? truncated - 1 : truncated + 1;
+			const f32 half = a < 0.0f ? -fraction : fraction;
+			if (half > 0.5f || (half == 0.5f && away % 2 == 0))
+				return away;
+
+			return truncated;
+		}
+
+		return static_cast<i32>(std::nearbyint(a));
+	}
+
+	constexpr f32 toFloat(i32 a) { return static_cast<f32>(a); }
+	constexpr f32 asFloat(i32 a) { return bitCast<f32>(a); }
+	constexpr i32 asInt(f32 a) { return bitCast<i32>(a); }
+	template<i32 Bits>
+	constexpr i32 shiftLeft(i32 a) { return static_cast<i32>(static_cast<u32>(a) << Bits); }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cmath>
+#include <cstring>
+
+#include "Core/Types.hpp"
+#include "Core/Math/Scalar.hpp"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define CORE_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define CORE_SIMD_SSE2 0
+#endif
+
+namespace core::math
+{
+	// Four float lanes. Maps to SSE2 on x64 and falls back to plain loops elsewhere.
+	// Kernels written against the free functions below also compile for plain f32 through Scalar.hpp.
+	// Comparisons return lane masks (all bits set or clear) meant to be consumed by select.
+	struct F32x4
+	{
+#if CORE_SIMD_SSE2
+		__m128 v;
+
+		F32x4() = default;
+		F32x4(__m128 value) : v(value) {}
+		F32x4(f32 value) : v(_mm_set1_ps(value)) {}
+		F32x4(f32 a, f32 b, f32 c, f32 d) : v(_mm_setr_ps(a, b, c, d)) {}
+
+		static F32x4 load(const f32 *data) { return _mm_loadu_ps(data); }
+		void store(f32 *data) const { _mm_storeu_ps(data, v); }
+#else
+		f32 v[4];
+
+		F32x4() = default;
+		F32x4(f32 value) : v{ value, value, value, value } {}
+		F32x4(f32 a, f32 b, f32 c, f32 d) : v{ a, b, c, d } {}
+
+		static F32x4 load(const f32 *data) { return F32x4(data[0], data[1], data[2], data[3]); }
+		void store(f32 *data) const { std::memcpy(data, v, sizeof(v)); }
+#endif
+		static constexpr usize k_width = 4;
+	};
+
+	// Four 32 bit integer lanes, used for bit manipulation of F32x4.
+	struct I32x4
+	{
+#if CORE_SIMD_SSE2
+		__m128i v;
+
+		I32x4() = default;
+		I32x4(__m128i value) : v(value) {}
+		I32x4(i32 value) : v(_mm_set1_epi32(value)) {}
+#else
+		i32 v[4];
+
+		I32x4() = default;
+		I32x4(i32 value) : v{ value, value, value, value } {}
+#endif
+	};
+
+#if CORE_SIMD_SSE2
+	inline F32x4 operator+(F32x4 a, F32x4 b) { return _mm_add_ps(a.v, b.v); }
+	inline F32x4 operator-(F32x4 a, F32x4 b) { return _mm_sub_ps(a.v, b.v); }
+	inline F32x4 operator*(F32x4 a, F32x4 b) { return _mm_mul_ps(a.v, b.v); }
+	inline F32x4 operator/(F32x4 a, F32x4 b) { return _mm_div_ps(a.v, b.v); }
+	inline F32x4 operator-(F32x4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+	inline F32x4 min(F32x4 a, F32x4 b) { return _mm_min_ps(a.v, b.v); }
+	inline F32x4 max(F32x4 a, F32x4 b) { return _mm_max_ps(a.v, b.v); }
+	inline F32x4 abs(F32x4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+	inline F32x4 sqrt(F32x4 a) { return _mm_sqrt_ps(a.v); }
+	// Relative error below 1.5 * 2^-12.
+	inline F32x4 rsqrtApprox(F32x4 a) { return _mm_rsqrt_ps(a.v); }
+
+	inline F32x4 lessThan(F32x4 a, F32x4 b) { return _mm_cmplt_ps(a.v, b.v); }
+	inline F32x4 greaterThan(F32x4 a, F32x4 b) { return _mm_cmpgt_ps(a.v, b.v); }
+	inline F32x4 select(F32x4 mask, F32x4 a, F32x4 b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+
+	// Rounds to nearest, ties to even. Every lane must round to a value that fits in an i32.
+	inline I32x4 roundToInt(F32x4 a) { return _mm_cvtps_epi32(a.v); }
+	inline F32x4 toFloat(I32x4 a) { return _mm_cvtepi32_ps(a.v); }
+	inline F32x4 asFloat(I32x4 a) { return _mm_castsi128_ps(a.v); }
+	inline I32x4 asInt(F32x4 a) { return _mm_castps_si128(a.v); }
+
+	inline I32x4 operator+(I32x4 a, I32x4 b) { return _mm_add_epi32(a.v, b.v); }
+	inline I32x4 operator-(I32x4 a, I32x4 b) { return _mm_sub_epi32(a.v, b.v); }
+	template<i32 Bits>
+	I32x4 shiftLeft(I32x4 a) { return _mm_slli_epi32(a.v, Bits); }
+#else
+	namespace detail
+	{
+		template<typename Result, typename Op>
+		Result perLane(Op op)
+		{
+			Result result;
+			for (usize i = 0; i < 4; ++i)
+				result.v[i] = op(i);
+			return result;
+		}
+	}
+
+	inline F32x4 operator+(F32x4 a, F32x4 b) { return detail::perLane<F32x4>([&](usize i) { return a.v[i] + b.v[i]; }); }
+	inline F32x4 operator-(F32x4 a, F32x4 b) { return detail::perLane<F32x4>([&](usize i) { return a.v[i] - b.v[i]; }); }
+	inline F32x4 operator*(F32x4 a, F32x4 b) { return detail::perLane<F32x4>([&](usize i) { return a.v[i] * b.v[i]; }); }
+	inline F32x4 operator/(F32x4 a, F32x4 b) { return detail::perLane<F32x4>([&](usize i) { return a.v[i] / b.v[i]; }); }
+	inline F32x4 operator-(F32x4 a) { return detail::perLane<F32x4>([&](usize i) { return -a.v[i]; }); }
+
+	inline F32x4 min(F32x4 a, F32x4 b) { return detail::perLane<F32x4>([&](usize i) { return a.v[i] < b.v[i] ? a.v[i] : b.v[i]; }); }
+	inline F32x4 max(F32x4 a, F32x4 b) { return detail::perLane<F32x4>([&](usize i) { return a.v[i] > b.v[i] ? a.v[i] : b.v[i]; }); }
+	inline F32x4 abs(F32x4 a) { return detail::perLane<F32x4>([&](usize i) { return std::fabs(a.v[i]); }); }
+	inline F32x4 sqrt(F32x4 a) { return detail::perLane<F32x4>([&](usize i) { return std::sqrt(a.v[i]); }); }
+	inline F32x4 rsqrtApprox(F32x4 a) { return detail::perLane<F32x4>([&](usize i) { return 1.0f / std::sqrt(a.v[i]); }); }
+
+	inline I32x4 roundToInt(F32x4 a) { return detail::perLane<I32x4>([&](usize i) { return static_cast<i32>(std::nearbyint(a.v[i])); }); }
+	inline F32x4 toFloat(I32x4 a) { return detail::perLane<F32x4>([&](usize i) { return static_cast<f32>(a.v[i]); }); }
+	inline F32x4 asFloat(I32x4 a) { F32x4 result; std::memcpy(result.v, a.v, sizeof(result.v)); return result; }
+	inline I32x4 asInt(F32x4 a) { I32x4 result; std::memcpy(result.v, a.v, sizeof(result.v)); return result; }
+
+	inline F32x4 lessThan(F32x4 a, F32x4 b) { return asFloat(detail::perLane<I32x4>([&](usize i) { return a.v[i] < b.v[i] ? -1 : 0; })); }
+	inline F32x4 greaterThan(F32x4 a, F32x4 b) { return asFloat(detail::perLane<I32x4>([&](usize i) { return a.v[i] > b.v[i] ? -1 : 0; })); }
+	inline F32x4 select(F32x4 mask, F32x4 a, F32x4 b)
+	{
+		const I32x4 bits = asInt(mask);
+		return detail::perLane<F32x4>([&](usize i) { return bits.v[i] != 0 ? a.v[i] : b.v[i]; });
+	}
+
+	inline I32x4 operator+(I32x4 a, I32x4 b) { return detail::perLane<I32x4>([&](usize i) { return a.v[i] + b.v[i]; }); }
+	inline I32x4 operator-(I32x4 a, I32x4 b) { return detail::perLane<I32x4>([&](usize i) { return a.v[i] - b.v[i]; }); }
+	template<i32 Bits>
+	I32x4 shiftLeft(I32x4 a) { return detail::perLane<I32x4>([&](usize i) { return static_cast<i32>(static_cast<u32>(a.v[i]) << Bits); }); }
+#endif
+
+	// Scalar counterpart of rsqrtApprox, the remaining scalar helpers live in Scalar.hpp.
+	constexpr f32 rsqrtApprox(f32 a)
+	{
+#if CORE_SIMD_SSE2
+		if (!CORE_IS_CONSTANT_EVALUATED())
+			return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(a)));
+#endif
+		return 1.0f / sqrt(a);
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <array>
+
+#include "Core/Types.hpp"
+
+namespace core::math
+{
+	// Builds a lookup table by calling generator with every index.
+	// Assign the result to a constexpr variable and the table is baked into the binary.
+	template<usize Size, typename Generator>
+	constexpr auto makeTable(Generator generator)
+	{
+		std::array<decltype(generator(usize(0))), Size> table{};
+		for (usize i = 0; i < Size; ++i)
+			table[i] = generator(i);
+
+		return table;
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core/Types.hpp"
+#include "Core/Math/Fixed.hpp"
+#include "Core/Math/Scalar.hpp"
+
+namespace core::math
+{
+	// Two dimensional vector over any scalar providing the arithmetic operators and a sqrt overload.
+	// Usable in constant expressions for f32 and the fixed point scalars.
+	// Use Vec2f for presentation and the fixed point variants for anything that must simulate in lockstep.
+	template<typename T>
+	struct Vec2
+	{
+		T x;
+		T y;
+
+		Vec2() = default;
+		constexpr Vec2(T xValue, T yValue) : x(xValue), y(yValue) {}
+
+		static constexpr Vec2 zero() { return Vec2(T(0), T(0)); }
+
+		constexpr Vec2 operator-() const { return Vec2(-x, -y); }
+
+		constexpr Vec2 operator+(const Vec2 &other) const { return Vec2(x + other.x, y + other.y); }
+		constexpr Vec2 operator-(const Vec2 &other) const { return Vec2(x - other.x, y - other.y); }
+		constexpr Vec2 operator*(T scalar) const { return Vec2(x * scalar, y * scalar); }
+		constexpr Vec2 operator/(T scalar) const { return Vec2(x / scalar, y / scalar); }
+
+		constexpr Vec2 &operator+=(const Vec2 &other) { x += other.x; y += other.y; return *this; }
+		constexpr Vec2 &operator-=(const Vec2 &other) { x -= other.x; y -= other.y; return *this; }
+		constexpr Vec2 &operator*=(T scalar) { x *= scalar; y *= scalar; return *this; }
+		constexpr Vec2 &operator/=(T scalar) { x /= scalar; y /= scalar; return *this; }
+
+		constexpr bool operator==(const Vec2 &other) const { return x == other.x && y == other.y; }
+		constexpr bool operator!=(const Vec2 &other) const { return !(*this == other); }
+
+		friend constexpr Vec2 operator*(T scalar, const Vec2 &vec) { return vec * scalar; }
+
+		constexpr T lengthSquared() const { return x * x + y * y; }
+
+		constexpr T length() const
+		{
+			return sqrt(lengthSquared());
+		}
+
+		// Returns the zero vector when the length is zero.
+		constexpr Vec2 normalized() const
+		{
+			const T len = length();
+			if (len == T(0))
+				return zero();
+
+			return *this / len;
+		}
+	};
+
+	template<typename T>
+	constexpr T dot(const Vec2<T> &a, const Vec2<T> &b) { return a.x * b.x + a.y * b.y; }
+
+	// Z component of the 3D cross product of a and b.
+	template<typename T>
+	constexpr T cross(const Vec2<T> &a, const Vec2<T> &b) { return a.x * b.y - a.y * b.x; }
+
+	template<typename T>
+	constexpr T distance(const Vec2<T> &a, const Vec2<T> &b) { return (b - a).length(); }
+
+	template<typename T>
+	constexpr Vec2<T> perpendicular(const Vec2<T> &vec) { return Vec2<T>(-vec.y, vec.x); }
+
+	template<typename T>
+	constexpr Vec2<T> lerp(const Vec2<T> &a, const Vec2<T> &b, T t) { return a + (b - a) * t; }
+
+	using Vec2f = Vec2<f32>;
+	using Vec2Q16 = Vec2<Q16_16>;
+	using Vec2Q32 = Vec2<Q32_32>;
+}
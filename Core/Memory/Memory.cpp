@@ -0,0 +1,190 @@
+#include "Core/Memory/Memory.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <iomanip>
+#include <iterator>
+#include <ostream>
+
+#if CORE_MEMORY_TRACK_ALLOCATIONS
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#endif
+
+namespace core::memory
+{
+	namespace
+	{
+		constexpr usize k_tagCount = static_cast<usize>(Tag::Count);
+
+		// One cache line per tag, so subsystems on different threads do not contend on the same line.
+		struct alignas(64) TagCounters
+		{
+			std::atomic<i64> liveBytes{ 0 };
+			std::atomic<i64> highWaterBytes{ 0 };
+			std::atomic<i64> budgetBytes{ 0 };
+#if CORE_MEMORY_TRACK_ALLOCATIONS
+			std::atomic<bool> warnedOverBudget{ false };
+#endif
+		};
+
+		TagCounters s_counters[k_tagCount];
+
+		const char *const k_tagNames[] = {
+			"General",
+			"Containers",
+			"Jobs",
+			"IO",
+			"Assets",
+			"Render",
+			"Scene",
+			"Net",
+			"Audio",
+		};
+		static_assert(std::size(k_tagNames) == k_tagCount, "Every tag needs a name.");
+
+#if CORE_MEMORY_TRACK_ALLOCATIONS
+		struct AllocationRecord
+		{
+			usize size;
+			Tag tag;
+		};
+
+		struct Registry
+		{
+			std::mutex mutex;
+			std::unordered_map<void *, AllocationRecord> allocations;
+		};
+
+		// Never destroyed, so allocations released by static destructors can still unregister.
+		Registry &registry()
+		{
+			static Registry *instance = new Registry();
+			return *instance;
+		}
+#endif
+
+		TagCounters &counters(Tag tag)
+		{
+			assert(tag < Tag::Count);
+			return s_counters[static_cast<usize>(tag)];
+		}
+
+		void add(Tag tag, i64 bytes)
+		{
+			TagCounters &tagCounters = counters(tag);
+			const i64 live = tagCounters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+			// Plain load on the common path, the compare exchange only runs when a new peak is reached.
+			i64 highWater = tagCounters.highWaterBytes.load(std::memory_order_relaxed);
+			while (live > highWater && !tagCounters.highWaterBytes.compare_exchange_weak(highWater, live, std::memory_order_relaxed)) {}
+
+#if CORE_MEMORY_TRACK_ALLOCATIONS
+			const i64 budget = tagCounters.budgetBytes.load(std::memory_order_relaxed);
+			if (budget > 0 && live > budget && !tagCounters.warnedOverBudget.exchange(true, std::memory_order_relaxed))
+				std::cerr << "[Memory] " << tagName(tag) << " is over budget: " << live << " of " << budget << " bytes.\n";
+#endif
+		}
+	}
+
+	const char *tagName(Tag tag)
+	{
+		return k_tagNames[static_cast<usize>(tag)];
+	}
+
+	void *allocate(usize size, Tag tag, usize alignment)
+	{
+		void *pointer = ::operator new(size, std::align_val_t(alignment));
+		add(tag, static_cast<i64>(size));
+
+#if CORE_MEMORY_TRACK_ALLOCATIONS
+		Registry &allocations = registry();
+		std::lock_guard<std::mutex> lock(allocations.mutex);
+		allocations.allocations.emplace(pointer, AllocationRecord{ size, tag });
+#endif
+
+		return pointer;
+	}
+
+	void deallocate(void *pointer, usize size, Tag tag, usize alignment)
+	{
+		if (pointer == nullptr)
+			return;
+
+#if CORE_MEMORY_TRACK_ALLOCATIONS
+		{
+			Registry &allocations = registry();
+			std::lock_guard<std::mutex> lock(allocations.mutex);
+			const auto record = allocations.allocations.find(pointer);
+			assert(record != allocations.allocations.end() && "Deallocating memory that was not allocated through core::memory.");
+			assert(record->second.size == size && record->second.tag == tag && "Deallocation does not match its allocation.");
+			allocations.allocations.erase(record);
+		}
+#endif
+
+		add(tag, -static_cast<i64>(size));
+		::operator delete(pointer, size, std::align_val_t(alignment));
+	}
+
+	void trackAllocation(usize size, Tag tag)
+	{
+		add(tag, static_cast<i64>(size));
+	}
+
+	void trackDeallocation(usize size, Tag tag)
+	{
+		add(tag, -static_cast<i64>(size));
+	}
+
+	TagStats stats(Tag tag)
+	{
+		const TagCounters &tagCounters = counters(tag);
+		return TagStats{
+			tagCounters.liveBytes.load(std::memory_order_relaxed),
+			tagCounters.highWaterBytes.load(std::memory_order_relaxed),
+			tagCounters.budgetBytes.load(std::memory_order_relaxed)
+		};
+	}
+
+	void setBudget(Tag tag, i64 bytes)
+	{
+		counters(tag).budgetBytes.store(bytes, std::memory_order_relaxed);
+	}
+
+	void report(std::ostream &out)
+	{
+		out << std::left << std::setw(12) << "Tag" << std::right << std::setw(16) << "Live" << std::setw(16) << "High water" << std::setw(16) << "Budget" << '\n';
+		for (usize i = 0; i < k_tagCount; ++i)
+		{
+			const TagStats tagStats = stats(static_cast<Tag>(i));
+			out << std::left << std::setw(12) << k_tagNames[i] << std::right
+				<< std::setw(16) << tagStats.liveBytes
+				<< std::setw(16) << tagStats.highWaterBytes
+				<< std::setw(16) << tagStats.budgetBytes << '\n';
+		}
+	}
+
+	bool reportLeaks(std::ostream &out)
+	{
+		bool clean = true;
+		for (usize i = 0; i < k_tagCount; ++i)
+		{
+			const i64 liveBytes = stats(static_cast<Tag>(i)).liveBytes;
+			if (liveBytes == 0)
+				continue;
+
+			out << "[Memory] " << k_tagNames[i] << " leaked " << liveBytes << " bytes.\n";
+			clean = false;
+		}
+
+#if CORE_MEMORY_TRACK_ALLOCATIONS
+		Registry &allocations = registry();
+		std::lock_guard<std::mutex> lock(allocations.mutex);
+		for (const auto &[pointer, record] : allocations.allocations)
+			out << "[Memory]   " << tagName(record.tag) << ' ' << record.size << " bytes at " << pointer << '\n';
+#endif
+
+		return clean;
+	}
+}
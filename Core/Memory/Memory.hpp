@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <new>
+#include <utility>
+
+#include "Core/Types.hpp"
+
+// Debug builds remember every live allocation so leaks can be listed one by one.
+// Release builds only keep the per tag counters.
+#if defined(_DEBUG) && !defined(CORE_MEMORY_TRACK_ALLOCATIONS)
+#define CORE_MEMORY_TRACK_ALLOCATIONS 1
+#endif
+
+namespace core::memory
+{
+	// Subsystem owning an allocation. Every Core allocation is attributed to one of these.
+	enum class Tag : u8
+	{
+		General,
+		Containers,
+		Jobs,
+		IO,
+		Assets,
+		Render,
+		Scene,
+		Net,
+		Audio,
+		Count
+	};
+
+	const char *tagName(Tag tag);
+
+	struct TagStats
+	{
+		i64 liveBytes;
+		i64 highWaterBytes;
+		i64 budgetBytes;	// Zero when the tag has no budget.
+	};
+
+	// The size must be passed back on deallocation. Not having to store it keeps tracking down to one atomic add.
+	void *allocate(usize size, Tag tag, usize alignment = alignof(std::max_align_t));
+	void deallocate(void *pointer, usize size, Tag tag, usize alignment = alignof(std::max_align_t));
+
+	// Attributes memory that is not obtained through allocate, such as committed virtual memory.
+	void trackAllocation(usize size, Tag tag);
+	void trackDeallocation(usize size, Tag tag);
+
+	TagStats stats(Tag tag);
+
+	// Debug builds warn once when a tag goes over its budget. Zero removes the budget.
+	void setBudget(Tag tag, i64 bytes);
+
+	// Writes live and high water bytes of every tag.
+	void report(std::ostream &out);
+
+	// Writes every tag that still holds memory and, when allocations are tracked, every live allocation.
+	// Returns true when nothing leaked.
+	bool reportLeaks(std::ostream &out);
+
+	template<typename T, typename... Args>
+	T *create(Tag tag, Args &&...args)
+	{
+		void *memory = allocate(sizeof(T), tag, alignof(T));
+		return new (memory) T(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	void destroy(T *object, Tag tag)
+	{
+		if (object == nullptr)
+			return;
+
+		object->~T();
+		deallocate(object, sizeof(T), tag, alignof(T));
+	}
+
+	// Standard library compatible allocator, so std containers inside Core are attributed to a tag.
+	template<typename T, Tag AllocationTag = Tag::Containers>
+	struct TaggedAllocator
+	{
+		using value_type = T;
+
+		template<typename Other>
+		struct rebind
+		{
+			using other = TaggedAllocator<Other, AllocationTag>;
+		};
+
+		TaggedAllocator() = default;
+		template<typename Other>
+		TaggedAllocator(const TaggedAllocator<Other, AllocationTag> &) {}
+
+		T *allocate(usize count) { return static_cast<T *>(memory::allocate(count * sizeof(T), AllocationTag, alignof(T))); }
+		void deallocate(T *pointer, usize count) { memory::deallocate(pointer, count * sizeof(T), AllocationTag, alignof(T)); }
+
+		template<typename Other>
+		bool operator==(const TaggedAllocator<Other, AllocationTag> &) const { return true; }
+		template<typename Other>
+		bool operator!=(const TaggedAllocator<Other, AllocationTag> &) const { return false; }
+	};
+}
@@ -0,0 +1,70 @@
+#include "Core/Memory/VirtualMemory.hpp"
+
+#include "Core/Platform.hpp"
+
+#if CORE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace core::memory
+{
+	usize pageSize()
+	{
+#if CORE_PLATFORM_WINDOWS
+		static const usize size = []()
+		{
+			SYSTEM_INFO info;
+			GetSystemInfo(&info);
+			return static_cast<usize>(info.dwPageSize);
+		}();
+#else
+		static const usize size = static_cast<usize>(sysconf(_SC_PAGESIZE));
+#endif
+		return size;
+	}
+
+	void *reserveAddressSpace(usize bytes)
+	{
+#if CORE_PLATFORM_WINDOWS
+		return VirtualAlloc(nullptr, bytes, MEM_RESERVE, PAGE_NOACCESS);
+#else
+		void *address = mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		return address == MAP_FAILED ? nullptr : address;
+#endif
+	}
+
+	bool commitPages(void *address, usize bytes)
+	{
+#if CORE_PLATFORM_WINDOWS
+		return VirtualAlloc(address, bytes, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+		return mprotect(address, bytes, PROT_READ | PROT_WRITE) == 0;
+#endif
+	}
+
+	void decommitPages(void *address, usize bytes)
+	{
+#if CORE_PLATFORM_WINDOWS
+		VirtualFree(address, bytes, MEM_DECOMMIT);
+#else
+		// Drop the pages first, so a later commit sees zeroed memory like it does on Windows.
+		madvise(address, bytes, MADV_DONTNEED);
+		mprotect(address, bytes, PROT_NONE);
+#endif
+	}
+
+	void releaseAddressSpace(void *address, usize bytes)
+	{
+#if CORE_PLATFORM_WINDOWS
+		(void)bytes;
+		VirtualFree(address, 0, MEM_RELEASE);
+#else
+		munmap(address, bytes);
+#endif
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+namespace core::memory
+{
+	// Granularity of commit and decommit.
+	usize pageSize();
+
+	// Reserves address space without backing memory. Returns nullptr on failure.
+	void *reserveAddressSpace(usize bytes);
+
+	// Backs a page aligned range of a reservation with zeroed read/write memory. Returns false on failure.
+	bool commitPages(void *address, usize bytes);
+
+	// Returns the memory of a page aligned range to the system, keeping the addresses reserved.
+	void decommitPages(void *address, usize bytes);
+
+	// Releases a whole reservation. Bytes must be the size passed to reserveAddressSpace.
+	void releaseAddressSpace(void *address, usize bytes);
+
+	inline usize alignToPage(usize bytes)
+	{
+		const usize page = pageSize();
+		return (bytes + page - 1) / page * page;
+	}
+}
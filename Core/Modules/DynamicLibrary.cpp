@@ -0,0 +1,72 @@
+#include "Core/Modules/DynamicLibrary.hpp"
+
+#include <utility>
+
+#include "Core/Platform.hpp"
+
+#if CORE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace core::modules
+{
+	DynamicLibrary::DynamicLibrary(DynamicLibrary &&other) noexcept
+		: m_handle(std::exchange(other.m_handle, nullptr))
+	{}
+
+	DynamicLibrary &DynamicLibrary::operator=(DynamicLibrary &&other) noexcept
+	{
+		if (this != &other)
+		{
+			close();
+			m_handle = std::exchange(other.m_handle, nullptr);
+		}
+
+		return *this;
+	}
+
+#if CORE_PLATFORM_WINDOWS
+	bool DynamicLibrary::open(const char *path)
+	{
+		close();
+		m_handle = LoadLibraryA(path);
+		return m_handle != nullptr;
+	}
+
+	void DynamicLibrary::close()
+	{
+		if (m_handle != nullptr)
+			FreeLibrary(static_cast<HMODULE>(m_handle));
+		m_handle = nullptr;
+	}
+
+	void *DynamicLibrary::symbol(const char *name) const
+	{
+		return reinterpret_cast<void *>(GetProcAddress(static_cast<HMODULE>(m_handle), name));
+	}
+#else
+	bool DynamicLibrary::open(const char *path)
+	{
+		close();
+		// Local symbols, so two builds of one module can be loaded side by side during a reload.
+		m_handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+		return m_handle != nullptr;
+	}
+
+	void DynamicLibrary::close()
+	{
+		if (m_handle != nullptr)
+			dlclose(m_handle);
+		m_handle = nullptr;
+	}
+
+	void *DynamicLibrary::symbol(const char *name) const
+	{
+		return dlsym(m_handle, name);
+	}
+#endif
+}
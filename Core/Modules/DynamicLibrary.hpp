@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+namespace core::modules
+{
+	// Shared library loaded at run time.
+	class DynamicLibrary
+	{
+	public:
+		DynamicLibrary() = default;
+		~DynamicLibrary() { close(); }
+
+		DynamicLibrary(DynamicLibrary &&other) noexcept;
+		DynamicLibrary &operator=(DynamicLibrary &&other) noexcept;
+		DynamicLibrary(const DynamicLibrary &) = delete;
+		DynamicLibrary &operator=(const DynamicLibrary &) = delete;
+
+		// Returns false when the file is missing or is not a library for this platform.
+		bool open(const char *path);
+		void close();
+		bool isOpen() const { return m_handle != nullptr; }
+
+		// Nullptr when the library exports no such symbol.
+		void *symbol(const char *name) const;
+
+	private:
+		void *m_handle = nullptr;
+	};
+}
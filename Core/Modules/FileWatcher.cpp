@@ -0,0 +1,103 @@
+#include "Core/Modules/FileWatcher.hpp"
+
+#if CORE_PLATFORM_POSIX && defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace core::modules
+{
+#if CORE_PLATFORM_POSIX && defined(__linux__)
+	bool FileWatcher::watch(const char *path)
+	{
+		stop();
+
+		// Build tools often write a new file and rename it over the old one, which a watch on the file itself misses.
+		std::error_code error;
+		const std::filesystem::path file = std::filesystem::absolute(path, error);
+		if (error)
+			return false;
+
+		m_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_descriptor < 0)
+			return false;
+
+		if (inotify_add_watch(m_descriptor, file.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+		{
+			stop();
+			return false;
+		}
+
+		m_path = file;
+		return true;
+	}
+
+	void FileWatcher::stop()
+	{
+		if (m_descriptor >= 0)
+			::close(m_descriptor);
+		m_descriptor = -1;
+		m_path.clear();
+	}
+
+	bool FileWatcher::poll()
+	{
+		if (m_descriptor < 0)
+			return false;
+
+		alignas(inotify_event) char events[4096];
+		const std::filesystem::path name = m_path.filename();
+		bool hasChanged = false;
+		for (;;)
+		{
+			const ssize_t size = ::read(m_descriptor, events, sizeof(events));
+			if (size <= 0)
+				break;
+
+			for (ssize_t offset = 0; offset < size;)
+			{
+				const inotify_event *event = reinterpret_cast<const inotify_event *>(events + offset);
+				if (event->len > 0 && name == event->name)
+					hasChanged = true;
+				offset += sizeof(inotify_event) + event->len;
+			}
+		}
+
+		return hasChanged;
+	}
+#else
+	bool FileWatcher::watch(const char *path)
+	{
+		stop();
+
+		std::error_code error;
+		const std::filesystem::path file = std::filesystem::absolute(path, error);
+		if (error || !std::filesystem::is_directory(file.parent_path(), error))
+			return false;
+
+		m_path = file;
+		m_writeTime = std::filesystem::last_write_time(m_path, error);
+		return true;
+	}
+
+	void FileWatcher::stop()
+	{
+		m_path.clear();
+	}
+
+	bool FileWatcher::poll()
+	{
+		if (m_path.empty())
+			return false;
+
+		// Missing while it is being replaced; the change shows up once the new file is in place.
+		std::error_code error;
+		const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(m_path, error);
+		if (error || writeTime == m_writeTime)
+			return false;
+
+		m_writeTime = writeTime;
+		return true;
+	}
+#endif
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <filesystem>
+
+#include "Core/Platform.hpp"
+#include "Core/Types.hpp"
+
+namespace core::modules
+{
+	// Tells when a file was rewritten or replaced. On Linux inotify reports finished writes and renames into place,
+	// so a file is never seen half written. Elsewhere the file's write time is compared on every poll.
+	class FileWatcher
+	{
+	public:
+		FileWatcher() = default;
+		~FileWatcher() { stop(); }
+
+		FileWatcher(const FileWatcher &) = delete;
+		FileWatcher &operator=(const FileWatcher &) = delete;
+
+		// Returns false when the file's directory cannot be watched.
+		bool watch(const char *path);
+		void stop();
+		bool isWatching() const { return !m_path.empty(); }
+
+		// True when the file changed since the last poll. Never blocks.
+		bool poll();
+
+	private:
+		std::filesystem::path m_path;
+#if CORE_PLATFORM_POSIX && defined(__linux__)
+		int m_descriptor = -1;
+#else
+		std::filesystem::file_time_type m_writeTime;
+#endif
+	};
+}
@@ -0,0 +1,184 @@
+#include "Core/Modules/HotModule.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "Core/Memory/Memory.hpp"
+
+namespace core::modules
+{
+	namespace
+	{
+		constexpr usize k_stateAlignment = 64;
+	}
+
+	HotModule::HotModule(const AngHostApi &host)
+	{
+		m_instances.push_back({ host, nullptr });
+	}
+
+	HotModule::~HotModule()
+	{
+		unload();
+	}
+
+	bool HotModule::load(const char *path)
+	{
+		unload();
+
+		m_path = path;
+		m_api = openCopy(m_library, m_copy);
+		if (m_api == nullptr)
+			return false;
+
+		m_stateSize = m_api->stateSize;
+		m_watcher.watch(path);
+		for (Instance &instance : m_instances)
+		{
+			allocateState(instance);
+			m_api->load(instance.state, &instance.host, false);
+		}
+		return true;
+	}
+
+	void HotModule::unload()
+	{
+		for (Instance &instance : m_instances)
+		{
+			if (m_api != nullptr)
+				m_api->unload(instance.state, &instance.host, false);
+			freeState(instance);
+		}
+		m_api = nullptr;
+
+		m_library.close();
+		removeCopy(m_copy);
+		m_watcher.stop();
+		m_stateSize = 0;
+	}
+
+	bool HotModule::reloadIfChanged()
+	{
+		return m_watcher.poll() && reload();
+	}
+
+	bool HotModule::reload()
+	{
+		if (m_api == nullptr)
+			return false;
+
+		DynamicLibrary library;
+		std::filesystem::path copy;
+		const AngModuleApi *api = openCopy(library, copy);
+		if (api == nullptr)
+		{
+			std::cerr << "[Modules] " << m_path.string() << " failed to load, keeping the running build.\n";
+			return false;
+		}
+
+		for (Instance &instance : m_instances)
+			m_api->unload(instance.state, &instance.host, true);
+
+		if (api->stateSize > m_stateSize)
+		{
+			for (Instance &instance : m_instances)
+			{
+				void *state = memory::allocate(api->stateSize, memory::Tag::General, k_stateAlignment);
+				std::memcpy(state, instance.state, m_stateSize);
+				std::memset(static_cast<u8 *>(state) + m_stateSize, 0, api->stateSize - m_stateSize);
+				memory::deallocate(instance.state, m_stateSize, memory::Tag::General, k_stateAlignment);
+				instance.state = state;
+			}
+			m_stateSize = api->stateSize;
+		}
+
+		// The old code goes once the new one has taken over the state.
+		for (Instance &instance : m_instances)
+			api->load(instance.state, &instance.host, true);
+		m_library = std::move(library);
+		removeCopy(m_copy);
+		m_copy = std::move(copy);
+		m_api = api;
+		++m_reloadCount;
+		return true;
+	}
+
+	u32 HotModule::addInstance(const AngHostApi &host)
+	{
+		Instance &instance = m_instances.emplace_back(Instance{ host, nullptr });
+		if (m_api != nullptr)
+		{
+			allocateState(instance);
+			m_api->load(instance.state, &instance.host, false);
+		}
+		return static_cast<u32>(m_instances.size() - 1);
+	}
+
+	void HotModule::update()
+	{
+		for (u32 instance = 0; instance < m_instances.size(); ++instance)
+			update(instance);
+	}
+
+	void HotModule::update(u32 instance)
+	{
+		if (m_api != nullptr)
+			m_api->update(m_instances[instance].state, &m_instances[instance].host);
+	}
+
+	void HotModule::allocateState(Instance &instance)
+	{
+		instance.state = memory::allocate(m_stateSize, memory::Tag::General, k_stateAlignment);
+		std::memset(instance.state, 0, m_stateSize);
+	}
+
+	void HotModule::freeState(Instance &instance)
+	{
+		if (instance.state != nullptr)
+			memory::deallocate(instance.state, m_stateSize, memory::Tag::General, k_stateAlignment);
+		instance.state = nullptr;
+	}
+
+	const AngModuleApi *HotModule::openCopy(DynamicLibrary &library, std::filesystem::path &copy)
+	{
+		// A new name every time: loaders hand back the already loaded library for a path they have seen.
+		const std::string name = m_path.stem().string() + "_" + std::to_string(reinterpret_cast<std::uintptr_t>(this))
+			+ "_" + std::to_string(m_copyCount++) + m_path.extension().string();
+
+		std::error_code error;
+		copy = std::filesystem::temp_directory_path(error) / name;
+		if (error || !std::filesystem::copy_file(m_path, copy, std::filesystem::copy_options::overwrite_existing, error))
+		{
+			copy.clear();
+			return nullptr;
+		}
+
+		const AngModuleApi *api = nullptr;
+		if (library.open(copy.string().c_str()))
+		{
+			const AngGetModuleApi getApi = reinterpret_cast<AngGetModuleApi>(library.symbol(ANG_MODULE_ENTRY_POINT));
+			api = getApi != nullptr ? getApi() : nullptr;
+		}
+
+		if (api == nullptr || api->version != k_angModuleApiVersion)
+		{
+			library.close();
+			removeCopy(copy);
+			return nullptr;
+		}
+
+		return api;
+	}
+
+	void HotModule::removeCopy(std::filesystem::path &copy)
+	{
+		if (copy.empty())
+			return;
+
+		std::error_code error;
+		std::filesystem::remove(copy, error);
+		copy.clear();
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Memory/Memory.hpp"
+#include "Core/Modules/DynamicLibrary.hpp"
+#include "Core/Modules/FileWatcher.hpp"
+#include "Core/Modules/ModuleApi.hpp"
+
+namespace core::modules
+{
+	// A module library that is swapped for its new build whenever the file changes, while its state stays in memory.
+	// The library is loaded from a copy in the temp directory, so the build can overwrite the original while it runs,
+	// and the new build is loaded before the old one is let go: a build that fails to load leaves the old one running.
+	// Several instances can run one copy of the code, each with its own state and host. They share whatever the module
+	// keeps in static data, so modules run this way keep none that changes.
+	class HotModule
+	{
+	public:
+		// Instance 0 talks to this host.
+		explicit HotModule(const AngHostApi &host);
+		// Unloads the module.
+		~HotModule();
+
+		HotModule(const HotModule &) = delete;
+		HotModule &operator=(const HotModule &) = delete;
+
+		// Returns false when the library cannot be loaded or does not export a matching ANG_MODULE_ENTRY_POINT.
+		bool load(const char *path);
+		// Calls the module's unload and frees the state of every instance.
+		void unload();
+		bool isLoaded() const { return m_api != nullptr; }
+
+		// Reloads when the library changed since the last call. Returns true when the new build was swapped in.
+		bool reloadIfChanged();
+		bool reload();
+
+		// Adds an instance with its own zeroed state, loaded right away when the module is. Returns its index.
+		u32 addInstance(const AngHostApi &host);
+		u32 instanceCount() const { return static_cast<u32>(m_instances.size()); }
+
+		// Every instance in turn.
+		void update();
+		// Different instances may update on different threads at once.
+		void update(u32 instance);
+
+		// Nullptr while the module is not loaded.
+		void *state(u32 instance = 0) const { return m_instances[instance].state; }
+		usize stateSize() const { return m_stateSize; }
+		u32 reloadCount() const { return m_reloadCount; }
+
+	private:
+		// Copies the library next to the others loaded this run and opens the copy.
+		const AngModuleApi *openCopy(DynamicLibrary &library, std::filesystem::path &copy);
+		void removeCopy(std::filesystem::path &copy);
+
+		struct Instance
+		{
+			AngHostApi host;
+			void *state;
+		};
+
+		void allocateState(Instance &instance);
+		void freeState(Instance &instance);
+
+		std::vector<Instance, memory::TaggedAllocator<Instance, memory::Tag::General>> m_instances;
+		std::filesystem::path m_path;
+		FileWatcher m_watcher;
+
+		DynamicLibrary m_library;
+		std::filesystem::path m_copy;
+		const AngModuleApi *m_api = nullptr;
+
+		usize m_stateSize = 0;
+		u32 m_reloadCount = 0;
+		u32 m_copyCount = 0;
+	};
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+#include "Core/Types.hpp"
+
+// The C interface between the engine and a hot reloadable module, such as the game.
+// Only plain C types cross it, so a module is rebuilt and reloaded without the engine relinking.
+// Modules link no Core code: a second copy of Core's statics would keep its own allocation counters and job system.
+// Any change to these structs bumps k_angModuleApiVersion.
+
+#define ANG_MODULE_ENTRY_POINT "angGetModuleApi"
+
+#if CORE_PLATFORM_WINDOWS
+#define ANG_MODULE_EXPORT extern "C" __declspec(dllexport)
+#else
+#define ANG_MODULE_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+extern "C"
+{
+	constexpr u32 k_angModuleApiVersion = 3;
+
+	// Services the engine hands to a module. Every function takes the context as its first argument.
+	struct AngHostApi
+	{
+		void *context;
+		// Memory attributed to the engine's tags, so module allocations show up in budgets and leak reports.
+		void *(*allocate)(void *context, usize size, usize alignment);
+		void (*deallocate)(void *context, void *pointer, usize size, usize alignment);
+		void (*requestExit)(void *context);
+		// Bytes of an uncompressed asset, read in place from memory the host maps read only and shares between
+		// every instance it runs. Null, with size left alone, when there is no such asset.
+		const void *(*findAsset)(void *context, u64 id, usize *size);
+		// Anything the module samples from outside the simulation, such as devices, the clock or the network,
+		// goes through here so replays reproduce it. What is submitted during a tick comes back from input() during
+		// the next; a replay hands back the recorded bytes instead and drops what is submitted.
+		void (*submitInput)(void *context, const void *data, usize size);
+		// This tick's input. Null, with a zero size, when there is none.
+		const void *(*input)(void *context, usize *size);
+	};
+
+	struct AngModuleApi
+	{
+		u32 version;
+		// Bytes of state the engine allocates, zeroed, and keeps across reloads. State is the only memory
+		// that survives one; pointers into the module's code or static data do not.
+		// A reload that grows the state keeps the old bytes and zeroes the new ones.
+		usize stateSize;
+		// isReload tells the calls around a reload apart from the first load and the last unload.
+		void (*load)(void *state, const AngHostApi *host, bool isReload);
+		void (*unload)(void *state, const AngHostApi *host, bool isReload);
+		void (*update)(void *state, const AngHostApi *host);
+	};
+
+	// Exported by every module as ANG_MODULE_ENTRY_POINT.
+	typedef const AngModuleApi *(*AngGetModuleApi)();
+}
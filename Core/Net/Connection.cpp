@@ -0,0 +1,384 @@
+#include "Core/Net/Connection.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "Core/Net/Socket.hpp"
+
+namespace core::net
+{
+	namespace
+	{
+		enum DatagramKind : u8
+		{
+			k_packetDatagram = 0xa1,
+			k_fragmentDatagram = 0xa2,
+		};
+
+		// kind, sequence, fragment index, fragment count.
+		constexpr usize k_fragmentHeaderSize = 5;
+		constexpr usize k_fragmentSize = 1024;
+		constexpr u32 k_maxFragments = 64;
+		constexpr usize k_maxPacketSize = k_fragmentSize * k_maxFragments;
+		static_assert(k_fragmentHeaderSize + k_fragmentSize <= k_maxDatagramSize, "Fragments must fit in a datagram.");
+
+		// sequence, ack, ack bits, flags.
+		constexpr usize k_packetHeaderSize = 9;
+		// channel, size, and the id of reliable messages.
+		constexpr usize k_messageHeaderSize = 5;
+		static_assert(k_packetHeaderSize + k_messageHeaderSize + Connection::k_maxMessageSize <= k_maxPacketSize, "A packet must fit any message.");
+
+		constexpr u8 k_hasAck = 1;
+
+		constexpr u32 k_sentPacketCount = 256;
+		constexpr u32 k_reassemblyCount = 16;
+		constexpr f64 k_minResendDelay = 0.05;
+
+		// Newer than, across the wrap around.
+		bool sequenceGreater(u16 a, u16 b)
+		{
+			return a != b && static_cast<u16>(a - b) < 0x8000;
+		}
+
+		template<typename Buffer>
+		void writeU16(Buffer &buffer, u16 value)
+		{
+			buffer.push_back(static_cast<u8>(value));
+			buffer.push_back(static_cast<u8>(value >> 8));
+		}
+
+		template<typename Buffer>
+		void writeU32(Buffer &buffer, u32 value)
+		{
+			writeU16(buffer, static_cast<u16>(value));
+			writeU16(buffer, static_cast<u16>(value >> 16));
+		}
+
+		u16 readU16(const u8 *data) { return static_cast<u16>(data[0] | data[1] << 8); }
+		u32 readU32(const u8 *data) { return readU16(data) | static_cast<u32>(readU16(data + 2)) << 16; }
+	}
+
+	Connection::Connection(SendFunction sendFunction, void *context)
+		: m_send(sendFunction)
+		, m_context(context)
+		, m_sentPackets(k_sentPacketCount)
+		, m_outgoing(k_reliableWindow)
+		, m_incoming(k_reliableWindow)
+		, m_reassembly(k_reassemblyCount)
+	{
+		assert(sendFunction != nullptr);
+	}
+
+	bool Connection::send(Channel channel, const void *data, usize size)
+	{
+		if (size > k_maxMessageSize)
+			return false;
+
+		const u8 *bytes = static_cast<const u8 *>(data);
+		if (channel == Channel::Unreliable)
+		{
+			writeU16(m_unreliable, static_cast<u16>(size));
+			m_unreliable.insert(m_unreliable.end(), bytes, bytes + size);
+			return true;
+		}
+
+		if (reliablePending() >= k_reliableWindow)
+			return false;
+
+		ReliableMessage &message = m_outgoing[m_nextMessageId % k_reliableWindow];
+		message.id = m_nextMessageId++;
+		message.isUsed = true;
+		message.lastSent = -1.0;
+		message.data.assign(bytes, bytes + size);
+		return true;
+	}
+
+	void Connection::update(f64 time)
+	{
+		const u16 sequence = m_nextSequence++;
+		SentPacket &sent = m_sentPackets[sequence % k_sentPacketCount];
+		sent.sequence = sequence;
+		sent.isUsed = true;
+		sent.isAcked = false;
+		sent.time = time;
+		sent.messageIds.clear();
+
+		m_packet.clear();
+		writeU16(m_packet, sequence);
+		writeU16(m_packet, m_receivedSequence);
+		writeU32(m_packet, m_receivedBits);
+		m_packet.push_back(m_hasReceived ? k_hasAck : 0);
+
+		// Oldest first, so a backlog drains in order and the receiver can deliver as soon as possible.
+		const f64 resendDelay = std::max(k_minResendDelay, m_stats.roundTripTime * 1.5);
+		for (u16 id = m_oldestUnacked; id != m_nextMessageId; ++id)
+		{
+			ReliableMessage &message = m_outgoing[id % k_reliableWindow];
+			if (!message.isUsed || (message.lastSent >= 0.0 && time - message.lastSent < resendDelay))
+				continue;
+			if (m_packet.size() + k_messageHeaderSize + message.data.size() > k_maxPacketSize)
+				break;
+
+			m_packet.push_back(static_cast<u8>(Channel::ReliableOrdered));
+			writeU16(m_packet, message.id);
+			writeU16(m_packet, static_cast<u16>(message.data.size()));
+			m_packet.insert(m_packet.end(), message.data.begin(), message.data.end());
+
+			if (message.lastSent >= 0.0)
+				++m_stats.reliableResends;
+			message.lastSent = time;
+			sent.messageIds.push_back(message.id);
+		}
+
+		for (usize offset = 0; offset < m_unreliable.size();)
+		{
+			const u16 size = readU16(&m_unreliable[offset]);
+			const u8 *data = &m_unreliable[offset + 2];
+			offset += 2 + size;
+			if (m_packet.size() + k_messageHeaderSize + size > k_maxPacketSize)
+				continue;
+
+			m_packet.push_back(static_cast<u8>(Channel::Unreliable));
+			writeU16(m_packet, 0);
+			writeU16(m_packet, size);
+			m_packet.insert(m_packet.end(), data, data + size);
+		}
+		m_unreliable.clear();
+
+		sendPacket(m_packet.data(), m_packet.size());
+		++m_stats.packetsSent;
+	}
+
+	void Connection::sendPacket(const u8 *body, usize size)
+	{
+		if (1 + size <= k_maxDatagramSize)
+		{
+			m_datagram.clear();
+			m_datagram.push_back(k_packetDatagram);
+			m_datagram.insert(m_datagram.end(), body, body + size);
+			m_send(m_context, m_datagram.data(), m_datagram.size());
+			++m_stats.datagramsSent;
+			m_stats.bytesSent += m_datagram.size();
+			return;
+		}
+
+		const u16 sequence = readU16(body);
+		const u32 fragmentCount = static_cast<u32>((size + k_fragmentSize - 1) / k_fragmentSize);
+		for (u32 index = 0; index < fragmentCount; ++index)
+		{
+			const usize offset = index * k_fragmentSize;
+			const usize fragmentSize = std::min(k_fragmentSize, size - offset);
+			m_datagram.clear();
+			m_datagram.push_back(k_fragmentDatagram);
+			writeU16(m_datagram, sequence);
+			m_datagram.push_back(static_cast<u8>(index));
+			m_datagram.push_back(static_cast<u8>(fragmentCount));
+			m_datagram.insert(m_datagram.end(), body + offset, body + offset + fragmentSize);
+			m_send(m_context, m_datagram.data(), m_datagram.size());
+			++m_stats.datagramsSent;
+			m_stats.bytesSent += m_datagram.size();
+		}
+	}
+
+	void Connection::receiveDatagram(const void *data, usize size, f64 time)
+	{
+		const u8 *bytes = static_cast<const u8 *>(data);
+		if (size < 1)
+			return;
+
+		m_stats.bytesReceived += size;
+		if (bytes[0] == k_packetDatagram)
+			receivePacket(bytes + 1, size - 1, time);
+		else if (bytes[0] == k_fragmentDatagram)
+			receiveFragment(bytes + 1, size - 1, time);
+	}
+
+	void Connection::receiveFragment(const u8 *data, usize size, f64 time)
+	{
+		if (size < k_fragmentHeaderSize - 1)
+			return;
+
+		const u16 sequence = readU16(data);
+		const u32 index = data[2];
+		const u32 fragmentCount = data[3];
+		const u8 *fragment = data + 4;
+		const usize fragmentSize = size - 4;
+		const bool isLast = index + 1 == fragmentCount;
+		if (fragmentCount < 2 || fragmentCount > k_maxFragments || index >= fragmentCount)
+			return;
+		if (fragmentSize == 0 || fragmentSize > k_fragmentSize || (!isLast && fragmentSize != k_fragmentSize))
+			return;
+
+		// A slot still holding an older packet gives up on it; its missing fragments are not coming anymore.
+		Reassembly &reassembly = m_reassembly[sequence % k_reassemblyCount];
+		if (!reassembly.isUsed || reassembly.sequence != sequence)
+		{
+			reassembly.sequence = sequence;
+			reassembly.isUsed = true;
+			reassembly.fragmentCount = fragmentCount;
+			reassembly.receivedCount = 0;
+			reassembly.receivedMask = 0;
+			reassembly.size = 0;
+			reassembly.data.resize(fragmentCount * k_fragmentSize);
+		}
+
+		const u64 bit = 1ull << index;
+		if (reassembly.fragmentCount != fragmentCount || (reassembly.receivedMask & bit) != 0)
+			return;
+
+		std::memcpy(&reassembly.data[index * k_fragmentSize], fragment, fragmentSize);
+		reassembly.receivedMask |= bit;
+		if (isLast)
+			reassembly.size = index * k_fragmentSize + fragmentSize;
+
+		if (++reassembly.receivedCount == fragmentCount)
+		{
+			reassembly.isUsed = false;
+			receivePacket(reassembly.data.data(), reassembly.size, time);
+		}
+	}
+
+	void Connection::receivePacket(const u8 *body, usize size, f64 time)
+	{
+		if (size < k_packetHeaderSize)
+			return;
+
+		// Check the messages fit before acting on any part of the packet.
+		for (usize offset = k_packetHeaderSize; offset < size;)
+		{
+			if (size - offset < k_messageHeaderSize || body[offset] >= static_cast<u8>(Channel::Count))
+				return;
+			offset += k_messageHeaderSize + readU16(body + offset + 3);
+			if (offset > size)
+				return;
+		}
+
+		++m_stats.packetsReceived;
+		if ((body[8] & k_hasAck) != 0)
+			acknowledge(readU16(body + 2), readU32(body + 4), time);
+
+		if (!trackReceived(readU16(body)))
+			return;
+
+		for (usize offset = k_packetHeaderSize; offset < size;)
+		{
+			const Channel channel = static_cast<Channel>(body[offset]);
+			const u16 id = readU16(body + offset + 1);
+			const u16 messageSize = readU16(body + offset + 3);
+			const u8 *data = body + offset + k_messageHeaderSize;
+			offset += k_messageHeaderSize + messageSize;
+
+			if (channel == Channel::ReliableOrdered)
+			{
+				receiveReliable(id, data, messageSize);
+			}
+			else
+			{
+				Message &message = m_delivered.emplace_back();
+				message.channel = Channel::Unreliable;
+				message.data.assign(data, data + messageSize);
+			}
+		}
+	}
+
+	void Connection::acknowledge(u16 ack, u32 ackBits, f64 time)
+	{
+		for (u32 i = 0; i <= 32; ++i)
+		{
+			if (i > 0 && (ackBits & (1u << (i - 1))) == 0)
+				continue;
+
+			const u16 sequence = static_cast<u16>(ack - i);
+			SentPacket &sent = m_sentPackets[sequence % k_sentPacketCount];
+			if (!sent.isUsed || sent.isAcked || sent.sequence != sequence)
+				continue;
+
+			sent.isAcked = true;
+			++m_stats.packetsAcked;
+			const f64 sample = time - sent.time;
+			m_stats.roundTripTime = m_stats.roundTripTime == 0.0 ? sample : m_stats.roundTripTime + (sample - m_stats.roundTripTime) * 0.1;
+
+			for (u16 id : sent.messageIds)
+			{
+				ReliableMessage &message = m_outgoing[id % k_reliableWindow];
+				if (message.isUsed && message.id == id)
+				{
+					message.isUsed = false;
+					message.data.clear();
+				}
+			}
+		}
+
+		while (m_oldestUnacked != m_nextMessageId && !m_outgoing[m_oldestUnacked % k_reliableWindow].isUsed)
+			++m_oldestUnacked;
+	}
+
+	bool Connection::trackReceived(u16 sequence)
+	{
+		if (!m_hasReceived)
+		{
+			m_hasReceived = true;
+			m_receivedSequence = sequence;
+			m_receivedBits = 0;
+			return true;
+		}
+
+		if (sequenceGreater(sequence, m_receivedSequence))
+		{
+			// The old newest becomes one of the bits, behind whatever was skipped.
+			const u32 shift = static_cast<u16>(sequence - m_receivedSequence);
+			m_receivedBits = shift > 32 ? 0 : static_cast<u32>(((static_cast<u64>(m_receivedBits) << 1) | 1) << (shift - 1));
+			m_receivedSequence = sequence;
+			return true;
+		}
+
+		const u32 age = static_cast<u16>(m_receivedSequence - sequence);
+		if (age == 0)
+			return false;
+		// Too old to acknowledge. Its reliable messages will be resent anyway, so only the unreliable ones are lost.
+		if (age > 32)
+			return false;
+
+		const u32 bit = 1u << (age - 1);
+		if ((m_receivedBits & bit) != 0)
+			return false;
+		m_receivedBits |= bit;
+		return true;
+	}
+
+	void Connection::receiveReliable(u16 id, const u8 *data, usize size)
+	{
+		// Already delivered, or too far ahead to buffer. Both get sent again if the peer still needs them to be.
+		if (static_cast<u16>(id - m_nextReceiveId) >= k_reliableWindow)
+			return;
+
+		ReliableMessage &slot = m_incoming[id % k_reliableWindow];
+		if (slot.isUsed)
+			return;
+
+		slot.id = id;
+		slot.isUsed = true;
+		slot.data.assign(data, data + size);
+
+		for (ReliableMessage *next = &m_incoming[m_nextReceiveId % k_reliableWindow]; next->isUsed; next = &m_incoming[m_nextReceiveId % k_reliableWindow])
+		{
+			Message &message = m_delivered.emplace_back();
+			message.channel = Channel::ReliableOrdered;
+			message.data.swap(next->data);
+			next->isUsed = false;
+			++m_nextReceiveId;
+		}
+	}
+
+	bool Connection::receive(Message &message)
+	{
+		if (m_delivered.empty())
+			return false;
+
+		message.channel = m_delivered.front().channel;
+		message.data.swap(m_delivered.front().data);
+		m_delivered.pop_front();
+		return true;
+	}
+}
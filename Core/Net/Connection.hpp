@@ -0,0 +1,139 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::net
+{
+	enum class Channel : u8
+	{
+		// Delivered at most once, in any order. Lost packets lose their messages.
+		Unreliable,
+		// Delivered exactly once, in the order sent. Messages are resent until the peer acknowledges them.
+		ReliableOrdered,
+		Count
+	};
+
+	struct Message
+	{
+		Channel channel;
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> data;
+	};
+
+	struct ConnectionStats
+	{
+		u64 packetsSent = 0;
+		u64 packetsReceived = 0;
+		u64 packetsAcked = 0;
+		u64 datagramsSent = 0;
+		u64 bytesSent = 0;
+		u64 bytesReceived = 0;
+		u64 reliableResends = 0;
+		// Smoothed, in seconds. Zero until the first acknowledgement.
+		f64 roundTripTime = 0.0;
+	};
+
+	// Hands one outgoing datagram to the transport, usually a UdpSocket sending to the peer.
+	using SendFunction = void (*)(void *context, const u8 *data, usize size);
+
+	// One side of a conversation with a peer over an unreliable datagram transport.
+	// Every update() sends one packet, which acknowledges the last 33 packets received, so acknowledgements
+	// survive lost packets without being sent on their own. Packets larger than a datagram are split into fragments
+	// and put back together on arrival; losing any fragment loses the packet, and the reliable channel resends.
+	// The connection does not read the transport: whoever owns the socket hands it the peer's datagrams.
+	class Connection
+	{
+	public:
+		static constexpr usize k_maxMessageSize = 16 * 1024;
+		// Reliable messages sent but not yet acknowledged. send() fails once this many are in flight.
+		static constexpr u32 k_reliableWindow = 256;
+
+		Connection(SendFunction sendFunction, void *context);
+
+		Connection(const Connection &) = delete;
+		Connection &operator=(const Connection &) = delete;
+
+		// Queues a message for the next update(). Returns false when it is too large or the reliable window is full.
+		bool send(Channel channel, const void *data, usize size);
+
+		// Sends a packet carrying the queued unreliable messages and the reliable ones due for a send or a resend.
+		// Unreliable messages that do not fit are dropped. Time is in seconds, from any fixed origin.
+		void update(f64 time);
+
+		// Datagrams that are malformed or not part of the protocol are ignored.
+		void receiveDatagram(const void *data, usize size, f64 time);
+		// Pops the next delivered message. Returns false when there is none.
+		bool receive(Message &message);
+
+		const ConnectionStats &stats() const { return m_stats; }
+		// Reliable messages sent or queued that the peer has not acknowledged yet.
+		u32 reliablePending() const { return static_cast<u16>(m_nextMessageId - m_oldestUnacked); }
+
+	private:
+		struct SentPacket
+		{
+			u16 sequence = 0;
+			bool isUsed = false;
+			bool isAcked = false;
+			f64 time = 0.0;
+			// Reliable messages the packet carried.
+			std::vector<u16, memory::TaggedAllocator<u16, memory::Tag::Net>> messageIds;
+		};
+
+		struct ReliableMessage
+		{
+			u16 id = 0;
+			bool isUsed = false;
+			// Negative until first sent.
+			f64 lastSent = -1.0;
+			std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> data;
+		};
+
+		struct Reassembly
+		{
+			u16 sequence = 0;
+			bool isUsed = false;
+			u32 fragmentCount = 0;
+			u32 receivedCount = 0;
+			u64 receivedMask = 0;
+			usize size = 0;
+			std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> data;
+		};
+
+		void sendPacket(const u8 *body, usize size);
+		void receiveFragment(const u8 *data, usize size, f64 time);
+		void receivePacket(const u8 *body, usize size, f64 time);
+		void acknowledge(u16 ack, u32 ackBits, f64 time);
+		// Returns false when the sequence was already received.
+		bool trackReceived(u16 sequence);
+		void receiveReliable(u16 id, const u8 *data, usize size);
+
+		SendFunction m_send;
+		void *m_context;
+
+		std::vector<SentPacket, memory::TaggedAllocator<SentPacket, memory::Tag::Net>> m_sentPackets;
+		std::vector<ReliableMessage, memory::TaggedAllocator<ReliableMessage, memory::Tag::Net>> m_outgoing;
+		std::vector<ReliableMessage, memory::TaggedAllocator<ReliableMessage, memory::Tag::Net>> m_incoming;
+		std::vector<Reassembly, memory::TaggedAllocator<Reassembly, memory::Tag::Net>> m_reassembly;
+		std::deque<Message, memory::TaggedAllocator<Message, memory::Tag::Net>> m_delivered;
+
+		// Unreliable messages queued since the last update, each prefixed by its u16 size.
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> m_unreliable;
+		// Scratch for building packets and datagrams.
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> m_packet;
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> m_datagram;
+
+		ConnectionStats m_stats;
+		u16 m_nextSequence = 0;
+		u16 m_nextMessageId = 0;
+		u16 m_oldestUnacked = 0;
+		u16 m_nextReceiveId = 0;
+		// Newest packet received, and which of the 32 before it arrived.
+		u16 m_receivedSequence = 0;
+		u32 m_receivedBits = 0;
+		bool m_hasReceived = false;
+	};
+}
@@ -0,0 +1,204 @@
+#include "Core/Net/InterestGrid.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace core::net
+{
+	InterestGrid::InterestGrid(const math::Vec2f &worldMin, f32 cellSize, u32 columns, u32 rows)
+		: m_worldMin(worldMin)
+		, m_inverseCellSize(1.0f / cellSize)
+		, m_columns(columns)
+		, m_rows(rows)
+		, m_cells(static_cast<usize>(columns) * rows)
+		, m_entities(memory::Tag::Net)
+		, m_clients(memory::Tag::Net)
+	{
+		assert(cellSize > 0.0f);
+		assert(columns > 0 && rows > 0 && columns <= 0x10000 && rows <= 0x10000);
+	}
+
+	InterestHandle InterestGrid::addEntity(u32 id, const math::Vec2f &position)
+	{
+		const u32 cell = cellOf(position);
+		const InterestHandle entity = m_entities.insert({ cell, 0 });
+		addMember(cell, id, entity);
+		return entity;
+	}
+
+	void InterestGrid::moveEntity(InterestHandle entity, const math::Vec2f &position)
+	{
+		Entity *data = m_entities.get(entity);
+		assert(data != nullptr && "Stale entity handle.");
+
+		const u32 cell = cellOf(position);
+		if (cell == data->cell)
+			return;
+
+		const u32 id = m_cells[data->cell].members[data->member].id;
+		removeMember(data->cell, data->member);
+		addMember(cell, id, entity);
+	}
+
+	void InterestGrid::removeEntity(InterestHandle entity)
+	{
+		const Entity *data = m_entities.get(entity);
+		assert(data != nullptr && "Stale entity handle.");
+
+		removeMember(data->cell, data->member);
+		m_entities.erase(entity);
+	}
+
+	InterestHandle InterestGrid::addClient(const math::Vec2f &position, f32 radius)
+	{
+		return m_clients.insert({ position, radius, ~0u });
+	}
+
+	void InterestGrid::moveClient(InterestHandle client, const math::Vec2f &position, f32 radius)
+	{
+		Client *data = m_clients.get(client);
+		assert(data != nullptr && "Stale client handle.");
+		data->position = position;
+		data->radius = radius;
+	}
+
+	void InterestGrid::removeClient(InterestHandle client)
+	{
+		const bool isRemoved = m_clients.erase(client);
+		assert(isRemoved && "Stale client handle.");
+		(void)isRemoved;
+	}
+
+	void InterestGrid::update()
+	{
+		for (Client &client : m_clients)
+			client.view = acquireView(rectOf(client.position, client.radius));
+
+		m_viewCount = 0;
+		m_rebuiltCount = 0;
+		for (u32 index = 0; index < m_views.size(); ++index)
+		{
+			View &view = m_views[index];
+			if (!view.isUsed)
+				continue;
+
+			// No client looks through it anymore.
+			if (view.usedAt != m_updateCount)
+			{
+				view.isUsed = false;
+				view.entities.clear();
+				m_viewsByRect.erase(view.rect.key());
+				m_freeViews.push_back(index);
+				continue;
+			}
+
+			++m_viewCount;
+			bool isStale = view.builtAt == 0;
+			for (u32 y = view.rect.y0; y <= view.rect.y1 && !isStale; ++y)
+			{
+				for (u32 x = view.rect.x0; x <= view.rect.x1 && !isStale; ++x)
+					isStale = m_cells[y * m_columns + x].changedAt > view.builtAt;
+			}
+
+			if (isStale)
+			{
+				rebuild(view);
+				++m_rebuiltCount;
+			}
+		}
+
+		++m_updateCount;
+	}
+
+	const std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Net>> &InterestGrid::visible(InterestHandle client) const
+	{
+		const Client *data = m_clients.get(client);
+		assert(data != nullptr && "Stale client handle.");
+		assert(data->view != ~0u && "Call update() after adding clients.");
+		return m_views[data->view].entities;
+	}
+
+	u32 InterestGrid::cellOf(const math::Vec2f &position) const
+	{
+		const f32 x = (position.x - m_worldMin.x) * m_inverseCellSize;
+		const f32 y = (position.y - m_worldMin.y) * m_inverseCellSize;
+		const u32 column = x > 0.0f ? std::min(static_cast<u32>(std::min(x, 65535.0f)), m_columns - 1) : 0;
+		const u32 row = y > 0.0f ? std::min(static_cast<u32>(std::min(y, 65535.0f)), m_rows - 1) : 0;
+		return row * m_columns + column;
+	}
+
+	InterestGrid::CellRect InterestGrid::rectOf(const math::Vec2f &position, f32 radius) const
+	{
+		const u32 low = cellOf(position - math::Vec2f(radius, radius));
+		const u32 high = cellOf(position + math::Vec2f(radius, radius));
+		return { static_cast<u16>(low % m_columns), static_cast<u16>(low / m_columns), static_cast<u16>(high % m_columns), static_cast<u16>(high / m_columns) };
+	}
+
+	void InterestGrid::addMember(u32 cell, u32 id, InterestHandle entity)
+	{
+		Cell &data = m_cells[cell];
+		Entity &entry = *m_entities.get(entity);
+		entry.cell = cell;
+		entry.member = static_cast<u32>(data.members.size());
+		data.members.push_back({ id, entity });
+		data.changedAt = m_updateCount;
+	}
+
+	void InterestGrid::removeMember(u32 cell, u32 member)
+	{
+		Cell &data = m_cells[cell];
+		if (member + 1 != data.members.size())
+		{
+			data.members[member] = data.members.back();
+			m_entities.get(data.members[member].handle)->member = member;
+		}
+		data.members.pop_back();
+		data.changedAt = m_updateCount;
+	}
+
+	u32 InterestGrid::acquireView(const CellRect &rect)
+	{
+		const auto found = m_viewsByRect.find(rect.key());
+		if (found != m_viewsByRect.end())
+		{
+			m_views[found->second].usedAt = m_updateCount;
+			return found->second;
+		}
+
+		u32 index;
+		if (!m_freeViews.empty())
+		{
+			index = m_freeViews.back();
+			m_freeViews.pop_back();
+		}
+		else
+		{
+			index = static_cast<u32>(m_views.size());
+			m_views.emplace_back();
+		}
+
+		View &view = m_views[index];
+		view.rect = rect;
+		view.builtAt = 0;
+		view.usedAt = m_updateCount;
+		view.isUsed = true;
+		m_viewsByRect.emplace(rect.key(), index);
+		return index;
+	}
+
+	void InterestGrid::rebuild(View &view)
+	{
+		view.entities.clear();
+		for (u32 y = view.rect.y0; y <= view.rect.y1; ++y)
+		{
+			for (u32 x = view.rect.x0; x <= view.rect.x1; ++x)
+			{
+				for (const Member &member : m_cells[y * m_columns + x].members)
+					view.entities.push_back(member.id);
+			}
+		}
+
+		std::sort(view.entities.begin(), view.entities.end());
+		view.builtAt = m_updateCount;
+	}
+}
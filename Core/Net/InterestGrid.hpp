@@ -0,0 +1,119 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Containers/SlotMap.hpp"
+#include "Core/Math/Vec2.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::net
+{
+	using InterestHandle = SlotHandle;
+
+	// Which entities each client should hear about. Entities live in the cells of a uniform grid over the world,
+	// and a client sees every entity in the cells its view circle's bounding square touches. The square's corner cells
+	// are kept even when the circle misses them, so a view depends on the cell range alone and can be shared.
+	// update() only rebuilds a visible set when the client's view moved to other cells or an entity entered or
+	// left one of them; moving within a cell changes nothing. Clients whose views cover the same cells share one set,
+	// so crowded areas cost one set, not one per client.
+	class InterestGrid
+	{
+	public:
+		// The grid covers columns * rows cells of cellSize from worldMin. Positions outside land in the border cells.
+		InterestGrid(const math::Vec2f &worldMin, f32 cellSize, u32 columns, u32 rows);
+
+		InterestGrid(const InterestGrid &) = delete;
+		InterestGrid &operator=(const InterestGrid &) = delete;
+
+		// Id is what visible sets hold, usually the entity's network id. Ids must be unique.
+		InterestHandle addEntity(u32 id, const math::Vec2f &position);
+		void moveEntity(InterestHandle entity, const math::Vec2f &position);
+		void removeEntity(InterestHandle entity);
+
+		InterestHandle addClient(const math::Vec2f &position, f32 radius);
+		void moveClient(InterestHandle client, const math::Vec2f &position, f32 radius);
+		void removeClient(InterestHandle client);
+
+		// Brings every client's visible set up to date.
+		void update();
+
+		// Entity ids sorted ascending, as of the last update(). Valid until the next one.
+		const std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Net>> &visible(InterestHandle client) const;
+
+		u32 entityCount() const { return static_cast<u32>(m_entities.size()); }
+		u32 clientCount() const { return static_cast<u32>(m_clients.size()); }
+		// Distinct visible sets, and how many of them the last update() rebuilt.
+		u32 viewCount() const { return m_viewCount; }
+		u32 rebuiltCount() const { return m_rebuiltCount; }
+
+	private:
+		// Inclusive range of cells, packed into one key.
+		struct CellRect
+		{
+			u16 x0, y0, x1, y1;
+
+			u64 key() const { return static_cast<u64>(x0) | static_cast<u64>(y0) << 16 | static_cast<u64>(x1) << 32 | static_cast<u64>(y1) << 48; }
+		};
+
+		struct Member
+		{
+			u32 id;
+			InterestHandle handle;
+		};
+
+		struct Cell
+		{
+			std::vector<Member, memory::TaggedAllocator<Member, memory::Tag::Net>> members;
+			// Update count when an entity last entered or left.
+			u32 changedAt = 0;
+		};
+
+		struct Entity
+		{
+			u32 cell;
+			u32 member;
+		};
+
+		struct View
+		{
+			CellRect rect;
+			u32 builtAt = 0;
+			u32 usedAt = 0;
+			bool isUsed = false;
+			std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Net>> entities;
+		};
+
+		struct Client
+		{
+			math::Vec2f position;
+			f32 radius;
+			u32 view;
+		};
+
+		u32 cellOf(const math::Vec2f &position) const;
+		CellRect rectOf(const math::Vec2f &position, f32 radius) const;
+		void addMember(u32 cell, u32 id, InterestHandle entity);
+		void removeMember(u32 cell, u32 member);
+		u32 acquireView(const CellRect &rect);
+		void rebuild(View &view);
+
+		math::Vec2f m_worldMin;
+		f32 m_inverseCellSize;
+		u32 m_columns;
+		u32 m_rows;
+
+		std::vector<Cell, memory::TaggedAllocator<Cell, memory::Tag::Net>> m_cells;
+		SlotMap<Entity> m_entities;
+		SlotMap<Client> m_clients;
+		std::vector<View, memory::TaggedAllocator<View, memory::Tag::Net>> m_views;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Net>> m_freeViews;
+		std::unordered_map<u64, u32, std::hash<u64>, std::equal_to<u64>, memory::TaggedAllocator<std::pair<const u64, u32>, memory::Tag::Net>> m_viewsByRect;
+
+		// Zero marks views not built yet.
+		u32 m_updateCount = 1;
+		u32 m_viewCount = 0;
+		u32 m_rebuiltCount = 0;
+	};
+}
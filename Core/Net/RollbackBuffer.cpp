@@ -0,0 +1,127 @@
+#include "Core/Net/RollbackBuffer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace core::net
+{
+	RollbackBuffer::RollbackBuffer(usize stateSize, u32 capacity, usize chunkSize)
+		: m_reference(stateSize)
+		, m_frames(capacity)
+		, m_chunkSize(chunkSize)
+	{
+		assert(capacity > 0 && chunkSize > 0);
+		m_dirty.assign((chunkCount() + 63) / 64, 0);
+	}
+
+	void RollbackBuffer::markDirty(usize offset, usize size)
+	{
+		assert(offset + size <= m_reference.size());
+		if (size == 0)
+			return;
+
+		const usize last = (offset + size - 1) / m_chunkSize;
+		for (usize chunk = offset / m_chunkSize; chunk <= last; ++chunk)
+			m_dirty[chunk / 64] |= 1ull << (chunk % 64);
+	}
+
+	void RollbackBuffer::save(u64 frame, const void *state)
+	{
+		const u8 *bytes = static_cast<const u8 *>(state);
+		Frame &record = m_frames[frame % m_frames.size()];
+		record.chunks.clear();
+		record.bytes.clear();
+		m_copiedChunkCount = 0;
+
+		if (m_count == 0)
+		{
+			std::memcpy(m_reference.data(), bytes, m_reference.size());
+			std::fill(m_dirty.begin(), m_dirty.end(), 0);
+			m_copiedChunkCount = chunkCount();
+			m_newestFrame = frame;
+			m_count = 1;
+			return;
+		}
+
+		assert(frame == m_newestFrame + 1 && "Frames are saved in order.");
+		takeDirty([&](u32 chunk)
+		{
+			const usize offset = chunk * m_chunkSize;
+			const usize size = chunkBytes(chunk);
+			if (std::memcmp(bytes + offset, m_reference.data() + offset, size) == 0)
+				return;
+
+			record.chunks.push_back(chunk);
+			record.bytes.insert(record.bytes.end(), m_reference.begin() + offset, m_reference.begin() + offset + size);
+			std::memcpy(m_reference.data() + offset, bytes + offset, size);
+			++m_copiedChunkCount;
+		});
+
+		// Once full, this frame took the slot of the oldest, whose changes no restore needs any more.
+		m_newestFrame = frame;
+		m_count = std::min(m_count + 1, static_cast<u32>(m_frames.size()));
+	}
+
+	bool RollbackBuffer::restore(u64 frame, void *state)
+	{
+		if (!contains(frame))
+			return false;
+
+		// Rewinds the reference first, so a chunk that changed over several frames reaches the state once.
+		// The chunks it rewinds join those written since the last save as the ones the state may differ in.
+		for (u64 undone = m_newestFrame; undone > frame; --undone)
+		{
+			const Frame &record = m_frames[undone % m_frames.size()];
+			const u8 *source = record.bytes.data();
+			for (u32 chunk : record.chunks)
+			{
+				const usize size = chunkBytes(chunk);
+				std::memcpy(m_reference.data() + chunk * m_chunkSize, source, size);
+				source += size;
+				m_dirty[chunk / 64] |= 1ull << (chunk % 64);
+			}
+		}
+
+		u8 *bytes = static_cast<u8 *>(state);
+		m_copiedChunkCount = 0;
+		takeDirty([&](u32 chunk)
+		{
+			const usize offset = chunk * m_chunkSize;
+			std::memcpy(bytes + offset, m_reference.data() + offset, chunkBytes(chunk));
+			++m_copiedChunkCount;
+		});
+
+		m_count -= static_cast<u32>(m_newestFrame - frame);
+		m_newestFrame = frame;
+		return true;
+	}
+
+	void RollbackBuffer::clear()
+	{
+		std::fill(m_dirty.begin(), m_dirty.end(), 0);
+		m_count = 0;
+		m_newestFrame = 0;
+		m_copiedChunkCount = 0;
+	}
+
+	usize RollbackBuffer::chunkBytes(u32 chunk) const
+	{
+		return std::min(m_chunkSize, m_reference.size() - chunk * m_chunkSize);
+	}
+
+	template<typename Function>
+	void RollbackBuffer::takeDirty(Function &&function)
+	{
+		for (usize word = 0; word < m_dirty.size(); ++word)
+		{
+			u32 chunk = static_cast<u32>(word * 64);
+			for (u64 bits = m_dirty[word]; bits != 0; bits >>= 1, ++chunk)
+			{
+				if ((bits & 1) != 0)
+					function(chunk);
+			}
+			m_dirty[word] = 0;
+		}
+	}
+}
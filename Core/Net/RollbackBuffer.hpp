@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::net
+{
+	// The last few frames of a simulation's state, for rollback netcode: when late input arrives the state goes back
+	// to the frame it belongs to and the frames since are simulated again.
+	// The state is one block of plain bytes owned by the caller, cut into chunks, and the caller marks the chunks it
+	// writes. A save keeps the previous contents of the marked chunks that changed; a restore rewinds those and copies
+	// back only the chunks that differ from the frame restored. Neither touches chunks nothing wrote, so both cost
+	// what the simulation changed rather than the size of the state.
+	// State written by code that cannot mark it, such as a module's, is marked whole before each save; saves then
+	// compare every chunk and still copy only the ones that changed.
+	class RollbackBuffer
+	{
+	public:
+		static constexpr usize k_defaultChunkSize = 1024;
+
+		// Frames past the capacity push the oldest out.
+		RollbackBuffer(usize stateSize, u32 capacity = 16, usize chunkSize = k_defaultChunkSize);
+
+		RollbackBuffer(const RollbackBuffer &) = delete;
+		RollbackBuffer &operator=(const RollbackBuffer &) = delete;
+
+		// Bytes of the state written since the last save or restore.
+		void markDirty(usize offset, usize size);
+
+		// Frames are saved in order, each the one after the newest, except for the first after a clear(),
+		// which copies the whole state.
+		void save(u64 frame, const void *state);
+		// Puts the state back as it was when the frame was saved, and forgets the frames after it.
+		// Returns false, leaving the state and the marks alone, when the frame is not held.
+		bool restore(u64 frame, void *state);
+		void clear();
+
+		bool contains(u64 frame) const { return m_count > 0 && frame >= oldestFrame() && frame <= m_newestFrame; }
+		bool empty() const { return m_count == 0; }
+		u64 oldestFrame() const { return m_newestFrame + 1 - m_count; }
+		u64 newestFrame() const { return m_newestFrame; }
+
+		usize stateSize() const { return m_reference.size(); }
+		usize chunkSize() const { return m_chunkSize; }
+		// Chunks the last save or restore copied.
+		u32 copiedChunkCount() const { return m_copiedChunkCount; }
+
+	private:
+		// The chunks of the frame before that differ from this one, as the frame before had them.
+		struct Frame
+		{
+			std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Net>> chunks;
+			std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> bytes;
+		};
+
+		u32 chunkCount() const { return static_cast<u32>((m_reference.size() + m_chunkSize - 1) / m_chunkSize); }
+		usize chunkBytes(u32 chunk) const;
+
+		// Calls function(chunk) for every marked chunk, clearing the marks.
+		template<typename Function>
+		void takeDirty(Function &&function);
+
+		// The state as of the newest frame.
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> m_reference;
+		// Indexed by frame modulo capacity.
+		std::vector<Frame, memory::TaggedAllocator<Frame, memory::Tag::Net>> m_frames;
+		// One bit per chunk.
+		std::vector<u64, memory::TaggedAllocator<u64, memory::Tag::Net>> m_dirty;
+		usize m_chunkSize;
+		u64 m_newestFrame = 0;
+		u32 m_count = 0;
+		u32 m_copiedChunkCount = 0;
+	};
+}
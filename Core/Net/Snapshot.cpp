@@ -0,0 +1,297 @@
+#include "Core/Net/Snapshot.hpp"
+
+#include <cassert>
+
+#include "Core/Serialization/BitStream.hpp"
+
+namespace core::net
+{
+	namespace
+	{
+		enum ChangeFlags : u8
+		{
+			k_positionChanged = 1 << 0,
+			k_velocityChanged = 1 << 1,
+			// Not in the baseline: the values that follow are absolute.
+			k_isNew = 1 << 2,
+		};
+
+		constexpr u32 k_flagBits = 3;
+
+		struct Ranges
+		{
+			QuantizedRange position[2];
+			QuantizedRange velocity;
+
+			explicit Ranges(const SnapshotFormat &format)
+				: position{ { format.worldMin.x, format.worldMax.x, format.positionStep }, { format.worldMin.y, format.worldMax.y, format.positionStep } }
+				, velocity(-format.maxSpeed, format.maxSpeed, format.velocityStep)
+			{}
+		};
+
+		void writeDelta(BitWriter &writer, u32 from, u32 to)
+		{
+			writer.writeSignedVarint(static_cast<i64>(to) - static_cast<i64>(from));
+		}
+
+		// Untrusted input: anything out of range fails the read.
+		struct Reader
+		{
+			BitReader bits;
+			bool isValid = true;
+
+			u32 value(u64 maxValue)
+			{
+				const u64 result = bits.readVarint();
+				if (result > maxValue)
+					isValid = false;
+				return isValid ? static_cast<u32>(result) : 0;
+			}
+
+			u32 quantized(const QuantizedRange &range)
+			{
+				const u64 result = range.bits > 0 ? bits.readBits(range.bits) : 0;
+				if (result > range.maxSteps)
+					isValid = false;
+				return isValid ? static_cast<u32>(result) : 0;
+			}
+
+			u32 delta(u32 from, u32 maxValue)
+			{
+				const i64 result = static_cast<i64>(from) + bits.readSignedVarint();
+				if (result < 0 || result > maxValue)
+					isValid = false;
+				return isValid ? static_cast<u32>(result) : 0;
+			}
+		};
+	}
+
+	SnapshotEncoder::SnapshotEncoder(const SnapshotFormat &format)
+		: m_format(format)
+		, m_history(k_historySize)
+	{}
+
+	void SnapshotEncoder::encode(u32 tick, const EntityState *entities, usize count, std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> &out)
+	{
+		assert(tick > 0);
+		const Ranges ranges(m_format);
+
+		// A baseline the client may have dropped from its history is as good as none.
+		const SnapshotRecord *baseline = nullptr;
+		if (m_baselineTick != 0 && tick - m_baselineTick < k_historySize && m_history[m_baselineTick % k_historySize].tick == m_baselineTick)
+			baseline = &m_history[m_baselineTick % k_historySize];
+
+		SnapshotRecord &record = m_history[tick % k_historySize];
+		assert(&record != baseline);
+		record.tick = tick;
+		record.entities.resize(count);
+		for (usize i = 0; i < count; ++i)
+		{
+			assert((i == 0 || entities[i].id > entities[i - 1].id) && "Entities must be sorted by id.");
+			QuantizedEntity &entity = record.entities[i];
+			entity.id = entities[i].id;
+			entity.position[0] = ranges.position[0].quantize(entities[i].position.x);
+			entity.position[1] = ranges.position[1].quantize(entities[i].position.y);
+			entity.velocity[0] = ranges.velocity.quantize(entities[i].velocity.x);
+			entity.velocity[1] = ranges.velocity.quantize(entities[i].velocity.y);
+		}
+
+		// Walk the snapshot and its baseline together, both sorted by id. Entities that did not move are left out.
+		m_changes.clear();
+		m_removals.clear();
+		const usize baselineCount = baseline != nullptr ? baseline->entities.size() : 0;
+		usize b = 0;
+		for (u32 i = 0; i < count; ++i)
+		{
+			const QuantizedEntity &entity = record.entities[i];
+			for (; b < baselineCount && baseline->entities[b].id < entity.id; ++b)
+				m_removals.push_back(baseline->entities[b].id);
+
+			if (b == baselineCount || baseline->entities[b].id != entity.id)
+			{
+				m_changes.push_back({ i, 0, k_isNew });
+				continue;
+			}
+
+			const QuantizedEntity &before = baseline->entities[b];
+			u8 flags = 0;
+			if (entity.position[0] != before.position[0] || entity.position[1] != before.position[1])
+				flags |= k_positionChanged;
+			if (entity.velocity[0] != before.velocity[0] || entity.velocity[1] != before.velocity[1])
+				flags |= k_velocityChanged;
+			if (flags != 0)
+				m_changes.push_back({ i, static_cast<u32>(b), flags });
+			++b;
+		}
+		for (; b < baselineCount; ++b)
+			m_removals.push_back(baseline->entities[b].id);
+
+		// Varints of up to 32 bits take 5 bytes; an entity's four values take at most 20 either way.
+		out.resize(32 + m_changes.size() * 28 + m_removals.size() * 5);
+		BitWriter writer(out.data(), out.size());
+		writer.writeVarint(tick);
+		writer.writeVarint(baseline != nullptr ? tick - m_baselineTick : 0);
+
+		writer.writeVarint(m_changes.size());
+		u32 previous = 0;
+		for (const Change &change : m_changes)
+		{
+			const QuantizedEntity &entity = record.entities[change.index];
+			writer.writeVarint(entity.id - previous);
+			previous = entity.id;
+			writer.writeBits(change.flags, k_flagBits);
+			if (change.flags == k_isNew)
+			{
+				writer.writeBits(entity.position[0], ranges.position[0].bits);
+				writer.writeBits(entity.position[1], ranges.position[1].bits);
+				writer.writeBits(entity.velocity[0], ranges.velocity.bits);
+				writer.writeBits(entity.velocity[1], ranges.velocity.bits);
+				continue;
+			}
+
+			const QuantizedEntity &before = baseline->entities[change.baselineIndex];
+			if ((change.flags & k_positionChanged) != 0)
+			{
+				writeDelta(writer, before.position[0], entity.position[0]);
+				writeDelta(writer, before.position[1], entity.position[1]);
+			}
+			if ((change.flags & k_velocityChanged) != 0)
+			{
+				writeDelta(writer, before.velocity[0], entity.velocity[0]);
+				writeDelta(writer, before.velocity[1], entity.velocity[1]);
+			}
+		}
+
+		writer.writeVarint(m_removals.size());
+		previous = 0;
+		for (u32 id : m_removals)
+		{
+			writer.writeVarint(id - previous);
+			previous = id;
+		}
+
+		out.resize(writer.finish());
+		assert(!writer.hasOverflowed());
+	}
+
+	void SnapshotEncoder::acknowledge(u32 tick)
+	{
+		// Acknowledgements can arrive out of order; only a newer one that is still in the history helps.
+		if (tick > m_baselineTick && m_history[tick % k_historySize].tick == tick)
+			m_baselineTick = tick;
+	}
+
+	SnapshotDecoder::SnapshotDecoder(const SnapshotFormat &format)
+		: m_format(format)
+		, m_history(SnapshotEncoder::k_historySize)
+	{}
+
+	bool SnapshotDecoder::decode(const u8 *data, usize size, u32 &tick, std::vector<EntityState, memory::TaggedAllocator<EntityState, memory::Tag::Net>> &entities)
+	{
+		constexpr u32 k_historySize = SnapshotEncoder::k_historySize;
+		const Ranges ranges(m_format);
+		Reader reader{ BitReader(data, size) };
+
+		const u32 snapshotTick = reader.value(~0u);
+		const u32 baselineAge = reader.value(k_historySize - 1);
+		if (!reader.isValid || snapshotTick == 0 || baselineAge > snapshotTick)
+			return false;
+
+		const SnapshotRecord *baseline = nullptr;
+		if (baselineAge != 0)
+		{
+			baseline = &m_history[(snapshotTick - baselineAge) % k_historySize];
+			if (baseline->tick != snapshotTick - baselineAge)
+				return false;
+		}
+
+		// Merge the changes into the baseline, both sorted by id.
+		m_decoded.clear();
+		const usize baselineCount = baseline != nullptr ? baseline->entities.size() : 0;
+		usize b = 0;
+		const u32 changeCount = reader.value(~0u);
+		u32 id = 0;
+		for (u32 i = 0; i < changeCount && reader.isValid; ++i)
+		{
+			const u32 idDelta = reader.value(~0u - id);
+			if (i > 0 && idDelta == 0)
+				return false;
+			id += idDelta;
+
+			for (; b < baselineCount && baseline->entities[b].id < id; ++b)
+				m_decoded.push_back(baseline->entities[b]);
+
+			const bool isInBaseline = b < baselineCount && baseline->entities[b].id == id;
+			const u8 flags = static_cast<u8>(reader.bits.readBits(k_flagBits));
+			if (isInBaseline ? flags == 0 || (flags & k_isNew) != 0 : flags != k_isNew)
+				return false;
+
+			QuantizedEntity entity;
+			if (flags == k_isNew)
+			{
+				entity.id = id;
+				entity.position[0] = reader.quantized(ranges.position[0]);
+				entity.position[1] = reader.quantized(ranges.position[1]);
+				entity.velocity[0] = reader.quantized(ranges.velocity);
+				entity.velocity[1] = reader.quantized(ranges.velocity);
+			}
+			else
+			{
+				entity = baseline->entities[b++];
+				if ((flags & k_positionChanged) != 0)
+				{
+					entity.position[0] = reader.delta(entity.position[0], ranges.position[0].maxSteps);
+					entity.position[1] = reader.delta(entity.position[1], ranges.position[1].maxSteps);
+				}
+				if ((flags & k_velocityChanged) != 0)
+				{
+					entity.velocity[0] = reader.delta(entity.velocity[0], ranges.velocity.maxSteps);
+					entity.velocity[1] = reader.delta(entity.velocity[1], ranges.velocity.maxSteps);
+				}
+			}
+			m_decoded.push_back(entity);
+		}
+		for (; b < baselineCount; ++b)
+			m_decoded.push_back(baseline->entities[b]);
+
+		// Removed ids are sorted too, so one pass drops them all.
+		const u32 removalCount = reader.value(~0u);
+		usize kept = 0;
+		usize next = 0;
+		id = 0;
+		for (u32 i = 0; i < removalCount && reader.isValid; ++i)
+		{
+			const u32 idDelta = reader.value(~0u - id);
+			if (i > 0 && idDelta == 0)
+				return false;
+			id += idDelta;
+
+			for (; next < m_decoded.size() && m_decoded[next].id < id; ++next)
+				m_decoded[kept++] = m_decoded[next];
+			if (next == m_decoded.size() || m_decoded[next].id != id)
+				return false;
+			++next;
+		}
+		for (; next < m_decoded.size(); ++next)
+			m_decoded[kept++] = m_decoded[next];
+		m_decoded.resize(kept);
+
+		if (!reader.isValid || reader.bits.hasOverflowed() || reader.bits.bytesRemaining() != 0)
+			return false;
+
+		SnapshotRecord &record = m_history[snapshotTick % k_historySize];
+		record.tick = snapshotTick;
+		record.entities.swap(m_decoded);
+
+		tick = snapshotTick;
+		entities.resize(record.entities.size());
+		for (usize i = 0; i < entities.size(); ++i)
+		{
+			const QuantizedEntity &entity = record.entities[i];
+			entities[i].id = entity.id;
+			entities[i].position = { ranges.position[0].dequantize(entity.position[0]), ranges.position[1].dequantize(entity.position[1]) };
+			entities[i].velocity = { ranges.velocity.dequantize(entity.velocity[0]), ranges.velocity.dequantize(entity.velocity[1]) };
+		}
+		return true;
+	}
+}
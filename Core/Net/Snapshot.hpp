@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Math/Vec2.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::net
+{
+	// What clients see of an entity.
+	struct EntityState
+	{
+		u32 id;
+		math::Vec2f position;
+		math::Vec2f velocity;
+	};
+
+	// Ranges and precision of the values sent. Values outside the ranges are clamped.
+	// The server and its clients must use the same format.
+	struct SnapshotFormat
+	{
+		math::Vec2f worldMin;
+		math::Vec2f worldMax;
+		f32 positionStep;
+		f32 maxSpeed;
+		f32 velocityStep;
+	};
+
+	// Entity state as sent, in steps of the format from the bottom of each range.
+	struct QuantizedEntity
+	{
+		u32 id;
+		u32 position[2];
+		u32 velocity[2];
+	};
+
+	struct SnapshotRecord
+	{
+		u32 tick = 0;
+		std::vector<QuantizedEntity, memory::TaggedAllocator<QuantizedEntity, memory::Tag::Net>> entities;
+	};
+
+	// Server side of one client's snapshots. Each snapshot is encoded against the newest one the client acknowledged,
+	// so it only carries entities that appeared, changed or went away since, and changes as quantized deltas.
+	// Until the client acknowledges one, or when its latest acknowledgement is too old, snapshots are sent whole.
+	class SnapshotEncoder
+	{
+	public:
+		// Snapshots kept as possible baselines, on both sides.
+		static constexpr u32 k_historySize = 32;
+
+		explicit SnapshotEncoder(const SnapshotFormat &format);
+
+		// Entities must be sorted by id. Ticks start at 1 and increase, but do not need to be consecutive.
+		void encode(u32 tick, const EntityState *entities, usize count, std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>> &out);
+
+		// The client decoded the snapshot of this tick.
+		void acknowledge(u32 tick);
+		// Zero when the next snapshot would be sent whole.
+		u32 baselineTick() const { return m_baselineTick; }
+
+	private:
+		// Entity of the snapshot being encoded and its counterpart in the baseline.
+		struct Change
+		{
+			u32 index;
+			u32 baselineIndex;
+			u8 flags;
+		};
+
+		SnapshotFormat m_format;
+		std::vector<SnapshotRecord, memory::TaggedAllocator<SnapshotRecord, memory::Tag::Net>> m_history;
+		std::vector<Change, memory::TaggedAllocator<Change, memory::Tag::Net>> m_changes;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Net>> m_removals;
+		u32 m_baselineTick = 0;
+	};
+
+	// Client side. Keeps the snapshots it decoded, which the server's next snapshots refer to.
+	class SnapshotDecoder
+	{
+	public:
+		explicit SnapshotDecoder(const SnapshotFormat &format);
+
+		// Entities come out sorted by id. Returns false when the data is malformed or refers to a snapshot
+		// this decoder no longer has, in which case nothing should be acknowledged.
+		bool decode(const u8 *data, usize size, u32 &tick, std::vector<EntityState, memory::TaggedAllocator<EntityState, memory::Tag::Net>> &entities);
+
+	private:
+		SnapshotFormat m_format;
+		std::vector<SnapshotRecord, memory::TaggedAllocator<SnapshotRecord, memory::Tag::Net>> m_history;
+		std::vector<QuantizedEntity, memory::TaggedAllocator<QuantizedEntity, memory::Tag::Net>> m_decoded;
+	};
+}
@@ -0,0 +1,120 @@
+#include "Core/Net/Socket.hpp"
+
+#if CORE_PLATFORM_WINDOWS
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <WinSock2.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace core::net
+{
+	namespace
+	{
+		sockaddr_in toSockaddr(const Address &address)
+		{
+			sockaddr_in result = {};
+			result.sin_family = AF_INET;
+			result.sin_addr.s_addr = htonl(address.ip);
+			result.sin_port = htons(address.port);
+			return result;
+		}
+
+#if CORE_PLATFORM_WINDOWS
+		bool startup()
+		{
+			static const bool s_isStarted = []()
+			{
+				WSADATA data;
+				return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+			}();
+			return s_isStarted;
+		}
+#endif
+	}
+
+	bool UdpSocket::open(u16 port)
+	{
+		close();
+
+#if CORE_PLATFORM_WINDOWS
+		if (!startup())
+			return false;
+#endif
+
+		m_handle = static_cast<Handle>(::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+		if (m_handle == k_invalidHandle)
+			return false;
+
+		const sockaddr_in address = toSockaddr({ INADDR_ANY, port });
+		if (::bind(m_handle, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+		{
+			close();
+			return false;
+		}
+
+#if CORE_PLATFORM_WINDOWS
+		u_long isNonBlocking = 1;
+		const bool isConfigured = ioctlsocket(m_handle, FIONBIO, &isNonBlocking) == 0;
+#else
+		const bool isConfigured = fcntl(m_handle, F_SETFL, O_NONBLOCK) == 0;
+#endif
+		sockaddr_in bound = {};
+#if CORE_PLATFORM_WINDOWS
+		int boundSize = sizeof(bound);
+#else
+		socklen_t boundSize = sizeof(bound);
+#endif
+		if (!isConfigured || ::getsockname(m_handle, reinterpret_cast<sockaddr *>(&bound), &boundSize) != 0)
+		{
+			close();
+			return false;
+		}
+
+		m_port = ntohs(bound.sin_port);
+		return true;
+	}
+
+	void UdpSocket::close()
+	{
+		if (m_handle == k_invalidHandle)
+			return;
+
+#if CORE_PLATFORM_WINDOWS
+		::closesocket(m_handle);
+#else
+		::close(m_handle);
+#endif
+		m_handle = k_invalidHandle;
+		m_port = 0;
+	}
+
+	bool UdpSocket::send(const Address &to, const void *data, usize size)
+	{
+		const sockaddr_in address = toSockaddr(to);
+		const auto sent = ::sendto(m_handle, static_cast<const char *>(data), static_cast<int>(size), 0, reinterpret_cast<const sockaddr *>(&address), sizeof(address));
+		return sent >= 0 && static_cast<usize>(sent) == size;
+	}
+
+	i32 UdpSocket::receive(Address &from, void *buffer, usize capacity)
+	{
+		sockaddr_in address = {};
+#if CORE_PLATFORM_WINDOWS
+		int addressSize = sizeof(address);
+#else
+		socklen_t addressSize = sizeof(address);
+#endif
+		const auto received = ::recvfrom(m_handle, static_cast<char *>(buffer), static_cast<int>(capacity), 0, reinterpret_cast<sockaddr *>(&address), &addressSize);
+		if (received < 0)
+			return -1;
+
+		from = { ntohl(address.sin_addr.s_addr), ntohs(address.sin_port) };
+		return static_cast<i32>(received);
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Core/Platform.hpp"
+#include "Core/Types.hpp"
+
+namespace core::net
+{
+	// IPv4 endpoint, in host byte order.
+	struct Address
+	{
+		u32 ip = 0;
+		u16 port = 0;
+
+		static constexpr Address loopback(u16 port) { return { 0x7f000001u, port }; }
+
+		bool operator==(const Address &other) const { return ip == other.ip && port == other.port; }
+		bool operator!=(const Address &other) const { return !(*this == other); }
+	};
+
+	// Datagrams larger than this may be split by the network on the way, and lost whole if any piece is.
+	constexpr usize k_maxDatagramSize = 1200;
+
+	// Nonblocking UDP socket.
+	class UdpSocket
+	{
+	public:
+		UdpSocket() = default;
+		~UdpSocket() { close(); }
+
+		UdpSocket(const UdpSocket &) = delete;
+		UdpSocket &operator=(const UdpSocket &) = delete;
+
+		// Port 0 lets the system pick one; localPort() tells which.
+		bool open(u16 port = 0);
+		void close();
+		bool isOpen() const { return m_handle != k_invalidHandle; }
+		u16 localPort() const { return m_port; }
+
+		bool send(const Address &to, const void *data, usize size);
+		// Size of the datagram copied to buffer, or -1 when none is waiting. Datagrams larger than capacity do not arrive whole.
+		i32 receive(Address &from, void *buffer, usize capacity);
+
+	private:
+#if CORE_PLATFORM_WINDOWS
+		using Handle = u64;
+		static constexpr Handle k_invalidHandle = ~0ull;
+#else
+		using Handle = int;
+		static constexpr Handle k_invalidHandle = -1;
+#endif
+
+		Handle m_handle = k_invalidHandle;
+		u16 m_port = 0;
+	};
+}
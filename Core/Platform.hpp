@@ -0,0 +1,37 @@
+#pragma once
+
+#if defined(_WIN32)
+#define CORE_PLATFORM_WINDOWS 1
+#define CORE_PLATFORM_POSIX 0
+#else
+#define CORE_PLATFORM_WINDOWS 0
+#define CORE_PLATFORM_POSIX 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CORE_NOINLINE __declspec(noinline)
+#else
+#define CORE_NOINLINE __attribute__((noinline))
+#endif
+
+// True while the enclosing constexpr function is being evaluated by the compiler.
+// Lets constexpr code fall back from intrinsics and the C runtime to portable implementations.
+#define CORE_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+
+// C++20 coroutines, available when the projects are built with CoreLanguageStandard set to stdcpp20.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define CORE_HAS_COROUTINES 1
+#else
+#define CORE_HAS_COROUTINES 0
+#endif
+
+namespace core
+{
+	// Compile time capable reinterpretation of the bits of a trivially copyable value.
+	template<typename To, typename From>
+	constexpr To bitCast(const From &from)
+	{
+		static_assert(sizeof(To) == sizeof(From), "bitCast requires types of the same size.");
+		return __builtin_bit_cast(To, from);
+	}
+}
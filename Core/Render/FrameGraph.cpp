@@ -0,0 +1,392 @@
+#include "Core/Render/FrameGraph.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace core::render
+{
+	namespace
+	{
+		constexpr usize alignToBuffer(usize value)
+		{
+			return (value + k_bufferAlignment - 1) & ~(k_bufferAlignment - 1);
+		}
+
+		bool isSubset(const u64 *set, const u64 *of, usize words)
+		{
+			for (usize i = 0; i < words; ++i)
+			{
+				if ((set[i] & ~of[i]) != 0)
+					return false;
+			}
+			return true;
+		}
+	}
+
+	FrameGraph::~FrameGraph()
+	{
+		if (m_heap != nullptr)
+			memory::deallocate(m_heap, m_heapCapacity, memory::Tag::Render, k_bufferAlignment);
+		if (m_runs != nullptr)
+			memory::deallocate(m_runs, sizeof(PassRun) * m_runCapacity, memory::Tag::Render, alignof(PassRun));
+	}
+
+	BufferHandle FrameGraph::createBuffer(const char *name, usize size)
+	{
+		assert(!m_isCompiled && "Reset the graph before building the next frame.");
+		m_buffers.push_back({ name, nullptr, size, 0, false });
+		return { static_cast<u32>(m_buffers.size() - 1) };
+	}
+
+	BufferHandle FrameGraph::importBuffer(const char *name, void *memory, usize size)
+	{
+		assert(!m_isCompiled && "Reset the graph before building the next frame.");
+		m_buffers.push_back({ name, memory, size, 0, true });
+		return { static_cast<u32>(m_buffers.size() - 1) };
+	}
+
+	PassHandle FrameGraph::addPass(const char *name, PassFunction function, void *data)
+	{
+		assert(!m_isCompiled && "Reset the graph before building the next frame.");
+		assert(function != nullptr);
+
+		Pass pass = {};
+		pass.name = name;
+		pass.function = function;
+		pass.data = data;
+		pass.firstAccess = static_cast<u32>(m_accesses.size());
+		m_passes.push_back(pass);
+		return { static_cast<u32>(m_passes.size() - 1) };
+	}
+
+	void FrameGraph::read(PassHandle pass, BufferHandle buffer)
+	{
+		addAccess(pass, buffer, false);
+	}
+
+	void FrameGraph::write(PassHandle pass, BufferHandle buffer)
+	{
+		addAccess(pass, buffer, true);
+	}
+
+	void FrameGraph::setSideEffect(PassHandle pass)
+	{
+		m_passes[pass.index].hasSideEffect = true;
+	}
+
+	void FrameGraph::addAccess(PassHandle pass, BufferHandle buffer, bool isWrite)
+	{
+		assert(!m_isCompiled && "Reset the graph before building the next frame.");
+		assert(pass.index + 1 == m_passes.size() && "Accesses are declared right after their pass is added.");
+		assert(buffer.index < m_buffers.size());
+
+		m_accesses.push_back({ buffer.index, isWrite });
+		++m_passes[pass.index].accessCount;
+	}
+
+	void FrameGraph::compile()
+	{
+		assert(!m_isCompiled);
+
+		cull();
+		buildDependencies();
+		allocateBuffers();
+		m_isCompiled = true;
+	}
+
+	void FrameGraph::cull()
+	{
+		// Walking backwards, a pass lives when something observable or a living pass after it reads what it writes.
+		m_scratch.assign(m_buffers.size(), 0);
+		u32 *isRead = m_scratch.data();
+
+		m_livePassCount = 0;
+		for (usize index = m_passes.size(); index-- > 0;)
+		{
+			Pass &pass = m_passes[index];
+			const Access *accesses = m_accesses.data() + pass.firstAccess;
+
+			bool isLive = pass.hasSideEffect;
+			for (u32 i = 0; i < pass.accessCount && !isLive; ++i)
+				isLive = accesses[i].isWrite && (m_buffers[accesses[i].buffer].isImported || isRead[accesses[i].buffer] != 0);
+
+			pass.isCulled = !isLive;
+			if (!isLive)
+				continue;
+
+			++m_livePassCount;
+			for (u32 i = 0; i < pass.accessCount; ++i)
+			{
+				if (!accesses[i].isWrite)
+					isRead[accesses[i].buffer] = 1;
+			}
+		}
+	}
+
+	void FrameGraph::buildDependencies()
+	{
+		// A read waits for the latest write; a write waits for the latest write and every read since.
+		// Edges are packed as (from << 32 | to), so sorting them groups each pass's successors.
+		const usize bufferCount = m_buffers.size();
+		m_scratch.assign(bufferCount * 2 + m_accesses.size() * 2, k_none);
+		u32 *lastWriter = m_scratch.data();
+		u32 *firstReader = lastWriter + bufferCount;
+		u32 *readerPass = firstReader + bufferCount;
+		u32 *nextReader = readerPass + m_accesses.size();
+
+		m_edges.clear();
+		const auto addEdge = [this](u32 from, u32 to)
+		{
+			if (from != k_none && from != to)
+				m_edges.push_back((u64(from) << 32) | to);
+		};
+
+		for (u32 index = 0; index < m_passes.size(); ++index)
+		{
+			const Pass &pass = m_passes[index];
+			if (pass.isCulled)
+				continue;
+
+			for (u32 i = 0; i < pass.accessCount; ++i)
+			{
+				const u32 accessIndex = pass.firstAccess + i;
+				const u32 buffer = m_accesses[accessIndex].buffer;
+				addEdge(lastWriter[buffer], index);
+
+				if (m_accesses[accessIndex].isWrite)
+				{
+					for (u32 reader = firstReader[buffer]; reader != k_none; reader = nextReader[reader])
+						addEdge(readerPass[reader], index);
+					firstReader[buffer] = k_none;
+					lastWriter[buffer] = index;
+				}
+				else
+				{
+					readerPass[accessIndex] = index;
+					nextReader[accessIndex] = firstReader[buffer];
+					firstReader[buffer] = accessIndex;
+				}
+			}
+		}
+
+		std::sort(m_edges.begin(), m_edges.end());
+		m_edges.erase(std::unique(m_edges.begin(), m_edges.end()), m_edges.end());
+
+		m_successors.resize(m_edges.size());
+		for (Pass &pass : m_passes)
+		{
+			pass.successorCount = 0;
+			pass.predecessorCount = 0;
+		}
+
+		for (usize i = 0; i < m_edges.size(); ++i)
+		{
+			Pass &from = m_passes[static_cast<u32>(m_edges[i] >> 32)];
+			const u32 to = static_cast<u32>(m_edges[i]);
+			if (from.successorCount == 0)
+				from.firstSuccessor = static_cast<u32>(i);
+			++from.successorCount;
+			++m_passes[to].predecessorCount;
+			m_successors[i] = to;
+		}
+	}
+
+	void FrameGraph::allocateBuffers()
+	{
+		// Passes reachable from each pass, built backwards since every edge points forward in declaration order.
+		const usize passCount = m_passes.size();
+		const usize words = (passCount + 63) / 64;
+		m_reachable.assign(passCount * words, 0);
+		for (usize index = passCount; index-- > 0;)
+		{
+			const Pass &pass = m_passes[index];
+			u64 *reachable = m_reachable.data() + index * words;
+			for (u32 i = 0; i < pass.successorCount; ++i)
+			{
+				const u32 successor = m_successors[pass.firstSuccessor + i];
+				const u64 *further = m_reachable.data() + successor * words;
+				reachable[successor / 64] |= u64(1) << (successor % 64);
+				for (usize word = 0; word < words; ++word)
+					reachable[word] |= further[word];
+			}
+		}
+
+		// For every buffer, the live passes using it, and the passes that only run once all of those are done.
+		const usize bufferCount = m_buffers.size();
+		m_users.assign(bufferCount * words, 0);
+		m_afterUses.assign(bufferCount * words, ~u64(0));
+		for (u32 index = 0; index < passCount; ++index)
+		{
+			const Pass &pass = m_passes[index];
+			if (pass.isCulled)
+				continue;
+
+			const u64 *reachable = m_reachable.data() + index * words;
+			for (u32 i = 0; i < pass.accessCount; ++i)
+			{
+				const u32 buffer = m_accesses[pass.firstAccess + i].buffer;
+				m_users[buffer * words + index / 64] |= u64(1) << (index % 64);
+				u64 *afterUses = m_afterUses.data() + buffer * words;
+				for (usize word = 0; word < words; ++word)
+					afterUses[word] &= reachable[word];
+			}
+		}
+
+		const auto isUsed = [this, words](u32 buffer)
+		{
+			const u64 *users = m_users.data() + buffer * words;
+			return std::any_of(users, users + words, [](u64 word) { return word != 0; });
+		};
+
+		// Two buffers can share memory when every use of one is ordered before every use of the other.
+		const auto canAlias = [this, words](u32 first, u32 second)
+		{
+			return isSubset(m_users.data() + second * words, m_afterUses.data() + first * words, words)
+				|| isSubset(m_users.data() + first * words, m_afterUses.data() + second * words, words);
+		};
+
+		m_scratch.clear();
+		m_requestedTransientBytes = 0;
+		for (u32 buffer = 0; buffer < bufferCount; ++buffer)
+		{
+			if (m_buffers[buffer].isImported)
+				continue;
+
+			m_buffers[buffer].memory = nullptr;
+			if (isUsed(buffer))
+			{
+				m_scratch.push_back(buffer);
+				m_requestedTransientBytes += alignToBuffer(m_buffers[buffer].size);
+			}
+		}
+
+		// Largest first, each at the lowest offset clear of the buffers it cannot alias.
+		std::stable_sort(m_scratch.begin(), m_scratch.end(), [this](u32 a, u32 b)
+		{
+			return m_buffers[a].size > m_buffers[b].size;
+		});
+
+		m_transientBytes = 0;
+		for (usize placed = 0; placed < m_scratch.size(); ++placed)
+		{
+			const u32 buffer = m_scratch[placed];
+			m_conflicts.clear();
+			for (usize i = 0; i < placed; ++i)
+			{
+				if (!canAlias(buffer, m_scratch[i]))
+					m_conflicts.push_back(m_scratch[i]);
+			}
+
+			std::sort(m_conflicts.begin(), m_conflicts.end(), [this](u32 a, u32 b)
+			{
+				return m_buffers[a].offset < m_buffers[b].offset;
+			});
+
+			const usize size = alignToBuffer(m_buffers[buffer].size);
+			usize offset = 0;
+			for (u32 conflict : m_conflicts)
+			{
+				const Buffer &other = m_buffers[conflict];
+				if (offset + size <= other.offset)
+					break;
+				offset = std::max(offset, other.offset + alignToBuffer(other.size));
+			}
+
+			m_buffers[buffer].offset = offset;
+			m_transientBytes = std::max(m_transientBytes, offset + size);
+		}
+
+		if (m_transientBytes > m_heapCapacity)
+		{
+			if (m_heap != nullptr)
+				memory::deallocate(m_heap, m_heapCapacity, memory::Tag::Render, k_bufferAlignment);
+			m_heap = static_cast<u8 *>(memory::allocate(m_transientBytes, memory::Tag::Render, k_bufferAlignment));
+			m_heapCapacity = m_transientBytes;
+		}
+
+		for (u32 buffer : m_scratch)
+			m_buffers[buffer].memory = m_heap + m_buffers[buffer].offset;
+	}
+
+	void FrameGraph::execute(jobs::JobSystem &jobs)
+	{
+		assert(m_isCompiled);
+
+		const u32 passCount = static_cast<u32>(m_passes.size());
+		reserveRuns(passCount);
+		for (u32 index = 0; index < passCount; ++index)
+		{
+			m_runs[index].graph = this;
+			m_runs[index].pass = index;
+			m_runs[index].remaining.store(m_passes[index].predecessorCount, std::memory_order_relaxed);
+		}
+
+		jobs::Counter counter;
+		m_jobs = &jobs;
+		m_counter = &counter;
+
+		// Passes with nothing to wait for start now; the rest are started by the last pass they wait for.
+		for (u32 index = 0; index < passCount; ++index)
+		{
+			if (!m_passes[index].isCulled && m_passes[index].predecessorCount == 0)
+				jobs.run(jobs::Job{ &FrameGraph::runPass, &m_runs[index] }, &counter);
+		}
+
+		jobs.wait(counter);
+		m_jobs = nullptr;
+		m_counter = nullptr;
+	}
+
+	void FrameGraph::execute()
+	{
+		assert(m_isCompiled);
+
+		for (const Pass &pass : m_passes)
+		{
+			if (!pass.isCulled)
+				pass.function(*this, pass.data);
+		}
+	}
+
+	void FrameGraph::reset()
+	{
+		m_passes.clear();
+		m_buffers.clear();
+		m_accesses.clear();
+		m_successors.clear();
+		m_edges.clear();
+		m_requestedTransientBytes = 0;
+		m_transientBytes = 0;
+		m_livePassCount = 0;
+		m_isCompiled = false;
+	}
+
+	void FrameGraph::runPass(void *data)
+	{
+		PassRun &run = *static_cast<PassRun *>(data);
+		FrameGraph &graph = *run.graph;
+		const Pass &pass = graph.m_passes[run.pass];
+		pass.function(graph, pass.data);
+
+		for (u32 i = 0; i < pass.successorCount; ++i)
+		{
+			PassRun &successor = graph.m_runs[graph.m_successors[pass.firstSuccessor + i]];
+			if (successor.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				graph.m_jobs->run(jobs::Job{ &FrameGraph::runPass, &successor }, graph.m_counter);
+		}
+	}
+
+	void FrameGraph::reserveRuns(u32 count)
+	{
+		if (count <= m_runCapacity)
+			return;
+
+		if (m_runs != nullptr)
+			memory::deallocate(m_runs, sizeof(PassRun) * m_runCapacity, memory::Tag::Render, alignof(PassRun));
+
+		m_runs = static_cast<PassRun *>(memory::allocate(sizeof(PassRun) * count, memory::Tag::Render, alignof(PassRun)));
+		for (u32 i = 0; i < count; ++i)
+			new (&m_runs[i]) PassRun();
+		m_runCapacity = count;
+	}
+}
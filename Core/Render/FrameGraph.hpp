@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::render
+{
+	class FrameGraph;
+
+	struct PassHandle
+	{
+		static constexpr u32 k_invalid = ~0u;
+
+		u32 index = k_invalid;
+
+		bool isValid() const { return index != k_invalid; }
+	};
+
+	struct BufferHandle
+	{
+		static constexpr u32 k_invalid = ~0u;
+
+		u32 index = k_invalid;
+
+		bool isValid() const { return index != k_invalid; }
+	};
+
+	// Records or runs the pass. Buffers the pass declared are reached through the graph.
+	using PassFunction = void (*)(FrameGraph &graph, void *data);
+
+	// Transient buffers start on this boundary.
+	constexpr usize k_bufferAlignment = 64;
+
+	// A frame's work as passes that declare which buffers they read and write.
+	// Each frame: add passes and buffers, compile(), execute(), reset().
+	// Compiling culls passes nothing observable depends on, orders the rest by their accesses, and packs transient
+	// buffers into one heap, where buffers whose uses can never overlap share memory.
+	// Declaration order is the reference order: a read sees the latest earlier write to the buffer.
+	class FrameGraph
+	{
+	public:
+		FrameGraph() = default;
+		~FrameGraph();
+
+		FrameGraph(const FrameGraph &) = delete;
+		FrameGraph &operator=(const FrameGraph &) = delete;
+
+		// Memory the graph owns for the frame. It is only valid while passes execute.
+		BufferHandle createBuffer(const char *name, usize size);
+		// Memory owned outside the graph, which outlives the frame. Passes writing it are never culled.
+		BufferHandle importBuffer(const char *name, void *memory, usize size);
+
+		PassHandle addPass(const char *name, PassFunction function, void *data);
+		// Accesses are declared right after their pass is added. Writes do not read the buffer's earlier contents;
+		// a pass that updates a buffer in place declares both.
+		void read(PassHandle pass, BufferHandle buffer);
+		void write(PassHandle pass, BufferHandle buffer);
+		// Keeps a pass whose effects the graph cannot see, such as presenting.
+		void setSideEffect(PassHandle pass);
+
+		void compile();
+
+		// Runs every pass that survived culling, each on a job worker as soon as the passes it depends on are done.
+		// Returns once all of them finished.
+		void execute(jobs::JobSystem &jobs);
+		// Runs the passes one after the other on the calling thread, in declaration order.
+		void execute();
+
+		// Drops this frame's passes and buffers. The heap is kept for the next frame.
+		void reset();
+
+		// Only valid inside a pass that declared the buffer, or for imported buffers.
+		void *buffer(BufferHandle buffer) const { return m_buffers[buffer.index].memory; }
+		usize bufferSize(BufferHandle buffer) const { return m_buffers[buffer.index].size; }
+
+		bool isCulled(PassHandle pass) const { return m_passes[pass.index].isCulled; }
+		u32 passCount() const { return static_cast<u32>(m_passes.size()); }
+		u32 livePassCount() const { return m_livePassCount; }
+
+		// Bytes of this frame's transient buffers, before and after aliasing.
+		usize requestedTransientBytes() const { return m_requestedTransientBytes; }
+		usize transientBytes() const { return m_transientBytes; }
+
+	private:
+		static constexpr u32 k_none = ~0u;
+
+		struct Pass
+		{
+			const char *name;
+			PassFunction function;
+			void *data;
+			u32 firstAccess;
+			u32 accessCount;
+			// Range of m_successors, filled by compile().
+			u32 firstSuccessor;
+			u32 successorCount;
+			u32 predecessorCount;
+			bool hasSideEffect;
+			bool isCulled;
+		};
+
+		struct Buffer
+		{
+			const char *name;
+			void *memory;
+			usize size;
+			usize offset;
+			bool isImported;
+		};
+
+		struct Access
+		{
+			u32 buffer;
+			bool isWrite;
+		};
+
+		// Job data for one pass. Kept apart from Pass so the pass list can grow while nothing runs.
+		struct PassRun
+		{
+			FrameGraph *graph;
+			u32 pass;
+			std::atomic<u32> remaining;
+		};
+
+		static void runPass(void *data);
+
+		void addAccess(PassHandle pass, BufferHandle buffer, bool isWrite);
+		void cull();
+		void buildDependencies();
+		void allocateBuffers();
+		void reserveRuns(u32 count);
+
+		std::vector<Pass, memory::TaggedAllocator<Pass, memory::Tag::Render>> m_passes;
+		std::vector<Buffer, memory::TaggedAllocator<Buffer, memory::Tag::Render>> m_buffers;
+		std::vector<Access, memory::TaggedAllocator<Access, memory::Tag::Render>> m_accesses;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Render>> m_successors;
+
+		// Scratch for compile(), kept to avoid allocating every frame. The u64 sets hold one bit per pass.
+		std::vector<u64, memory::TaggedAllocator<u64, memory::Tag::Render>> m_edges;
+		std::vector<u64, memory::TaggedAllocator<u64, memory::Tag::Render>> m_reachable;
+		std::vector<u64, memory::TaggedAllocator<u64, memory::Tag::Render>> m_users;
+		std::vector<u64, memory::TaggedAllocator<u64, memory::Tag::Render>> m_afterUses;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Render>> m_scratch;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Render>> m_conflicts;
+
+		PassRun *m_runs = nullptr;
+		u32 m_runCapacity = 0;
+		jobs::JobSystem *m_jobs = nullptr;
+		jobs::Counter *m_counter = nullptr;
+
+		u8 *m_heap = nullptr;
+		usize m_heapCapacity = 0;
+		usize m_requestedTransientBytes = 0;
+		usize m_transientBytes = 0;
+		u32 m_livePassCount = 0;
+		bool m_isCompiled = false;
+	};
+}
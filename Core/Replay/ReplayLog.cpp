@@ -0,0 +1,185 @@
+#include "Core/Replay/ReplayLog.hpp"
+
+#include <cassert>
+
+#include "Core/Compression/Lz4.hpp"
+#include "Core/Serialization/BitStream.hpp"
+
+namespace core::replay
+{
+	namespace
+	{
+		// A block closes on the record that reaches k_replayBlockSize, which may be as large as a record gets.
+		constexpr usize k_maxRecordSize = 10 + k_maxTickInputSize + 8;
+		constexpr usize k_maxBlockSize = k_replayBlockSize + k_maxRecordSize;
+	}
+
+	bool ReplayWriter::open(const char *path)
+	{
+		close();
+
+		m_out.open(path, std::ios::binary | std::ios::trunc);
+		if (!m_out)
+			return false;
+
+		const ReplayHeader header = { ReplayHeader::k_magic, ReplayHeader::k_version };
+		m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		m_record.resize(k_maxRecordSize);
+		m_block.reserve(k_maxBlockSize);
+		m_tickCount = 0;
+		return static_cast<bool>(m_out);
+	}
+
+	bool ReplayWriter::close()
+	{
+		if (!m_out.is_open())
+			return true;
+
+		writeBlock();
+		const bool isWritten = static_cast<bool>(m_out);
+		m_out.close();
+		return isWritten;
+	}
+
+	bool ReplayWriter::writeTick(const void *input, usize size)
+	{
+		return write(input, size, false, 0);
+	}
+
+	bool ReplayWriter::writeTick(const void *input, usize size, u64 checksum)
+	{
+		return write(input, size, true, checksum);
+	}
+
+	bool ReplayWriter::write(const void *input, usize size, bool hasChecksum, u64 checksum)
+	{
+		assert(m_out.is_open());
+
+		// Readers reject such records as corrupt, and the record would overrun its room in the block.
+		if (size > k_maxTickInputSize)
+			return false;
+
+		// Encoded aside and appended at its real size: growing the block by k_maxRecordSize would zero that much
+		// every tick, which unoptimized builds feel.
+		BitWriter writer(m_record.data(), m_record.size());
+		writer.writeVarint(static_cast<u64>(size) << 1 | (hasChecksum ? 1 : 0));
+		if (size > 0)
+			writer.writeBytes(input, size);
+		if (hasChecksum)
+			writer.writeBits(checksum, 64);
+		m_block.insert(m_block.end(), m_record.data(), m_record.data() + writer.finish());
+		++m_tickCount;
+
+		if (m_block.size() >= k_replayBlockSize)
+			writeBlock();
+		return true;
+	}
+
+	void ReplayWriter::writeBlock()
+	{
+		if (m_block.empty())
+			return;
+
+		m_compressed.resize(lz4::compressBound(m_block.size()));
+		usize storedSize = lz4::compress(m_block.data(), m_block.size(), m_compressed.data(), m_compressed.size());
+		const u8 *stored = m_compressed.data();
+		if (storedSize == 0 || storedSize >= m_block.size())
+		{
+			storedSize = m_block.size();
+			stored = m_block.data();
+		}
+
+		const BlockHeader header = { static_cast<u32>(storedSize), static_cast<u32>(m_block.size()) };
+		m_out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		m_out.write(reinterpret_cast<const char *>(stored), static_cast<std::streamsize>(storedSize));
+		m_block.clear();
+	}
+
+	bool ReplayReader::open(const char *path)
+	{
+		close();
+		if (!m_file.open(path))
+			return false;
+
+		ReplayHeader header;
+		if (m_file.read(0, &header, sizeof(header)) != static_cast<i64>(sizeof(header)) || header.magic != ReplayHeader::k_magic || header.version != ReplayHeader::k_version)
+		{
+			close();
+			return false;
+		}
+
+		m_offset = sizeof(header);
+		return true;
+	}
+
+	void ReplayReader::close()
+	{
+		m_file.close();
+		m_block.clear();
+		m_offset = 0;
+		m_position = 0;
+		m_tickIndex = 0;
+		m_isCorrupt = false;
+	}
+
+	bool ReplayReader::next(ReplayTick &tick)
+	{
+		if (m_isCorrupt || !m_file.isOpen())
+			return false;
+		if (m_position == m_block.size() && !readBlock())
+			return false;
+
+		BitReader reader(m_block.data() + m_position, m_block.size() - m_position);
+		const u64 header = reader.readVarint();
+		tick.inputSize = static_cast<usize>(header >> 1);
+		tick.hasChecksum = (header & 1) != 0;
+		tick.input = tick.inputSize > 0 && tick.inputSize <= k_maxTickInputSize ? reader.viewBytes(tick.inputSize) : nullptr;
+		tick.checksum = tick.hasChecksum ? reader.readBits(64) : 0;
+		if (reader.hasOverflowed() || tick.inputSize > k_maxTickInputSize)
+		{
+			m_isCorrupt = true;
+			return false;
+		}
+
+		m_position += reader.bitsRead() / 8;
+		++m_tickIndex;
+		return true;
+	}
+
+	bool ReplayReader::readBlock()
+	{
+		m_block.clear();
+		m_position = 0;
+
+		BlockHeader header;
+		const i64 headerRead = m_file.read(m_offset, &header, sizeof(header));
+		if (headerRead == 0)
+			return false;
+
+		// Cut short, or sizes no writer produces: the log was truncated or damaged.
+		if (headerRead != static_cast<i64>(sizeof(header)) || header.size == 0 || header.size > k_maxBlockSize || header.storedSize > header.size)
+		{
+			m_isCorrupt = true;
+			return false;
+		}
+
+		m_block.resize(header.size);
+		u8 *stored = m_block.data();
+		if (header.storedSize != header.size)
+		{
+			m_compressed.resize(header.storedSize);
+			stored = m_compressed.data();
+		}
+
+		if (m_file.read(m_offset + sizeof(header), stored, header.storedSize) != header.storedSize
+			|| (stored != m_block.data() && !lz4::decompress(stored, header.storedSize, m_block.data(), header.size)))
+		{
+			m_block.clear();
+			m_isCorrupt = true;
+			return false;
+		}
+
+		m_offset += sizeof(header) + header.storedSize;
+		return true;
+	}
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <fstream>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/IO/File.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::replay
+{
+	// On disk layout: ReplayHeader, then blocks of tick records, each a BlockHeader followed by its LZ4 compressed bytes.
+	// A tick record is a varint of the input size shifted left once, the low bit telling whether a checksum follows,
+	// then the input bytes, then the u64 checksum.
+	struct ReplayHeader
+	{
+		static constexpr u32 k_magic = 0x524e4741;	// "ANGR"
+		static constexpr u32 k_version = 1;
+
+		u32 magic;
+		u32 version;
+	};
+
+	struct BlockHeader
+	{
+		// Equal to size when the block did not compress and is stored raw.
+		u32 storedSize;
+		u32 size;
+	};
+
+	// Tick records gather until this many bytes, then are compressed as one block.
+	constexpr usize k_replayBlockSize = 64 * 1024;
+	constexpr usize k_maxTickInputSize = 64 * 1024;
+
+	struct ReplayTick
+	{
+		// In the reader's block, valid until the next call to next().
+		const u8 *input = nullptr;
+		usize inputSize = 0;
+		bool hasChecksum = false;
+		u64 checksum = 0;
+	};
+
+	// Records what a simulation consumed each tick, and now and then a checksum of its state after the tick,
+	// so a playback can feed the same input and tell the first tick where it stopped matching.
+	class ReplayWriter
+	{
+	public:
+		ReplayWriter() = default;
+		~ReplayWriter() { close(); }
+
+		ReplayWriter(const ReplayWriter &) = delete;
+		ReplayWriter &operator=(const ReplayWriter &) = delete;
+
+		bool open(const char *path);
+		// Writes the last block. Returns false when any write failed.
+		bool close();
+		bool isOpen() const { return m_out.is_open(); }
+
+		// Ticks are numbered in the order they are written.
+		// Returns false, and writes nothing, when size is past k_maxTickInputSize.
+		bool writeTick(const void *input, usize size);
+		bool writeTick(const void *input, usize size, u64 checksum);
+
+		u64 tickCount() const { return m_tickCount; }
+
+	private:
+		bool write(const void *input, usize size, bool hasChecksum, u64 checksum);
+		void writeBlock();
+
+		std::ofstream m_out;
+		// One tick's record, encoded here before it joins the block.
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::IO>> m_record;
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::IO>> m_block;
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::IO>> m_compressed;
+		u64 m_tickCount = 0;
+	};
+
+	// Reads a log back one tick at a time, a block in memory at once.
+	class ReplayReader
+	{
+	public:
+		// Returns false when the file is missing or is not a replay of this version.
+		bool open(const char *path);
+		void close();
+
+		// Returns false at the end of the log, or at the first record that cannot be read; isCorrupt() tells which.
+		bool next(ReplayTick &tick);
+		bool isCorrupt() const { return m_isCorrupt; }
+
+		// Ticks read so far.
+		u64 tickIndex() const { return m_tickIndex; }
+
+	private:
+		bool readBlock();
+
+		io::File m_file;
+		u64 m_offset = 0;
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::IO>> m_block;
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::IO>> m_compressed;
+		usize m_position = 0;
+		u64 m_tickIndex = 0;
+		bool m_isCorrupt = false;
+	};
+}
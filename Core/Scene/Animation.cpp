@@ -0,0 +1,301 @@
+#include "Core/Scene/Animation.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "Core/Math/FastMath.hpp"
+#include "Core/Math/Simd.hpp"
+
+namespace core::scene
+{
+	namespace
+	{
+		constexpr f32 k_twoPi = 6.28318530717958647692f;
+		constexpr f32 k_quantumCount = 65535.0f;
+
+		// Stored channel of the rotation, which sampling turns into PoseChannel::Cos and Sin.
+		constexpr u32 k_angleChannel = 2;
+		constexpr PoseChannel k_sampledChannels[] = { PoseChannel::X, PoseChannel::Y, PoseChannel::Count, PoseChannel::ScaleX, PoseChannel::ScaleY };
+
+		u32 roundUpToWidth(u32 count)
+		{
+			const u32 width = static_cast<u32>(math::F32x4::k_width);
+			return (count + width - 1) / width * width;
+		}
+
+		math::F32x4 gather(const u16 *keys)
+		{
+			return math::F32x4(static_cast<f32>(keys[0]), static_cast<f32>(keys[1]), static_cast<f32>(keys[2]), static_cast<f32>(keys[3]));
+		}
+
+		void advance(const AnimationClip *clip, f32 &time, f32 dt, bool loops)
+		{
+			if (clip == nullptr)
+				return;
+
+			const f32 duration = clip->duration();
+			time += dt;
+			if (loops && duration > 0.0f)
+			{
+				time = std::fmod(time, duration);
+				if (time < 0.0f)
+					time += duration;
+			}
+			else
+			{
+				time = std::clamp(time, 0.0f, duration);
+			}
+		}
+	}
+
+	Skeleton::Skeleton(const u32 *parents, u32 jointCount)
+		: m_parents(parents, parents + jointCount)
+		, m_stride(roundUpToWidth(jointCount))
+	{
+		for (u32 joint = 0; joint < jointCount; ++joint)
+			assert((parents[joint] == k_noParent || parents[joint] < joint) && "Parents must come before their children.");
+	}
+
+	LocalPose::LocalPose(const Skeleton &skeleton)
+		: m_stride(skeleton.stride())
+	{
+		// Padding joints hold the identity, so every lane blends and normalizes cleanly.
+		m_values.assign(usize(PoseChannel::Count) * m_stride, 0.0f);
+		std::fill_n(channel(PoseChannel::Cos), m_stride, 1.0f);
+		std::fill_n(channel(PoseChannel::ScaleX), m_stride, 1.0f);
+		std::fill_n(channel(PoseChannel::ScaleY), m_stride, 1.0f);
+	}
+
+	JointPose LocalPose::joint(u32 index) const
+	{
+		JointPose pose;
+		pose.translation = math::Vec2f(channel(PoseChannel::X)[index], channel(PoseChannel::Y)[index]);
+		pose.rotation = std::atan2(channel(PoseChannel::Sin)[index], channel(PoseChannel::Cos)[index]);
+		pose.scale = math::Vec2f(channel(PoseChannel::ScaleX)[index], channel(PoseChannel::ScaleY)[index]);
+		return pose;
+	}
+
+	void LocalPose::setJoint(u32 index, const JointPose &pose)
+	{
+		channel(PoseChannel::X)[index] = pose.translation.x;
+		channel(PoseChannel::Y)[index] = pose.translation.y;
+		channel(PoseChannel::Cos)[index] = std::cos(pose.rotation);
+		channel(PoseChannel::Sin)[index] = std::sin(pose.rotation);
+		channel(PoseChannel::ScaleX)[index] = pose.scale.x;
+		channel(PoseChannel::ScaleY)[index] = pose.scale.y;
+	}
+
+	AnimationClip::AnimationClip(const Skeleton &skeleton, const JointPose *keys, u32 frameCount, f32 sampleRate)
+		: m_stride(skeleton.stride())
+		, m_frameCount(frameCount)
+		, m_sampleRate(sampleRate)
+	{
+		assert(frameCount > 0 && sampleRate > 0.0f);
+
+		const u32 jointCount = skeleton.jointCount();
+		const usize blockSize = usize(k_storedChannels) * m_stride;
+
+		// Every channel of every key as a float, in the stored layout, with each joint's rotation made continuous.
+		std::vector<f32, memory::TaggedAllocator<f32, memory::Tag::Scene>> values(blockSize * frameCount, 0.0f);
+		for (u32 frame = 0; frame < frameCount; ++frame)
+		{
+			f32 *block = values.data() + frame * blockSize;
+			for (u32 joint = 0; joint < jointCount; ++joint)
+			{
+				const JointPose &pose = keys[usize(frame) * jointCount + joint];
+				f32 angle = pose.rotation;
+				if (frame > 0)
+				{
+					const f32 previous = values[(frame - 1) * blockSize + k_angleChannel * m_stride + joint];
+					angle = previous + std::remainder(pose.rotation - previous, k_twoPi);
+				}
+
+				block[0 * m_stride + joint] = pose.translation.x;
+				block[1 * m_stride + joint] = pose.translation.y;
+				block[k_angleChannel * m_stride + joint] = angle;
+				block[3 * m_stride + joint] = pose.scale.x;
+				block[4 * m_stride + joint] = pose.scale.y;
+			}
+		}
+
+		// Minimums, then steps.
+		m_ranges.assign(blockSize * 2, 0.0f);
+		f32 *minimums = m_ranges.data();
+		f32 *steps = m_ranges.data() + blockSize;
+		for (usize i = 0; i < blockSize; ++i)
+		{
+			f32 low = values[i];
+			f32 high = values[i];
+			for (u32 frame = 1; frame < frameCount; ++frame)
+			{
+				low = std::min(low, values[frame * blockSize + i]);
+				high = std::max(high, values[frame * blockSize + i]);
+			}
+			minimums[i] = low;
+			steps[i] = (high - low) / k_quantumCount;
+		}
+
+		m_keys.resize(blockSize * frameCount);
+		for (u32 frame = 0; frame < frameCount; ++frame)
+		{
+			for (usize i = 0; i < blockSize; ++i)
+			{
+				const f32 quanta = steps[i] > 0.0f ? std::round((values[frame * blockSize + i] - minimums[i]) / steps[i]) : 0.0f;
+				m_keys[frame * blockSize + i] = static_cast<u16>(std::clamp(quanta, 0.0f, k_quantumCount));
+			}
+		}
+	}
+
+	void AnimationClip::sample(f32 time, LocalPose &pose) const
+	{
+		using math::F32x4;
+		assert(pose.stride() == m_stride);
+
+		const f32 position = std::clamp(time * m_sampleRate, 0.0f, static_cast<f32>(m_frameCount - 1));
+		const u32 first = static_cast<u32>(position);
+		const u32 second = std::min(first + 1, m_frameCount - 1);
+		const F32x4 alpha(position - static_cast<f32>(first));
+
+		const usize blockSize = usize(k_storedChannels) * m_stride;
+		const u16 *firstKeys = m_keys.data() + first * blockSize;
+		const u16 *secondKeys = m_keys.data() + second * blockSize;
+		const f32 *minimums = m_ranges.data();
+		const f32 *steps = m_ranges.data() + blockSize;
+
+		for (u32 stored = 0; stored < k_storedChannels; ++stored)
+		{
+			for (u32 joint = 0; joint < m_stride; joint += static_cast<u32>(F32x4::k_width))
+			{
+				const usize i = usize(stored) * m_stride + joint;
+				const F32x4 from = gather(firstKeys + i);
+				const F32x4 quanta = from + (gather(secondKeys + i) - from) * alpha;
+				const F32x4 value = F32x4::load(minimums + i) + F32x4::load(steps + i) * quanta;
+
+				if (stored == k_angleChannel)
+				{
+					math::fast::cos(value).store(pose.channel(PoseChannel::Cos) + joint);
+					math::fast::sin(value).store(pose.channel(PoseChannel::Sin) + joint);
+				}
+				else
+				{
+					value.store(pose.channel(k_sampledChannels[stored]) + joint);
+				}
+			}
+		}
+	}
+
+	void blend(const LocalPose &from, const LocalPose &to, f32 weight, LocalPose &out)
+	{
+		using math::F32x4;
+		assert(from.stride() == to.stride() && from.stride() == out.stride());
+
+		const F32x4 w(weight);
+		for (u32 channel = 0; channel < u32(PoseChannel::Count); ++channel)
+		{
+			const f32 *a = from.channel(static_cast<PoseChannel>(channel));
+			const f32 *b = to.channel(static_cast<PoseChannel>(channel));
+			f32 *result = out.channel(static_cast<PoseChannel>(channel));
+			for (u32 joint = 0; joint < out.stride(); joint += static_cast<u32>(F32x4::k_width))
+			{
+				const F32x4 start = F32x4::load(a + joint);
+				(start + (F32x4::load(b + joint) - start) * w).store(result + joint);
+			}
+		}
+
+		// Rotations half a turn apart cancel out halfway; those keep no rotation rather than dividing by zero.
+		f32 *cosines = out.channel(PoseChannel::Cos);
+		f32 *sines = out.channel(PoseChannel::Sin);
+		for (u32 joint = 0; joint < out.stride(); joint += static_cast<u32>(F32x4::k_width))
+		{
+			const F32x4 c = F32x4::load(cosines + joint);
+			const F32x4 s = F32x4::load(sines + joint);
+			const F32x4 lengthSquared = c * c + s * s;
+			const F32x4 isUsable = math::greaterThan(lengthSquared, F32x4(1e-12f));
+			const F32x4 inverse = math::fast::rsqrt(math::select(isUsable, lengthSquared, F32x4(1.0f)));
+			math::select(isUsable, c * inverse, F32x4(1.0f)).store(cosines + joint);
+			math::select(isUsable, s * inverse, F32x4(0.0f)).store(sines + joint);
+		}
+	}
+
+	void localToModel(const Skeleton &skeleton, const LocalPose &pose, math::Mat3f *model)
+	{
+		const f32 *x = pose.channel(PoseChannel::X);
+		const f32 *y = pose.channel(PoseChannel::Y);
+		const f32 *cosines = pose.channel(PoseChannel::Cos);
+		const f32 *sines = pose.channel(PoseChannel::Sin);
+		const f32 *scaleX = pose.channel(PoseChannel::ScaleX);
+		const f32 *scaleY = pose.channel(PoseChannel::ScaleY);
+
+		// Parents come first, so theirs are ready by the time a joint needs them.
+		for (u32 joint = 0; joint < skeleton.jointCount(); ++joint)
+		{
+			const math::Mat3f local = math::Mat3f::transform(math::Vec2f(x[joint], y[joint]), cosines[joint], sines[joint],
+				math::Vec2f(scaleX[joint], scaleY[joint]));
+			const u32 parent = skeleton.parent(joint);
+			model[joint] = parent == Skeleton::k_noParent ? local : model[parent] * local;
+		}
+	}
+
+	Animator::Animator(const Skeleton &skeleton, jobs::JobSystem &jobs, u32 characterCount)
+		: m_skeleton(skeleton)
+		, m_jobs(jobs)
+		, m_states(characterCount)
+		, m_model(usize(characterCount) * skeleton.jointCount(), math::Mat3f::identity())
+	{
+		for (u32 begin = 0; begin < characterCount; begin += k_batchSize)
+		{
+			m_batches.push_back(Batch{ this, begin, std::min(begin + k_batchSize, characterCount), LocalPose(skeleton), LocalPose(skeleton) });
+			m_jobList.push_back(jobs::Job{});
+		}
+		for (usize i = 0; i < m_batches.size(); ++i)
+			m_jobList[i] = jobs::Job{ &Animator::animate, &m_batches[i] };
+	}
+
+	void Animator::update(f32 dt)
+	{
+		for (AnimationState &state : m_states)
+		{
+			advance(state.clip, state.time, dt, state.loops);
+			advance(state.blendClip, state.blendTime, dt, state.loops);
+		}
+
+		// A single batch is not worth the round trip through the workers.
+		if (m_batches.size() == 1)
+		{
+			animate(&m_batches[0]);
+		}
+		else if (!m_batches.empty())
+		{
+			jobs::Counter counter;
+			m_jobs.run(m_jobList.data(), m_jobList.size(), &counter);
+			m_jobs.wait(counter);
+		}
+	}
+
+	void Animator::animate(void *data)
+	{
+		Batch &batch = *static_cast<Batch *>(data);
+		const Animator &animator = *batch.animator;
+		const Skeleton &skeleton = animator.m_skeleton;
+
+		for (u32 character = batch.begin; character < batch.end; ++character)
+		{
+			const AnimationState &state = animator.m_states[character];
+			math::Mat3f *model = batch.animator->m_model.data() + usize(character) * skeleton.jointCount();
+			if (state.clip == nullptr)
+			{
+				std::fill_n(model, skeleton.jointCount(), math::Mat3f::identity());
+				continue;
+			}
+
+			state.clip->sample(state.time, batch.from);
+			if (state.blendClip != nullptr && state.blendWeight > 0.0f)
+			{
+				state.blendClip->sample(state.blendTime, batch.to);
+				blend(batch.from, batch.to, state.blendWeight, batch.from);
+			}
+			localToModel(skeleton, batch.from, model);
+		}
+	}
+}
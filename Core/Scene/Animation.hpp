@@ -0,0 +1,160 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Math/Mat3.hpp"
+#include "Core/Math/Vec2.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::scene
+{
+	// A joint's transform relative to its parent.
+	struct JointPose
+	{
+		math::Vec2f translation = math::Vec2f::zero();
+		// Counter clockwise, in radians.
+		f32 rotation = 0.0f;
+		math::Vec2f scale = math::Vec2f(1.0f, 1.0f);
+	};
+
+	// Joints as parent indices. Parents come before their children.
+	class Skeleton
+	{
+	public:
+		static constexpr u32 k_noParent = ~0u;
+
+		Skeleton(const u32 *parents, u32 jointCount);
+
+		u32 jointCount() const { return static_cast<u32>(m_parents.size()); }
+		// Joints rounded up to the SIMD width; the length of every per joint array.
+		u32 stride() const { return m_stride; }
+		u32 parent(u32 joint) const { return m_parents[joint]; }
+
+	private:
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Scene>> m_parents;
+		u32 m_stride = 0;
+	};
+
+	enum class PoseChannel : u32
+	{
+		X,
+		Y,
+		// Rotation as a unit vector, which blends without wrapping around.
+		Cos,
+		Sin,
+		ScaleX,
+		ScaleY,
+		Count,
+	};
+
+	// Local transforms of every joint of a skeleton, one array per channel.
+	class LocalPose
+	{
+	public:
+		explicit LocalPose(const Skeleton &skeleton);
+
+		f32 *channel(PoseChannel channel) { return m_values.data() + usize(channel) * m_stride; }
+		const f32 *channel(PoseChannel channel) const { return m_values.data() + usize(channel) * m_stride; }
+
+		JointPose joint(u32 index) const;
+		void setJoint(u32 index, const JointPose &pose);
+
+		u32 stride() const { return m_stride; }
+
+	private:
+		std::vector<f32, memory::TaggedAllocator<f32, memory::Tag::Scene>> m_values;
+		u32 m_stride = 0;
+	};
+
+	// Keyframes sampled at a fixed rate and quantized to 16 bits per channel against each channel's range.
+	// A key is one block holding every joint's channels, so sampling reads two neighbouring blocks whatever the
+	// time. Rotations are stored unwrapped, so interpolating across the half turn takes the short way round.
+	// Looping clips repeat their first key as their last.
+	class AnimationClip
+	{
+	public:
+		// keys holds frameCount poses of every joint, one frame after the other.
+		AnimationClip(const Skeleton &skeleton, const JointPose *keys, u32 frameCount, f32 sampleRate);
+
+		// Time is clamped to the clip.
+		void sample(f32 time, LocalPose &pose) const;
+
+		f32 duration() const { return static_cast<f32>(m_frameCount - 1) / m_sampleRate; }
+		u32 frameCount() const { return m_frameCount; }
+		// Keys and ranges.
+		usize byteSize() const { return m_keys.size() * sizeof(u16) + m_ranges.size() * sizeof(f32); }
+
+	private:
+		// Channels as stored. The rotation is an angle until it is sampled.
+		static constexpr u32 k_storedChannels = 5;
+
+		std::vector<u16, memory::TaggedAllocator<u16, memory::Tag::Scene>> m_keys;
+		// Minimum, then step per quantum, of each stored channel of each joint.
+		std::vector<f32, memory::TaggedAllocator<f32, memory::Tag::Scene>> m_ranges;
+		u32 m_stride = 0;
+		u32 m_frameCount = 0;
+		f32 m_sampleRate = 0.0f;
+	};
+
+	// Four joints at a time; the rotation is renormalized after blending.
+	void blend(const LocalPose &from, const LocalPose &to, f32 weight, LocalPose &out);
+	// Transforms of every joint relative to the skeleton's root space.
+	void localToModel(const Skeleton &skeleton, const LocalPose &pose, math::Mat3f *model);
+
+	// What a character plays: a clip, optionally blended towards a second one.
+	struct AnimationState
+	{
+		const AnimationClip *clip = nullptr;
+		f32 time = 0.0f;
+		const AnimationClip *blendClip = nullptr;
+		f32 blendTime = 0.0f;
+		// Zero plays clip alone, one plays blendClip alone.
+		f32 blendWeight = 0.0f;
+		bool loops = true;
+	};
+
+	// Animates many characters sharing a skeleton. update() advances every character, then samples, blends and
+	// converts their poses in batches run as jobs; each batch owns its scratch poses, so nothing is allocated past
+	// construction. Clips are shared, so a character costs its state and its model pose.
+	class Animator
+	{
+	public:
+		Animator(const Skeleton &skeleton, jobs::JobSystem &jobs, u32 characterCount);
+
+		Animator(const Animator &) = delete;
+		Animator &operator=(const Animator &) = delete;
+
+		AnimationState &state(u32 character) { return m_states[character]; }
+		const AnimationState &state(u32 character) const { return m_states[character]; }
+
+		void update(f32 dt);
+
+		// jointCount() transforms, as of the last update().
+		const math::Mat3f *modelPose(u32 character) const { return m_model.data() + usize(character) * m_skeleton.jointCount(); }
+		u32 characterCount() const { return static_cast<u32>(m_states.size()); }
+
+		// Characters one job animates.
+		static constexpr u32 k_batchSize = 32;
+
+	private:
+		struct Batch
+		{
+			Animator *animator;
+			u32 begin;
+			u32 end;
+			LocalPose from;
+			LocalPose to;
+		};
+
+		static void animate(void *data);
+
+		const Skeleton &m_skeleton;
+		jobs::JobSystem &m_jobs;
+		std::vector<AnimationState, memory::TaggedAllocator<AnimationState, memory::Tag::Scene>> m_states;
+		std::vector<math::Mat3f, memory::TaggedAllocator<math::Mat3f, memory::Tag::Scene>> m_model;
+		std::vector<Batch, memory::TaggedAllocator<Batch, memory::Tag::Scene>> m_batches;
+		std::vector<jobs::Job, memory::TaggedAllocator<jobs::Job, memory::Tag::Scene>> m_jobList;
+	};
+}
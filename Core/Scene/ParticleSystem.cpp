@@ -0,0 +1,304 @@
+#include "Core/Scene/ParticleSystem.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "Core/Math/FastMath.hpp"
+#include "Core/Math/Simd.hpp"
+
+namespace core::scene
+{
+	namespace
+	{
+		// Every array starts on a cache line.
+		constexpr usize k_storageAlignment = 64;
+		constexpr u32 k_strideGranularity = static_cast<u32>(k_storageAlignment / sizeof(f32));
+
+		// Xorshift, so a seeded emitter spawns the same particles on every machine.
+		f32 nextRandom(u32 &state)
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return static_cast<f32>(state >> 8) * (1.0f / 16777216.0f);
+		}
+
+		f32 lerp(f32 from, f32 to, f32 t)
+		{
+			return from + (to - from) * t;
+		}
+	}
+
+	ParticleSystem::ParticleSystem(jobs::JobSystem &jobs)
+		: m_jobs(jobs)
+		, m_emitters(memory::Tag::Scene)
+	{}
+
+	ParticleSystem::~ParticleSystem()
+	{
+		for (Emitter &emitter : m_emitters)
+			memory::deallocate(emitter.storage, sizeof(f32) * StreamCount * emitter.stride, memory::Tag::Scene, k_storageAlignment);
+	}
+
+	EmitterHandle ParticleSystem::create(const EmitterConfig &config)
+	{
+		assert(config.capacity > 0 && config.minLifetime > 0.0f && config.minLifetime <= config.maxLifetime);
+
+		Emitter emitter;
+		emitter.config = config;
+		emitter.stride = (config.capacity + k_strideGranularity - 1) / k_strideGranularity * k_strideGranularity;
+		emitter.storage = static_cast<f32 *>(memory::allocate(sizeof(f32) * StreamCount * emitter.stride, memory::Tag::Scene, k_storageAlignment));
+		// Zero is a fixed point of xorshift.
+		emitter.random = config.seed != 0 ? config.seed : 1;
+		if (config.blend == ParticleBlend::Alpha)
+			emitter.drawOrder.reserve(config.capacity);
+
+		// Lanes past the live particles are simulated along with them, so they must hold numbers.
+		std::memset(emitter.storage, 0, sizeof(f32) * StreamCount * emitter.stride);
+		return m_emitters.insert(std::move(emitter));
+	}
+
+	void ParticleSystem::destroy(EmitterHandle emitter)
+	{
+		Emitter *found = m_emitters.get(emitter);
+		assert(found != nullptr && "Stale emitter handle.");
+
+		m_particleCount -= found->count;
+		memory::deallocate(found->storage, sizeof(f32) * StreamCount * found->stride, memory::Tag::Scene, k_storageAlignment);
+		m_emitters.erase(emitter);
+	}
+
+	void ParticleSystem::setPosition(EmitterHandle emitter, math::Vec2f position)
+	{
+		Emitter *found = m_emitters.get(emitter);
+		assert(found != nullptr && "Stale emitter handle.");
+		found->config.position = position;
+	}
+
+	void ParticleSystem::setRate(EmitterHandle emitter, f32 rate)
+	{
+		Emitter *found = m_emitters.get(emitter);
+		assert(found != nullptr && "Stale emitter handle.");
+		found->config.rate = rate;
+	}
+
+	void ParticleSystem::burst(EmitterHandle emitter, u32 count)
+	{
+		Emitter *found = m_emitters.get(emitter);
+		assert(found != nullptr && "Stale emitter handle.");
+		found->pendingBurst += count;
+	}
+
+	void ParticleSystem::update(f32 dt)
+	{
+		m_chunks.clear();
+		for (Emitter &emitter : m_emitters)
+		{
+			for (u32 begin = 0; begin < emitter.count; begin += k_chunkSize)
+				m_chunks.push_back(Chunk{ &emitter, begin, std::min(begin + k_chunkSize, emitter.count), dt, 0 });
+		}
+
+		// A single chunk is not worth the round trip through the workers.
+		if (m_chunks.size() == 1)
+		{
+			simulate(&m_chunks[0]);
+		}
+		else if (!m_chunks.empty())
+		{
+			m_jobList.clear();
+			for (Chunk &chunk : m_chunks)
+				m_jobList.push_back(jobs::Job{ &ParticleSystem::simulate, &chunk });
+
+			jobs::Counter counter;
+			m_jobs.run(m_jobList.data(), m_jobList.size(), &counter);
+			m_jobs.wait(counter);
+		}
+
+		// Chunks of an emitter are listed in order; slide each one's survivors down against the previous ones.
+		for (usize i = 0; i < m_chunks.size(); ++i)
+		{
+			const Chunk &chunk = m_chunks[i];
+			Emitter &emitter = *chunk.emitter;
+			if (chunk.begin == 0)
+				emitter.count = 0;
+
+			if (chunk.begin != emitter.count && chunk.aliveCount > 0)
+			{
+				for (u32 stream = 0; stream < StreamCount; ++stream)
+				{
+					f32 *data = emitter.stream(static_cast<Stream>(stream));
+					std::memmove(data + emitter.count, data + chunk.begin, sizeof(f32) * chunk.aliveCount);
+				}
+			}
+			emitter.count += chunk.aliveCount;
+		}
+
+		m_particleCount = 0;
+		for (Emitter &emitter : m_emitters)
+		{
+			spawn(emitter, dt);
+			if (emitter.config.blend == ParticleBlend::Alpha)
+				sort(emitter);
+			m_particleCount += emitter.count;
+		}
+	}
+
+	ParticleView ParticleSystem::particles(EmitterHandle emitter) const
+	{
+		const Emitter *found = m_emitters.get(emitter);
+		assert(found != nullptr && "Stale emitter handle.");
+
+		ParticleView view;
+		view.x = found->stream(X);
+		view.y = found->stream(Y);
+		view.velocityX = found->stream(VelocityX);
+		view.velocityY = found->stream(VelocityY);
+		view.r = found->stream(R);
+		view.g = found->stream(G);
+		view.b = found->stream(B);
+		view.a = found->stream(A);
+		view.life = found->stream(Life);
+		view.count = found->count;
+		if (found->config.blend == ParticleBlend::Alpha)
+			view.drawOrder = found->drawOrder.data();
+		return view;
+	}
+
+	u32 ParticleSystem::droppedCount(EmitterHandle emitter) const
+	{
+		const Emitter *found = m_emitters.get(emitter);
+		assert(found != nullptr && "Stale emitter handle.");
+		return found->droppedCount;
+	}
+
+	void ParticleSystem::simulate(void *data)
+	{
+		using math::F32x4;
+
+		Chunk &chunk = *static_cast<Chunk *>(data);
+		Emitter &emitter = *chunk.emitter;
+		const EmitterConfig &config = emitter.config;
+
+		f32 *x = emitter.stream(X);
+		f32 *y = emitter.stream(Y);
+		f32 *velocityX = emitter.stream(VelocityX);
+		f32 *velocityY = emitter.stream(VelocityY);
+		f32 *r = emitter.stream(R);
+		f32 *g = emitter.stream(G);
+		f32 *b = emitter.stream(B);
+		f32 *a = emitter.stream(A);
+		f32 *life = emitter.stream(Life);
+		f32 *inverseLifetime = emitter.stream(InverseLifetime);
+
+		const F32x4 dt(chunk.dt);
+		const F32x4 keep(std::max(0.0f, 1.0f - config.drag * chunk.dt));
+		const F32x4 pullX(config.gravity.x * chunk.dt);
+		const F32x4 pullY(config.gravity.y * chunk.dt);
+		const F32x4 zero(0.0f);
+		const F32x4 endR(config.endColour.r), spanR(config.startColour.r - config.endColour.r);
+		const F32x4 endG(config.endColour.g), spanG(config.startColour.g - config.endColour.g);
+		const F32x4 endB(config.endColour.b), spanB(config.startColour.b - config.endColour.b);
+		const F32x4 endA(config.endColour.a), spanA(config.startColour.a - config.endColour.a);
+
+		// Arrays are padded to the SIMD width, so the last step runs past the end instead of having a scalar tail.
+		for (u32 i = chunk.begin; i < chunk.end; i += static_cast<u32>(F32x4::k_width))
+		{
+			const F32x4 vx = F32x4::load(velocityX + i) * keep + pullX;
+			const F32x4 vy = F32x4::load(velocityY + i) * keep + pullY;
+			vx.store(velocityX + i);
+			vy.store(velocityY + i);
+			(F32x4::load(x + i) + vx * dt).store(x + i);
+			(F32x4::load(y + i) + vy * dt).store(y + i);
+
+			const F32x4 remaining = F32x4::load(life + i) - dt;
+			remaining.store(life + i);
+
+			// One at birth, zero at death.
+			const F32x4 t = max(remaining, zero) * F32x4::load(inverseLifetime + i);
+			(endR + spanR * t).store(r + i);
+			(endG + spanG * t).store(g + i);
+			(endB + spanB * t).store(b + i);
+			(endA + spanA * t).store(a + i);
+		}
+
+		// Survivors keep their order, so particles stay sorted by age.
+		u32 alive = chunk.begin;
+		for (u32 i = chunk.begin; i < chunk.end; ++i)
+		{
+			if (life[i] <= 0.0f)
+				continue;
+
+			if (alive != i)
+			{
+				for (u32 stream = 0; stream < StreamCount; ++stream)
+				{
+					f32 *values = emitter.stream(static_cast<Stream>(stream));
+					values[alive] = values[i];
+				}
+			}
+			++alive;
+		}
+		chunk.aliveCount = alive - chunk.begin;
+	}
+
+	void ParticleSystem::spawn(Emitter &emitter, f32 dt)
+	{
+		const EmitterConfig &config = emitter.config;
+
+		// Kept from going negative, where converting the debt to a count would be undefined. NaN lands on zero too.
+		emitter.spawnDebt += std::max(0.0f, config.rate * dt);
+		const u32 due = static_cast<u32>(emitter.spawnDebt);
+		emitter.spawnDebt -= static_cast<f32>(due);
+
+		const u32 wanted = emitter.pendingBurst + due;
+		const u32 count = std::min(wanted, config.capacity - emitter.count);
+		emitter.droppedCount += wanted - count;
+		emitter.pendingBurst = 0;
+
+		f32 *x = emitter.stream(X);
+		f32 *y = emitter.stream(Y);
+		f32 *velocityX = emitter.stream(VelocityX);
+		f32 *velocityY = emitter.stream(VelocityY);
+		f32 *r = emitter.stream(R);
+		f32 *g = emitter.stream(G);
+		f32 *b = emitter.stream(B);
+		f32 *a = emitter.stream(A);
+		f32 *life = emitter.stream(Life);
+		f32 *inverseLifetime = emitter.stream(InverseLifetime);
+
+		for (u32 i = emitter.count; i < emitter.count + count; ++i)
+		{
+			const f32 angle = config.direction + config.spread * (2.0f * nextRandom(emitter.random) - 1.0f);
+			const f32 speed = lerp(config.minSpeed, config.maxSpeed, nextRandom(emitter.random));
+			const f32 lifetime = lerp(config.minLifetime, config.maxLifetime, nextRandom(emitter.random));
+
+			x[i] = config.position.x;
+			y[i] = config.position.y;
+			velocityX[i] = math::fast::cos<math::Accuracy::Low>(angle) * speed;
+			velocityY[i] = math::fast::sin<math::Accuracy::Low>(angle) * speed;
+			r[i] = config.startColour.r;
+			g[i] = config.startColour.g;
+			b[i] = config.startColour.b;
+			a[i] = config.startColour.a;
+			life[i] = lifetime;
+			inverseLifetime[i] = 1.0f / lifetime;
+		}
+		emitter.count += count;
+	}
+
+	void ParticleSystem::sort(Emitter &emitter)
+	{
+		// Reserved at the capacity, so this never allocates.
+		emitter.drawOrder.resize(emitter.count);
+		for (u32 i = 0; i < emitter.count; ++i)
+			emitter.drawOrder[i] = i;
+
+		// Ties go to the older particle, so equal depths do not flicker from one frame to the next.
+		const f32 *y = emitter.stream(Y);
+		std::sort(emitter.drawOrder.begin(), emitter.drawOrder.end(), [y](u32 left, u32 right)
+		{
+			return y[left] < y[right] || (y[left] == y[right] && left < right);
+		});
+	}
+}
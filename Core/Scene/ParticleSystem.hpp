@@ -0,0 +1,164 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Containers/SlotMap.hpp"
+#include "Core/Jobs/JobSystem.hpp"
+#include "Core/Math/Vec2.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::scene
+{
+	// Handles of destroyed emitters stop resolving, even once their slot is reused.
+	using EmitterHandle = SlotHandle;
+
+	struct ParticleColour
+	{
+		f32 r = 1.0f;
+		f32 g = 1.0f;
+		f32 b = 1.0f;
+		f32 a = 1.0f;
+	};
+
+	enum class ParticleBlend : u8
+	{
+		// Order independent, drawn as stored.
+		Additive,
+		// Drawn back to front, lowest y first, through drawOrder.
+		Alpha,
+	};
+
+	struct EmitterConfig
+	{
+		// Particles alive at once. Spawns past it are dropped.
+		u32 capacity = 1024;
+		// Particles per second, on top of bursts. Negative rates spawn nothing.
+		f32 rate = 0.0f;
+		math::Vec2f position = math::Vec2f::zero();
+		// Particles leave at a random angle within spread of direction, in radians, and a random speed in the range.
+		f32 direction = 0.0f;
+		f32 spread = 3.14159265f;
+		f32 minSpeed = 0.0f;
+		f32 maxSpeed = 1.0f;
+		f32 minLifetime = 1.0f;
+		f32 maxLifetime = 1.0f;
+		math::Vec2f gravity = math::Vec2f::zero();
+		// Fraction of velocity lost per second.
+		f32 drag = 0.0f;
+		// Colour fades from start to end over each particle's life.
+		ParticleColour startColour;
+		ParticleColour endColour;
+		ParticleBlend blend = ParticleBlend::Additive;
+		u32 seed = 1;
+	};
+
+	// An emitter's live particles, one array per attribute, as of the last update().
+	struct ParticleView
+	{
+		const f32 *x = nullptr;
+		const f32 *y = nullptr;
+		const f32 *velocityX = nullptr;
+		const f32 *velocityY = nullptr;
+		const f32 *r = nullptr;
+		const f32 *g = nullptr;
+		const f32 *b = nullptr;
+		const f32 *a = nullptr;
+		// Seconds left.
+		const f32 *life = nullptr;
+		u32 count = 0;
+		// Indices back to front for alpha blended emitters, nullptr when the storage order will do.
+		const u32 *drawOrder = nullptr;
+	};
+
+	// Emitters and their particles, kept as structure of arrays so the simulation loads four particles per
+	// instruction instead of walking Vec2 pairs. Each emitter allocates its arrays once, at its capacity.
+	// update() spawns on the calling thread, then simulates every emitter in chunks run as jobs; each chunk packs its
+	// survivors to its front, and the chunks are then closed up in place, keeping particles in spawn order.
+	// Only alpha blended emitters are sorted.
+	class ParticleSystem
+	{
+	public:
+		explicit ParticleSystem(jobs::JobSystem &jobs);
+		~ParticleSystem();
+
+		ParticleSystem(const ParticleSystem &) = delete;
+		ParticleSystem &operator=(const ParticleSystem &) = delete;
+
+		EmitterHandle create(const EmitterConfig &config);
+		void destroy(EmitterHandle emitter);
+		bool contains(EmitterHandle emitter) const { return m_emitters.contains(emitter); }
+
+		void setPosition(EmitterHandle emitter, math::Vec2f position);
+		void setRate(EmitterHandle emitter, f32 rate);
+		// Spawns count particles on the next update.
+		void burst(EmitterHandle emitter, u32 count);
+
+		// Advances every emitter by dt seconds.
+		void update(f32 dt);
+
+		ParticleView particles(EmitterHandle emitter) const;
+		u32 particleCount() const { return m_particleCount; }
+		// Spawns dropped because an emitter was full, since it was created.
+		u32 droppedCount(EmitterHandle emitter) const;
+
+		// Particles one simulation job handles. A multiple of the SIMD width.
+		static constexpr u32 k_chunkSize = 4096;
+
+	private:
+		// Attribute arrays, in the order they sit in an emitter's storage.
+		enum Stream : u32
+		{
+			X,
+			Y,
+			VelocityX,
+			VelocityY,
+			R,
+			G,
+			B,
+			A,
+			Life,
+			InverseLifetime,
+			StreamCount,
+		};
+
+		struct Emitter
+		{
+			EmitterConfig config;
+			// StreamCount arrays of stride floats each, freed by the system.
+			f32 *storage = nullptr;
+			u32 stride = 0;
+			u32 count = 0;
+			u32 pendingBurst = 0;
+			f32 spawnDebt = 0.0f;
+			u32 random = 0;
+			u32 droppedCount = 0;
+			std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Scene>> drawOrder;
+
+			f32 *stream(Stream index) { return storage + usize(index) * stride; }
+			const f32 *stream(Stream index) const { return storage + usize(index) * stride; }
+		};
+
+		struct Chunk
+		{
+			Emitter *emitter;
+			u32 begin;
+			u32 end;
+			f32 dt;
+			// Survivors, packed to the front of the chunk by the job.
+			u32 aliveCount;
+		};
+
+		static void simulate(void *data);
+		void spawn(Emitter &emitter, f32 dt);
+		void sort(Emitter &emitter);
+
+		jobs::JobSystem &m_jobs;
+		SlotMap<Emitter> m_emitters;
+		u32 m_particleCount = 0;
+
+		// Scratch, kept to avoid allocating every update.
+		std::vector<Chunk, memory::TaggedAllocator<Chunk, memory::Tag::Scene>> m_chunks;
+		std::vector<jobs::Job, memory::TaggedAllocator<jobs::Job, memory::Tag::Scene>> m_jobList;
+	};
+}
@@ -0,0 +1,261 @@
+#include "Core/Scene/TransformHierarchy.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "Core/Math/Simd.hpp"
+
+namespace core::scene
+{
+	namespace
+	{
+		// parent * local, skipping the constant bottom row.
+		void compose(const math::Mat3f &parent, const math::Mat3f &local, math::Mat3f &world)
+		{
+			world.m[0][0] = parent.m[0][0] * local.m[0][0] + parent.m[0][1] * local.m[1][0];
+			world.m[0][1] = parent.m[0][0] * local.m[0][1] + parent.m[0][1] * local.m[1][1];
+			world.m[0][2] = parent.m[0][0] * local.m[0][2] + parent.m[0][1] * local.m[1][2] + parent.m[0][2];
+			world.m[1][0] = parent.m[1][0] * local.m[0][0] + parent.m[1][1] * local.m[1][0];
+			world.m[1][1] = parent.m[1][0] * local.m[0][1] + parent.m[1][1] * local.m[1][1];
+			world.m[1][2] = parent.m[1][0] * local.m[0][2] + parent.m[1][1] * local.m[1][2] + parent.m[1][2];
+			world.m[2][0] = 0.0f;
+			world.m[2][1] = 0.0f;
+			world.m[2][2] = 1.0f;
+		}
+
+		// Reorders array so that position i holds what was at order[i].
+		template<typename Array>
+		void permute(Array &array, const u32 *order, usize count)
+		{
+			Array sorted(count);
+			for (usize i = 0; i < count; ++i)
+				sorted[i] = array[order[i]];
+			array.swap(sorted);
+		}
+	}
+
+	TransformHandle TransformHierarchy::create(TransformHandle parent, const math::Mat3f &local)
+	{
+		const u32 index = static_cast<u32>(m_handles.size());
+		const u32 parentPosition = parent.isValid() ? positionOf(parent) : k_none;
+		const u32 depth = parentPosition != k_none ? m_depths[parentPosition] + 1 : 0;
+
+		// Appending keeps parents ahead of children, but only keeps the levels grouped when it is the deepest node yet.
+		if (index > 0 && depth < m_depths.back())
+			m_isSorted = false;
+
+		const TransformHandle node = m_slots.insert(index);
+		m_handles.push_back(node);
+		m_parents.push_back(parentPosition);
+		m_depths.push_back(depth);
+		m_childCounts.push_back(0);
+		m_isDirty.push_back(1);
+		m_local.push_back(local);
+		m_world.push_back(local);
+
+		if (parentPosition != k_none)
+			++m_childCounts[parentPosition];
+		return node;
+	}
+
+	void TransformHierarchy::destroy(TransformHandle node)
+	{
+		const u32 index = positionOf(node);
+		assert(m_childCounts[index] == 0 && "Destroy or move the children first.");
+
+		if (m_parents[index] != k_none)
+			--m_childCounts[m_parents[index]];
+
+		// The node stays in the arrays, without a handle, until the next update compacts them.
+		m_handles[index] = {};
+		m_isDirty[index] = 0;
+		m_slots.erase(node);
+		m_isSorted = false;
+	}
+
+	void TransformHierarchy::setParent(TransformHandle node, TransformHandle parent)
+	{
+		const u32 index = positionOf(node);
+		const u32 parentPosition = parent.isValid() ? positionOf(parent) : k_none;
+		for (u32 ancestor = parentPosition; ancestor != k_none; ancestor = m_parents[ancestor])
+			assert(ancestor != index && "A node cannot become its own descendant.");
+
+		if (m_parents[index] != k_none)
+			--m_childCounts[m_parents[index]];
+		if (parentPosition != k_none)
+			++m_childCounts[parentPosition];
+
+		m_parents[index] = parentPosition;
+		m_isDirty[index] = 1;
+		m_isSorted = false;
+	}
+
+	TransformHandle TransformHierarchy::parent(TransformHandle node) const
+	{
+		const u32 parentPosition = m_parents[positionOf(node)];
+		return parentPosition != k_none ? m_handles[parentPosition] : TransformHandle{};
+	}
+
+	void TransformHierarchy::setLocal(TransformHandle node, const math::Mat3f &local)
+	{
+		const u32 index = positionOf(node);
+		m_local[index] = local;
+		m_isDirty[index] = 1;
+	}
+
+	void TransformHierarchy::update()
+	{
+		if (!m_isSorted)
+			sortByDepth();
+
+		// Parents come first, so a single pass hands every dirty flag down to the whole subtree.
+		m_dirty.clear();
+		const usize count = m_handles.size();
+		for (usize position = 0; position < count; ++position)
+		{
+			const u32 parent = m_parents[position];
+			if (parent != k_none && m_isDirty[parent] != 0)
+				m_isDirty[position] = 1;
+			if (m_isDirty[position] != 0)
+				m_dirty.push_back(static_cast<u32>(position));
+		}
+
+		// A level only reads the one above it, which is done by the time it runs.
+		for (usize begin = 0; begin < m_dirty.size();)
+		{
+			const u32 depth = m_depths[m_dirty[begin]];
+			usize end = begin + 1;
+			while (end < m_dirty.size() && m_depths[m_dirty[end]] == depth)
+				++end;
+
+			if (depth == 0)
+			{
+				for (usize i = begin; i < end; ++i)
+					m_world[m_dirty[i]] = m_local[m_dirty[i]];
+			}
+			else
+			{
+				composeLevel(m_dirty.data() + begin, end - begin);
+			}
+
+			begin = end;
+		}
+
+		for (u32 position : m_dirty)
+			m_isDirty[position] = 0;
+		m_updatedCount = static_cast<u32>(m_dirty.size());
+	}
+
+	void TransformHierarchy::sortByDepth()
+	{
+		const usize count = m_handles.size();
+
+		// Depths from the parent links, walking up to the nearest node whose depth is known.
+		std::fill(m_depths.begin(), m_depths.end(), k_none);
+		u32 maxDepth = 0;
+		for (usize position = 0; position < count; ++position)
+		{
+			if (!m_handles[position].isValid())
+				continue;
+
+			m_order.clear();
+			u32 node = static_cast<u32>(position);
+			while (node != k_none && m_depths[node] == k_none)
+			{
+				m_order.push_back(node);
+				node = m_parents[node];
+			}
+
+			u32 depth = node != k_none ? m_depths[node] + 1 : 0;
+			for (usize i = m_order.size(); i-- > 0; ++depth)
+				m_depths[m_order[i]] = depth;
+			maxDepth = std::max(maxDepth, m_depths[position]);
+		}
+
+		// Counting sort by depth. Within a level nodes keep their order, so transforms that are set together stay close.
+		m_remap.assign(maxDepth + 2, 0);
+		for (usize position = 0; position < count; ++position)
+		{
+			if (m_handles[position].isValid())
+				++m_remap[m_depths[position] + 1];
+		}
+		for (u32 depth = 1; depth < m_remap.size(); ++depth)
+			m_remap[depth] += m_remap[depth - 1];
+
+		m_order.assign(nodeCount(), 0);
+		for (usize position = 0; position < count; ++position)
+		{
+			if (m_handles[position].isValid())
+				m_order[m_remap[m_depths[position]]++] = static_cast<u32>(position);
+		}
+
+		m_remap.assign(count, k_none);
+		for (u32 i = 0; i < nodeCount(); ++i)
+			m_remap[m_order[i]] = i;
+
+		permute(m_handles, m_order.data(), nodeCount());
+		permute(m_parents, m_order.data(), nodeCount());
+		permute(m_depths, m_order.data(), nodeCount());
+		permute(m_childCounts, m_order.data(), nodeCount());
+		permute(m_isDirty, m_order.data(), nodeCount());
+		permute(m_local, m_order.data(), nodeCount());
+		permute(m_world, m_order.data(), nodeCount());
+
+		for (u32 position = 0; position < nodeCount(); ++position)
+		{
+			if (m_parents[position] != k_none)
+				m_parents[position] = m_remap[m_parents[position]];
+			*m_slots.get(m_handles[position]) = position;
+		}
+
+		m_isSorted = true;
+	}
+
+	void TransformHierarchy::composeLevel(const u32 *nodes, usize count)
+	{
+		using math::F32x4;
+
+		// Four nodes per step, one per lane. Parents are scattered, so lanes are gathered and scattered one by one;
+		// the twelve products and eight sums still run four wide.
+		usize i = 0;
+		for (; i + F32x4::k_width <= count; i += F32x4::k_width)
+		{
+			const math::Mat3f *parent[4];
+			const math::Mat3f *local[4];
+			for (usize lane = 0; lane < 4; ++lane)
+			{
+				parent[lane] = &m_world[m_parents[nodes[i + lane]]];
+				local[lane] = &m_local[nodes[i + lane]];
+			}
+
+			const auto gather = [](const math::Mat3f *const *matrices, usize row, usize column)
+			{
+				return F32x4(matrices[0]->m[row][column], matrices[1]->m[row][column], matrices[2]->m[row][column], matrices[3]->m[row][column]);
+			};
+
+			const F32x4 p00 = gather(parent, 0, 0), p01 = gather(parent, 0, 1), p02 = gather(parent, 0, 2);
+			const F32x4 p10 = gather(parent, 1, 0), p11 = gather(parent, 1, 1), p12 = gather(parent, 1, 2);
+			const F32x4 l00 = gather(local, 0, 0), l01 = gather(local, 0, 1), l02 = gather(local, 0, 2);
+			const F32x4 l10 = gather(local, 1, 0), l11 = gather(local, 1, 1), l12 = gather(local, 1, 2);
+
+			f32 result[6][4];
+			(p00 * l00 + p01 * l10).store(result[0]);
+			(p00 * l01 + p01 * l11).store(result[1]);
+			(p00 * l02 + p01 * l12 + p02).store(result[2]);
+			(p10 * l00 + p11 * l10).store(result[3]);
+			(p10 * l01 + p11 * l11).store(result[4]);
+			(p10 * l02 + p11 * l12 + p12).store(result[5]);
+
+			for (usize lane = 0; lane < 4; ++lane)
+			{
+				m_world[nodes[i + lane]] = math::Mat3f{ {
+					{ result[0][lane], result[1][lane], result[2][lane] },
+					{ result[3][lane], result[4][lane], result[5][lane] },
+					{ 0.0f, 0.0f, 1.0f } } };
+			}
+		}
+
+		for (; i < count; ++i)
+			compose(m_world[m_parents[nodes[i]]], m_local[nodes[i]], m_world[nodes[i]]);
+	}
+}
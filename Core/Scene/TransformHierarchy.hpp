@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+#include "Core/Types.hpp"
+#include "Core/Containers/SlotMap.hpp"
+#include "Core/Math/Mat3.hpp"
+#include "Core/Memory/Memory.hpp"
+
+namespace core::scene
+{
+	// Handles of destroyed nodes stop resolving, even once their slot is reused.
+	using TransformHandle = SlotHandle;
+
+	// Parent relative 2D transforms and the world transforms they compose into.
+	// Nodes live in flat arrays sorted by depth, so every parent comes before its children and one forward pass
+	// propagates changes. update() only recomputes the world transforms of changed nodes and their descendants,
+	// four at a time in SIMD lanes, one depth level after the other.
+	// Transforms must be affine: a bottom row of 0 0 1.
+	class TransformHierarchy
+	{
+	public:
+		TransformHierarchy()
+			: m_slots(memory::Tag::Scene)
+		{}
+
+		TransformHierarchy(const TransformHierarchy &) = delete;
+		TransformHierarchy &operator=(const TransformHierarchy &) = delete;
+
+		// An invalid parent makes a root.
+		TransformHandle create(TransformHandle parent = {}, const math::Mat3f &local = math::Mat3f::identity());
+		// The node must have no children left.
+		void destroy(TransformHandle node);
+
+		// The new parent cannot be the node or one of its descendants.
+		void setParent(TransformHandle node, TransformHandle parent);
+		TransformHandle parent(TransformHandle node) const;
+		bool contains(TransformHandle node) const { return m_slots.contains(node); }
+
+		void setLocal(TransformHandle node, const math::Mat3f &local);
+		const math::Mat3f &local(TransformHandle node) const { return m_local[positionOf(node)]; }
+		// As of the last update().
+		const math::Mat3f &world(TransformHandle node) const { return m_world[positionOf(node)]; }
+
+		// Recomputes the world transforms of nodes changed since the last update and of everything under them.
+		void update();
+
+		u32 nodeCount() const { return static_cast<u32>(m_slots.size()); }
+		// World transforms the last update() recomputed.
+		u32 updatedCount() const { return m_updatedCount; }
+
+	private:
+		static constexpr u32 k_none = ~0u;
+
+		u32 positionOf(TransformHandle node) const
+		{
+			assert(m_slots.contains(node) && "Stale transform handle.");
+			return *m_slots.get(node);
+		}
+
+		// Puts the nodes back in depth order after nodes were added, removed or moved.
+		void sortByDepth();
+		void composeLevel(const u32 *nodes, usize count);
+
+		// Position of each node in the node arrays.
+		SlotMap<u32> m_slots;
+
+		// Node arrays, indexed by position. Destroyed nodes keep an invalid handle until they are compacted away.
+		std::vector<TransformHandle, memory::TaggedAllocator<TransformHandle, memory::Tag::Scene>> m_handles;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Scene>> m_parents;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Scene>> m_depths;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Scene>> m_childCounts;
+		std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Scene>> m_isDirty;
+		std::vector<math::Mat3f, memory::TaggedAllocator<math::Mat3f, memory::Tag::Scene>> m_local;
+		std::vector<math::Mat3f, memory::TaggedAllocator<math::Mat3f, memory::Tag::Scene>> m_world;
+
+		// Scratch, kept to avoid allocating every update.
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Scene>> m_dirty;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Scene>> m_order;
+		std::vector<u32, memory::TaggedAllocator<u32, memory::Tag::Scene>> m_remap;
+
+		u32 m_updatedCount = 0;
+		bool m_isSorted = true;
+	};
+}
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include "Core/Types.hpp"
+#include "Core/Math/Vec2.hpp"
+
+namespace core
+{
+	// Bits needed to hold every value up to maxValue.
+	constexpr u32 bitsRequired(u64 maxValue)
+	{
+		u32 bits = 0;
+		for (; maxValue != 0; maxValue >>= 1)
+			++bits;
+		return bits;
+	}
+
+	// Floats between min and max, rounded to multiples of step from min. Values outside are clamped.
+	struct QuantizedRange
+	{
+		f32 min = 0.0f;
+		f32 step = 1.0f;
+		u32 maxSteps = 0;
+		u32 bits = 0;
+
+		QuantizedRange() = default;
+		QuantizedRange(f32 rangeMin, f32 rangeMax, f32 rangeStep)
+			: min(rangeMin)
+			, step(rangeStep)
+		{
+			assert(rangeStep > 0.0f && rangeMax > rangeMin);
+			const f32 steps = std::ceil((rangeMax - rangeMin) / rangeStep);
+			// Floats only count exactly up to 2^24.
+			assert(steps <= 16777216.0f && "Too many steps in the range.");
+			maxSteps = static_cast<u32>(steps);
+			bits = bitsRequired(maxSteps);
+		}
+
+		u32 quantize(f32 value) const
+		{
+			// Written so NaN lands on min instead of an undefined conversion.
+			const f32 steps = std::round((value - min) / step);
+			return steps > 0.0f ? static_cast<u32>(std::min(steps, static_cast<f32>(maxSteps))) : 0;
+		}
+
+		f32 dequantize(u32 steps) const { return min + static_cast<f32>(steps) * step; }
+	};
+
+	// Packs values into as few bits as they need. Bits gather in a 64 bit word that is stored whole once full,
+	// so writing is a shift and an or, with a store every 64 bits. Writing past the capacity sets hasOverflowed()
+	// and stores nothing more. Words are stored in host byte order, which the targets all share as little endian.
+	class BitWriter
+	{
+	public:
+		BitWriter(void *buffer, usize capacity)
+			: m_buffer(static_cast<u8 *>(buffer))
+			, m_capacity(capacity)
+		{}
+
+		// Count is 1 to 64, and value must fit in count bits.
+		void writeBits(u64 value, u32 count)
+		{
+			assert(count >= 1 && count <= 64);
+			assert((count == 64 || value >> count == 0) && "Value does not fit in the bits given.");
+
+			m_scratch |= value << m_scratchBits;
+			const u32 total = m_scratchBits + count;
+			if (total >= 64)
+			{
+				storeWord(m_scratch);
+				// The bits of value that did not fit, written as two shifts so a shift by 64 never happens.
+				m_scratch = (value >> 1) >> (63 - m_scratchBits);
+			}
+			m_scratchBits = total & 63;
+			m_bitsWritten += count;
+		}
+
+		void writeBool(bool value) { writeBits(value ? 1 : 0, 1); }
+
+		// Seven bits at a time, smaller values in fewer bytes.
+		void writeVarint(u64 value)
+		{
+			for (; value >= 0x80; value >>= 7)
+				writeBits((value & 0x7f) | 0x80, 8);
+			writeBits(value, 8);
+		}
+
+		// Zigzag encoded, so small values of either sign stay small.
+		void writeSignedVarint(i64 value)
+		{
+			writeVarint((static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63));
+		}
+
+		void writeFloat(f32 value, const QuantizedRange &range)
+		{
+			if (range.bits > 0)
+				writeBits(range.quantize(value), range.bits);
+		}
+
+		void writeVec2(const math::Vec2f &value, const QuantizedRange &range) { writeVec2(value, range, range); }
+		void writeVec2(const math::Vec2f &value, const QuantizedRange &rangeX, const QuantizedRange &rangeY)
+		{
+			writeFloat(value.x, rangeX);
+			writeFloat(value.y, rangeY);
+		}
+
+		// Starts at the next byte boundary, and copied as a block.
+		void writeBytes(const void *data, usize size)
+		{
+			alignToByte();
+			flushScratch();
+			if (m_bytesStored + size > m_capacity)
+			{
+				m_hasOverflowed = true;
+				return;
+			}
+			std::memcpy(m_buffer + m_bytesStored, data, size);
+			m_bytesStored += size;
+			m_bitsWritten += size * 8;
+		}
+
+		void alignToByte()
+		{
+			const u32 padding = (8 - (m_bitsWritten & 7)) & 7;
+			if (padding > 0)
+				writeBits(0, padding);
+		}
+
+		// Stores the bits still in the scratch word. Returns the bytes written, the last one padded with zeros.
+		usize finish()
+		{
+			alignToByte();
+			flushScratch();
+			return m_bytesStored;
+		}
+
+		usize bitsWritten() const { return m_bitsWritten; }
+		bool hasOverflowed() const { return m_hasOverflowed; }
+
+	private:
+		void storeWord(u64 word)
+		{
+			if (m_bytesStored + 8 > m_capacity)
+			{
+				m_hasOverflowed = true;
+				return;
+			}
+			std::memcpy(m_buffer + m_bytesStored, &word, 8);
+			m_bytesStored += 8;
+		}
+
+		// Only called on a byte boundary.
+		void flushScratch()
+		{
+			usize bytes = m_scratchBits / 8;
+			if (m_bytesStored + bytes > m_capacity)
+			{
+				m_hasOverflowed = true;
+				bytes = m_bytesStored < m_capacity ? m_capacity - m_bytesStored : 0;
+			}
+			if (bytes > 0)
+				std::memcpy(m_buffer + m_bytesStored, &m_scratch, bytes);
+			m_bytesStored += bytes;
+			m_scratch = 0;
+			m_scratchBits = 0;
+		}
+
+		u8 *m_buffer;
+		usize m_capacity;
+		usize m_bytesStored = 0;
+		usize m_bitsWritten = 0;
+		u64 m_scratch = 0;
+		u32 m_scratchBits = 0;
+		bool m_hasOverflowed = false;
+	};
+
+	// Reads what a BitWriter wrote, straight from the buffer, a 64 bit word at a time.
+	// Bits past the end read as zeros and set hasOverflowed(), so a reader can decode a whole message
+	// and check once at the end. Values read from untrusted data must still be range checked.
+	class BitReader
+	{
+	public:
+		BitReader(const void *data, usize size)
+			: m_data(static_cast<const u8 *>(data))
+			, m_size(size)
+		{}
+
+		// Count is 1 to 64. Words past the end load as zeros, so the end is only checked when asked about.
+		u64 readBits(u32 count)
+		{
+			assert(count >= 1 && count <= 64);
+
+			u64 value = m_scratch;
+			if (count > m_scratchBits)
+			{
+				const u64 word = loadWord();
+				value |= word << m_scratchBits;
+				m_scratch = (word >> 1) >> (count - m_scratchBits - 1);
+				m_scratchBits += 64 - count;
+			}
+			else
+			{
+				m_scratch = (m_scratch >> 1) >> (count - 1);
+				m_scratchBits -= count;
+			}
+
+			return value & (~0ull >> (64 - count));
+		}
+
+		bool readBool() { return readBits(1) != 0; }
+
+		u64 readVarint()
+		{
+			u64 value = 0;
+			for (u32 shift = 0; shift < 64; shift += 7)
+			{
+				const u64 byte = readBits(8);
+				value |= (byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+					return value;
+			}
+			m_hasOverflowed = true;
+			return 0;
+		}
+
+		i64 readSignedVarint()
+		{
+			const u64 value = readVarint();
+			return static_cast<i64>(value >> 1) ^ -static_cast<i64>(value & 1);
+		}
+
+		f32 readFloat(const QuantizedRange &range)
+		{
+			if (range.bits == 0)
+				return range.min;
+			const u64 steps = readBits(range.bits);
+			return range.dequantize(static_cast<u32>(std::min<u64>(steps, range.maxSteps)));
+		}
+
+		math::Vec2f readVec2(const QuantizedRange &range) { return readVec2(range, range); }
+		math::Vec2f readVec2(const QuantizedRange &rangeX, const QuantizedRange &rangeY)
+		{
+			const f32 x = readFloat(rangeX);
+			const f32 y = readFloat(rangeY);
+			return { x, y };
+		}
+
+		// Returns false, copying nothing, when fewer bytes remain.
+		bool readBytes(void *data, usize size)
+		{
+			const u8 *bytes = viewBytes(size);
+			if (bytes == nullptr)
+				return false;
+			std::memcpy(data, bytes, size);
+			return true;
+		}
+
+		// Skips a byte aligned block and returns where it is in the buffer. Nullptr when fewer bytes remain.
+		const u8 *viewBytes(usize size)
+		{
+			alignToByte();
+			const usize offset = bitsRead() / 8;
+			if (hasOverflowed() || size > m_size - offset)
+			{
+				m_hasOverflowed = true;
+				return nullptr;
+			}
+			// Restart word loads at the byte after the block.
+			m_nextWord = offset + size;
+			m_scratch = 0;
+			m_scratchBits = 0;
+			return m_data + offset;
+		}
+
+		void alignToByte()
+		{
+			const u32 padding = (8 - (bitsRead() & 7)) & 7;
+			if (padding > 0)
+				readBits(padding);
+		}
+
+		// Bits loaded from the buffer, less those still waiting in the scratch word.
+		usize bitsRead() const { return m_nextWord * 8 - m_scratchBits; }
+		// Whole bytes not read yet.
+		usize bytesRemaining() const { return bitsRead() >= m_size * 8 ? 0 : m_size - (bitsRead() + 7) / 8; }
+		bool hasOverflowed() const { return m_hasOverflowed || bitsRead() > m_size * 8; }
+
+	private:
+		u64 loadWord()
+		{
+			u64 word = 0;
+			if (m_nextWord + 8 <= m_size)
+				std::memcpy(&word, m_data + m_nextWord, 8);
+			else if (m_nextWord < m_size)
+				std::memcpy(&word, m_data + m_nextWord, m_size - m_nextWord);
+			m_nextWord += 8;
+			return word;
+		}
+
+		const u8 *m_data;
+		usize m_size;
+		usize m_nextWord = 0;
+		u64 m_scratch = 0;
+		u32 m_scratchBits = 0;
+		bool m_hasOverflowed = false;
+	};
+}
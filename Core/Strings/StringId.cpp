@@ -0,0 +1,163 @@
+#include "Core/Strings/StringId.hpp"
+
+#if CORE_STRINGID_TRACK
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <thread>
+#endif
+
+namespace core
+{
+#if CORE_STRINGID_TRACK
+	namespace
+	{
+		// Open addressed table of hash to string, filled with compare and swap so interning never takes a lock.
+		// Entries are never removed. The strings live in static storage, outside the memory tags, because the
+		// table outlives every leak report.
+		constexpr usize k_tableCapacity = 1 << 16;
+		constexpr usize k_storageBytes = 2 * 1024 * 1024;
+
+		struct Entry
+		{
+			std::atomic<u64> hash{ 0 };
+			std::atomic<const char *> text{ nullptr };
+			// Written before text is published, so readers that saw text see it too. Strings may hold NULs.
+			usize length = 0;
+		};
+
+		Entry s_entries[k_tableCapacity];
+		char s_storage[k_storageBytes];
+		std::atomic<usize> s_storageUsed{ 0 };
+		std::atomic<u32> s_collisions{ 0 };
+		std::atomic<bool> s_warnedFull{ false };
+		// Text of entries claimed after the storage filled up. Compared by address, so their ids neither turn back
+		// into strings nor get checked for collisions.
+		const char s_truncated[] = "";
+
+		const char *copyString(const char *text, usize length)
+		{
+			const usize offset = s_storageUsed.fetch_add(length + 1, std::memory_order_relaxed);
+			if (offset + length + 1 > k_storageBytes)
+				return nullptr;
+
+			char *copy = s_storage + offset;
+			std::memcpy(copy, text, length);
+			copy[length] = '\0';
+			return copy;
+		}
+
+		// Another thread claimed the entry but may not have published its string yet.
+		const char *waitForText(const Entry &entry)
+		{
+			const char *text;
+			while ((text = entry.text.load(std::memory_order_acquire)) == nullptr)
+				std::this_thread::yield();
+			return text;
+		}
+
+		void warnFull()
+		{
+			if (!s_warnedFull.exchange(true, std::memory_order_relaxed))
+				std::cerr << "[StringId] The intern table is full, new ids will have no string.\n";
+		}
+
+		void record(u64 hash, const char *text, usize length)
+		{
+			// Zero marks empty entries, and an id hashing to it could not be recorded anyway.
+			if (hash == 0)
+				return;
+
+			for (usize probe = 0; probe < k_tableCapacity; ++probe)
+			{
+				Entry &entry = s_entries[(hash + probe) & (k_tableCapacity - 1)];
+				u64 current = entry.hash.load(std::memory_order_acquire);
+				if (current == 0 && entry.hash.compare_exchange_strong(current, hash, std::memory_order_acq_rel))
+				{
+					const char *copy = copyString(text, length);
+					if (copy == nullptr)
+					{
+						warnFull();
+						copy = s_truncated;
+					}
+					entry.length = length;
+					entry.text.store(copy, std::memory_order_release);
+					return;
+				}
+
+				if (current != hash)
+					continue;
+
+				const char *known = waitForText(entry);
+				if (known == s_truncated)
+					return;
+				if (entry.length != length || std::memcmp(known, text, length) != 0)
+				{
+					s_collisions.fetch_add(1, std::memory_order_relaxed);
+					std::cerr << "[StringId] \"" << std::string_view(text, length) << "\" and \"" << std::string_view(known, entry.length)
+						<< "\" hash to the same id.\n";
+				}
+				return;
+			}
+
+			warnFull();
+		}
+
+		const Entry *find(u64 hash)
+		{
+			if (hash == 0)
+				return nullptr;
+
+			for (usize probe = 0; probe < k_tableCapacity; ++probe)
+			{
+				const Entry &entry = s_entries[(hash + probe) & (k_tableCapacity - 1)];
+				const u64 current = entry.hash.load(std::memory_order_acquire);
+				if (current == hash)
+					return &entry;
+				if (current == 0)
+					return nullptr;
+			}
+
+			return nullptr;
+		}
+	}
+
+	StringId StringId::intern(const char *text, usize length)
+	{
+		const StringId id(text, length);
+		record(id.m_hash, text, length);
+		return id;
+	}
+
+	const char *StringId::str() const
+	{
+		const Entry *entry = find(m_hash);
+		if (entry == nullptr)
+			return nullptr;
+
+		const char *text = waitForText(*entry);
+		return text != s_truncated ? text : nullptr;
+	}
+
+	u32 StringId::collisionCount()
+	{
+		return s_collisions.load(std::memory_order_relaxed);
+	}
+#else
+	StringId StringId::intern(const char *text, usize length)
+	{
+		return StringId(text, length);
+	}
+
+	const char *StringId::str() const
+	{
+		return nullptr;
+	}
+
+	u32 StringId::collisionCount()
+	{
+		return 0;
+	}
+#endif
+}
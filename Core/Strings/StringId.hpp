@@ -0,0 +1,82 @@
+#pragma once
+
+#include <functional>
+
+#include "Core/Types.hpp"
+
+// Debug builds remember the string behind every interned id, for str() and collision checks.
+#if defined(_DEBUG) && !defined(CORE_STRINGID_TRACK)
+#define CORE_STRINGID_TRACK 1
+#endif
+
+namespace core
+{
+	// 64 bit FNV-1a. Runs at compile time for constant strings.
+	constexpr u64 hashString(const char *text, usize length)
+	{
+		u64 hash = 14695981039346656037ull;
+		for (usize i = 0; i < length; ++i)
+		{
+			hash ^= static_cast<u8>(text[i]);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	constexpr usize stringLength(const char *text)
+	{
+		usize length = 0;
+		while (text[length] != '\0')
+			++length;
+		return length;
+	}
+
+	// Name reduced to its 64 bit hash, so comparing and hashing names costs an integer compare.
+	// Ids built from constant strings are computed by the compiler. intern() also records the string,
+	// which lets str() turn ids back into names and reports two strings with the same hash.
+	class StringId
+	{
+	public:
+		constexpr StringId() = default;
+		constexpr explicit StringId(const char *text) : m_hash(hashString(text, stringLength(text))) {}
+		constexpr StringId(const char *text, usize length) : m_hash(hashString(text, length)) {}
+
+		// Without CORE_STRINGID_TRACK this only hashes.
+		static StringId intern(const char *text) { return intern(text, stringLength(text)); }
+		static StringId intern(const char *text, usize length);
+
+		constexpr u64 hash() const { return m_hash; }
+		// Default constructed ids name nothing.
+		constexpr bool isValid() const { return m_hash != 0; }
+
+		// The interned string with this id, or nullptr when none was interned or ids are not tracked.
+		const char *str() const;
+
+		// Distinct strings interned with the same hash since startup.
+		static u32 collisionCount();
+
+		constexpr bool operator==(const StringId &other) const { return m_hash == other.m_hash; }
+		constexpr bool operator!=(const StringId &other) const { return m_hash != other.m_hash; }
+		constexpr bool operator<(const StringId &other) const { return m_hash < other.m_hash; }
+
+	private:
+		u64 m_hash = 0;
+	};
+
+	namespace literals
+	{
+		constexpr StringId operator""_sid(const char *text, usize length)
+		{
+			return StringId(text, length);
+		}
+	}
+}
+
+namespace std
+{
+	template<>
+	struct hash<core::StringId>
+	{
+		usize operator()(const core::StringId &id) const { return static_cast<usize>(id.hash()); }
+	};
+}
@@ -0,0 +1,272 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Core/Assets/AssetPack.hpp"
+
+using namespace core;
+using namespace core::assets;
+
+TEST_CASE("AssetPack finds every asset written to it", "[assets][assetpack]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_assetpack_test.pack").string();
+
+	u32 numbers[100];
+	for (u32 i = 0; i < 100; ++i)
+		numbers[i] = i * i;
+	const char text[] = "hello pack";
+
+	AssetPackWriter writer;
+	writer.add(900, text, sizeof(text));
+	writer.add(7, numbers, sizeof(numbers));
+	writer.add(42, numbers, 3);
+	REQUIRE(writer.write(path.c_str()));
+
+	AssetPack pack;
+	REQUIRE(pack.open(path.c_str()));
+	CHECK(pack.assetCount() == 3);
+
+	const AssetView first = pack.find(7);
+	REQUIRE(first);
+	CHECK(first.size == sizeof(numbers));
+	CHECK(reinterpret_cast<std::uintptr_t>(first.data) % k_assetAlignment == 0);
+	CHECK(reinterpret_cast<const u32 *>(first.data)[99] == 99 * 99);
+
+	const AssetView second = pack.find(900);
+	REQUIRE(second);
+	CHECK(std::string(reinterpret_cast<const char *>(second.data)) == text);
+	CHECK(pack.offsetOf(second) % k_assetAlignment == 0);
+
+	CHECK(pack.find(42).size == 3);
+	CHECK_FALSE(pack.find(8));
+
+	pack.close();
+	CHECK_FALSE(pack.isOpen());
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("AssetPack rejects files that are not packs", "[assets][assetpack]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_assetpack_invalid_test.pack").string();
+	{
+		std::FILE *file = std::fopen(path.c_str(), "wb");
+		std::fputs("definitely not an asset pack, just some text that is long enough", file);
+		std::fclose(file);
+	}
+
+	AssetPack pack;
+	CHECK_FALSE(pack.open(path.c_str()));
+	CHECK_FALSE(pack.open((path + ".missing").c_str()));
+	std::filesystem::remove(path);
+}
+
+namespace
+{
+	// Texture-like data: long runs with some noise, so LZ4 has something to find.
+	std::vector<u8> makeCompressibleData(usize size)
+	{
+		std::vector<u8> data(size);
+		u32 state = 12345;
+		for (usize i = 0; i < size; ++i)
+		{
+			state = state * 1664525u + 1013904223u;
+			data[i] = static_cast<u8>((i / 64) & 0xff) ^ ((state >> 28) == 0 ? static_cast<u8>(state >> 8) : 0);
+		}
+		return data;
+	}
+}
+
+TEST_CASE("AssetPack loads compressed assets", "[assets][assetpack]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_assetpack_lz4_test.pack").string();
+
+	const std::vector<u8> large = makeCompressibleData(1024 * 1024 + 1234);
+	std::vector<u8> noise(200 * 1024);
+	u32 state = 7;
+	for (u8 &byte : noise)
+	{
+		state = state * 1664525u + 1013904223u;
+		byte = static_cast<u8>(state >> 24);
+	}
+
+	AssetPackWriter writer;
+	writer.add(1, large.data(), large.size(), Compression::Lz4);
+	writer.add(2, noise.data(), noise.size(), Compression::Lz4, k_minBlockSize);
+	writer.add(3, large.data(), 100, Compression::Lz4);
+	writer.add(4, large.data(), large.size());
+	REQUIRE(writer.write(path.c_str()));
+
+	AssetPack pack;
+	REQUIRE(pack.open(path.c_str()));
+
+	const PackEntry *entry = pack.findEntry(1);
+	REQUIRE(entry != nullptr);
+	CHECK(entry->compression == Compression::Lz4);
+	CHECK(entry->size == large.size());
+	CHECK(entry->storedSize < large.size() / 2);
+	CHECK(entry->blockCount() == 9);
+	CHECK_FALSE(pack.find(1));
+
+	jobs::JobSystemConfig config;
+	config.workerCount = 4;
+	config.fiberCount = 16;
+	jobs::JobSystem jobs(config);
+
+	for (AssetId id : { AssetId(1), AssetId(2), AssetId(3), AssetId(4) })
+	{
+		const PackEntry *asset = pack.findEntry(id);
+		REQUIRE(asset != nullptr);
+		const u8 *expected = id == 2 ? noise.data() : large.data();
+
+		std::vector<u8> serial(static_cast<usize>(asset->size));
+		std::vector<u8> parallel(static_cast<usize>(asset->size));
+		REQUIRE(pack.load(*asset, serial.data()));
+		REQUIRE(pack.load(*asset, parallel.data(), jobs));
+		CHECK(std::memcmp(serial.data(), expected, serial.size()) == 0);
+		CHECK(std::memcmp(parallel.data(), expected, parallel.size()) == 0);
+	}
+
+	// Blocks that do not compress are stored as they are.
+	CHECK(pack.findEntry(2)->storedSize == noise.size() + sizeof(u64) * 5);
+
+	pack.close();
+	std::filesystem::remove(path);
+}
+
+namespace
+{
+	std::vector<u8> readFile(const std::string &path)
+	{
+		std::vector<u8> bytes(static_cast<usize>(std::filesystem::file_size(path)));
+		std::FILE *file = std::fopen(path.c_str(), "rb");
+		std::fread(bytes.data(), 1, bytes.size(), file);
+		std::fclose(file);
+		return bytes;
+	}
+
+	void writeFile(const std::string &path, const std::vector<u8> &bytes)
+	{
+		std::FILE *file = std::fopen(path.c_str(), "wb");
+		std::fwrite(bytes.data(), 1, bytes.size(), file);
+		std::fclose(file);
+	}
+
+	template<typename Patch>
+	bool opensPatched(const std::vector<u8> &original, const std::string &path, Patch patch)
+	{
+		std::vector<u8> bytes = original;
+		PackHeader header;
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		patch(bytes, header);
+		std::memcpy(bytes.data(), &header, sizeof(header));
+		writeFile(path, bytes);
+
+		AssetPack pack;
+		return pack.open(path.c_str());
+	}
+}
+
+TEST_CASE("AssetPack rejects packs whose entries reach past the file", "[assets][assetpack]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_assetpack_cut_test.pack").string();
+	const std::vector<u8> large = makeCompressibleData(512 * 1024);
+
+	AssetPackWriter writer;
+	writer.add(1, large.data(), 1000);
+	writer.add(2, large.data(), large.size(), Compression::Lz4);
+	REQUIRE(writer.write(path.c_str()));
+	const std::vector<u8> original = readFile(path);
+	CHECK(opensPatched(original, path, [](std::vector<u8> &, PackHeader &) {}));
+
+	const auto entryAt = [](std::vector<u8> &bytes, const PackHeader &header, usize index)
+	{
+		return reinterpret_cast<PackEntry *>(bytes.data() + header.tableOffset + index * sizeof(PackEntry));
+	};
+
+	// Cut short in the middle of the compressed asset, with the table moved up so that it still fits.
+	CHECK_FALSE(opensPatched(original, path, [](std::vector<u8> &bytes, PackHeader &header)
+	{
+		const usize kept = static_cast<usize>(header.tableOffset - 64 * 1024) & ~usize(7);
+		std::vector<u8> table(bytes.begin() + static_cast<std::ptrdiff_t>(header.tableOffset), bytes.end());
+		bytes.resize(kept);
+		bytes.insert(bytes.end(), table.begin(), table.end());
+		header.tableOffset = kept;
+	}));
+
+	CHECK_FALSE(opensPatched(original, path, [&](std::vector<u8> &bytes, PackHeader &header)
+	{
+		entryAt(bytes, header, 0)->size = bytes.size();
+		entryAt(bytes, header, 0)->storedSize = bytes.size();
+	}));
+	CHECK_FALSE(opensPatched(original, path, [&](std::vector<u8> &bytes, PackHeader &header)
+	{
+		entryAt(bytes, header, 0)->offset = ~u64(0) - 10;
+	}));
+	CHECK_FALSE(opensPatched(original, path, [&](std::vector<u8> &bytes, PackHeader &header)
+	{
+		entryAt(bytes, header, 1)->blockSize = 0;
+	}));
+	// A block table longer than the asset.
+	CHECK_FALSE(opensPatched(original, path, [&](std::vector<u8> &bytes, PackHeader &header)
+	{
+		entryAt(bytes, header, 1)->blockSize = 1;
+	}));
+
+	// Block offsets are only checked on load.
+	{
+		std::vector<u8> bytes = original;
+		PackHeader header;
+		std::memcpy(&header, bytes.data(), sizeof(header));
+		const PackEntry entry = *entryAt(bytes, header, 1);
+		const u64 pastEnd = entry.storedSize + 1;
+		std::memcpy(bytes.data() + entry.offset + sizeof(u64) * 2, &pastEnd, sizeof(pastEnd));
+		writeFile(path, bytes);
+
+		AssetPack pack;
+		REQUIRE(pack.open(path.c_str()));
+		std::vector<u8> loaded(static_cast<usize>(entry.size));
+		CHECK_FALSE(pack.load(*pack.findEntry(2), loaded.data()));
+	}
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("AssetPack load throughput", "[assets][assetpack][!benchmark]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_assetpack_benchmark.pack").string();
+
+	const std::vector<u8> data = makeCompressibleData(32 * 1024 * 1024);
+	AssetPackWriter writer;
+	writer.add(1, data.data(), data.size());
+	writer.add(2, data.data(), data.size(), Compression::Lz4);
+	REQUIRE(writer.write(path.c_str()));
+
+	AssetPack pack;
+	REQUIRE(pack.open(path.c_str()));
+	jobs::JobSystem jobs;
+	std::vector<u8> destination(data.size());
+	const PackEntry &raw = *pack.findEntry(1);
+	const PackEntry &compressed = *pack.findEntry(2);
+
+	BENCHMARK("Uncompressed mapped copy")
+	{
+		return pack.load(raw, destination.data());
+	};
+
+	BENCHMARK("LZ4 serial")
+	{
+		return pack.load(compressed, destination.data());
+	};
+
+	BENCHMARK("LZ4 parallel")
+	{
+		return pack.load(compressed, destination.data(), jobs);
+	};
+
+	pack.close();
+	std::filesystem::remove(path);
+}
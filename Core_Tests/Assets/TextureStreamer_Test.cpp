@@ -0,0 +1,231 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core/Assets/TextureStreamer.hpp"
+
+using namespace core;
+using namespace core::assets;
+
+namespace
+{
+	constexpr u32 k_extent = 256;
+	constexpr u32 k_mipCount = 9;
+	constexpr u32 k_bytesPerTexel = 4;
+
+	// Every texel of a level holds the texture id and level, so mixed up data is easy to spot.
+	void addTexture(AssetPackWriter &writer, AssetId id)
+	{
+		std::vector<std::vector<u8>> levels(k_mipCount);
+		const u8 *pointers[k_mipCount];
+		for (u32 mip = 0; mip < k_mipCount; ++mip)
+		{
+			levels[mip].assign(mipSize(k_extent, k_extent, k_bytesPerTexel, mip), static_cast<u8>(id * 16 + mip));
+			pointers[mip] = levels[mip].data();
+		}
+
+		const TextureBytes bytes = buildTextureAsset(k_extent, k_extent, k_bytesPerTexel, k_mipCount, pointers);
+		writer.add(id, bytes.data(), bytes.size());
+	}
+
+	usize bytesFrom(u32 mip)
+	{
+		usize total = 0;
+		for (; mip < k_mipCount; ++mip)
+			total += mipSize(k_extent, k_extent, k_bytesPerTexel, mip);
+		return total;
+	}
+
+	// Runs frames until the texture stops gaining levels.
+	void settle(TextureStreamer &streamer, TextureHandle texture, f32 screenSize)
+	{
+		for (u32 frame = 0; frame < 10000; ++frame)
+		{
+			streamer.request(texture, screenSize);
+			streamer.update();
+			if (streamer.residentMip(texture) == streamer.requestedMip(texture))
+				break;
+			std::this_thread::yield();
+		}
+
+		// The frame that finishes the last load.
+		streamer.request(texture, screenSize);
+		streamer.update();
+	}
+
+	bool levelMatches(const TextureStreamer &streamer, TextureHandle texture, AssetId id, u32 mip)
+	{
+		const u8 *data = streamer.mipData(texture, mip);
+		if (data == nullptr)
+			return false;
+
+		const usize size = mipSize(k_extent, k_extent, k_bytesPerTexel, mip);
+		for (usize i = 0; i < size; ++i)
+		{
+			if (data[i] != static_cast<u8>(id * 16 + mip))
+				return false;
+		}
+
+		return true;
+	}
+}
+
+TEST_CASE("TextureStreamer loads the levels a texture is requested at", "[assets][texturestreamer]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_texturestreamer_test.pack").string();
+	{
+		AssetPackWriter writer;
+		addTexture(writer, 1);
+		addTexture(writer, 2);
+		REQUIRE(writer.write(path.c_str()));
+	}
+
+	AssetPack pack;
+	REQUIRE(pack.open(path.c_str()));
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+
+	{
+		TextureStreamer streamer(pack, jobs);
+		CHECK_FALSE(streamer.addTexture(3).isValid());
+		const TextureHandle texture = streamer.addTexture(1);
+		REQUIRE(texture.isValid());
+		CHECK(streamer.residentMip(texture) == k_mipCount);
+		CHECK(streamer.usedBytes() == 0);
+
+		// 40 pixels across needs the 64 texel level.
+		settle(streamer, texture, 40.0f);
+		CHECK(streamer.residentMip(texture) == 2);
+		CHECK(streamer.usedBytes() == bytesFrom(2));
+		CHECK(streamer.mipData(texture, 1) == nullptr);
+		for (u32 mip = 2; mip < k_mipCount; ++mip)
+			CHECK(levelMatches(streamer, texture, 1, mip));
+
+		settle(streamer, texture, 1000.0f);
+		CHECK(streamer.residentMip(texture) == 0);
+		CHECK(levelMatches(streamer, texture, 1, 0));
+	}
+
+	pack.close();
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("TextureStreamer evicts least recently used levels under its budget", "[assets][texturestreamer]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_texturestreamer_budget_test.pack").string();
+	{
+		AssetPackWriter writer;
+		addTexture(writer, 1);
+		addTexture(writer, 2);
+		REQUIRE(writer.write(path.c_str()));
+	}
+
+	AssetPack pack;
+	REQUIRE(pack.open(path.c_str()));
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+
+	// Room for one full chain plus the coarse half of another.
+	TextureStreamerConfig config;
+	config.budgetBytes = bytesFrom(0) + bytesFrom(2);
+	TextureStreamer streamer(pack, jobs, config);
+	const TextureHandle first = streamer.addTexture(1);
+	const TextureHandle second = streamer.addTexture(2);
+
+	settle(streamer, first, 256.0f);
+	CHECK(streamer.residentMip(first) == 0);
+
+	// The second texture takes the first one's finest levels, as they were used longest ago.
+	settle(streamer, second, 256.0f);
+	CHECK(streamer.residentMip(second) == 0);
+	CHECK(streamer.residentMip(first) == 2);
+	CHECK(streamer.usedBytes() <= streamer.budgetBytes());
+	CHECK(levelMatches(streamer, first, 1, 2));
+	CHECK(levelMatches(streamer, second, 2, 0));
+
+	// Levels requested in the same frame are never evicted for each other; loading stops at the budget instead.
+	for (u32 frame = 0; frame < 1000; ++frame)
+	{
+		streamer.request(first, 256.0f);
+		streamer.request(second, 256.0f);
+		streamer.update();
+		CHECK(streamer.usedBytes() <= streamer.budgetBytes());
+	}
+	CHECK(streamer.residentMip(second) == 0);
+	CHECK(streamer.residentMip(first) == 2);
+
+	// Lowering the budget drops unused levels on the next update.
+	streamer.setBudget(bytesFrom(3));
+	streamer.update();
+	CHECK(streamer.usedBytes() <= bytesFrom(3));
+	CHECK(streamer.usedBytes() == bytesFrom(streamer.residentMip(first)) + bytesFrom(streamer.residentMip(second)));
+}
+
+TEST_CASE("TextureStreamer rejects textures with corrupt level records", "[assets][texturestreamer]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_texturestreamer_corrupt_test.pack").string();
+
+	std::vector<std::vector<u8>> levels(k_mipCount);
+	const u8 *pointers[k_mipCount];
+	for (u32 mip = 0; mip < k_mipCount; ++mip)
+	{
+		levels[mip].assign(mipSize(k_extent, k_extent, k_bytesPerTexel, mip), static_cast<u8>(mip));
+		pointers[mip] = levels[mip].data();
+	}
+	const TextureBytes original = buildTextureAsset(k_extent, k_extent, k_bytesPerTexel, k_mipCount, pointers);
+
+	const auto recordAt = [](TextureBytes &bytes, u32 mip)
+	{
+		return reinterpret_cast<TextureMip *>(bytes.data() + sizeof(TextureHeader)) + mip;
+	};
+	const auto headerOf = [](TextureBytes &bytes)
+	{
+		return reinterpret_cast<TextureHeader *>(bytes.data());
+	};
+
+	{
+		AssetPackWriter writer;
+		writer.add(1, original.data(), original.size());
+
+		// A level reaching past the asset.
+		TextureBytes pastEnd = original;
+		recordAt(pastEnd, 0)->offset = pastEnd.size() - 16;
+		writer.add(2, pastEnd.data(), pastEnd.size());
+
+		// An offset that wraps around when the size is added.
+		TextureBytes wrapped = original;
+		recordAt(wrapped, 1)->offset = ~u64(0) - 8;
+		writer.add(3, wrapped.data(), wrapped.size());
+
+		// A level that fits in the asset but is smaller than its extent needs.
+		TextureBytes shrunk = original;
+		recordAt(shrunk, 2)->size -= 4;
+		writer.add(4, shrunk.data(), shrunk.size());
+
+		// More levels than a u32 extent can have, all records still inside the asset.
+		TextureBytes tooMany(sizeof(TextureHeader) + sizeof(TextureMip) * 40);
+		std::memcpy(tooMany.data(), original.data(), sizeof(TextureHeader));
+		headerOf(tooMany)->mipCount = 40;
+		writer.add(5, tooMany.data(), tooMany.size());
+
+		REQUIRE(writer.write(path.c_str()));
+	}
+
+	AssetPack pack;
+	REQUIRE(pack.open(path.c_str()));
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+
+	{
+		TextureStreamer streamer(pack, jobs);
+		CHECK(streamer.addTexture(1).isValid());
+		CHECK_FALSE(streamer.addTexture(2).isValid());
+		CHECK_FALSE(streamer.addTexture(3).isValid());
+		CHECK_FALSE(streamer.addTexture(4).isValid());
+		CHECK_FALSE(streamer.addTexture(5).isValid());
+	}
+
+	pack.close();
+	std::filesystem::remove(path);
+}
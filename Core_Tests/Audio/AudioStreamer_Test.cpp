@@ -0,0 +1,235 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core/Audio/AudioStreamer.hpp"
+#include "Core/Audio/Mixer.hpp"
+#include "Core/Audio/SoundAsset.hpp"
+
+using namespace core;
+using namespace core::audio;
+
+namespace
+{
+	constexpr u32 k_ringFrames = 4096;
+	// A 60 Hz frame of audio at 48 kHz.
+	constexpr u32 k_frameSamples = 800;
+
+	// Two sines a fifth apart, one per channel, so swapped channels or frames show up.
+	std::vector<f32> music(u32 frameCount, u32 channelCount)
+	{
+		std::vector<f32> samples(usize(frameCount) * channelCount);
+		for (u32 i = 0; i < frameCount; ++i)
+		{
+			for (u32 channel = 0; channel < channelCount; ++channel)
+				samples[i * channelCount + channel] = 0.5f * std::sin(static_cast<f32>(i) * (0.01f + 0.005f * channel));
+		}
+		return samples;
+	}
+
+	void addSound(assets::AssetPackWriter &writer, assets::AssetId id, const std::vector<f32> &samples, u32 channelCount, u32 sampleRate = 48000)
+	{
+		const SoundBytes bytes = buildSoundAsset(samples.data(), static_cast<u32>(samples.size() / channelCount), channelCount, sampleRate);
+		writer.add(id, bytes.data(), bytes.size());
+	}
+
+	// What a frame of the game does, then waits until the refill it started has decoded the frames the next render
+	// needs, so tests do not depend on the scheduler.
+	void runFrame(AudioStreamer &streamer, const AudioStream &stream, u32 wanted = k_frameSamples * 2)
+	{
+		streamer.update();
+		for (u32 spin = 0; spin < 1000000 && stream.bufferedFrames() < wanted; ++spin)
+			std::this_thread::yield();
+	}
+
+	struct StreamFixture
+	{
+		std::string path;
+		assets::AssetPack pack;
+		std::vector<f32> stereo = music(100000, 2);
+		std::vector<f32> loop = music(1000, 1);
+
+		StreamFixture()
+			: path((std::filesystem::temp_directory_path() / "ang_audiostreamer_test.pack").string())
+		{
+			assets::AssetPackWriter writer;
+			addSound(writer, 1, stereo, 2);
+			addSound(writer, 2, loop, 1);
+			const f32 text[] = { 1.0f, 2.0f, 3.0f };
+			writer.add(3, text, sizeof(text));
+			addSound(writer, 4, loop, 1, 0);
+			REQUIRE(writer.write(path.c_str()));
+			REQUIRE(pack.open(path.c_str()));
+		}
+
+		~StreamFixture()
+		{
+			pack.close();
+			std::filesystem::remove(path);
+		}
+	};
+
+	VoiceParams centred()
+	{
+		VoiceParams params;
+		params.isPositional = false;
+		return params;
+	}
+}
+
+TEST_CASE("AudioStreamer plays a sound through a ring far smaller than it", "[audio][audiostreamer]")
+{
+	StreamFixture fixture;
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	AudioStreamerConfig config;
+	config.maxStreams = 4;
+	config.ringFrames = k_ringFrames;
+	AudioStreamer streamer(fixture.pack, jobs, config);
+	Mixer mixer;
+
+	AudioStream *stream = streamer.open(1);
+	REQUIRE(stream != nullptr);
+	CHECK(stream->channelCount() == 2);
+	CHECK(stream->frameCount() == 100000);
+	runFrame(streamer, *stream);
+	REQUIRE(stream->isPrimed());
+
+	const VoiceHandle voice = mixer.playStream(*stream, centred());
+	REQUIRE(voice.isValid());
+
+	// Nothing is allocated while it plays.
+	const i64 liveBytes = memory::stats(memory::Tag::Audio).liveBytes;
+
+	std::vector<f32> output(k_frameSamples * 2);
+	u32 played = 0;
+	f32 worst = 0.0f;
+	while (played < 100000)
+	{
+		mixer.render(output.data(), k_frameSamples);
+		for (u32 i = 0; i < k_frameSamples && played + i < 100000; ++i)
+		{
+			worst = std::max(worst, std::abs(output[i * 2] - fixture.stereo[(played + i) * 2]));
+			worst = std::max(worst, std::abs(output[i * 2 + 1] - fixture.stereo[(played + i) * 2 + 1]));
+		}
+		played += k_frameSamples;
+		mixer.update();
+		runFrame(streamer, *stream, std::min(k_frameSamples * 2, played < 100000 ? 100000 - played : 0));
+	}
+
+	// 16 bit samples.
+	CHECK(worst < 1.0f / 32767.0f);
+	CHECK(stream->underrunCount() == 0);
+	CHECK(memory::stats(memory::Tag::Audio).liveBytes == liveBytes);
+	CHECK(streamer.ringBytes() == 4 * k_ringFrames * 2 * sizeof(f32));
+
+	// The end fades out within a frame, and the voice is done.
+	mixer.render(output.data(), k_frameSamples);
+	mixer.update();
+	CHECK_FALSE(mixer.isPlaying(voice));
+
+	streamer.close(stream);
+	streamer.update();
+	CHECK(streamer.openCount() == 0);
+}
+
+TEST_CASE("AudioStreamer loops streams without a seam", "[audio][audiostreamer]")
+{
+	StreamFixture fixture;
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	AudioStreamerConfig config;
+	config.ringFrames = k_ringFrames;
+	AudioStreamer streamer(fixture.pack, jobs, config);
+	Mixer mixer;
+
+	AudioStream *stream = streamer.open(2, true);
+	REQUIRE(stream != nullptr);
+	runFrame(streamer, *stream);
+	REQUIRE(stream->isPrimed());
+	mixer.playStream(*stream, centred());
+
+	std::vector<f32> output(k_frameSamples * 2);
+	f32 worst = 0.0f;
+	for (u32 frame = 0; frame < 60; ++frame)
+	{
+		mixer.render(output.data(), k_frameSamples);
+		for (u32 i = 0; i < k_frameSamples; ++i)
+			worst = std::max(worst, std::abs(output[i * 2] - fixture.loop[(frame * k_frameSamples + i) % 1000]));
+		runFrame(streamer, *stream);
+	}
+
+	CHECK(worst < 1.0f / 32767.0f);
+	CHECK(stream->underrunCount() == 0);
+}
+
+TEST_CASE("AudioStreamer keeps a closed stream until its voice lets go", "[audio][audiostreamer]")
+{
+	StreamFixture fixture;
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	AudioStreamerConfig config;
+	config.maxStreams = 1;
+	config.ringFrames = k_ringFrames;
+	AudioStreamer streamer(fixture.pack, jobs, config);
+	Mixer mixer;
+
+	CHECK(streamer.open(99) == nullptr);
+	CHECK(streamer.open(3) == nullptr);
+	// No rate to play it at.
+	CHECK(streamer.open(4) == nullptr);
+
+	AudioStream *stream = streamer.open(2, true);
+	REQUIRE(stream != nullptr);
+	CHECK(streamer.open(1) == nullptr);
+
+	runFrame(streamer, *stream);
+	const VoiceHandle voice = mixer.playStream(*stream, centred());
+	std::vector<f32> output(k_frameSamples * 2);
+	mixer.render(output.data(), k_frameSamples);
+
+	streamer.close(stream);
+	streamer.update();
+	CHECK(streamer.openCount() == 1);
+
+	mixer.stop(voice);
+	streamer.update();
+	CHECK(streamer.openCount() == 1);
+
+	// The stop reaches the audio thread with the next render.
+	mixer.render(output.data(), k_frameSamples);
+	streamer.update();
+	CHECK(streamer.openCount() == 0);
+	CHECK(streamer.open(1) != nullptr);
+}
+
+TEST_CASE("AudioStreamer counts underruns when refills fall behind", "[audio][audiostreamer]")
+{
+	StreamFixture fixture;
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	AudioStreamerConfig config;
+	config.ringFrames = k_ringFrames;
+	AudioStreamer streamer(fixture.pack, jobs, config);
+	Mixer mixer;
+
+	AudioStream *stream = streamer.open(1);
+	REQUIRE(stream != nullptr);
+	runFrame(streamer, *stream);
+	mixer.playStream(*stream, centred());
+
+	// No updates, so nothing refills the ring once the first fill runs out.
+	std::vector<f32> output(k_frameSamples * 2);
+	for (u32 frame = 0; frame < 10; ++frame)
+		mixer.render(output.data(), k_frameSamples);
+	CHECK(stream->underrunCount() > 0);
+	CHECK(output[k_frameSamples] == 0.0f);
+
+	// Decoding picks up where the voice is now rather than where it fell behind.
+	const u32 underruns = stream->underrunCount();
+	runFrame(streamer, *stream);
+	mixer.render(output.data(), k_frameSamples);
+	CHECK(stream->underrunCount() == underruns);
+	CHECK(output[k_frameSamples] == Approx(fixture.stereo[(10 * k_frameSamples + k_frameSamples / 2) * 2]).margin(1e-4f));
+}
@@ -0,0 +1,386 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "Core/Audio/Mixer.hpp"
+
+using namespace core;
+using namespace core::audio;
+
+namespace
+{
+	std::vector<f32> ramp(u32 frameCount)
+	{
+		std::vector<f32> samples(frameCount);
+		for (u32 i = 0; i < frameCount; ++i)
+			samples[i] = static_cast<f32>(i) / static_cast<f32>(frameCount);
+		return samples;
+	}
+
+	std::vector<f32> sine(u32 frameCount, f32 cyclesPerFrame)
+	{
+		std::vector<f32> samples(frameCount);
+		for (u32 i = 0; i < frameCount; ++i)
+			samples[i] = std::sin(static_cast<f32>(i) * cyclesPerFrame * 6.2831853f);
+		return samples;
+	}
+
+	f32 energy(const std::vector<f32> &output, usize channel)
+	{
+		f32 sum = 0.0f;
+		for (usize i = channel; i < output.size(); i += 2)
+			sum += output[i] * output[i];
+		return sum;
+	}
+
+	VoiceParams centred(f32 gain = 1.0f)
+	{
+		VoiceParams params;
+		params.gain = gain;
+		params.isPositional = false;
+		return params;
+	}
+}
+
+TEST_CASE("Mixer plays a sound at its own rate sample for sample", "[audio][mixer]")
+{
+	const std::vector<f32> samples = ramp(1000);
+	const Sound sound = { samples.data(), 1000, 1, 48000 };
+
+	Mixer mixer;
+	const VoiceHandle voice = mixer.play(sound, centred(0.5f));
+	REQUIRE(voice.isValid());
+	CHECK(mixer.isPlaying(voice));
+	CHECK(mixer.playingCount() == 1);
+
+	std::vector<f32> output(1200 * 2);
+	mixer.render(output.data(), 1200);
+	CHECK(mixer.mixedVoiceCount() == 1);
+	for (u32 i = 0; i < 999; ++i)
+	{
+		REQUIRE(output[i * 2] == Approx(samples[i] * 0.5f));
+		REQUIRE(output[i * 2 + 1] == Approx(samples[i] * 0.5f));
+	}
+	for (u32 i = 1000; i < 1200; ++i)
+		REQUIRE(output[i * 2] == 0.0f);
+
+	// The voice ended during the render, which the game sees after its next update.
+	CHECK(mixer.isPlaying(voice));
+	mixer.update();
+	CHECK_FALSE(mixer.isPlaying(voice));
+	CHECK(mixer.playingCount() == 0);
+}
+
+TEST_CASE("Mixer resamples with linear interpolation", "[audio][mixer]")
+{
+	const std::vector<f32> samples = ramp(400);
+
+	SECTION("A lower rate plays every sample twice as long")
+	{
+		const Sound sound = { samples.data(), 400, 1, 24000 };
+		Mixer mixer;
+		mixer.play(sound, centred());
+
+		std::vector<f32> output(1000 * 2);
+		mixer.render(output.data(), 1000);
+		for (u32 i = 0; i < 797; ++i)
+			REQUIRE(output[i * 2] == Approx(static_cast<f32>(i) * 0.5f / 400.0f).margin(1e-5f));
+		CHECK(output[900 * 2] == 0.0f);
+	}
+
+	SECTION("Pitch scales the rate")
+	{
+		const Sound sound = { samples.data(), 400, 1, 48000 };
+		Mixer mixer;
+		VoiceParams params = centred();
+		params.pitch = 1.5f;
+		mixer.play(sound, params);
+
+		std::vector<f32> output(300 * 2);
+		mixer.render(output.data(), 300);
+		for (u32 i = 0; i < 260; ++i)
+			REQUIRE(output[i * 2] == Approx(static_cast<f32>(i) * 1.5f / 400.0f).margin(1e-5f));
+	}
+}
+
+TEST_CASE("Mixer plays zero and negative pitches forward at the lowest pitch", "[audio][mixer]")
+{
+	const std::vector<f32> samples = ramp(400);
+	const Sound sound = { samples.data(), 400, 1, 48000 };
+	const f32 pitch = GENERATE(0.0f, -0.0f, -1.0f, -1000.0f, std::nanf(""));
+
+	Mixer mixer;
+	VoiceParams params = centred();
+	params.pitch = pitch;
+	const VoiceHandle slow = mixer.play(sound, params);
+	const VoiceHandle changed = mixer.play(sound, centred());
+
+	std::vector<f32> output(256 * 2);
+	mixer.render(output.data(), 100);
+	mixer.setPitch(changed, pitch);
+	mixer.render(output.data(), 256);
+	mixer.update();
+	CHECK(mixer.isPlaying(slow));
+	CHECK(mixer.isPlaying(changed));
+
+	// Both voices add up: the slow one from frame 100 at the minimum pitch, the other from frame 100 of the sound.
+	for (u32 i = 0; i < 256; ++i)
+	{
+		const f32 expected = (100.0f + static_cast<f32>(i)) * Mixer::k_minPitch / 400.0f + (100.0f + static_cast<f32>(i) * Mixer::k_minPitch) / 400.0f;
+		REQUIRE(output[i * 2] == Approx(expected).margin(1e-5f));
+	}
+}
+
+TEST_CASE("Mixer pans and attenuates voices by their position", "[audio][mixer]")
+{
+	const std::vector<f32> samples = sine(4800, 0.01f);
+	const Sound sound = { samples.data(), 4800, 1, 48000 };
+
+	MixerConfig config;
+	config.referenceDistance = 10.0f;
+	config.maxDistance = 1000.0f;
+
+	const auto render = [&](math::Vec2f position, math::Vec2f listener, std::vector<f32> &output)
+	{
+		Mixer mixer(config);
+		mixer.setListener(listener);
+		VoiceParams params;
+		params.position = position;
+		mixer.play(sound, params);
+		output.assign(4800 * 2, 0.0f);
+		mixer.render(output.data(), 4800);
+	};
+
+	std::vector<f32> centre, right, left, far, outside;
+	render({ 0.0f, 5.0f }, { 0.0f, 0.0f }, centre);
+	render({ 100.0f, 0.0f }, { 0.0f, 0.0f }, right);
+	render({ 0.0f, 0.0f }, { 100.0f, 0.0f }, left);
+	render({ 0.0f, 500.0f }, { 0.0f, 0.0f }, far);
+	render({ 0.0f, 2000.0f }, { 0.0f, 0.0f }, outside);
+
+	CHECK(energy(centre, 0) == Approx(energy(centre, 1)));
+	CHECK(energy(right, 0) < energy(right, 1) * 1e-6f);
+	CHECK(energy(left, 1) < energy(left, 0) * 1e-6f);
+	// Moving the listener is the same as moving the voice the other way.
+	CHECK(energy(left, 0) == Approx(energy(right, 1)));
+
+	// Constant power: a voice at the side is as loud, overall, as one in the middle at the same distance.
+	std::vector<f32> side;
+	render({ 10.0f, 0.0f }, { 0.0f, 0.0f }, side);
+	CHECK(energy(side, 0) + energy(side, 1) == Approx(energy(centre, 0) + energy(centre, 1)).epsilon(0.02));
+
+	CHECK(energy(far, 0) < energy(centre, 0) * 0.01f);
+	CHECK(energy(far, 0) > 0.0f);
+	CHECK(energy(outside, 0) == 0.0f);
+	CHECK(energy(outside, 1) == 0.0f);
+}
+
+TEST_CASE("Mixer keeps the channels of stereo sounds apart", "[audio][mixer]")
+{
+	std::vector<f32> samples(200 * 2);
+	for (u32 i = 0; i < 200; ++i)
+	{
+		samples[i * 2] = 0.25f;
+		samples[i * 2 + 1] = -0.5f;
+	}
+	const Sound sound = { samples.data(), 200, 2, 44100 };
+
+	Mixer mixer;
+	mixer.play(sound, centred());
+	std::vector<f32> output(100 * 2);
+	mixer.render(output.data(), 100);
+	for (u32 i = 0; i < 100; ++i)
+	{
+		REQUIRE(output[i * 2] == Approx(0.25f));
+		REQUIRE(output[i * 2 + 1] == Approx(-0.5f));
+	}
+}
+
+TEST_CASE("Mixer loops voices until they are stopped", "[audio][mixer]")
+{
+	const std::vector<f32> samples = sine(100, 0.01f);
+	const Sound sound = { samples.data(), 100, 1, 48000 };
+
+	Mixer mixer;
+	VoiceParams params = centred();
+	params.loops = true;
+	const VoiceHandle voice = mixer.play(sound, params);
+
+	std::vector<f32> output(1000 * 2);
+	for (u32 i = 0; i < 10; ++i)
+	{
+		mixer.render(output.data(), 1000);
+		mixer.update();
+	}
+	CHECK(mixer.isPlaying(voice));
+	// A whole number of periods in the sound, so the loop plays the sine on without a seam.
+	for (u32 i = 0; i < 1000; ++i)
+		REQUIRE(output[i * 2] == Approx(samples[(9000 + i) % 100]).margin(1e-5f));
+
+	CHECK(mixer.stop(voice));
+	CHECK_FALSE(mixer.isPlaying(voice));
+	CHECK(mixer.playingCount() == 0);
+
+	// The slot plays something new at once, and the old handle does not reach it.
+	const VoiceHandle next = mixer.play(sound, centred(0.0f));
+	CHECK(next.index == voice.index);
+	CHECK(next != voice);
+	mixer.setGain(voice, 1.0f);
+	mixer.render(output.data(), 1000);
+	CHECK(energy(output, 0) == 0.0f);
+	CHECK(mixer.mixedVoiceCount() == 1);
+}
+
+TEST_CASE("Mixer drops commands instead of blocking when the queue is full", "[audio][mixer]")
+{
+	const std::vector<f32> samples = ramp(100);
+	const Sound sound = { samples.data(), 100, 1, 48000 };
+
+	MixerConfig config;
+	config.commandCapacity = 4;
+	config.maxVoices = 8;
+	Mixer mixer(config);
+
+	u32 played = 0;
+	for (u32 i = 0; i < 8; ++i)
+		played += mixer.play(sound).isValid() ? 1 : 0;
+	CHECK(played == 4);
+	CHECK(mixer.droppedCommandCount() == 4);
+	CHECK(mixer.playingCount() == 4);
+
+	std::vector<f32> output(64 * 2);
+	mixer.render(output.data(), 64);
+	CHECK(mixer.mixedVoiceCount() == 4);
+
+	// Every voice busy.
+	for (u32 i = 0; i < 4; ++i)
+		CHECK(mixer.play(sound).isValid());
+	CHECK_FALSE(mixer.play(sound).isValid());
+}
+
+TEST_CASE("Mixer keeps a voice whose stop found the queue full", "[audio][mixer]")
+{
+	const std::vector<f32> samples = sine(100, 0.01f);
+	const Sound sound = { samples.data(), 100, 1, 48000 };
+
+	MixerConfig config;
+	config.commandCapacity = 4;
+	Mixer mixer(config);
+	VoiceParams params = centred();
+	params.loops = true;
+	const VoiceHandle voice = mixer.play(sound, params);
+
+	std::vector<f32> output(100 * 2);
+	mixer.render(output.data(), 100);
+	for (u32 i = 0; i < 8; ++i)
+		mixer.setGain(voice, 1.0f);
+
+	CHECK_FALSE(mixer.stop(voice));
+	CHECK(mixer.isPlaying(voice));
+	CHECK(mixer.playingCount() == 1);
+	mixer.render(output.data(), 100);
+	CHECK(mixer.mixedVoiceCount() == 1);
+
+	// The render made room, so the stop goes through and the voice falls silent.
+	CHECK(mixer.stop(voice));
+	CHECK_FALSE(mixer.isPlaying(voice));
+	CHECK(mixer.playingCount() == 0);
+	mixer.render(output.data(), 100);
+	CHECK(mixer.mixedVoiceCount() == 0);
+	CHECK(energy(output, 0) == 0.0f);
+	CHECK(mixer.stop(voice));
+}
+
+TEST_CASE("Mixer takes commands from the game thread while the audio thread renders", "[audio][mixer]")
+{
+	const std::vector<f32> samples = sine(480, 0.01f);
+	const Sound sound = { samples.data(), 480, 1, 48000 };
+
+	Mixer mixer;
+	std::atomic<bool> isDone{ false };
+	std::atomic<u32> renderCount{ 0 };
+	std::atomic<u32> gameFrame{ 0 };
+	f32 loudest = 0.0f;
+	std::thread audio([&]()
+	{
+		std::vector<f32> output(256 * 2);
+		while (!isDone.load())
+		{
+			if (renderCount.load() > gameFrame.load() / 4 + 1)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			mixer.render(output.data(), 256);
+			for (f32 sample : output)
+				loudest = std::max(loudest, std::abs(sample));
+			++renderCount;
+		}
+	});
+
+	std::vector<VoiceHandle> voices;
+	for (u32 frame = 0; frame < 2000; ++frame)
+	{
+		// Keeps the two threads going together, on machines with a single core too: neither runs far ahead.
+		gameFrame.store(frame);
+		while (renderCount.load() < frame / 4)
+			std::this_thread::yield();
+
+		mixer.update();
+		VoiceParams params;
+		params.gain = 0.01f;
+		params.position = math::Vec2f(static_cast<f32>(frame % 64), 0.0f);
+		const VoiceHandle voice = mixer.play(sound, params);
+		if (voice.isValid())
+			voices.push_back(voice);
+		for (VoiceHandle playing : voices)
+			mixer.setPosition(playing, math::Vec2f(static_cast<f32>(frame % 32), 4.0f));
+		while (voices.size() > 32 && mixer.stop(voices.front()))
+			voices.erase(voices.begin());
+	}
+	isDone = true;
+	audio.join();
+
+	// Stops the full queue turned away left their voices playing. Once a render empties it, they go through.
+	std::vector<f32> output(256 * 2);
+	mixer.render(output.data(), 256);
+	while (voices.size() > 32 && mixer.stop(voices.front()))
+		voices.erase(voices.begin());
+
+	CHECK(loudest > 0.0f);
+	CHECK(loudest <= 1.0f);
+	CHECK(voices.size() <= 33);
+	CHECK(mixer.playingCount() <= 33);
+}
+
+TEST_CASE("Mixer benchmark", "[audio][mixer][!benchmark]")
+{
+	const std::vector<f32> samples = sine(48000, 0.005f);
+	const Sound sound = { samples.data(), 48000, 1, 44100 };
+	const Sound native = { samples.data(), 48000, 1, 48000 };
+
+	Mixer mixer;
+	for (u32 i = 0; i < 256; ++i)
+	{
+		VoiceParams params;
+		params.gain = 0.01f;
+		params.loops = true;
+		params.position = math::Vec2f(static_cast<f32>(i % 16) * 8.0f - 64.0f, static_cast<f32>(i / 16) * 8.0f);
+		mixer.play(i % 2 == 0 ? sound : native, params);
+	}
+
+	std::vector<f32> output(Mixer::k_blockFrames * 2);
+	mixer.render(output.data(), Mixer::k_blockFrames);
+	WARN(mixer.mixedVoiceCount() << " voices, half resampled from 44.1 kHz, " << Mixer::k_blockFrames << " frames a block");
+
+	BENCHMARK("256 positional voices, one block")
+	{
+		mixer.render(output.data(), Mixer::k_blockFrames);
+		return output[0];
+	};
+}
@@ -0,0 +1,58 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Core/Audio/WavWriter.hpp"
+
+using namespace core;
+using namespace core::audio;
+
+TEST_CASE("WavWriter writes 16 bit PCM with the sizes filled in", "[audio][wav]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_wavwriter_test.wav").string();
+
+	const f32 samples[] = { 0.0f, 1.0f, -1.0f, 0.5f, 2.0f, -3.0f };
+	WavWriter writer;
+	REQUIRE(writer.open(path.c_str(), 2, 44100));
+	writer.write(samples, 2);
+	writer.write(samples + 4, 1);
+	CHECK(writer.frameCount() == 3);
+	REQUIRE(writer.close());
+
+	std::ifstream in(path, std::ios::binary);
+	std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	REQUIRE(bytes.size() == 44 + 3 * 2 * sizeof(i16));
+	CHECK(std::memcmp(bytes.data(), "RIFF", 4) == 0);
+	CHECK(std::memcmp(bytes.data() + 8, "WAVEfmt ", 8) == 0);
+	CHECK(std::memcmp(bytes.data() + 36, "data", 4) == 0);
+
+	u32 riffSize, sampleRate, dataSize;
+	u16 channelCount, bitsPerSample;
+	std::memcpy(&riffSize, bytes.data() + 4, 4);
+	std::memcpy(&channelCount, bytes.data() + 22, 2);
+	std::memcpy(&sampleRate, bytes.data() + 24, 4);
+	std::memcpy(&bitsPerSample, bytes.data() + 34, 2);
+	std::memcpy(&dataSize, bytes.data() + 40, 4);
+	CHECK(riffSize == 36 + 12);
+	CHECK(channelCount == 2);
+	CHECK(sampleRate == 44100);
+	CHECK(bitsPerSample == 16);
+	CHECK(dataSize == 12);
+
+	i16 pcm[6];
+	std::memcpy(pcm, bytes.data() + 44, sizeof(pcm));
+	CHECK(pcm[0] == 0);
+	CHECK(pcm[1] == 32767);
+	CHECK(pcm[2] == -32767);
+	CHECK(pcm[3] == 16384);
+	// Clamped.
+	CHECK(pcm[4] == 32767);
+	CHECK(pcm[5] == -32767);
+
+	in.close();
+	std::filesystem::remove(path);
+}
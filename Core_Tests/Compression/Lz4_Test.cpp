@@ -0,0 +1,94 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <vector>
+
+#include "Core/Compression/Lz4.hpp"
+
+using namespace core;
+
+namespace
+{
+	std::vector<u8> roundTrip(const std::vector<u8> &input)
+	{
+		std::vector<u8> compressed(lz4::compressBound(input.size()));
+		const usize compressedSize = lz4::compress(input.data(), input.size(), compressed.data(), compressed.size());
+		REQUIRE(compressedSize > 0);
+		compressed.resize(compressedSize);
+
+		std::vector<u8> output(input.size());
+		REQUIRE(lz4::decompress(compressed.data(), compressed.size(), output.data(), output.size()));
+		return output;
+	}
+}
+
+TEST_CASE("LZ4 round trips", "[compression][lz4]")
+{
+	SECTION("Empty and tiny inputs")
+	{
+		for (usize size : { usize(0), usize(1), usize(5), usize(12), usize(13) })
+		{
+			std::vector<u8> input(size);
+			for (usize i = 0; i < size; ++i)
+				input[i] = static_cast<u8>('a' + i);
+			CHECK(roundTrip(input) == input);
+		}
+	}
+
+	SECTION("Repetitive input shrinks")
+	{
+		std::vector<u8> input(100000);
+		for (usize i = 0; i < input.size(); ++i)
+			input[i] = static_cast<u8>(i % 7);
+
+		std::vector<u8> compressed(lz4::compressBound(input.size()));
+		const usize compressedSize = lz4::compress(input.data(), input.size(), compressed.data(), compressed.size());
+		CHECK(compressedSize > 0);
+		CHECK(compressedSize < input.size() / 50);
+		CHECK(roundTrip(input) == input);
+	}
+
+	SECTION("Random input survives")
+	{
+		std::vector<u8> input(70000);
+		u32 state = 99;
+		for (u8 &byte : input)
+		{
+			state = state * 1664525u + 1013904223u;
+			byte = static_cast<u8>(state >> 24);
+		}
+		CHECK(roundTrip(input) == input);
+
+		// Incompressible data does not fit in fewer bytes than it started with.
+		std::vector<u8> compressed(input.size());
+		CHECK(lz4::compress(input.data(), input.size(), compressed.data(), compressed.size() - 1) == 0);
+	}
+}
+
+TEST_CASE("LZ4 rejects malformed input", "[compression][lz4]")
+{
+	std::vector<u8> input(4096);
+	for (usize i = 0; i < input.size(); ++i)
+		input[i] = static_cast<u8>((i / 16) % 5);
+
+	std::vector<u8> compressed(lz4::compressBound(input.size()));
+	compressed.resize(lz4::compress(input.data(), input.size(), compressed.data(), compressed.size()));
+	REQUIRE_FALSE(compressed.empty());
+
+	std::vector<u8> output(input.size());
+	CHECK_FALSE(lz4::decompress(compressed.data(), compressed.size() - 1, output.data(), output.size()));
+	CHECK_FALSE(lz4::decompress(compressed.data(), compressed.size(), output.data(), output.size() - 1));
+
+	// A match reaching back before the start of the output.
+	const u8 badOffset[] = { 0x14, 'a', 0xff, 0x00, 0x00 };
+	CHECK_FALSE(lz4::decompress(badOffset, sizeof(badOffset), output.data(), 5 + 4));
+
+	u32 state = 3;
+	for (int i = 0; i < 1000; ++i)
+	{
+		std::vector<u8> corrupt = compressed;
+		state = state * 1664525u + 1013904223u;
+		corrupt[state % corrupt.size()] ^= static_cast<u8>(1 + (state >> 24) % 255);
+		lz4::decompress(corrupt.data(), corrupt.size(), output.data(), output.size());
+	}
+}
@@ -0,0 +1,87 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Core/Containers/MpmcQueue.hpp"
+
+using namespace core;
+
+TEST_CASE("MpmcQueue is first in first out and bounded", "[containers][mpmcqueue]")
+{
+	MpmcQueue<u32> queue(4);
+	CHECK(queue.capacity() == 4);
+
+	for (u32 i = 0; i < 4; ++i)
+		CHECK(queue.tryPush(i));
+	CHECK_FALSE(queue.tryPush(4));
+
+	u32 value = 0;
+	for (u32 i = 0; i < 4; ++i)
+	{
+		REQUIRE(queue.tryPop(value));
+		CHECK(value == i);
+	}
+	CHECK_FALSE(queue.tryPop(value));
+
+	// Wraps around the ring.
+	for (u32 i = 0; i < 10; ++i)
+	{
+		CHECK(queue.tryPush(i));
+		REQUIRE(queue.tryPop(value));
+		CHECK(value == i);
+	}
+}
+
+TEST_CASE("MpmcQueue delivers every element exactly once across threads", "[containers][mpmcqueue]")
+{
+	constexpr u32 k_producers = 4;
+	constexpr u32 k_consumers = 4;
+	constexpr u32 k_perProducer = 50000;
+
+	MpmcQueue<u32> queue(1024);
+	std::vector<std::atomic<u8>> seen(k_producers * k_perProducer);
+	std::atomic<u32> consumed{ 0 };
+
+	std::vector<std::thread> threads;
+	for (u32 p = 0; p < k_producers; ++p)
+	{
+		threads.emplace_back([&, p]()
+		{
+			for (u32 i = 0; i < k_perProducer; ++i)
+			{
+				while (!queue.tryPush(p * k_perProducer + i))
+					std::this_thread::yield();
+			}
+		});
+	}
+
+	for (u32 c = 0; c < k_consumers; ++c)
+	{
+		threads.emplace_back([&]()
+		{
+			u32 value = 0;
+			while (consumed.load() < k_producers * k_perProducer)
+			{
+				if (queue.tryPop(value))
+				{
+					seen[value].fetch_add(1);
+					consumed.fetch_add(1);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	for (std::thread &thread : threads)
+		thread.join();
+
+	u32 duplicatesOrMissing = 0;
+	for (const std::atomic<u8> &count : seen)
+		duplicatesOrMissing += count.load() != 1 ? 1 : 0;
+	CHECK(duplicatesOrMissing == 0);
+}
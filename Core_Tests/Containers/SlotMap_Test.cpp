@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include <memory>
+#include <vector>
+
+#include "Core/Containers/SlotMap.hpp"
+
+using namespace core;
+
+TEST_CASE("SlotMap resolves live handles and rejects stale ones", "[containers][slotmap]")
+{
+	SlotMap<u32> map;
+	const SlotHandle first = map.insert(10);
+	const SlotHandle second = map.insert(20);
+	const SlotHandle third = map.insert(30);
+	CHECK(map.size() == 3);
+	CHECK(*map.get(second) == 20);
+
+	CHECK(map.erase(first));
+	CHECK_FALSE(map.erase(first));
+	CHECK_FALSE(map.contains(first));
+	CHECK(map.get(first) == nullptr);
+
+	// The last element filled the hole, and handles to it still resolve.
+	CHECK(map.size() == 2);
+	CHECK(*map.get(third) == 30);
+	CHECK(*map.get(second) == 20);
+
+	// The slot is reused under a new generation.
+	const SlotHandle reused = map.insert(40);
+	CHECK(reused.index == first.index);
+	CHECK(reused.generation != first.generation);
+	CHECK(map.get(first) == nullptr);
+	CHECK(*map.get(reused) == 40);
+
+	CHECK_FALSE(map.contains(SlotHandle()));
+	CHECK_FALSE(map.contains(SlotHandle{ 100, 1 }));
+}
+
+TEST_CASE("SlotMap iterates packed elements", "[containers][slotmap]")
+{
+	SlotMap<u32> map;
+	std::vector<SlotHandle> handles;
+	for (u32 i = 0; i < 1000; ++i)
+		handles.push_back(map.insert(i));
+
+	for (u32 i = 0; i < 1000; i += 2)
+		map.erase(handles[i]);
+
+	u64 sum = 0;
+	for (u32 value : map)
+		sum += value;
+	CHECK(map.size() == 500);
+	CHECK(sum == 500 * 500);
+
+	for (usize position = 0; position < map.size(); ++position)
+		CHECK(*map.get(map.handleAt(position)) == map[position]);
+
+	for (u32 i = 1; i < 1000; i += 2)
+		CHECK(*map.get(handles[i]) == i);
+
+	map.clear();
+	CHECK(map.empty());
+	CHECK_FALSE(map.contains(handles[1]));
+}
+
+TEST_CASE("SlotMap owns its elements", "[containers][slotmap]")
+{
+	const i64 before = memory::stats(memory::Tag::Containers).liveBytes;
+	const std::shared_ptr<int> shared = std::make_shared<int>(5);
+	{
+		SlotMap<std::shared_ptr<int>> map;
+		for (int i = 0; i < 100; ++i)
+			map.emplace(shared);
+		CHECK(shared.use_count() == 101);
+
+		map.erase(map.handleAt(0));
+		CHECK(shared.use_count() == 100);
+	}
+	CHECK(shared.use_count() == 1);
+	CHECK(memory::stats(memory::Tag::Containers).liveBytes == before);
+}
@@ -0,0 +1,97 @@
+#include "catch.hpp"
+
+#include <limits>
+#include <memory>
+
+#include "Core/Containers/VirtualArray.hpp"
+
+using namespace core;
+
+TEST_CASE("VirtualArray keeps element addresses stable while growing", "[containers][virtualarray]")
+{
+	VirtualArray<u64> values(1 << 20);
+	const u64 *first = &values.emplaceBack(42);
+
+	for (u64 i = 1; i < 100000; ++i)
+		values.pushBack(i);
+
+	CHECK(&values[0] == first);
+	CHECK(values.data() == first);
+	CHECK(values.size() == 100000);
+	CHECK(values[0] == 42);
+	CHECK(values[99999] == 99999);
+	CHECK(values.capacity() >= values.size());
+	CHECK(values.committedBytes() < values.maxSize() * sizeof(u64));
+
+	u64 sum = 0;
+	for (u64 value : values)
+		sum += value;
+	CHECK(sum == 42 + 99999ull * 100000ull / 2);
+}
+
+TEST_CASE("VirtualArray commits and decommits through its memory tag", "[containers][virtualarray]")
+{
+	const i64 before = memory::stats(memory::Tag::Assets).liveBytes;
+	{
+		VirtualArray<u8> bytes(64 * 1024 * 1024, memory::Tag::Assets);
+		CHECK(bytes.committedBytes() == 0);
+
+		bytes.resize(300000);
+		CHECK(bytes[299999] == 0);
+		CHECK(memory::stats(memory::Tag::Assets).liveBytes == before + static_cast<i64>(bytes.committedBytes()));
+
+		bytes.resize(10);
+		bytes.shrinkToFit();
+		CHECK(bytes.committedBytes() == memory::pageSize());
+		CHECK(memory::stats(memory::Tag::Assets).liveBytes == before + static_cast<i64>(memory::pageSize()));
+
+		bytes.resize(200000);
+		CHECK(bytes[150000] == 0);
+	}
+	CHECK(memory::stats(memory::Tag::Assets).liveBytes == before);
+}
+
+TEST_CASE("VirtualArray manages element lifetimes", "[containers][virtualarray]")
+{
+	auto shared = std::make_shared<i32>(7);
+	{
+		VirtualArray<std::shared_ptr<i32>> owners(1000);
+		for (i32 i = 0; i < 10; ++i)
+			owners.pushBack(shared);
+		CHECK(shared.use_count() == 11);
+
+		owners.popBack();
+		CHECK(shared.use_count() == 10);
+
+		VirtualArray<std::shared_ptr<i32>> moved = std::move(owners);
+		CHECK(moved.size() == 9);
+		CHECK(owners.size() == 0);
+		CHECK(shared.use_count() == 10);
+	}
+	CHECK(shared.use_count() == 1);
+}
+
+TEST_CASE("VirtualArray refuses to grow past its maximum size", "[containers][virtualarray]")
+{
+	VirtualArray<u32> values(16);
+	values.resize(16);
+	CHECK_THROWS_AS(values.pushBack(1), std::bad_alloc);
+	CHECK(values.size() == 16);
+}
+
+TEST_CASE("VirtualArray checks its maximum size up front", "[containers][virtualarray]")
+{
+	// Times eight, this wraps around to a few bytes.
+	CHECK_THROWS_AS(VirtualArray<u64>(std::numeric_limits<usize>::max() / sizeof(u64) + 2), std::bad_alloc);
+	CHECK_THROWS_AS(VirtualArray<u8>(std::numeric_limits<usize>::max()), std::bad_alloc);
+
+	VirtualArray<u32> empty(0);
+	CHECK(empty.empty());
+	CHECK(empty.begin() == empty.end());
+	CHECK(empty.committedBytes() == 0);
+	empty.reserve(0);
+	CHECK_THROWS_AS(empty.pushBack(1), std::bad_alloc);
+
+	VirtualArray<u32> moved(std::move(empty));
+	CHECK(moved.maxSize() == 0);
+}
@@ -0,0 +1,162 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core/IO/File.hpp"
+#include "Core/IO/FileService.hpp"
+
+using namespace core;
+using namespace core::io;
+
+namespace
+{
+	std::string writeTestFile(const char *name, usize size)
+	{
+		const std::string path = (std::filesystem::temp_directory_path() / name).string();
+		std::ofstream out(path, std::ios::binary);
+		for (usize i = 0; i < size; ++i)
+			out.put(static_cast<char>(i * 7));
+		return path;
+	}
+
+	struct Completion
+	{
+		std::atomic<i64> bytesRead{ 0 };
+		std::atomic<u32> calls{ 0 };
+	};
+
+	void onRead(const ReadRequest &request, i64 bytesRead)
+	{
+		Completion *completion = static_cast<Completion *>(request.userData);
+		completion->bytesRead.fetch_add(bytesRead);
+		completion->calls.fetch_add(1);
+	}
+}
+
+TEST_CASE("File reads by offset and stops at the end", "[io][file]")
+{
+	const std::string path = writeTestFile("ang_file_test.bin", 1000);
+
+	File file;
+	CHECK_FALSE(file.open((path + ".missing").c_str()));
+	REQUIRE(file.open(path.c_str()));
+	CHECK(file.size() == 1000);
+
+	u8 buffer[64];
+	CHECK(file.read(10, buffer, 16) == 16);
+	CHECK(buffer[0] == u8(10 * 7));
+	CHECK(buffer[15] == u8(25 * 7));
+	CHECK(file.read(990, buffer, 64) == 10);
+	CHECK(file.read(2000, buffer, 64) == 0);
+
+	File moved(std::move(file));
+	CHECK_FALSE(file.isOpen());
+	CHECK(moved.isOpen());
+
+	moved.close();
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("FileService delivers batched reads through the completion queue", "[io][fileservice]")
+{
+	constexpr usize k_blockSize = 4096;
+	constexpr u32 k_blockCount = 64;
+	const std::string path = writeTestFile("ang_fileservice_test.bin", k_blockSize * k_blockCount);
+
+	File file;
+	REQUIRE(file.open(path.c_str()));
+
+	const FileBackend backend = GENERATE(FileBackend::ThreadPool, FileBackend::Automatic);
+	FileServiceConfig config;
+	config.backend = backend;
+	config.threadCount = 3;
+	config.ringEntries = 16;
+	config.queueCapacity = 32;
+	config.completionCapacity = 64;
+
+	std::vector<u8> buffer(k_blockSize * k_blockCount);
+	Completion completion;
+	{
+		FileService service(config);
+		if (backend == FileBackend::ThreadPool)
+			CHECK(service.backend() == FileBackend::ThreadPool);
+
+		std::vector<ReadRequest> requests(k_blockCount);
+		for (u32 block = 0; block < k_blockCount; ++block)
+		{
+			requests[block].file = &file;
+			requests[block].offset = block * k_blockSize;
+			requests[block].buffer = buffer.data() + block * k_blockSize;
+			requests[block].size = k_blockSize;
+			requests[block].onComplete = &onRead;
+			requests[block].userData = &completion;
+		}
+
+		// Twice the queue capacity, so submitting has to wait on the service.
+		service.submit(requests.data(), 32);
+		service.submit(requests.data() + 32, 32);
+
+		while (service.hasPendingWork())
+			service.drainCompletions(4);
+		CHECK(service.drainCompletions() == 0);
+	}
+
+	CHECK(completion.calls.load() == k_blockCount);
+	CHECK(completion.bytesRead.load() == i64(k_blockSize * k_blockCount));
+
+	u32 mismatches = 0;
+	for (usize i = 0; i < buffer.size(); ++i)
+		mismatches += buffer[i] != u8(i * 7) ? 1 : 0;
+	CHECK(mismatches == 0);
+
+	file.close();
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("FileService reads into registered buffers and completes on the I/O thread", "[io][fileservice]")
+{
+	constexpr usize k_size = 100000;
+	const std::string path = writeTestFile("ang_fileservice_registered_test.bin", k_size);
+
+	File file;
+	REQUIRE(file.open(path.c_str()));
+
+	const FileBackend backend = GENERATE(FileBackend::ThreadPool, FileBackend::Automatic);
+	FileServiceConfig config;
+	config.backend = backend;
+
+	std::vector<u8> staging(k_size + 100);
+	Completion completion;
+	{
+		FileService service(config);
+		const RegisteredBuffer registered = { staging.data(), staging.size() };
+		REQUIRE(service.registerBuffers(&registered, 1));
+
+		ReadRequest request;
+		request.file = &file;
+		request.offset = 0;
+		request.buffer = staging.data();
+		request.size = staging.size();
+		request.onComplete = &onRead;
+		request.userData = &completion;
+		request.registeredBuffer = 0;
+		request.context = CompletionContext::IoThread;
+		service.submit(request);
+
+		while (completion.calls.load() == 0)
+			std::this_thread::yield();
+		CHECK(service.drainCompletions() == 0);
+	}
+
+	// Reading past the end stops at the end of the file.
+	CHECK(completion.bytesRead.load() == i64(k_size));
+	CHECK(staging[k_size - 1] == u8((k_size - 1) * 7));
+
+	file.close();
+	std::filesystem::remove(path);
+}
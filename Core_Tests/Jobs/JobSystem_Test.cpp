@@ -0,0 +1,125 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <vector>
+
+#include "Core/Jobs/JobSystem.hpp"
+
+using namespace core;
+using namespace core::jobs;
+
+namespace
+{
+	struct SumJob
+	{
+		std::atomic<u64> *sum;
+		u64 value;
+	};
+
+	void addToSum(void *data)
+	{
+		const SumJob *job = static_cast<const SumJob *>(data);
+		job->sum->fetch_add(job->value, std::memory_order_relaxed);
+	}
+
+	struct ParentJob
+	{
+		JobSystem *system;
+		std::atomic<u64> *sum;
+		std::atomic<u32> *childrenSeenDone;
+		u64 base;
+	};
+
+	constexpr u32 k_childCount = 64;
+
+	// Spawns children and waits on them, which parks this fiber instead of blocking the worker.
+	void spawnAndWait(void *data)
+	{
+		const ParentJob *parent = static_cast<const ParentJob *>(data);
+
+		SumJob childData[k_childCount];
+		Job children[k_childCount];
+		for (u32 i = 0; i < k_childCount; ++i)
+		{
+			childData[i] = { parent->sum, parent->base + i };
+			children[i] = { &addToSum, &childData[i] };
+		}
+
+		Counter counter;
+		parent->system->run(children, k_childCount, &counter);
+		parent->system->wait(counter);
+
+		if (counter.isDone())
+			parent->childrenSeenDone->fetch_add(1);
+	}
+}
+
+TEST_CASE("JobSystem runs every job and counts them down", "[jobs]")
+{
+	JobSystem system(JobSystemConfig{ 3, 32 });
+	CHECK(system.workerCount() == 3);
+	CHECK(JobSystem::currentWorkerIndex() == JobSystem::k_notAWorker);
+
+	constexpr u32 k_jobCount = 10000;
+	std::atomic<u64> sum{ 0 };
+	std::vector<SumJob> data(k_jobCount);
+	std::vector<Job> jobs(k_jobCount);
+	for (u32 i = 0; i < k_jobCount; ++i)
+	{
+		data[i] = { &sum, i + 1 };
+		jobs[i] = { &addToSum, &data[i] };
+	}
+
+	Counter counter;
+	system.run(jobs.data(), jobs.size(), &counter);
+	system.wait(counter);
+
+	CHECK(counter.value() == 0);
+	CHECK(sum.load() == u64(k_jobCount) * (k_jobCount + 1) / 2);
+}
+
+TEST_CASE("JobSystem jobs can wait on jobs they spawn", "[jobs]")
+{
+	const u32 workerCount = GENERATE(1u, 4u);
+	JobSystem system(JobSystemConfig{ workerCount, 64 });
+
+	constexpr u32 k_parentCount = 24;
+	std::atomic<u64> sum{ 0 };
+	std::atomic<u32> childrenSeenDone{ 0 };
+
+	ParentJob parentData[k_parentCount];
+	Job parents[k_parentCount];
+	for (u32 i = 0; i < k_parentCount; ++i)
+	{
+		parentData[i] = { &system, &sum, &childrenSeenDone, u64(i) * k_childCount };
+		parents[i] = { &spawnAndWait, &parentData[i] };
+	}
+
+	Counter counter;
+	system.run(parents, k_parentCount, &counter);
+	system.wait(counter);
+
+	const u64 total = u64(k_parentCount) * k_childCount;
+	CHECK(sum.load() == total * (total - 1) / 2);
+	CHECK(childrenSeenDone.load() == k_parentCount);
+}
+
+TEST_CASE("JobSystem submitting past the queue capacity still runs everything", "[jobs]")
+{
+	JobSystemConfig config;
+	config.workerCount = 2;
+	config.fiberCount = 16;
+	config.queueCapacity = 16;
+	JobSystem system(config);
+
+	std::atomic<u64> sum{ 0 };
+	std::vector<SumJob> data(1000, SumJob{ &sum, 1 });
+	std::vector<Job> jobs;
+	for (SumJob &job : data)
+		jobs.push_back({ &addToSum, &job });
+
+	Counter counter;
+	system.run(jobs.data(), jobs.size(), &counter);
+	system.wait(counter);
+	CHECK(sum.load() == 1000);
+}
@@ -0,0 +1,99 @@
+#include "catch.hpp"
+
+#include "Core/Platform.hpp"
+
+#if CORE_HAS_COROUTINES
+
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "Core/IO/AsyncRead.hpp"
+#include "Core/Jobs/Task.hpp"
+
+using namespace core;
+using namespace core::jobs;
+
+namespace
+{
+	Task<i32> square(i32 value)
+	{
+		co_return value * value;
+	}
+
+	Task<i32> sumOfSquares(i32 count)
+	{
+		i32 sum = 0;
+		for (i32 i = 1; i <= count; ++i)
+			sum += co_await square(i);
+		co_return sum;
+	}
+
+	Task<u32> workerIndexAfterSchedule(JobSystem &system)
+	{
+		co_await schedule(system);
+		co_return JobSystem::currentWorkerIndex();
+	}
+
+	Task<> fail()
+	{
+		throw std::runtime_error("failed");
+		co_return;
+	}
+
+	Task<i64> readSum(io::FileService &service, JobSystem &system, const io::File &file, u32 *resumedOn)
+	{
+		u8 buffer[256];
+		const i64 bytesRead = co_await io::readAsync(service, system, file, 0, buffer, sizeof(buffer));
+		*resumedOn = JobSystem::currentWorkerIndex();
+
+		i64 sum = 0;
+		for (i64 i = 0; i < bytesRead; ++i)
+			sum += buffer[i];
+		co_return sum;
+	}
+}
+
+TEST_CASE("Task returns values through nested awaits", "[jobs][task]")
+{
+	JobSystem system(JobSystemConfig{ 2, 16 });
+	CHECK(syncWait(system, sumOfSquares(10)) == 385);
+}
+
+TEST_CASE("Task continues on a worker after schedule", "[jobs][task]")
+{
+	JobSystem system(JobSystemConfig{ 2, 16 });
+	const u32 index = syncWait(system, workerIndexAfterSchedule(system));
+	CHECK(index < system.workerCount());
+}
+
+TEST_CASE("Task rethrows the exception it exited with", "[jobs][task]")
+{
+	JobSystem system(JobSystemConfig{ 2, 16 });
+	CHECK_THROWS_AS(syncWait(system, fail()), std::runtime_error);
+}
+
+TEST_CASE("Task awaits file reads without blocking a worker", "[jobs][task][io]")
+{
+	const std::string path = (std::filesystem::temp_directory_path() / "ang_task_test.bin").string();
+	{
+		std::ofstream out(path, std::ios::binary);
+		for (u32 i = 0; i < 100; ++i)
+			out.put(static_cast<char>(i));
+	}
+
+	io::File file;
+	REQUIRE(file.open(path.c_str()));
+
+	JobSystem system(JobSystemConfig{ 2, 16 });
+	io::FileService service;
+	u32 resumedOn = JobSystem::k_notAWorker;
+	CHECK(syncWait(system, readSum(service, system, file, &resumedOn)) == 99 * 100 / 2);
+	CHECK(resumedOn < system.workerCount());
+
+	file.close();
+	std::filesystem::remove(path);
+}
+
+#endif
@@ -0,0 +1,224 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Core/Math/FastMath.hpp"
+
+using namespace core::math;
+
+namespace
+{
+	constexpr f64 k_unitUlp = 1.0 / (1 << 23);
+
+	// Error in units of the float spacing at the reference value.
+	f64 relativeUlps(f32 value, f64 reference)
+	{
+		const f64 ulp = std::ldexp(1.0, std::ilogb(reference) - 23);
+		return std::fabs(static_cast<f64>(value) - reference) / ulp;
+	}
+
+	// Error in units of the float spacing at 1.0, for functions whose error budget is absolute.
+	f64 absoluteUlps(f32 value, f64 reference)
+	{
+		return std::fabs(static_cast<f64>(value) - reference) / k_unitUlp;
+	}
+
+	// Maximum ULP error each tier promises. Exact is bounded by the standard library.
+	template<Accuracy A>
+	f64 maxUlps()
+	{
+		if constexpr (A == Accuracy::Exact)
+			return 4.0;
+		else if constexpr (A == Accuracy::High)
+			return 1e-5 / k_unitUlp;
+		else
+			return 1e-3 / k_unitUlp;
+	}
+
+	std::vector<f32> range(f32 first, f32 last, i32 count)
+	{
+		std::vector<f32> values;
+		for (i32 i = 0; i < count; ++i)
+			values.push_back(first + (last - first) * static_cast<f32>(i) / static_cast<f32>(count - 1));
+		return values;
+	}
+}
+
+TEMPLATE_TEST_CASE_SIG("Fast math stays within the ULP budget of its tier", "[math][fastmath]",
+	((Accuracy A), A), Accuracy::Exact, Accuracy::High, Accuracy::Low)
+{
+	const f64 budget = maxUlps<A>();
+
+	SECTION("rsqrt")
+	{
+		f64 worst = 0.0;
+		for (f32 exponent : range(-20.0f, 20.0f, 20001))
+		{
+			const f32 x = std::exp2(exponent);
+			worst = std::max(worst, relativeUlps(fast::rsqrt<A>(x), 1.0 / std::sqrt(static_cast<f64>(x))));
+		}
+		CHECK(worst <= budget);
+	}
+
+	SECTION("sin and cos")
+	{
+		f64 worst = 0.0;
+		for (f32 x : range(-100.0f, 100.0f, 200001))
+		{
+			worst = std::max(worst, absoluteUlps(fast::sin<A>(x), std::sin(static_cast<f64>(x))));
+			worst = std::max(worst, absoluteUlps(fast::cos<A>(x), std::cos(static_cast<f64>(x))));
+		}
+		CHECK(worst <= budget);
+	}
+
+	SECTION("sin and cos at the edge of their range")
+	{
+		f64 worst = 0.0;
+		for (f32 edge : { -fast::detail::k_maxAngle, fast::detail::k_maxAngle })
+		{
+			f32 x = edge;
+			for (i32 i = 0; i < 20000; ++i, x = std::nextafter(x, 0.0f))
+			{
+				worst = std::max(worst, absoluteUlps(fast::sin<A>(x), std::sin(static_cast<f64>(x))));
+				worst = std::max(worst, absoluteUlps(fast::cos<A>(x), std::cos(static_cast<f64>(x))));
+			}
+		}
+		CHECK(worst <= budget);
+
+		// Past it the result is no longer the sine, but it stays a number on the unit circle, in every lane.
+		if constexpr (A != Accuracy::Exact)
+		{
+			const f32 far[] = { 1e10f, -3e9f, 1e38f, INFINITY, -INFINITY, NAN };
+			for (f32 x : far)
+			{
+				const f32 scalar = fast::sin<A>(x);
+				CHECK(std::fabs(scalar) <= 1.0f);
+				CHECK(std::fabs(fast::cos<A>(x)) <= 1.0f);
+
+				alignas(16) f32 lanes[4];
+				fast::sin<A>(F32x4(x)).store(lanes);
+				CHECK(lanes[0] == scalar);
+			}
+		}
+	}
+
+	SECTION("atan2")
+	{
+		f64 worst = 0.0;
+		for (f32 radius : { 1e-3f, 1.0f, 1e4f })
+		{
+			for (f32 angle : range(-3.14159f, 3.14159f, 20001))
+			{
+				const f32 y = radius * std::sin(angle);
+				const f32 x = radius * std::cos(angle);
+				worst = std::max(worst, absoluteUlps(fast::atan2<A>(y, x), std::atan2(static_cast<f64>(y), static_cast<f64>(x))));
+			}
+		}
+		CHECK(worst <= budget);
+		CHECK(fast::atan2<A>(0.0f, 0.0f) == 0.0f);
+	}
+
+	SECTION("exp")
+	{
+		f64 worst = 0.0;
+		for (f32 x : range(-80.0f, 80.0f, 200001))
+			worst = std::max(worst, relativeUlps(fast::exp<A>(x), std::exp(static_cast<f64>(x))));
+		CHECK(worst <= budget);
+	}
+}
+
+TEST_CASE("Fast math array versions match the scalar versions", "[math][fastmath]")
+{
+	// Odd count, so both the SIMD body and the scalar tail run.
+	const std::vector<f32> input = range(0.1f, 50.0f, 1023);
+	std::vector<f32> output(input.size());
+
+	fast::sin<Accuracy::High>(input.data(), output.data(), input.size());
+	for (usize i = 0; i < input.size(); ++i)
+		CHECK(output[i] == fast::sin<Accuracy::High>(input[i]));
+
+	fast::exp<Accuracy::Low>(input.data(), output.data(), input.size());
+	for (usize i = 0; i < input.size(); ++i)
+		CHECK(output[i] == fast::exp<Accuracy::Low>(input[i]));
+
+	fast::rsqrt<Accuracy::High>(input.data(), output.data(), input.size());
+	for (usize i = 0; i < input.size(); ++i)
+		CHECK(output[i] == Approx(fast::rsqrt<Accuracy::High>(input[i])).epsilon(1e-6));
+
+	const std::vector<f32> negative(input.size(), -1.0f);
+	fast::atan2<Accuracy::Low>(input.data(), negative.data(), output.data(), input.size());
+	for (usize i = 0; i < input.size(); ++i)
+		CHECK(output[i] == fast::atan2<Accuracy::Low>(input[i], -1.0f));
+}
+
+TEST_CASE("Fast math Vec2 helpers", "[math][fastmath]")
+{
+	const Vec2f normal = fast::normalized(Vec2f(3.0f, 4.0f));
+	CHECK(normal.x == Approx(0.6f).margin(1e-5));
+	CHECK(normal.y == Approx(0.8f).margin(1e-5));
+	CHECK(fast::normalized(Vec2f::zero()) == Vec2f::zero());
+
+	const Vec2f turned = fast::rotated(Vec2f(1.0f, 0.0f), fast::detail::k_halfPi);
+	CHECK(turned.x == Approx(0.0f).margin(1e-5));
+	CHECK(turned.y == Approx(1.0f).margin(1e-5));
+	CHECK(fast::angle<Accuracy::Low>(Vec2f(-1.0f, 0.0f)) == Approx(fast::detail::k_pi).margin(1e-3));
+}
+
+TEST_CASE("Fast math is usable in constant expressions", "[math][fastmath][constexpr]")
+{
+	STATIC_REQUIRE(fast::exp<Accuracy::High>(0.0f) > 0.99999f);
+	STATIC_REQUIRE(fast::atan2<Accuracy::Low>(1.0f, 1.0f) > 0.784f);
+	STATIC_REQUIRE(fast::sin(fast::detail::k_halfPi) > 0.99999f);
+	STATIC_REQUIRE(fast::sin(1e20f) <= 1.0f);
+
+	constexpr f32 compileTime = fast::cos<Accuracy::High>(1.0f);
+	volatile f32 input = 1.0f;
+	CHECK(compileTime == fast::cos<Accuracy::High>(static_cast<f32>(input)));
+}
+
+TEST_CASE("Fast math benchmark against the standard library", "[math][fastmath][!benchmark]")
+{
+	const std::vector<f32> input = range(0.1f, 50.0f, 4096);
+	std::vector<f32> output(input.size());
+
+	BENCHMARK("std::sin")
+	{
+		for (usize i = 0; i < input.size(); ++i)
+			output[i] = std::sin(input[i]);
+		return output[0];
+	};
+
+	BENCHMARK("fast::sin High")
+	{
+		fast::sin<Accuracy::High>(input.data(), output.data(), input.size());
+		return output[0];
+	};
+
+	BENCHMARK("1 / std::sqrt")
+	{
+		for (usize i = 0; i < input.size(); ++i)
+			output[i] = 1.0f / std::sqrt(input[i]);
+		return output[0];
+	};
+
+	BENCHMARK("fast::rsqrt High")
+	{
+		fast::rsqrt<Accuracy::High>(input.data(), output.data(), input.size());
+		return output[0];
+	};
+
+	BENCHMARK("std::atan2")
+	{
+		for (usize i = 0; i < input.size(); ++i)
+			output[i] = std::atan2(input[i], 1.0f);
+		return output[0];
+	};
+
+	BENCHMARK("fast::atan2 High")
+	{
+		fast::atan2<Accuracy::High>(input.data(), input.data(), output.data(), input.size());
+		return output[0];
+	};
+}
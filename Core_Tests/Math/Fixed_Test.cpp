@@ -0,0 +1,72 @@
+#include "catch.hpp"
+
+#include "Core/Math/Fixed.hpp"
+
+using namespace core::math;
+
+TEMPLATE_TEST_CASE("Fixed arithmetic", "[math][fixed]", Q16_16, Q32_32)
+{
+	const TestType half = TestType::fromFloat(0.5);
+	const TestType three(3);
+
+	CHECK(half.raw() == TestType::k_oneRaw / 2);
+	CHECK(three + half == TestType::fromFloat(3.5));
+	CHECK(three - half == TestType::fromFloat(2.5));
+	CHECK(three * half == TestType::fromFloat(1.5));
+	CHECK(three / half == TestType(6));
+	CHECK(-three * half == TestType::fromFloat(-1.5));
+	CHECK(TestType(1) / three * three < TestType(1));
+	CHECK(abs(-three) == three);
+	CHECK(half < three);
+	CHECK((three / TestType(-2)).toDouble() == -1.5);
+}
+
+TEMPLATE_TEST_CASE("Fixed sqrt", "[math][fixed]", Q16_16, Q32_32)
+{
+	CHECK(sqrt(TestType(0)) == TestType(0));
+	CHECK(sqrt(TestType(1)) == TestType(1));
+	CHECK(sqrt(TestType(16)) == TestType(4));
+	CHECK(sqrt(TestType::fromFloat(0.25)) == TestType::fromFloat(0.5));
+
+	for (f64 value : { 2.0, 3.0, 0.001, 1234.5678, 30000.0 })
+	{
+		const TestType input = TestType::fromFloat(value);
+		const TestType root = sqrt(input);
+		const f64 expected = std::sqrt(input.toDouble());
+		CHECK(root.toDouble() <= expected);
+		CHECK(TestType::fromRaw(root.raw() + 1).toDouble() > expected);
+	}
+}
+
+TEST_CASE("Fixed results are bit exact", "[math][fixed]")
+{
+	// Reference raw values, any platform or compiler must reproduce these exactly.
+	CHECK((Q16_16(7) / Q16_16(3)).raw() == 152917);
+	CHECK((Q16_16::fromRaw(-98765) * Q16_16::fromRaw(43210)).raw() == -65119);
+	CHECK(sqrt(Q16_16(2)).raw() == 92681);
+	CHECK((Q32_32(7) / Q32_32(3)).raw() == 10021590357);
+	CHECK((Q32_32::fromRaw(-9876543210) * Q32_32::fromRaw(1234567890)).raw() == -2838965299);
+	CHECK(sqrt(Q32_32(2)).raw() == 6074000999);
+}
+
+TEST_CASE("Fixed is usable in constant expressions", "[math][fixed][constexpr]")
+{
+	constexpr Q32_32 root = sqrt(Q32_32(2));
+	STATIC_REQUIRE(root.raw() == 6074000999);
+	STATIC_REQUIRE((Q16_16(7) / Q16_16(3)).raw() == 152917);
+	STATIC_REQUIRE((Q32_32::fromRaw(-9876543210) * Q32_32::fromRaw(1234567890)).raw() == -2838965299);
+}
+
+TEST_CASE("Portable 128 bit fixed point helpers match the native path", "[math][fixed]")
+{
+	const i64 values[] = { 1, -1, 3, 7, 0x7fffffffll, -0x80000000ll, 1234567890123ll, -987654321098ll, 0x123456789abcll };
+	for (i64 a : values)
+	{
+		for (i64 b : values)
+		{
+			CHECK(detail::mulShiftPortable(a, b, 32) == detail::mulShift(a, b, 32));
+			if ((a < 0 ? -a : a) < (i64(1) << 30))
+				CHECK(detail::shiftDivPortable(a, b, 32) == detail::shiftDiv(a, b, 32));
+		}
+	}
+}
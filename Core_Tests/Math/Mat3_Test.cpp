@@ -0,0 +1,50 @@
+#include "catch.hpp"
+
+#include "Core/Math/FastMath.hpp"
+#include "Core/Math/Mat3.hpp"
+#include "Core/Math/Table.hpp"
+
+using namespace core::math;
+
+namespace
+{
+	constexpr Mat3f k_model = Mat3f::transform(Vec2f(10.0f, -4.0f), 0.0f, 1.0f, Vec2f(2.0f, 3.0f));
+
+	// Whole table is computed by the compiler, nothing runs at startup.
+	constexpr auto k_circle = makeTable<16>([](usize i)
+	{
+		const f32 angle = static_cast<f32>(i) * (2.0f * fast::detail::k_pi / 16.0f);
+		return Vec2f(fast::cos(angle), fast::sin(angle));
+	});
+}
+
+static_assert(Mat3f::identity() * k_model == k_model, "Identity must not change the matrix.");
+static_assert(k_model.transformPoint(Vec2f(1.0f, 0.0f)) == Vec2f(10.0f, -2.0f), "Scale, rotate and translate in that order.");
+static_assert(k_model.transformVector(Vec2f(0.0f, 1.0f)) == Vec2f(-3.0f, 0.0f), "Vectors ignore translation.");
+static_assert(k_model.determinant() == 6.0f, "Determinant is the product of the scale factors.");
+static_assert((k_model * k_model.inverse()) == Mat3f::identity(), "Exact for power of two friendly values.");
+static_assert(Mat3Q16::translation(Vec2Q16(Q16_16(1), Q16_16(2))).transformPoint(Vec2Q16::zero()) == Vec2Q16(Q16_16(1), Q16_16(2)),
+	"Fixed point matrices are constexpr too.");
+static_assert(k_circle[4].y > 0.99999f && k_circle[4].x < 1e-5f && k_circle[4].x > -1e-5f, "Tables can use fast math.");
+
+TEMPLATE_TEST_CASE("Mat3 composes affine transforms", "[math][mat3]", f32, Q16_16, Q32_32)
+{
+	using Vec = Vec2<TestType>;
+	using Mat = Mat3<TestType>;
+
+	const Mat translate = Mat::translation(Vec(TestType(5), TestType(-1)));
+	const Mat scale = Mat::scale(Vec(TestType(2), TestType(4)));
+	const Mat rotate = Mat::rotation(TestType(0), TestType(1));
+
+	const Mat combined = translate * rotate * scale;
+	CHECK(combined == Mat::transform(Vec(TestType(5), TestType(-1)), TestType(0), TestType(1), Vec(TestType(2), TestType(4))));
+	CHECK(combined.transformPoint(Vec(TestType(1), TestType(1))) == Vec(TestType(1), TestType(1)));
+	CHECK(combined.inverse().transformPoint(Vec(TestType(1), TestType(1))) == Vec(TestType(1), TestType(1)));
+	CHECK(combined.inverse() * combined == Mat::identity());
+	CHECK(rotate.transposed() * rotate == Mat::identity());
+
+	Mat accumulated = Mat::identity();
+	accumulated *= translate;
+	CHECK(accumulated(0, 2) == TestType(5));
+	CHECK(accumulated(1, 2) == TestType(-1));
+}
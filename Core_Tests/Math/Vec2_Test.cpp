@@ -0,0 +1,112 @@
+#include "catch.hpp"
+
+#include "Core/Math/Vec2.hpp"
+
+using namespace core::math;
+
+namespace
+{
+	f64 toDouble(f32 value) { return value; }
+	template<typename Storage, u32 FractionBits>
+	f64 toDouble(Fixed<Storage, FractionBits> value) { return value.toDouble(); }
+}
+
+TEMPLATE_TEST_CASE("Vec2 arithmetic", "[math][vec2]", f32, Q16_16, Q32_32)
+{
+	using Vec = Vec2<TestType>;
+	const Vec a(TestType(3), TestType(4));
+	const Vec b(TestType(1), TestType(-2));
+
+	CHECK(a + b == Vec(TestType(4), TestType(2)));
+	CHECK(a - b == Vec(TestType(2), TestType(6)));
+	CHECK(-b == Vec(TestType(-1), TestType(2)));
+	CHECK(a * TestType(2) == Vec(TestType(6), TestType(8)));
+	CHECK(TestType(2) * a == a * TestType(2));
+	CHECK(a / TestType(2) * TestType(2) == a);
+	CHECK(dot(a, b) == TestType(-5));
+	CHECK(cross(a, b) == TestType(-10));
+	CHECK(perpendicular(a) == Vec(TestType(-4), TestType(3)));
+
+	Vec c = a;
+	c += b;
+	c -= a;
+	CHECK(c == b);
+}
+
+TEMPLATE_TEST_CASE("Vec2 length and normalization", "[math][vec2]", f32, Q16_16, Q32_32)
+{
+	using Vec = Vec2<TestType>;
+	const Vec a(TestType(3), TestType(4));
+
+	CHECK(a.lengthSquared() == TestType(25));
+	CHECK(a.length() == TestType(5));
+	CHECK(distance(Vec::zero(), a) == TestType(5));
+	CHECK(Vec::zero().normalized() == Vec::zero());
+
+	const Vec n = a.normalized();
+	CHECK(toDouble(n.x) == Approx(0.6).margin(1e-4));
+	CHECK(toDouble(n.y) == Approx(0.8).margin(1e-4));
+	CHECK(toDouble(n.length()) == Approx(1.0).margin(1e-4));
+}
+
+TEST_CASE("Vec2 is usable in constant expressions", "[math][vec2][constexpr]")
+{
+	constexpr Vec2f a(3.0f, 4.0f);
+	constexpr f32 root = sqrt(2.0f);
+	constexpr Vec2Q16 fixedNormal = Vec2Q16(Q16_16(3), Q16_16(4)).normalized();
+
+	STATIC_REQUIRE(a.length() == 5.0f);
+	STATIC_REQUIRE(a.normalized() == Vec2f(0.6f, 0.8f));
+	STATIC_REQUIRE(dot(a, perpendicular(a)) == 0.0f);
+	STATIC_REQUIRE(fixedNormal == Vec2Q16(Q16_16(3), Q16_16(4)) / Q16_16(5));
+
+	// Compile time and run time evaluation agree.
+	volatile f32 runtimeInput = 2.0f;
+	CHECK(root == sqrt(static_cast<f32>(runtimeInput)));
+}
+
+TEST_CASE("Vec2 benchmark float against fixed point", "[math][vec2][!benchmark]")
+{
+	// Components stay below 128 so every squared length fits the Q16.16 range.
+	constexpr i32 k_count = 4096;
+
+	BENCHMARK("Vec2f normalize")
+	{
+		Vec2f sum = Vec2f::zero();
+		for (i32 i = 1; i <= k_count; ++i)
+			sum += Vec2f(static_cast<f32>(i & 127), static_cast<f32>((k_count - i) & 127)).normalized();
+		return sum;
+	};
+
+	BENCHMARK("Vec2Q16 normalize")
+	{
+		Vec2Q16 sum = Vec2Q16::zero();
+		for (i32 i = 1; i <= k_count; ++i)
+			sum += Vec2Q16(Q16_16(i & 127), Q16_16((k_count - i) & 127)).normalized();
+		return sum;
+	};
+
+	BENCHMARK("Vec2Q32 normalize")
+	{
+		Vec2Q32 sum = Vec2Q32::zero();
+		for (i32 i = 1; i <= k_count; ++i)
+			sum += Vec2Q32(Q32_32(i & 127), Q32_32((k_count - i) & 127)).normalized();
+		return sum;
+	};
+
+	BENCHMARK("Vec2f dot")
+	{
+		f32 sum = 0.0f;
+		for (i32 i = 1; i <= k_count; ++i)
+			sum += dot(Vec2f(static_cast<f32>(i & 127), 1.0f), Vec2f(0.5f, static_cast<f32>(i & 127)));
+		return sum;
+	};
+
+	BENCHMARK("Vec2Q16 dot")
+	{
+		Q16_16 sum(0);
+		for (i32 i = 1; i <= k_count; ++i)
+			sum += dot(Vec2Q16(Q16_16(i & 127), Q16_16(1)), Vec2Q16(Q16_16::fromRaw(1 << 15), Q16_16(i & 127)));
+		return sum;
+	};
+}
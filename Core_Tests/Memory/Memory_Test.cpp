@@ -0,0 +1,62 @@
+#include "catch.hpp"
+
+#include <sstream>
+#include <vector>
+
+#include "Core/Memory/Memory.hpp"
+
+using namespace core::memory;
+
+TEST_CASE("Memory tracks live and high water bytes per tag", "[memory]")
+{
+	const TagStats before = stats(Tag::General);
+
+	void *first = allocate(1000, Tag::General);
+	void *second = allocate(24, Tag::General, 64);
+	CHECK(reinterpret_cast<uintptr_t>(second) % 64 == 0);
+	CHECK(stats(Tag::General).liveBytes == before.liveBytes + 1024);
+
+	deallocate(first, 1000, Tag::General);
+	deallocate(second, 24, Tag::General, 64);
+
+	const TagStats after = stats(Tag::General);
+	CHECK(after.liveBytes == before.liveBytes);
+	CHECK(after.highWaterBytes >= before.liveBytes + 1024);
+}
+
+TEST_CASE("Memory attributes containers to their tag", "[memory]")
+{
+	const i64 before = stats(Tag::Assets).liveBytes;
+	{
+		std::vector<u32, TaggedAllocator<u32, Tag::Assets>> values(256);
+		CHECK(stats(Tag::Assets).liveBytes == before + static_cast<i64>(256 * sizeof(u32)));
+	}
+	CHECK(stats(Tag::Assets).liveBytes == before);
+
+	struct Object { u64 a; u64 b; };
+	Object *object = create<Object>(Tag::IO, Object{ 1, 2 });
+	CHECK(object->b == 2);
+	CHECK(stats(Tag::IO).liveBytes >= static_cast<i64>(sizeof(Object)));
+	destroy(object, Tag::IO);
+}
+
+TEST_CASE("Memory budgets and reports", "[memory]")
+{
+	setBudget(Tag::Jobs, 4096);
+	CHECK(stats(Tag::Jobs).budgetBytes == 4096);
+
+	std::ostringstream usage;
+	report(usage);
+	CHECK(usage.str().find("Jobs") != std::string::npos);
+	setBudget(Tag::Jobs, 0);
+
+	void *leak = allocate(48, Tag::IO);
+	std::ostringstream leaks;
+	CHECK_FALSE(reportLeaks(leaks));
+	CHECK(leaks.str().find("IO leaked 48 bytes") != std::string::npos);
+
+	deallocate(leak, 48, Tag::IO);
+	std::ostringstream clean;
+	CHECK(reportLeaks(clean));
+	CHECK(clean.str().empty());
+}
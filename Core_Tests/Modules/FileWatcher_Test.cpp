@@ -0,0 +1,63 @@
+#include "catch.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Core/Modules/FileWatcher.hpp"
+
+using namespace core;
+using namespace core::modules;
+
+namespace
+{
+	void writeFile(const std::filesystem::path &path, const char *text)
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out << text;
+	}
+}
+
+TEST_CASE("FileWatcher reports writes to the watched file only", "[modules][filewatcher]")
+{
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "ang_filewatcher_test";
+	std::filesystem::create_directories(directory);
+	const std::filesystem::path watched = directory / "module.bin";
+	const std::filesystem::path other = directory / "other.bin";
+	writeFile(watched, "first");
+
+	FileWatcher watcher;
+	REQUIRE(watcher.watch(watched.string().c_str()));
+	CHECK(watcher.isWatching());
+	CHECK_FALSE(watcher.poll());
+
+	writeFile(other, "unrelated");
+	CHECK_FALSE(watcher.poll());
+
+	// Write times can be coarse, so the rewrite is dated explicitly for watchers that compare them.
+	writeFile(watched, "second");
+	std::filesystem::last_write_time(watched, std::filesystem::last_write_time(watched) + std::chrono::seconds(1));
+	CHECK(watcher.poll());
+	CHECK_FALSE(watcher.poll());
+
+	// Replacing the file by renaming a new one over it, the way linkers and build tools often do.
+	const std::filesystem::path staged = directory / "module.tmp";
+	writeFile(staged, "third");
+	std::filesystem::last_write_time(staged, std::filesystem::last_write_time(watched) + std::chrono::seconds(1));
+	std::filesystem::rename(staged, watched);
+	CHECK(watcher.poll());
+
+	watcher.stop();
+	CHECK_FALSE(watcher.isWatching());
+	CHECK_FALSE(watcher.poll());
+	std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("FileWatcher refuses paths in missing directories", "[modules][filewatcher]")
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "ang_missing_directory" / "module.bin";
+
+	FileWatcher watcher;
+	CHECK_FALSE(watcher.watch(path.string().c_str()));
+	CHECK_FALSE(watcher.isWatching());
+}
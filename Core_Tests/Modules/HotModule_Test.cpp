@@ -0,0 +1,147 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Core/Modules/DynamicLibrary.hpp"
+#include "Core/Memory/Memory.hpp"
+#include "Core/Modules/HotModule.hpp"
+
+#include "Core_Tests/Modules/TestModule/TestModuleState.hpp"
+
+using namespace core;
+using namespace core::modules;
+
+TEST_CASE("HotModule refuses files that are not modules", "[modules][hotmodule]")
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "ang_hotmodule_test.bin";
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out << "not a shared library";
+	}
+
+	DynamicLibrary library;
+	CHECK_FALSE(library.open(path.string().c_str()));
+	CHECK_FALSE(library.isOpen());
+
+	const AngHostApi host = {};
+	HotModule module(host);
+	CHECK_FALSE(module.load(path.string().c_str()));
+	CHECK_FALSE(module.load((path.string() + ".missing").c_str()));
+	CHECK_FALSE(module.isLoaded());
+	CHECK_FALSE(module.reload());
+	CHECK(module.state() == nullptr);
+
+	// Copies of a build that failed to load are not left behind.
+	const std::string prefix = path.stem().string() + "_";
+	for (const auto &entry : std::filesystem::directory_iterator(std::filesystem::temp_directory_path()))
+		CHECK(entry.path().filename().string().rfind(prefix, 0) != 0);
+
+	std::filesystem::remove(path);
+}
+
+#ifdef ANG_TEST_MODULE_DIR
+namespace
+{
+#if CORE_PLATFORM_WINDOWS
+	constexpr const char *k_moduleExtension = ".dll";
+#else
+	constexpr const char *k_moduleExtension = ".so";
+#endif
+
+	std::filesystem::path testModulePath(const char *name)
+	{
+		return std::filesystem::path(ANG_TEST_MODULE_DIR) / (std::string(name) + k_moduleExtension);
+	}
+
+	// The write time is moved past the previous one, so a copy that keeps its source's time, or lands within the
+	// file system's time resolution, still reads as a change.
+	void replaceModule(const std::filesystem::path &path, const std::filesystem::path &build)
+	{
+		const std::filesystem::file_time_type previous = std::filesystem::last_write_time(path);
+		std::filesystem::copy_file(build, path, std::filesystem::copy_options::overwrite_existing);
+		std::filesystem::last_write_time(path, previous + std::chrono::seconds(2));
+	}
+
+	void breakModule(const std::filesystem::path &path)
+	{
+		const std::filesystem::file_time_type previous = std::filesystem::last_write_time(path);
+		{
+			std::ofstream out(path, std::ios::binary | std::ios::trunc);
+			out << "not a shared library";
+		}
+		std::filesystem::last_write_time(path, previous + std::chrono::seconds(2));
+	}
+
+	const TestModuleState &stateOf(const HotModule &module)
+	{
+		return *static_cast<const TestModuleState *>(module.state());
+	}
+}
+
+TEST_CASE("HotModule swaps in a new build and keeps the state", "[modules][hotmodule]")
+{
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / (std::string("ang_hotmodule_live") + k_moduleExtension);
+	std::filesystem::copy_file(testModulePath("TestModuleV1"), path, std::filesystem::copy_options::overwrite_existing);
+
+	const AngHostApi host = {};
+	HotModule module(host);
+	// The state is Core memory, so it outlives the module's code.
+	const i64 liveBytes = memory::stats(memory::Tag::General).liveBytes;
+	REQUIRE(module.load(path.string().c_str()));
+	CHECK(module.stateSize() == sizeof(TestModuleState));
+	CHECK(memory::stats(memory::Tag::General).liveBytes == liveBytes + static_cast<i64>(sizeof(TestModuleState)));
+	CHECK(stateOf(module).version == 1);
+	CHECK(stateOf(module).loadCount == 1);
+	CHECK(stateOf(module).wasLoadReload == 0);
+
+	for (u32 i = 0; i < 3; ++i)
+		module.update();
+	CHECK(stateOf(module).counter == 3);
+	CHECK_FALSE(module.reloadIfChanged());
+
+	SECTION("A new build takes over the state, grown to the size it asks for")
+	{
+		replaceModule(path, testModulePath("TestModuleV2"));
+		REQUIRE(module.reloadIfChanged());
+		CHECK(module.reloadCount() == 1);
+		CHECK(module.stateSize() == sizeof(TestModuleGrownState));
+		CHECK(memory::stats(memory::Tag::General).liveBytes == liveBytes + static_cast<i64>(sizeof(TestModuleGrownState)));
+
+		// The old build let go of the state before the new one took it.
+		const TestModuleGrownState &state = *static_cast<const TestModuleGrownState *>(module.state());
+		CHECK(state.unloadCount == 1);
+		CHECK(state.unloadedVersion == 1);
+		CHECK(state.wasUnloadReload == 1);
+		CHECK(state.loadCount == 2);
+		CHECK(state.version == 2);
+		CHECK(state.wasLoadReload == 1);
+		CHECK(state.counter == 3);
+		CHECK(state.grownUpdates == 0);
+
+		module.update();
+		CHECK(state.counter == 103);
+		CHECK(state.grownUpdates == 1);
+	}
+
+	SECTION("A build that does not load leaves the first build running")
+	{
+		const void *state = module.state();
+		breakModule(path);
+		CHECK_FALSE(module.reloadIfChanged());
+		CHECK(module.isLoaded());
+		CHECK(module.reloadCount() == 0);
+		CHECK(module.state() == state);
+		CHECK(stateOf(module).unloadCount == 0);
+
+		module.update();
+		CHECK(stateOf(module).counter == 4);
+	}
+
+	module.unload();
+	CHECK(memory::stats(memory::Tag::General).liveBytes == liveBytes);
+	std::filesystem::remove(path);
+}
+#endif
@@ -0,0 +1,58 @@
+#include "Core/Modules/ModuleApi.hpp"
+
+#include "Core_Tests/Modules/TestModule/TestModuleState.hpp"
+
+// Built twice, as TestModuleV1 and TestModuleV2, so HotModule tests can swap one build for the other.
+// The second build asks for more state and counts differently, so a test can tell which code ran.
+#ifndef TEST_MODULE_VERSION
+#define TEST_MODULE_VERSION 1
+#endif
+
+namespace
+{
+#if TEST_MODULE_VERSION == 1
+	constexpr usize k_stateSize = sizeof(TestModuleState);
+	constexpr u32 k_step = 1;
+#else
+	constexpr usize k_stateSize = sizeof(TestModuleGrownState);
+	constexpr u32 k_step = 100;
+#endif
+
+	void load(void *data, const AngHostApi *, bool isReload)
+	{
+		TestModuleState &state = *static_cast<TestModuleState *>(data);
+		++state.loadCount;
+		state.version = TEST_MODULE_VERSION;
+		state.wasLoadReload = isReload ? 1 : 0;
+	}
+
+	void unload(void *data, const AngHostApi *, bool isReload)
+	{
+		TestModuleState &state = *static_cast<TestModuleState *>(data);
+		++state.unloadCount;
+		state.unloadedVersion = TEST_MODULE_VERSION;
+		state.wasUnloadReload = isReload ? 1 : 0;
+	}
+
+	void update(void *data, const AngHostApi *)
+	{
+		TestModuleState &state = *static_cast<TestModuleState *>(data);
+		state.counter += k_step;
+#if TEST_MODULE_VERSION != 1
+		++static_cast<TestModuleGrownState *>(data)->grownUpdates;
+#endif
+	}
+
+	const AngModuleApi k_api = {
+		k_angModuleApiVersion,
+		k_stateSize,
+		&load,
+		&unload,
+		&update,
+	};
+}
+
+ANG_MODULE_EXPORT const AngModuleApi *angGetModuleApi()
+{
+	return &k_api;
+}
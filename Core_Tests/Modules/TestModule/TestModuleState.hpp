@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Core/Types.hpp"
+
+// State of the test module, shared with the tests that look into it.
+struct TestModuleState
+{
+	u32 version;
+	u32 counter;
+	u32 loadCount;
+	u32 unloadCount;
+	u32 unloadedVersion;
+	u32 wasLoadReload;
+	u32 wasUnloadReload;
+};
+
+// What the second build asks for: the first build's state with a field added at the end.
+struct TestModuleGrownState : TestModuleState
+{
+	u32 grownUpdates;
+};
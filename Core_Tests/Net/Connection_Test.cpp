@@ -0,0 +1,242 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core/Net/Connection.hpp"
+#include "Core/Net/Socket.hpp"
+
+using namespace core;
+using namespace core::net;
+
+namespace
+{
+	// In memory link to the other side, losing some datagrams and delivering the rest out of order.
+	struct LossyLink
+	{
+		Connection *peer = nullptr;
+		std::mt19937 random{ 7 };
+		u32 lossPercent = 0;
+		bool shuffle = false;
+		std::vector<std::vector<u8>> inFlight;
+		u32 dropped = 0;
+
+		static void send(void *context, const u8 *data, usize size)
+		{
+			LossyLink &link = *static_cast<LossyLink *>(context);
+			if (link.random() % 100 < link.lossPercent)
+				++link.dropped;
+			else
+				link.inFlight.emplace_back(data, data + size);
+		}
+
+		void deliver(f64 time)
+		{
+			if (shuffle)
+				std::shuffle(inFlight.begin(), inFlight.end(), random);
+			for (const std::vector<u8> &datagram : inFlight)
+				peer->receiveDatagram(datagram.data(), datagram.size(), time);
+			inFlight.clear();
+		}
+	};
+
+	struct SocketPeer
+	{
+		UdpSocket *socket;
+		Address address;
+
+		static void send(void *context, const u8 *data, usize size)
+		{
+			SocketPeer &peer = *static_cast<SocketPeer *>(context);
+			peer.socket->send(peer.address, data, size);
+		}
+	};
+
+	std::string messageText(const Message &message)
+	{
+		return std::string(message.data.begin(), message.data.end());
+	}
+}
+
+TEST_CASE("Connection delivers reliable messages in order despite loss", "[net][connection]")
+{
+	LossyLink toServer;
+	LossyLink toClient;
+	Connection client(&LossyLink::send, &toServer);
+	Connection server(&LossyLink::send, &toClient);
+	toServer.peer = &server;
+	toClient.peer = &client;
+	toServer.lossPercent = toClient.lossPercent = 30;
+	toServer.shuffle = toClient.shuffle = true;
+
+	constexpr u32 k_messageCount = 500;
+	u32 sent = 0;
+	std::vector<std::string> received;
+	u32 unreliableReceived = 0;
+	Message message;
+	f64 time = 0.0;
+	for (u32 frame = 0; frame < 2000 && received.size() < k_messageCount; ++frame, time += 1.0 / 60.0)
+	{
+		for (u32 i = 0; i < 3 && sent < k_messageCount; ++i)
+		{
+			const std::string text = "message " + std::to_string(sent);
+			if (!client.send(Channel::ReliableOrdered, text.data(), text.size()))
+				break;
+			++sent;
+		}
+		client.send(Channel::Unreliable, "position", 8);
+
+		client.update(time);
+		server.update(time);
+		toServer.deliver(time);
+		toClient.deliver(time);
+
+		while (server.receive(message))
+		{
+			if (message.channel == Channel::ReliableOrdered)
+				received.push_back(messageText(message));
+			else
+				++unreliableReceived;
+		}
+	}
+
+	REQUIRE(received.size() == k_messageCount);
+	for (u32 i = 0; i < k_messageCount; ++i)
+		CHECK(received[i] == "message " + std::to_string(i));
+
+	CHECK(toServer.dropped > 0);
+	CHECK(client.stats().reliableResends > 0);
+	CHECK(unreliableReceived > 0);
+	CHECK(unreliableReceived < client.stats().packetsSent);
+
+	// Once the acknowledgements get through, nothing is left pending.
+	for (u32 frame = 0; frame < 100 && client.reliablePending() > 0; ++frame, time += 1.0 / 60.0)
+	{
+		client.update(time);
+		server.update(time);
+		toServer.deliver(time);
+		toClient.deliver(time);
+	}
+	CHECK(client.reliablePending() == 0);
+	CHECK_FALSE(server.receive(message));
+}
+
+TEST_CASE("Connection fragments packets larger than a datagram", "[net][connection]")
+{
+	LossyLink toServer;
+	LossyLink toClient;
+	Connection client(&LossyLink::send, &toServer);
+	Connection server(&LossyLink::send, &toClient);
+	toServer.peer = &server;
+	toClient.peer = &client;
+
+	std::vector<u8> large(Connection::k_maxMessageSize);
+	for (usize i = 0; i < large.size(); ++i)
+		large[i] = static_cast<u8>(i * 31 + 7);
+	CHECK_FALSE(client.send(Channel::Unreliable, large.data(), large.size() + 1));
+
+	REQUIRE(client.send(Channel::Unreliable, large.data(), large.size()));
+	client.update(0.0);
+	CHECK(client.stats().datagramsSent > 1);
+
+	// Fragments arrive in any order.
+	toServer.shuffle = true;
+	toServer.deliver(0.0);
+	Message message;
+	REQUIRE(server.receive(message));
+	CHECK(message.channel == Channel::Unreliable);
+	REQUIRE(message.data.size() == large.size());
+	CHECK(std::memcmp(message.data.data(), large.data(), large.size()) == 0);
+
+	// Losing one fragment loses the packet.
+	REQUIRE(client.send(Channel::Unreliable, large.data(), large.size()));
+	client.update(0.1);
+	toServer.inFlight.erase(toServer.inFlight.begin() + 3);
+	toServer.deliver(0.1);
+	CHECK_FALSE(server.receive(message));
+
+	// The reliable channel resends until every fragment made it.
+	REQUIRE(client.send(Channel::ReliableOrdered, large.data(), large.size()));
+	toServer.lossPercent = 20;
+	toServer.shuffle = false;
+	f64 time = 0.2;
+	bool isReceived = false;
+	for (u32 frame = 0; frame < 500 && !isReceived; ++frame, time += 1.0 / 60.0)
+	{
+		client.update(time);
+		server.update(time);
+		toServer.deliver(time);
+		toClient.deliver(time);
+		isReceived = server.receive(message);
+	}
+	REQUIRE(isReceived);
+	CHECK(message.channel == Channel::ReliableOrdered);
+	CHECK(std::memcmp(message.data.data(), large.data(), large.size()) == 0);
+}
+
+TEST_CASE("Connection ignores malformed datagrams", "[net][connection]")
+{
+	LossyLink toClient;
+	Connection server(&LossyLink::send, &toClient);
+
+	std::mt19937 random(3);
+	std::vector<u8> garbage(1500);
+	for (u32 i = 0; i < 2000; ++i)
+	{
+		const usize size = random() % garbage.size();
+		for (usize b = 0; b < size; ++b)
+			garbage[b] = static_cast<u8>(random());
+		// Most of them with a valid datagram kind, to get past the first check.
+		if (size > 0 && i % 2 == 0)
+			garbage[0] = static_cast<u8>(0xa1 + i % 4 / 2);
+		server.receiveDatagram(garbage.data(), size, 0.0);
+	}
+
+	Message message;
+	while (server.receive(message))
+		CHECK(message.data.size() <= Connection::k_maxMessageSize);
+}
+
+TEST_CASE("Connection runs over loopback sockets", "[net][connection]")
+{
+	UdpSocket serverSocket;
+	UdpSocket clientSocket;
+	REQUIRE(serverSocket.open());
+	REQUIRE(clientSocket.open());
+
+	SocketPeer toServer{ &clientSocket, Address::loopback(serverSocket.localPort()) };
+	SocketPeer toClient{ &serverSocket, Address::loopback(clientSocket.localPort()) };
+	Connection client(&SocketPeer::send, &toServer);
+	Connection server(&SocketPeer::send, &toClient);
+
+	REQUIRE(client.send(Channel::ReliableOrdered, "hello", 5));
+	std::vector<u8> large(5000, 42);
+	REQUIRE(client.send(Channel::ReliableOrdered, large.data(), large.size()));
+
+	u8 buffer[k_maxDatagramSize];
+	Address from;
+	Message message;
+	std::vector<Message> received;
+	f64 time = 0.0;
+	for (u32 frame = 0; frame < 1000 && received.size() < 2; ++frame, time += 0.001)
+	{
+		client.update(time);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		for (i32 size; (size = serverSocket.receive(from, buffer, sizeof(buffer))) >= 0;)
+		{
+			CHECK(from == toClient.address);
+			server.receiveDatagram(buffer, size, time);
+		}
+		while (server.receive(message))
+			received.push_back(std::move(message));
+	}
+
+	REQUIRE(received.size() == 2);
+	CHECK(messageText(received[0]) == "hello");
+	CHECK(received[1].data.size() == large.size());
+}
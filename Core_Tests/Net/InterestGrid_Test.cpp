@@ -0,0 +1,185 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Core/Net/InterestGrid.hpp"
+
+using namespace core;
+using namespace core::net;
+
+namespace
+{
+	constexpr f32 k_cellSize = 32.0f;
+	constexpr u32 k_cells = 32;
+
+	struct TestEntity
+	{
+		u32 id;
+		math::Vec2f position;
+		InterestHandle handle;
+	};
+
+	i32 cellCoordinate(f32 value)
+	{
+		return std::clamp(static_cast<i32>(std::floor(value / k_cellSize)), 0, static_cast<i32>(k_cells) - 1);
+	}
+
+	// Everything in the cells the view touches, worked out from scratch.
+	std::vector<u32> expectedVisible(const std::vector<TestEntity> &entities, const math::Vec2f &position, f32 radius)
+	{
+		const i32 x0 = cellCoordinate(position.x - radius), x1 = cellCoordinate(position.x + radius);
+		const i32 y0 = cellCoordinate(position.y - radius), y1 = cellCoordinate(position.y + radius);
+		std::vector<u32> visible;
+		for (const TestEntity &entity : entities)
+		{
+			const i32 x = cellCoordinate(entity.position.x), y = cellCoordinate(entity.position.y);
+			if (x >= x0 && x <= x1 && y >= y0 && y <= y1)
+				visible.push_back(entity.id);
+		}
+		std::sort(visible.begin(), visible.end());
+		return visible;
+	}
+}
+
+TEST_CASE("InterestGrid matches a brute force search", "[net][interestgrid]")
+{
+	std::mt19937 random(17);
+	std::uniform_real_distribution<f32> coordinate(-20.0f, k_cellSize * k_cells + 20.0f);
+	std::uniform_real_distribution<f32> step(-6.0f, 6.0f);
+
+	InterestGrid grid({ 0.0f, 0.0f }, k_cellSize, k_cells, k_cells);
+	std::vector<TestEntity> entities;
+	u32 nextId = 0;
+	for (u32 i = 0; i < 500; ++i)
+	{
+		const math::Vec2f position(coordinate(random), coordinate(random));
+		entities.push_back({ nextId, position, grid.addEntity(nextId, position) });
+		++nextId;
+	}
+
+	struct TestClient
+	{
+		math::Vec2f position;
+		f32 radius;
+		InterestHandle handle;
+	};
+	std::vector<TestClient> clients;
+	for (u32 i = 0; i < 40; ++i)
+	{
+		const math::Vec2f position(coordinate(random), coordinate(random));
+		const f32 radius = 20.0f + static_cast<f32>(random() % 80);
+		clients.push_back({ position, radius, grid.addClient(position, radius) });
+	}
+
+	for (u32 tick = 0; tick < 50; ++tick)
+	{
+		for (TestEntity &entity : entities)
+		{
+			entity.position += math::Vec2f(step(random), step(random));
+			grid.moveEntity(entity.handle, entity.position);
+		}
+		for (u32 i = 0; i < 5; ++i)
+		{
+			const usize index = random() % entities.size();
+			grid.removeEntity(entities[index].handle);
+			entities.erase(entities.begin() + index);
+
+			const math::Vec2f position(coordinate(random), coordinate(random));
+			entities.push_back({ nextId, position, grid.addEntity(nextId, position) });
+			++nextId;
+		}
+		for (TestClient &client : clients)
+		{
+			client.position += math::Vec2f(step(random), step(random));
+			grid.moveClient(client.handle, client.position, client.radius);
+		}
+
+		grid.update();
+		for (const TestClient &client : clients)
+		{
+			const std::vector<u32> expected = expectedVisible(entities, client.position, client.radius);
+			const auto &visible = grid.visible(client.handle);
+			REQUIRE(std::vector<u32>(visible.begin(), visible.end()) == expected);
+		}
+	}
+
+	CHECK(grid.entityCount() == entities.size());
+	grid.removeClient(clients[0].handle);
+	grid.update();
+	CHECK(grid.clientCount() == clients.size() - 1);
+}
+
+TEST_CASE("InterestGrid shares and keeps visible sets", "[net][interestgrid]")
+{
+	InterestGrid grid({ 0.0f, 0.0f }, k_cellSize, k_cells, k_cells);
+	const InterestHandle near = grid.addEntity(1, { 40.0f, 40.0f });
+	grid.addEntity(2, { 300.0f, 300.0f });
+
+	// Both views cover the same cells.
+	const InterestHandle first = grid.addClient({ 40.0f, 40.0f }, 5.0f);
+	const InterestHandle second = grid.addClient({ 50.0f, 50.0f }, 5.0f);
+	const InterestHandle far = grid.addClient({ 300.0f, 300.0f }, 5.0f);
+	grid.update();
+	CHECK(grid.viewCount() == 2);
+	CHECK(grid.rebuiltCount() == 2);
+	CHECK(&grid.visible(first) == &grid.visible(second));
+	REQUIRE(grid.visible(first).size() == 1);
+	CHECK(grid.visible(first)[0] == 1);
+
+	// Moving inside a cell rebuilds nothing.
+	grid.moveEntity(near, { 45.0f, 50.0f });
+	grid.moveClient(first, { 42.0f, 41.0f }, 5.0f);
+	grid.update();
+	CHECK(grid.rebuiltCount() == 0);
+
+	// Crossing into the far view's cell rebuilds both sets it left and entered, and only those.
+	grid.moveEntity(near, { 290.0f, 295.0f });
+	grid.update();
+	CHECK(grid.rebuiltCount() == 2);
+	CHECK(grid.visible(first).empty());
+	CHECK(grid.visible(far).size() == 2);
+
+	// A view nobody uses anymore goes away.
+	grid.removeClient(far);
+	grid.update();
+	CHECK(grid.viewCount() == 1);
+}
+
+TEST_CASE("InterestGrid benchmark", "[net][interestgrid][!benchmark]")
+{
+	std::mt19937 random(3);
+	std::uniform_real_distribution<f32> coordinate(0.0f, k_cellSize * k_cells);
+	std::uniform_real_distribution<f32> step(-2.0f, 2.0f);
+
+	InterestGrid grid({ 0.0f, 0.0f }, k_cellSize, k_cells, k_cells);
+	std::vector<TestEntity> entities;
+	for (u32 i = 0; i < 10000; ++i)
+	{
+		const math::Vec2f position(coordinate(random), coordinate(random));
+		entities.push_back({ i, position, grid.addEntity(i, position) });
+	}
+
+	// Players crowd around a few points of interest, so many of them share views.
+	std::vector<InterestHandle> clients;
+	for (u32 i = 0; i < 1000; ++i)
+	{
+		const math::Vec2f center(128.0f + 256.0f * static_cast<f32>(i % 4), 128.0f + 256.0f * static_cast<f32>(i / 4 % 4));
+		clients.push_back(grid.addClient(center + math::Vec2f(step(random), step(random)) * 8.0f, 48.0f));
+	}
+	grid.update();
+
+	BENCHMARK("10000 entities moving, 1000 clients")
+	{
+		for (TestEntity &entity : entities)
+		{
+			entity.position += math::Vec2f(step(random), step(random));
+			grid.moveEntity(entity.handle, entity.position);
+		}
+		grid.update();
+		return grid.rebuiltCount();
+	};
+	WARN(grid.viewCount() << " distinct views for " << clients.size() << " clients");
+}
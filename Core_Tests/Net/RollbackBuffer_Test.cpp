@@ -0,0 +1,175 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Core/Net/RollbackBuffer.hpp"
+
+using namespace core;
+using namespace core::net;
+
+namespace
+{
+	// Writes a few runs of bytes, the way a tick touches some of the entities and leaves the rest.
+	void simulate(std::vector<u8> &state, RollbackBuffer &buffer, std::mt19937 &random, u32 writes)
+	{
+		std::uniform_int_distribution<usize> offset(0, state.size() - 1);
+		std::uniform_int_distribution<u32> length(1, 48);
+		for (u32 i = 0; i < writes; ++i)
+		{
+			const usize start = offset(random);
+			const usize end = std::min(state.size(), start + length(random));
+			for (usize byte = start; byte < end; ++byte)
+				state[byte] = static_cast<u8>(random());
+			buffer.markDirty(start, end - start);
+		}
+	}
+}
+
+TEST_CASE("RollbackBuffer restores every frame it holds", "[net][rollback]")
+{
+	std::mt19937 random(11);
+	// Not a whole number of chunks, so the last one is short.
+	std::vector<u8> state(64 * 1024 + 300, 0);
+	RollbackBuffer buffer(state.size(), 10);
+
+	// Every state saved, to check restores against.
+	std::vector<std::vector<u8>> saved;
+	u64 frame = 100;
+	buffer.save(frame, state.data());
+	saved.push_back(state);
+
+	for (u32 round = 0; round < 200; ++round)
+	{
+		simulate(state, buffer, random, 12);
+		buffer.save(++frame, state.data());
+		saved.push_back(state);
+		CHECK(buffer.copiedChunkCount() <= 12 * 2);
+
+		if (round % 5 == 4)
+		{
+			// Some of the frames since the last save are thrown away too, as a rollback mid tick would.
+			simulate(state, buffer, random, 4);
+
+			const u64 target = frame - random() % (frame - buffer.oldestFrame() + 1);
+			REQUIRE(buffer.contains(target));
+			REQUIRE(buffer.restore(target, state.data()));
+			REQUIRE(state == saved[target - 100]);
+			CHECK(buffer.newestFrame() == target);
+
+			saved.resize(target - 100 + 1);
+			frame = target;
+		}
+	}
+
+	CHECK(buffer.newestFrame() - buffer.oldestFrame() < 10);
+}
+
+TEST_CASE("RollbackBuffer refuses frames it does not hold", "[net][rollback]")
+{
+	std::vector<u8> state(4096, 1);
+	RollbackBuffer buffer(state.size(), 4);
+
+	std::vector<u8> untouched = state;
+	CHECK_FALSE(buffer.restore(0, state.data()));
+	CHECK(buffer.empty());
+
+	for (u64 frame = 1; frame <= 6; ++frame)
+	{
+		state[frame * 100] = static_cast<u8>(frame);
+		buffer.markDirty(frame * 100, 1);
+		buffer.save(frame, state.data());
+	}
+	CHECK(buffer.oldestFrame() == 3);
+	CHECK(buffer.newestFrame() == 6);
+
+	untouched = state;
+	CHECK_FALSE(buffer.restore(2, state.data()));
+	CHECK_FALSE(buffer.restore(7, state.data()));
+	CHECK(state == untouched);
+
+	REQUIRE(buffer.restore(3, state.data()));
+	CHECK(state[300] == 3);
+	CHECK(state[400] == 1);
+	CHECK(state[600] == 1);
+
+	// A restore to the newest frame only undoes what changed since it was saved.
+	state[10] = 42;
+	buffer.markDirty(10, 1);
+	REQUIRE(buffer.restore(3, state.data()));
+	CHECK(state[10] == 1);
+	CHECK(buffer.copiedChunkCount() == 1);
+
+	buffer.clear();
+	CHECK(buffer.empty());
+	buffer.save(50, state.data());
+	CHECK(buffer.contains(50));
+}
+
+TEST_CASE("RollbackBuffer finds the changes in a state marked whole", "[net][rollback]")
+{
+	std::vector<u8> state(10000, 0);
+	RollbackBuffer buffer(state.size(), 8, 256);
+	buffer.save(1, state.data());
+
+	state[5000] = 1;
+	state[9999] = 2;
+	buffer.markDirty(0, state.size());
+	buffer.save(2, state.data());
+	CHECK(buffer.copiedChunkCount() == 2);
+
+	buffer.markDirty(0, state.size());
+	buffer.save(3, state.data());
+	CHECK(buffer.copiedChunkCount() == 0);
+
+	REQUIRE(buffer.restore(1, state.data()));
+	CHECK(buffer.copiedChunkCount() == 2);
+	CHECK(state == std::vector<u8>(10000, 0));
+}
+
+TEST_CASE("RollbackBuffer benchmark", "[net][rollback][!benchmark]")
+{
+	std::mt19937 random(5);
+	std::vector<u8> state(1024 * 1024, 0);
+	RollbackBuffer buffer(state.size(), 16);
+
+	u64 frame = 0;
+	buffer.save(frame, state.data());
+	for (u32 i = 0; i < 16; ++i)
+	{
+		simulate(state, buffer, random, 16);
+		buffer.save(++frame, state.data());
+	}
+
+	// Late input for 8 frames ago: rewind, then simulate and save the 8 frames again.
+	BENCHMARK("1 MiB state, rollback of 8 frames")
+	{
+		buffer.restore(frame - 8, state.data());
+		frame -= 8;
+		for (u32 i = 0; i < 8; ++i)
+		{
+			simulate(state, buffer, random, 16);
+			buffer.save(++frame, state.data());
+		}
+		return buffer.copiedChunkCount();
+	};
+
+	// The same without saving or restoring, and the whole copies a rollback would need without marks.
+	RollbackBuffer unused(state.size(), 1);
+	BENCHMARK("1 MiB state, simulating 8 frames")
+	{
+		for (u32 i = 0; i < 8; ++i)
+			simulate(state, unused, random, 16);
+		return state[0];
+	};
+
+	std::vector<u8> copy(state.size());
+	BENCHMARK("1 MiB state, whole copies of 9 frames")
+	{
+		for (u32 i = 0; i < 9; ++i)
+			std::memcpy(copy.data(), state.data(), state.size());
+		return copy[0];
+	};
+}
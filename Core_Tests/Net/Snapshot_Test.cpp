@@ -0,0 +1,176 @@
+#include "catch.hpp"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "Core/Net/Snapshot.hpp"
+
+using namespace core;
+using namespace core::net;
+
+namespace
+{
+	const SnapshotFormat k_format = { { -512.0f, -512.0f }, { 512.0f, 512.0f }, 1.0f / 64.0f, 32.0f, 1.0f / 32.0f };
+
+	using EntityList = std::vector<EntityState, memory::TaggedAllocator<EntityState, memory::Tag::Net>>;
+	using Bytes = std::vector<u8, memory::TaggedAllocator<u8, memory::Tag::Net>>;
+
+	std::vector<EntityState> makeWorld(u32 count, std::mt19937 &random)
+	{
+		std::uniform_real_distribution<f32> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<f32> velocity(-30.0f, 30.0f);
+		std::vector<EntityState> entities(count);
+		for (u32 i = 0; i < count; ++i)
+			entities[i] = { i * 3 + 1, { position(random), position(random) }, { velocity(random), velocity(random) } };
+		return entities;
+	}
+
+	void checkMatches(const std::vector<EntityState> &expected, const EntityList &decoded)
+	{
+		REQUIRE(decoded.size() == expected.size());
+		for (usize i = 0; i < expected.size(); ++i)
+		{
+			CHECK(decoded[i].id == expected[i].id);
+			CHECK(std::abs(decoded[i].position.x - expected[i].position.x) <= k_format.positionStep * 0.5f);
+			CHECK(std::abs(decoded[i].position.y - expected[i].position.y) <= k_format.positionStep * 0.5f);
+			CHECK(std::abs(decoded[i].velocity.x - expected[i].velocity.x) <= k_format.velocityStep * 0.5f);
+			CHECK(std::abs(decoded[i].velocity.y - expected[i].velocity.y) <= k_format.velocityStep * 0.5f);
+		}
+	}
+}
+
+TEST_CASE("Snapshots decode against acknowledged baselines", "[net][snapshot]")
+{
+	std::mt19937 random(11);
+	std::vector<EntityState> world = makeWorld(200, random);
+	SnapshotEncoder encoder(k_format);
+	SnapshotDecoder decoder(k_format);
+	Bytes packet;
+	EntityList decoded;
+	u32 tick = 0;
+
+	encoder.encode(1, world.data(), world.size(), packet);
+	const usize fullSize = packet.size();
+	REQUIRE(decoder.decode(packet.data(), packet.size(), tick, decoded));
+	CHECK(tick == 1);
+	checkMatches(world, decoded);
+	encoder.acknowledge(1);
+	CHECK(encoder.baselineTick() == 1);
+
+	// A few entities move, one goes away and one appears.
+	for (u32 i = 0; i < world.size(); i += 20)
+		world[i].position.x += 1.5f;
+	world.erase(world.begin() + 50);
+	world.push_back({ 10000, { 3.0f, 4.0f }, { 0.0f, 0.0f } });
+
+	encoder.encode(2, world.data(), world.size(), packet);
+	CHECK(packet.size() < fullSize / 10);
+	REQUIRE(decoder.decode(packet.data(), packet.size(), tick, decoded));
+	CHECK(tick == 2);
+	checkMatches(world, decoded);
+
+	// Snapshot 3 is lost, and 4 is still encoded against 1, the last one acknowledged.
+	world[0].velocity.y = -12.0f;
+	encoder.encode(3, world.data(), world.size(), packet);
+	world[1].velocity.y = 12.0f;
+	encoder.encode(4, world.data(), world.size(), packet);
+	REQUIRE(decoder.decode(packet.data(), packet.size(), tick, decoded));
+	CHECK(tick == 4);
+	checkMatches(world, decoded);
+
+	// Acknowledgements arriving late do not move the baseline back.
+	encoder.acknowledge(4);
+	encoder.acknowledge(2);
+	CHECK(encoder.baselineTick() == 4);
+	encoder.encode(5, world.data(), world.size(), packet);
+	CHECK(packet.size() < 8);
+	REQUIRE(decoder.decode(packet.data(), packet.size(), tick, decoded));
+	checkMatches(world, decoded);
+}
+
+TEST_CASE("Snapshots fall back to whole ones when the baseline is too old", "[net][snapshot]")
+{
+	std::mt19937 random(5);
+	const std::vector<EntityState> world = makeWorld(50, random);
+	SnapshotEncoder encoder(k_format);
+	SnapshotDecoder decoder(k_format);
+	Bytes packet;
+	EntityList decoded;
+	u32 tick = 0;
+
+	encoder.encode(1, world.data(), world.size(), packet);
+	const usize fullSize = packet.size();
+	REQUIRE(decoder.decode(packet.data(), packet.size(), tick, decoded));
+	encoder.acknowledge(1);
+
+	encoder.encode(1 + SnapshotEncoder::k_historySize, world.data(), world.size(), packet);
+	CHECK(packet.size() >= fullSize);
+	REQUIRE(decoder.decode(packet.data(), packet.size(), tick, decoded));
+	checkMatches(world, decoded);
+}
+
+TEST_CASE("Snapshot decoder rejects what it cannot decode", "[net][snapshot]")
+{
+	std::mt19937 random(9);
+	const std::vector<EntityState> world = makeWorld(100, random);
+	SnapshotEncoder encoder(k_format);
+	SnapshotDecoder decoder(k_format);
+	Bytes packet;
+	EntityList decoded;
+	u32 tick = 0;
+
+	// Encoded against a baseline this decoder never saw.
+	encoder.encode(1, world.data(), world.size(), packet);
+	encoder.acknowledge(1);
+	encoder.encode(2, world.data(), world.size(), packet);
+	CHECK_FALSE(decoder.decode(packet.data(), packet.size(), tick, decoded));
+
+	encoder.encode(3, world.data(), world.size(), packet);
+	SnapshotEncoder fresh(k_format);
+	fresh.encode(3, world.data(), world.size(), packet);
+	for (usize size = 0; size < packet.size(); size += 7)
+		CHECK_FALSE(decoder.decode(packet.data(), size, tick, decoded));
+
+	for (u32 i = 0; i < 500; ++i)
+	{
+		Bytes corrupt = packet;
+		corrupt[random() % corrupt.size()] ^= static_cast<u8>(1 + random() % 255);
+		if (decoder.decode(corrupt.data(), corrupt.size(), tick, decoded))
+			CHECK(decoded.size() <= world.size() + 1);
+	}
+}
+
+TEST_CASE("Snapshot bandwidth", "[net][snapshot][!benchmark]")
+{
+	std::mt19937 random(1);
+	std::vector<EntityState> world = makeWorld(1000, random);
+	SnapshotEncoder encoder(k_format);
+	SnapshotDecoder decoder(k_format);
+	Bytes packet;
+	EntityList decoded;
+	u32 tick = 0;
+
+	encoder.encode(1, world.data(), world.size(), packet);
+	decoder.decode(packet.data(), packet.size(), tick, decoded);
+	encoder.acknowledge(1);
+	const usize fullSize = packet.size();
+
+	// A tenth of the entities move every tick.
+	for (u32 i = 0; i < world.size(); i += 10)
+		world[i].position += world[i].velocity * (1.0f / 60.0f);
+	encoder.encode(2, world.data(), world.size(), packet);
+	WARN("1000 entities: " << sizeof(EntityState) * world.size() << " bytes raw, " << fullSize << " whole, " << packet.size() << " as a delta");
+
+	BENCHMARK("encode 1000 entities against a baseline")
+	{
+		encoder.encode(2, world.data(), world.size(), packet);
+		return packet.size();
+	};
+
+	BENCHMARK("decode 1000 entities against a baseline")
+	{
+		decoder.decode(packet.data(), packet.size(), tick, decoded);
+		return decoded.size();
+	};
+}
@@ -0,0 +1,52 @@
+#include "catch.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "Core/Net/Socket.hpp"
+
+using namespace core::net;
+
+namespace
+{
+	// Loopback delivery is fast but not synchronous.
+	i32 receiveWithin(UdpSocket &socket, Address &from, void *buffer, usize capacity)
+	{
+		for (u32 attempt = 0; attempt < 1000; ++attempt)
+		{
+			const i32 size = socket.receive(from, buffer, capacity);
+			if (size >= 0)
+				return size;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return -1;
+	}
+}
+
+TEST_CASE("UdpSocket exchanges datagrams on loopback", "[net][socket]")
+{
+	UdpSocket server;
+	UdpSocket client;
+	REQUIRE(server.open());
+	REQUIRE(client.open());
+	CHECK(server.localPort() != 0);
+	CHECK(server.localPort() != client.localPort());
+
+	char buffer[k_maxDatagramSize];
+	Address from;
+	CHECK(server.receive(from, buffer, sizeof(buffer)) == -1);
+
+	REQUIRE(client.send(Address::loopback(server.localPort()), "ping", 4));
+	REQUIRE(receiveWithin(server, from, buffer, sizeof(buffer)) == 4);
+	CHECK(std::memcmp(buffer, "ping", 4) == 0);
+	CHECK(from == Address::loopback(client.localPort()));
+
+	REQUIRE(server.send(from, "pong", 4));
+	REQUIRE(receiveWithin(client, from, buffer, sizeof(buffer)) == 4);
+	CHECK(std::memcmp(buffer, "pong", 4) == 0);
+	CHECK(from == Address::loopback(server.localPort()));
+
+	client.close();
+	CHECK_FALSE(client.isOpen());
+}
@@ -0,0 +1,213 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#include "Core/Render/FrameGraph.hpp"
+
+using namespace core;
+using namespace core::render;
+
+namespace
+{
+	void doNothing(FrameGraph &, void *) {}
+
+	// Each stage reads its input buffer, adds one to every value and writes the result to its output.
+	struct Stage
+	{
+		BufferHandle input;
+		BufferHandle output;
+		u32 count;
+	};
+
+	void increment(FrameGraph &graph, void *data)
+	{
+		const Stage &stage = *static_cast<const Stage *>(data);
+		u32 *output = static_cast<u32 *>(graph.buffer(stage.output));
+		if (!stage.input.isValid())
+		{
+			for (u32 i = 0; i < stage.count; ++i)
+				output[i] = i;
+			return;
+		}
+
+		const u32 *input = static_cast<const u32 *>(graph.buffer(stage.input));
+		for (u32 i = 0; i < stage.count; ++i)
+			output[i] = input[i] + 1;
+	}
+
+	struct Branch
+	{
+		std::atomic<u32> *clock;
+		u32 startedAt = 0;
+		u32 finishedAt = 0;
+		BufferHandle buffer;
+		u8 *memory = nullptr;
+	};
+
+	void recordBranch(FrameGraph &graph, void *data)
+	{
+		Branch &branch = *static_cast<Branch *>(data);
+		branch.startedAt = branch.clock->fetch_add(1);
+		branch.memory = static_cast<u8 *>(graph.buffer(branch.buffer));
+		branch.finishedAt = branch.clock->fetch_add(1);
+	}
+}
+
+TEST_CASE("FrameGraph culls passes nothing depends on", "[render][framegraph]")
+{
+	u32 backBuffer[4] = {};
+
+	FrameGraph graph;
+	const BufferHandle depth = graph.createBuffer("Depth", 256);
+	const BufferHandle unusedOutput = graph.createBuffer("Debug", 256);
+	const BufferHandle unusedInput = graph.createBuffer("Debug input", 256);
+	const BufferHandle output = graph.importBuffer("Back buffer", backBuffer, sizeof(backBuffer));
+
+	const PassHandle depthPass = graph.addPass("Depth", &doNothing, nullptr);
+	graph.write(depthPass, depth);
+
+	const PassHandle debugInputPass = graph.addPass("Debug input", &doNothing, nullptr);
+	graph.write(debugInputPass, unusedInput);
+
+	const PassHandle debugPass = graph.addPass("Debug", &doNothing, nullptr);
+	graph.read(debugPass, depth);
+	graph.read(debugPass, unusedInput);
+	graph.write(debugPass, unusedOutput);
+
+	const PassHandle lightingPass = graph.addPass("Lighting", &doNothing, nullptr);
+	graph.read(lightingPass, depth);
+	graph.write(lightingPass, output);
+
+	const PassHandle presentPass = graph.addPass("Present", &doNothing, nullptr);
+	graph.setSideEffect(presentPass);
+
+	graph.compile();
+	CHECK_FALSE(graph.isCulled(depthPass));
+	CHECK(graph.isCulled(debugInputPass));
+	CHECK(graph.isCulled(debugPass));
+	CHECK_FALSE(graph.isCulled(lightingPass));
+	CHECK_FALSE(graph.isCulled(presentPass));
+	CHECK(graph.livePassCount() == 3);
+
+	// Only the depth buffer is used by a live pass.
+	CHECK(graph.requestedTransientBytes() == 256);
+	CHECK(graph.transientBytes() == 256);
+}
+
+TEST_CASE("FrameGraph aliases buffers whose uses never overlap", "[render][framegraph]")
+{
+	constexpr u32 k_count = 1024;
+	u32 result[k_count] = {};
+
+	jobs::JobSystemConfig config;
+	config.workerCount = 3;
+	config.fiberCount = 16;
+	jobs::JobSystem jobs(config);
+
+	FrameGraph graph;
+	for (u32 frame = 0; frame < 3; ++frame)
+	{
+		// A chain of four stages: the first buffer is dead once the second stage is done, so the third can reuse it.
+		BufferHandle buffers[4];
+		for (BufferHandle &buffer : buffers)
+			buffer = graph.createBuffer("Stage", sizeof(u32) * k_count);
+		const BufferHandle output = graph.importBuffer("Result", result, sizeof(result));
+
+		Stage stages[5];
+		for (u32 i = 0; i < 5; ++i)
+		{
+			stages[i] = { i == 0 ? BufferHandle() : buffers[i - 1], i == 4 ? output : buffers[i], k_count };
+			const PassHandle pass = graph.addPass("Stage", &increment, &stages[i]);
+			if (stages[i].input.isValid())
+				graph.read(pass, stages[i].input);
+			graph.write(pass, stages[i].output);
+		}
+
+		graph.compile();
+		CHECK(graph.livePassCount() == 5);
+		CHECK(graph.requestedTransientBytes() == 4 * sizeof(u32) * k_count);
+		CHECK(graph.transientBytes() == 2 * sizeof(u32) * k_count);
+
+		std::fill(std::begin(result), std::end(result), 0);
+		if (frame == 0)
+			graph.execute();
+		else
+			graph.execute(jobs);
+
+		bool isCorrect = true;
+		for (u32 i = 0; i < k_count; ++i)
+			isCorrect &= result[i] == i + 4;
+		CHECK(isCorrect);
+
+		graph.reset();
+		CHECK(graph.passCount() == 0);
+	}
+}
+
+TEST_CASE("FrameGraph runs independent passes in parallel in dependency order", "[render][framegraph]")
+{
+	constexpr u32 k_branchCount = 16;
+	constexpr usize k_bufferSize = 1000;
+
+	jobs::JobSystemConfig config;
+	config.workerCount = 4;
+	config.fiberCount = 32;
+	jobs::JobSystem jobs(config);
+
+	std::atomic<u32> clock{ 0 };
+	Branch producers[k_branchCount];
+	Branch consumers[k_branchCount];
+	Branch present;
+	present.clock = &clock;
+
+	FrameGraph graph;
+	const PassHandle presentPass = [&]
+	{
+		BufferHandle buffers[k_branchCount];
+		for (u32 i = 0; i < k_branchCount; ++i)
+		{
+			buffers[i] = graph.createBuffer("Branch", k_bufferSize);
+
+			producers[i].clock = &clock;
+			producers[i].buffer = buffers[i];
+			const PassHandle producer = graph.addPass("Produce", &recordBranch, &producers[i]);
+			graph.write(producer, buffers[i]);
+		}
+
+		for (u32 i = 0; i < k_branchCount; ++i)
+		{
+			consumers[i].clock = &clock;
+			consumers[i].buffer = buffers[i];
+			const PassHandle consumer = graph.addPass("Consume", &recordBranch, &consumers[i]);
+			graph.read(consumer, buffers[i]);
+			graph.setSideEffect(consumer);
+		}
+
+		present.buffer = buffers[0];
+		const PassHandle pass = graph.addPass("Present", &recordBranch, &present);
+		for (u32 i = 0; i < k_branchCount; ++i)
+			graph.read(pass, buffers[i]);
+		graph.setSideEffect(pass);
+		return pass;
+	}();
+
+	graph.compile();
+	CHECK_FALSE(graph.isCulled(presentPass));
+	// Every branch is still in use when the present pass runs, so nothing can alias.
+	CHECK(graph.transientBytes() == graph.requestedTransientBytes());
+
+	graph.execute(jobs);
+
+	for (u32 i = 0; i < k_branchCount; ++i)
+	{
+		CHECK(producers[i].finishedAt < consumers[i].startedAt);
+		CHECK(consumers[i].memory == producers[i].memory);
+		CHECK(reinterpret_cast<std::uintptr_t>(producers[i].memory) % k_bufferAlignment == 0);
+		for (u32 j = i + 1; j < k_branchCount; ++j)
+			CHECK((producers[i].memory + k_bufferSize <= producers[j].memory || producers[j].memory + k_bufferSize <= producers[i].memory));
+	}
+
+	for (const Branch &branch : producers)
+		CHECK(branch.finishedAt < present.startedAt);
+}
@@ -0,0 +1,197 @@
+#include "catch.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Core/Replay/ReplayLog.hpp"
+
+using namespace core;
+using namespace core::replay;
+
+namespace
+{
+	std::string tempPath(const char *name)
+	{
+		return (std::filesystem::temp_directory_path() / name).string();
+	}
+
+	// Input that looks like a controller: a few bytes that rarely change, then a frame counter.
+	std::vector<u8> inputFor(u64 tick)
+	{
+		std::vector<u8> input(16, 0);
+		input[0] = static_cast<u8>(tick / 90 % 4);
+		input[1] = static_cast<u8>(tick / 250 % 2);
+		std::memcpy(input.data() + 8, &tick, sizeof(tick));
+		return input;
+	}
+}
+
+TEST_CASE("ReplayLog reads back every tick written across several blocks", "[replay]")
+{
+	const std::string path = tempPath("ang_replay_test.bin");
+	constexpr u64 k_tickCount = 20000;
+
+	ReplayWriter writer;
+	REQUIRE(writer.open(path.c_str()));
+	usize inputBytes = 0;
+	for (u64 tick = 0; tick < k_tickCount; ++tick)
+	{
+		// Every seventh tick has no input at all, and every sixtieth carries a checksum.
+		const std::vector<u8> input = tick % 7 == 0 ? std::vector<u8>() : inputFor(tick);
+		inputBytes += input.size();
+		if (tick % 60 == 59)
+			writer.writeTick(input.data(), input.size(), tick * 0x9e3779b97f4a7c15ull);
+		else
+			writer.writeTick(input.data(), input.size());
+	}
+	CHECK(writer.tickCount() == k_tickCount);
+	REQUIRE(writer.close());
+
+	// Several blocks, each well under the input it records.
+	CHECK(inputBytes > k_replayBlockSize * 4);
+	CHECK(std::filesystem::file_size(path) < inputBytes / 3);
+
+	ReplayReader reader;
+	REQUIRE(reader.open(path.c_str()));
+	ReplayTick tick;
+	u64 index = 0;
+	while (reader.next(tick))
+	{
+		const std::vector<u8> expected = index % 7 == 0 ? std::vector<u8>() : inputFor(index);
+		REQUIRE(tick.inputSize == expected.size());
+		if (tick.inputSize > 0)
+			REQUIRE(std::memcmp(tick.input, expected.data(), expected.size()) == 0);
+		REQUIRE(tick.hasChecksum == (index % 60 == 59));
+		if (tick.hasChecksum)
+			REQUIRE(tick.checksum == index * 0x9e3779b97f4a7c15ull);
+		++index;
+	}
+	CHECK_FALSE(reader.isCorrupt());
+	CHECK(index == k_tickCount);
+	CHECK(reader.tickIndex() == k_tickCount);
+
+	reader.close();
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("ReplayLog keeps inputs that do not compress", "[replay]")
+{
+	const std::string path = tempPath("ang_replay_noise_test.bin");
+
+	std::vector<u8> noise(k_maxTickInputSize);
+	u32 seed = 12345;
+	for (u8 &byte : noise)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		byte = static_cast<u8>(seed >> 24);
+	}
+
+	ReplayWriter writer;
+	REQUIRE(writer.open(path.c_str()));
+	writer.writeTick(noise.data(), noise.size(), 7);
+	writer.writeTick(noise.data(), 100);
+	REQUIRE(writer.close());
+
+	ReplayReader reader;
+	REQUIRE(reader.open(path.c_str()));
+	ReplayTick tick;
+	REQUIRE(reader.next(tick));
+	REQUIRE(tick.inputSize == noise.size());
+	CHECK(std::memcmp(tick.input, noise.data(), noise.size()) == 0);
+	CHECK(tick.checksum == 7);
+	REQUIRE(reader.next(tick));
+	CHECK(tick.inputSize == 100);
+	CHECK_FALSE(tick.hasChecksum);
+	CHECK_FALSE(reader.next(tick));
+	CHECK_FALSE(reader.isCorrupt());
+
+	reader.close();
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("ReplayWriter refuses inputs larger than a record holds", "[replay]")
+{
+	const std::string path = tempPath("ang_replay_oversized_test.bin");
+	const std::vector<u8> input(k_maxTickInputSize + 1, 3);
+
+	ReplayWriter writer;
+	REQUIRE(writer.open(path.c_str()));
+	CHECK(writer.writeTick(input.data(), 8));
+	CHECK_FALSE(writer.writeTick(input.data(), input.size()));
+	CHECK_FALSE(writer.writeTick(input.data(), input.size(), 7));
+	CHECK(writer.tickCount() == 1);
+	REQUIRE(writer.close());
+
+	ReplayReader reader;
+	REQUIRE(reader.open(path.c_str()));
+	ReplayTick tick;
+	REQUIRE(reader.next(tick));
+	CHECK(tick.inputSize == 8);
+	CHECK_FALSE(reader.next(tick));
+	CHECK_FALSE(reader.isCorrupt());
+
+	reader.close();
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("ReplayLog stops at damaged or truncated logs", "[replay]")
+{
+	const std::string path = tempPath("ang_replay_damaged_test.bin");
+
+	ReplayWriter writer;
+	REQUIRE(writer.open(path.c_str()));
+	for (u64 tick = 0; tick < 10000; ++tick)
+	{
+		const std::vector<u8> input = inputFor(tick);
+		writer.writeTick(input.data(), input.size());
+	}
+	REQUIRE(writer.close());
+
+	const auto fileSize = std::filesystem::file_size(path);
+	std::filesystem::resize_file(path, fileSize - 10);
+
+	ReplayReader reader;
+	REQUIRE(reader.open(path.c_str()));
+	ReplayTick tick;
+	while (reader.next(tick)) {}
+	CHECK(reader.isCorrupt());
+	CHECK(reader.tickIndex() < 10000);
+	reader.close();
+
+	// A block header that claims more than any block holds.
+	{
+		std::FILE *file = std::fopen(path.c_str(), "r+b");
+		REQUIRE(file != nullptr);
+		const BlockHeader header = { 0x7fffffff, 0x7fffffff };
+		std::fseek(file, sizeof(ReplayHeader), SEEK_SET);
+		std::fwrite(&header, sizeof(header), 1, file);
+		std::fclose(file);
+	}
+
+	REQUIRE(reader.open(path.c_str()));
+	CHECK_FALSE(reader.next(tick));
+	CHECK(reader.isCorrupt());
+	CHECK(reader.tickIndex() == 0);
+	reader.close();
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("ReplayLog rejects files that are not replays", "[replay]")
+{
+	const std::string path = tempPath("ang_replay_invalid_test.bin");
+	{
+		std::FILE *file = std::fopen(path.c_str(), "wb");
+		std::fputs("not a replay, only some text", file);
+		std::fclose(file);
+	}
+
+	ReplayReader reader;
+	CHECK_FALSE(reader.open(path.c_str()));
+	CHECK_FALSE(reader.open(tempPath("ang_replay_missing_test.bin").c_str()));
+
+	std::filesystem::remove(path);
+}
@@ -0,0 +1,254 @@
+#include "catch.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "Core/Scene/Animation.hpp"
+
+using namespace core;
+using namespace core::math;
+using namespace core::scene;
+
+namespace
+{
+	constexpr f32 k_pi = 3.14159265358979323846f;
+
+	// A chain with a branch: 0 <- 1 <- 2, 0 <- 3 <- 4.
+	Skeleton limbs()
+	{
+		const u32 parents[] = { Skeleton::k_noParent, 0, 1, 0, 3 };
+		return Skeleton(parents, 5);
+	}
+
+	// Every joint turns a little faster than its parent, and crosses the half turn on the way.
+	std::vector<JointPose> walk(u32 jointCount, u32 frameCount, f32 phase)
+	{
+		std::vector<JointPose> keys(usize(jointCount) * frameCount);
+		for (u32 frame = 0; frame < frameCount; ++frame)
+		{
+			for (u32 joint = 0; joint < jointCount; ++joint)
+			{
+				JointPose &pose = keys[usize(frame) * jointCount + joint];
+				pose.translation = Vec2f(static_cast<f32>(frame + joint), 2.0f * static_cast<f32>(frame) - static_cast<f32>(joint));
+				pose.rotation = std::remainder(phase + 0.3f * static_cast<f32>(frame * (joint + 1)), 2.0f * k_pi);
+				pose.scale = Vec2f(1.0f + 0.1f * static_cast<f32>(frame), 1.0f);
+			}
+		}
+		return keys;
+	}
+
+	f32 angleBetween(f32 a, f32 b)
+	{
+		return std::fabs(std::remainder(a - b, 2.0f * k_pi));
+	}
+
+	bool isClose(const Mat3f &a, const Mat3f &b, f32 tolerance)
+	{
+		for (usize row = 0; row < 3; ++row)
+			for (usize column = 0; column < 3; ++column)
+				if (std::fabs(a(row, column) - b(row, column)) > tolerance * (1.0f + std::fabs(b(row, column))))
+					return false;
+
+		return true;
+	}
+}
+
+TEST_CASE("AnimationClip samples its keys and interpolates between them", "[scene][animation]")
+{
+	const Skeleton skeleton = limbs();
+	const std::vector<JointPose> keys = walk(5, 11, 0.0f);
+	const AnimationClip clip(skeleton, keys.data(), 11, 10.0f);
+	CHECK(clip.duration() == Approx(1.0f));
+
+	LocalPose pose(skeleton);
+	for (u32 frame = 0; frame < 11; ++frame)
+	{
+		clip.sample(static_cast<f32>(frame) / 10.0f, pose);
+		for (u32 joint = 0; joint < 5; ++joint)
+		{
+			const JointPose &key = keys[frame * 5 + joint];
+			const JointPose sampled = pose.joint(joint);
+			CHECK(sampled.translation.x == Approx(key.translation.x).margin(1e-3f));
+			CHECK(sampled.translation.y == Approx(key.translation.y).margin(1e-3f));
+			CHECK(angleBetween(sampled.rotation, key.rotation) < 1e-3f);
+			CHECK(sampled.scale.x == Approx(key.scale.x).margin(1e-4f));
+		}
+	}
+
+	// Halfway between two keys, and clamped past the end.
+	clip.sample(0.35f, pose);
+	CHECK(pose.joint(2).translation.x == Approx(5.5f).margin(1e-3f));
+	CHECK(angleBetween(pose.joint(2).rotation, 0.3f * 3.5f * 3.0f) < 1e-3f);
+	clip.sample(5.0f, pose);
+	CHECK(pose.joint(4).translation.y == Approx(16.0f).margin(1e-3f));
+}
+
+TEST_CASE("AnimationClip stores little more than half the bytes of its poses", "[scene][animation]")
+{
+	std::vector<u32> parents(32, 0);
+	parents[0] = Skeleton::k_noParent;
+	const Skeleton skeleton(parents.data(), 32);
+	const std::vector<JointPose> keys = walk(32, 61, 0.0f);
+	const AnimationClip clip(skeleton, keys.data(), 61, 30.0f);
+
+	// Ranges included.
+	CHECK(clip.byteSize() < keys.size() * sizeof(JointPose) * 55 / 100);
+}
+
+TEST_CASE("AnimationClip takes the short way round the half turn", "[scene][animation]")
+{
+	const u32 parents[] = { Skeleton::k_noParent };
+	const Skeleton skeleton(parents, 1);
+	JointPose keys[2];
+	keys[0].rotation = 3.0f;
+	keys[1].rotation = -3.0f;
+	const AnimationClip clip(skeleton, keys, 2, 30.0f);
+
+	LocalPose pose(skeleton);
+	clip.sample(clip.duration() / 2.0f, pose);
+	CHECK(angleBetween(pose.joint(0).rotation, k_pi) < 1e-3f);
+}
+
+TEST_CASE("blend interpolates poses and keeps rotations unit length", "[scene][animation]")
+{
+	const Skeleton skeleton = limbs();
+	LocalPose from(skeleton);
+	LocalPose to(skeleton);
+	LocalPose out(skeleton);
+	for (u32 joint = 0; joint < 5; ++joint)
+	{
+		from.setJoint(joint, JointPose{ Vec2f(0.0f, 0.0f), 0.0f, Vec2f(1.0f, 1.0f) });
+		to.setJoint(joint, JointPose{ Vec2f(2.0f, 4.0f), k_pi / 2.0f, Vec2f(3.0f, 1.0f) });
+	}
+	to.setJoint(4, JointPose{ Vec2f(2.0f, 4.0f), k_pi, Vec2f(3.0f, 1.0f) });
+
+	blend(from, to, 0.5f, out);
+	const JointPose halfway = out.joint(1);
+	CHECK(halfway.translation.x == Approx(1.0f));
+	CHECK(halfway.translation.y == Approx(2.0f));
+	CHECK(halfway.rotation == Approx(k_pi / 4.0f).margin(1e-4f));
+	CHECK(halfway.scale.x == Approx(2.0f));
+	CHECK(out.channel(PoseChannel::Cos)[1] * out.channel(PoseChannel::Cos)[1] + out.channel(PoseChannel::Sin)[1] * out.channel(PoseChannel::Sin)[1] == Approx(1.0f).margin(1e-4f));
+
+	// Opposite rotations cancel out rather than turning into NaN.
+	CHECK(out.joint(4).rotation == 0.0f);
+
+	blend(from, to, 0.0f, out);
+	CHECK(out.joint(3).translation.x == 0.0f);
+	CHECK(out.joint(3).rotation == Approx(0.0f).margin(1e-4f));
+}
+
+TEST_CASE("localToModel composes joints down the hierarchy", "[scene][animation]")
+{
+	const Skeleton skeleton = limbs();
+	LocalPose pose(skeleton);
+	std::vector<Mat3f> locals;
+	for (u32 joint = 0; joint < 5; ++joint)
+	{
+		const JointPose jointPose{ Vec2f(1.0f + joint, -0.5f * joint), 0.4f * joint, Vec2f(1.0f, 1.0f + 0.2f * joint) };
+		pose.setJoint(joint, jointPose);
+		locals.push_back(Mat3f::transform(jointPose.translation, std::cos(jointPose.rotation), std::sin(jointPose.rotation), jointPose.scale));
+	}
+
+	Mat3f model[5];
+	localToModel(skeleton, pose, model);
+	CHECK(isClose(model[0], locals[0], 1e-5f));
+	CHECK(isClose(model[2], locals[0] * locals[1] * locals[2], 1e-5f));
+	CHECK(isClose(model[4], locals[0] * locals[3] * locals[4], 1e-5f));
+}
+
+TEST_CASE("Animator matches sampling each character by hand", "[scene][animation]")
+{
+	const Skeleton skeleton = limbs();
+	const std::vector<JointPose> walkKeys = walk(5, 31, 0.0f);
+	const std::vector<JointPose> runKeys = walk(5, 16, 1.0f);
+	const AnimationClip walkClip(skeleton, walkKeys.data(), 31, 30.0f);
+	const AnimationClip runClip(skeleton, runKeys.data(), 16, 30.0f);
+
+	// Several batches, the last one partial.
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	const u32 characterCount = Animator::k_batchSize * 3 + 5;
+	Animator animator(skeleton, jobs, characterCount);
+	for (u32 character = 0; character < characterCount; ++character)
+	{
+		AnimationState &state = animator.state(character);
+		state.clip = &walkClip;
+		state.time = 0.01f * character;
+		if (character % 3 != 0)
+		{
+			state.blendClip = &runClip;
+			state.blendTime = 0.02f * character;
+			state.blendWeight = static_cast<f32>(character % 7) / 6.0f;
+		}
+		state.loops = character % 5 != 0;
+	}
+	// Nothing to play.
+	animator.state(1).clip = nullptr;
+
+	for (u32 frame = 0; frame < 45; ++frame)
+		animator.update(1.0f / 60.0f);
+
+	LocalPose from(skeleton);
+	LocalPose to(skeleton);
+	Mat3f expected[5];
+	bool isCorrect = true;
+	for (u32 character = 0; character < characterCount; ++character)
+	{
+		const AnimationState &state = animator.state(character);
+		if (state.clip == nullptr)
+		{
+			isCorrect &= animator.modelPose(character)[4] == Mat3f::identity();
+			continue;
+		}
+
+		// Looping characters wrapped around, the others that ran past the end hold their last frame.
+		isCorrect &= state.time >= 0.0f && state.time <= walkClip.duration();
+		if (!state.loops && character >= 30)
+			isCorrect &= state.time == walkClip.duration();
+
+		state.clip->sample(state.time, from);
+		if (state.blendClip != nullptr && state.blendWeight > 0.0f)
+		{
+			state.blendClip->sample(state.blendTime, to);
+			blend(from, to, state.blendWeight, from);
+		}
+		localToModel(skeleton, from, expected);
+
+		for (u32 joint = 0; joint < 5; ++joint)
+			isCorrect &= isClose(animator.modelPose(character)[joint], expected[joint], 1e-5f);
+	}
+	CHECK(isCorrect);
+}
+
+TEST_CASE("Animator update", "[scene][animation][!benchmark]")
+{
+	std::vector<u32> parents(32);
+	for (u32 joint = 0; joint < 32; ++joint)
+		parents[joint] = joint == 0 ? Skeleton::k_noParent : (joint - 1) / 2;
+	const Skeleton skeleton(parents.data(), 32);
+
+	const std::vector<JointPose> walkKeys = walk(32, 61, 0.0f);
+	const std::vector<JointPose> runKeys = walk(32, 31, 1.0f);
+	const AnimationClip walkClip(skeleton, walkKeys.data(), 61, 30.0f);
+	const AnimationClip runClip(skeleton, runKeys.data(), 31, 30.0f);
+
+	jobs::JobSystem jobs;
+	Animator animator(skeleton, jobs, 1000);
+	for (u32 character = 0; character < 1000; ++character)
+	{
+		AnimationState &state = animator.state(character);
+		state.clip = &walkClip;
+		state.time = 0.001f * character;
+		state.blendClip = &runClip;
+		state.blendTime = 0.002f * character;
+		state.blendWeight = 0.5f;
+	}
+
+	WARN("1000 characters of 32 joints, two clips each, on " << jobs.workerCount() << " workers. Clips take "
+		<< walkClip.byteSize() + runClip.byteSize() << " bytes.");
+	BENCHMARK("Sample, blend and convert")
+	{
+		animator.update(1.0f / 60.0f);
+		return animator.modelPose(999)[31](0, 2);
+	};
+}
@@ -0,0 +1,236 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Core/Scene/ParticleSystem.hpp"
+
+using namespace core;
+using namespace core::math;
+using namespace core::scene;
+
+namespace
+{
+	struct ReferenceParticle
+	{
+		Vec2f position;
+		Vec2f velocity;
+		f32 life;
+		f32 inverseLifetime;
+		ParticleColour colour;
+	};
+
+	// Of particles that just spawned, whose life is their lifetime.
+	std::vector<ReferenceParticle> snapshot(const ParticleView &view)
+	{
+		std::vector<ReferenceParticle> particles;
+		for (u32 i = 0; i < view.count; ++i)
+			particles.push_back({ Vec2f(view.x[i], view.y[i]), Vec2f(view.velocityX[i], view.velocityY[i]), view.life[i], 1.0f / view.life[i],
+				ParticleColour{ view.r[i], view.g[i], view.b[i], view.a[i] } });
+		return particles;
+	}
+
+	// The same step, one Vec2 particle at a time.
+	void step(std::vector<ReferenceParticle> &particles, const EmitterConfig &config, f32 dt)
+	{
+		for (ReferenceParticle &particle : particles)
+		{
+			particle.velocity = particle.velocity * std::max(0.0f, 1.0f - config.drag * dt) + config.gravity * dt;
+			particle.position += particle.velocity * dt;
+			particle.life -= dt;
+
+			const f32 t = std::max(particle.life, 0.0f) * particle.inverseLifetime;
+			particle.colour.r = config.endColour.r + (config.startColour.r - config.endColour.r) * t;
+			particle.colour.g = config.endColour.g + (config.startColour.g - config.endColour.g) * t;
+			particle.colour.b = config.endColour.b + (config.startColour.b - config.endColour.b) * t;
+			particle.colour.a = config.endColour.a + (config.startColour.a - config.endColour.a) * t;
+		}
+		particles.erase(std::remove_if(particles.begin(), particles.end(), [](const ReferenceParticle &particle) { return particle.life <= 0.0f; }),
+			particles.end());
+	}
+
+	EmitterConfig sparks()
+	{
+		EmitterConfig config;
+		config.capacity = 20000;
+		config.position = Vec2f(10.0f, -5.0f);
+		config.minSpeed = 1.0f;
+		config.maxSpeed = 40.0f;
+		config.minLifetime = 0.1f;
+		config.maxLifetime = 2.0f;
+		config.gravity = Vec2f(0.0f, -9.8f);
+		config.drag = 0.5f;
+		config.startColour = ParticleColour{ 1.0f, 0.5f, 0.0f, 1.0f };
+		config.endColour = ParticleColour{ 0.0f, 0.0f, 0.0f, 0.0f };
+		return config;
+	}
+}
+
+TEST_CASE("ParticleSystem simulates and compacts like a plain loop", "[scene][particlesystem]")
+{
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	ParticleSystem system(jobs);
+	const EmitterConfig config = sparks();
+	const EmitterHandle emitter = system.create(config);
+
+	// Several chunks, dying at different times.
+	system.burst(emitter, 15000);
+	system.update(0.0f);
+	REQUIRE(system.particleCount() == 15000);
+
+	std::vector<ReferenceParticle> reference = snapshot(system.particles(emitter));
+	const f32 *storage = system.particles(emitter).x;
+	const f32 dt = 1.0f / 60.0f;
+	bool isCorrect = true;
+	while (!reference.empty())
+	{
+		system.update(dt);
+		step(reference, config, dt);
+
+		const ParticleView view = system.particles(emitter);
+		REQUIRE(view.count == reference.size());
+		for (u32 i = 0; i < view.count; ++i)
+		{
+			isCorrect &= std::fabs(view.x[i] - reference[i].position.x) < 1e-3f;
+			isCorrect &= std::fabs(view.y[i] - reference[i].position.y) < 1e-3f;
+			isCorrect &= std::fabs(view.life[i] - reference[i].life) < 1e-5f;
+			isCorrect &= std::fabs(view.a[i] - reference[i].colour.a) < 1e-4f;
+		}
+		CHECK(view.x == storage);
+	}
+
+	CHECK(isCorrect);
+	CHECK(system.particleCount() == 0);
+}
+
+TEST_CASE("ParticleSystem fades colour over each particle's life", "[scene][particlesystem]")
+{
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	ParticleSystem system(jobs);
+	EmitterConfig config = sparks();
+	config.minLifetime = 1.0f;
+	config.maxLifetime = 1.0f;
+	const EmitterHandle emitter = system.create(config);
+
+	system.burst(emitter, 8);
+	system.update(0.0f);
+	ParticleView view = system.particles(emitter);
+	CHECK(view.r[0] == 1.0f);
+	CHECK(view.a[7] == 1.0f);
+
+	system.update(0.25f);
+	view = system.particles(emitter);
+	CHECK(view.r[3] == Approx(0.75f));
+	CHECK(view.g[3] == Approx(0.375f));
+	CHECK(view.b[3] == Approx(0.0f));
+	CHECK(view.a[3] == Approx(0.75f));
+}
+
+TEST_CASE("ParticleSystem spawns at its rate and drops what does not fit", "[scene][particlesystem]")
+{
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	ParticleSystem system(jobs);
+	EmitterConfig config = sparks();
+	config.capacity = 100;
+	config.rate = 30.0f;
+	config.minLifetime = 100.0f;
+	config.maxLifetime = 100.0f;
+	const EmitterHandle emitter = system.create(config);
+
+	for (u32 frame = 0; frame < 60; ++frame)
+		system.update(1.0f / 60.0f);
+	CHECK((system.particleCount() == 30 || system.particleCount() == 29));
+
+	// Nothing is allocated once the emitter exists.
+	const i64 liveBytes = memory::stats(memory::Tag::Scene).liveBytes;
+	system.burst(emitter, 100);
+	system.update(0.0f);
+	CHECK(system.particleCount() == 100);
+	CHECK(system.droppedCount(emitter) > 0);
+	CHECK(memory::stats(memory::Tag::Scene).liveBytes == liveBytes);
+
+	system.setRate(emitter, 0.0f);
+	system.destroy(emitter);
+	CHECK_FALSE(system.contains(emitter));
+	CHECK(system.particleCount() == 0);
+}
+
+TEST_CASE("ParticleSystem spawns nothing at a negative rate and owes nothing for it", "[scene][particlesystem]")
+{
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	ParticleSystem system(jobs);
+	EmitterConfig config = sparks();
+	config.capacity = 100;
+	config.rate = -30.0f;
+	config.minLifetime = 100.0f;
+	config.maxLifetime = 100.0f;
+	const EmitterHandle emitter = system.create(config);
+
+	for (u32 frame = 0; frame < 60; ++frame)
+		system.update(1.0f / 60.0f);
+	CHECK(system.particleCount() == 0);
+	CHECK(system.droppedCount(emitter) == 0);
+
+	// The second of negative rate is not paid back before spawning starts.
+	system.setRate(emitter, 30.0f);
+	for (u32 frame = 0; frame < 60; ++frame)
+		system.update(1.0f / 60.0f);
+	CHECK((system.particleCount() == 30 || system.particleCount() == 29));
+}
+
+TEST_CASE("ParticleSystem only sorts alpha blended emitters", "[scene][particlesystem]")
+{
+	jobs::JobSystem jobs(jobs::JobSystemConfig{ 2, 16 });
+	ParticleSystem system(jobs);
+	EmitterConfig config = sparks();
+	const EmitterHandle additive = system.create(config);
+	config.blend = ParticleBlend::Alpha;
+	config.seed = 7;
+	const EmitterHandle alpha = system.create(config);
+
+	system.burst(additive, 1000);
+	system.burst(alpha, 1000);
+	system.setPosition(alpha, Vec2f(0.0f, 100.0f));
+	for (u32 frame = 0; frame < 10; ++frame)
+		system.update(1.0f / 60.0f);
+
+	CHECK(system.particles(additive).drawOrder == nullptr);
+
+	const ParticleView view = system.particles(alpha);
+	REQUIRE(view.drawOrder != nullptr);
+	REQUIRE(view.count > 0);
+	bool isSorted = true;
+	for (u32 i = 1; i < view.count; ++i)
+		isSorted &= view.y[view.drawOrder[i - 1]] <= view.y[view.drawOrder[i]];
+	CHECK(isSorted);
+	CHECK(view.y[view.drawOrder[0]] > 50.0f);
+}
+
+TEST_CASE("ParticleSystem update", "[scene][particlesystem][!benchmark]")
+{
+	jobs::JobSystem jobs;
+	ParticleSystem system(jobs);
+	EmitterConfig config = sparks();
+	config.capacity = 200000;
+	config.minLifetime = 1e6f;
+	config.maxLifetime = 1e6f;
+	const EmitterHandle emitter = system.create(config);
+	system.burst(emitter, 200000);
+	system.update(0.0f);
+
+	std::vector<ReferenceParticle> particles = snapshot(system.particles(emitter));
+
+	WARN("200k particles on " << jobs.workerCount() << " workers.");
+	BENCHMARK("Structure of arrays, chunked jobs")
+	{
+		system.update(1.0f / 60.0f);
+		return system.particleCount();
+	};
+
+	BENCHMARK("Vec2 array of structures, one thread")
+	{
+		step(particles, config, 1.0f / 60.0f);
+		return particles.size();
+	};
+}
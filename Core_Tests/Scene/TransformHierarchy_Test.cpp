@@ -0,0 +1,158 @@
+#include "catch.hpp"
+
+#include <cmath>
+#include <vector>
+
+#include "Core/Scene/TransformHierarchy.hpp"
+
+using namespace core;
+using namespace core::math;
+using namespace core::scene;
+
+namespace
+{
+	Mat3f referenceWorld(const TransformHierarchy &hierarchy, TransformHandle node)
+	{
+		const TransformHandle parent = hierarchy.parent(node);
+		return parent.isValid() ? referenceWorld(hierarchy, parent) * hierarchy.local(node) : hierarchy.local(node);
+	}
+
+	bool isClose(const Mat3f &a, const Mat3f &b)
+	{
+		for (usize row = 0; row < 3; ++row)
+			for (usize column = 0; column < 3; ++column)
+				if (std::fabs(a(row, column) - b(row, column)) > 1e-3f * (1.0f + std::fabs(b(row, column))))
+					return false;
+
+		return true;
+	}
+
+	struct Random
+	{
+		u32 state;
+
+		u32 next()
+		{
+			state = state * 1664525u + 1013904223u;
+			return state >> 8;
+		}
+
+		f32 unit() { return static_cast<f32>(next() % 2001) / 1000.0f - 1.0f; }
+
+		Mat3f transform()
+		{
+			const f32 angle = unit() * 3.14159f;
+			return Mat3f::transform(Vec2f(unit() * 10.0f, unit() * 10.0f), std::cos(angle), std::sin(angle), Vec2f(1.0f + unit() * 0.1f, 1.0f + unit() * 0.1f));
+		}
+	};
+}
+
+TEST_CASE("TransformHierarchy composes world transforms down the tree", "[scene][transformhierarchy]")
+{
+	TransformHierarchy hierarchy;
+	const TransformHandle root = hierarchy.create({}, Mat3f::translation(Vec2f(10.0f, 0.0f)));
+	const TransformHandle arm = hierarchy.create(root, Mat3f::rotation(0.0f, 1.0f));
+	const TransformHandle hand = hierarchy.create(arm, Mat3f::translation(Vec2f(2.0f, 0.0f)));
+	const TransformHandle other = hierarchy.create();
+
+	hierarchy.update();
+	CHECK(hierarchy.updatedCount() == 4);
+	CHECK(hierarchy.world(hand).transformPoint(Vec2f(0.0f, 0.0f)) == Vec2f(10.0f, 2.0f));
+	CHECK(hierarchy.world(other) == Mat3f::identity());
+
+	// Nothing changed, nothing is recomputed.
+	hierarchy.update();
+	CHECK(hierarchy.updatedCount() == 0);
+
+	// A change reaches the subtree below it and nothing else.
+	hierarchy.setLocal(arm, Mat3f::identity());
+	hierarchy.update();
+	CHECK(hierarchy.updatedCount() == 2);
+	CHECK(hierarchy.world(hand).transformPoint(Vec2f(0.0f, 0.0f)) == Vec2f(12.0f, 0.0f));
+
+	// Moving a subtree under another parent.
+	hierarchy.setParent(arm, other);
+	CHECK(hierarchy.parent(arm) == other);
+	hierarchy.update();
+	CHECK(hierarchy.updatedCount() == 2);
+	CHECK(hierarchy.world(hand).transformPoint(Vec2f(0.0f, 0.0f)) == Vec2f(2.0f, 0.0f));
+
+	hierarchy.destroy(hand);
+	hierarchy.destroy(arm);
+	CHECK(hierarchy.nodeCount() == 2);
+	hierarchy.update();
+	CHECK(hierarchy.world(root) == Mat3f::translation(Vec2f(10.0f, 0.0f)));
+
+	CHECK_FALSE(hierarchy.contains(hand));
+	CHECK(hierarchy.contains(root));
+
+	// Freed slots are reused, and the old handles still do not resolve.
+	const TransformHandle reused = hierarchy.create(root);
+	CHECK((reused.index == hand.index || reused.index == arm.index));
+	CHECK_FALSE(hierarchy.contains(hand));
+	CHECK_FALSE(hierarchy.contains(arm));
+	hierarchy.update();
+	CHECK(hierarchy.world(reused) == hierarchy.world(root));
+}
+
+TEST_CASE("TransformHierarchy matches a full recomputation under random edits", "[scene][transformhierarchy]")
+{
+	Random random{ 77 };
+	TransformHierarchy hierarchy;
+	std::vector<TransformHandle> nodes;
+
+	for (u32 i = 0; i < 500; ++i)
+	{
+		const TransformHandle parent = nodes.empty() || random.next() % 10 == 0 ? TransformHandle() : nodes[random.next() % nodes.size()];
+		nodes.push_back(hierarchy.create(parent, random.transform()));
+	}
+	hierarchy.update();
+	CHECK(hierarchy.updatedCount() == nodes.size());
+
+	for (u32 frame = 0; frame < 20; ++frame)
+	{
+		for (u32 edit = 0; edit < 20; ++edit)
+			hierarchy.setLocal(nodes[random.next() % nodes.size()], random.transform());
+
+		// Reparenting under a node created earlier can never make a cycle.
+		const usize moved = 1 + random.next() % (nodes.size() - 1);
+		hierarchy.setParent(nodes[moved], nodes[random.next() % moved]);
+
+		hierarchy.update();
+		CHECK(hierarchy.updatedCount() < nodes.size());
+
+		bool isCorrect = true;
+		for (TransformHandle node : nodes)
+			isCorrect &= isClose(hierarchy.world(node), referenceWorld(hierarchy, node));
+		CHECK(isCorrect);
+	}
+}
+
+TEST_CASE("TransformHierarchy update", "[scene][transformhierarchy][!benchmark]")
+{
+	Random random{ 5 };
+	TransformHierarchy hierarchy;
+	std::vector<TransformHandle> nodes;
+	for (u32 i = 0; i < 100000; ++i)
+	{
+		const TransformHandle parent = i < 100 ? TransformHandle() : nodes[random.next() % nodes.size()];
+		nodes.push_back(hierarchy.create(parent, random.transform()));
+	}
+	hierarchy.update();
+
+	BENCHMARK("One percent of the nodes moved")
+	{
+		for (usize i = 0; i < nodes.size(); i += 100)
+			hierarchy.setLocal(nodes[i], hierarchy.local(nodes[i]));
+		hierarchy.update();
+		return hierarchy.updatedCount();
+	};
+
+	BENCHMARK("Every root moved")
+	{
+		for (usize i = 0; i < 100; ++i)
+			hierarchy.setLocal(nodes[i], hierarchy.local(nodes[i]));
+		hierarchy.update();
+		return hierarchy.updatedCount();
+	};
+}
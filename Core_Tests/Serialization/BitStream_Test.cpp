@@ -0,0 +1,194 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Core/Serialization/BitStream.hpp"
+
+using namespace core;
+
+TEST_CASE("BitStream reads back fields of any width", "[serialization][bitstream]")
+{
+	struct Field
+	{
+		u64 value;
+		u32 bits;
+	};
+
+	std::mt19937_64 random(21);
+	std::vector<Field> fields;
+	usize totalBits = 0;
+	for (u32 i = 0; i < 5000; ++i)
+	{
+		const u32 bits = 1 + static_cast<u32>(random() % 64);
+		const u64 value = bits == 64 ? random() : random() & ((1ull << bits) - 1);
+		fields.push_back({ value, bits });
+		totalBits += bits;
+	}
+
+	std::vector<u8> buffer((totalBits + 7) / 8);
+	BitWriter writer(buffer.data(), buffer.size());
+	for (const Field &field : fields)
+		writer.writeBits(field.value, field.bits);
+	CHECK(writer.bitsWritten() == totalBits);
+	CHECK(writer.finish() == buffer.size());
+	CHECK_FALSE(writer.hasOverflowed());
+
+	BitReader reader(buffer.data(), buffer.size());
+	for (const Field &field : fields)
+		REQUIRE(reader.readBits(field.bits) == field.value);
+	CHECK_FALSE(reader.hasOverflowed());
+	CHECK(reader.bytesRemaining() == 0);
+}
+
+TEST_CASE("BitStream encodes varints, floats and vectors", "[serialization][bitstream]")
+{
+	const QuantizedRange unit(-1.0f, 1.0f, 1.0f / 1024.0f);
+	const QuantizedRange world(-1000.0f, 1000.0f, 1.0f / 16.0f);
+	CHECK(unit.bits == 12);
+	CHECK(world.bits == 15);
+
+	u8 buffer[256];
+	BitWriter writer(buffer, sizeof(buffer));
+	writer.writeBool(true);
+	writer.writeVarint(0);
+	writer.writeVarint(127);
+	writer.writeVarint(128);
+	writer.writeVarint(~0ull);
+	writer.writeSignedVarint(-1);
+	writer.writeSignedVarint(-1234567);
+	writer.writeSignedVarint(INT64_MIN);
+	writer.writeFloat(0.3f, unit);
+	writer.writeFloat(5.0f, unit);
+	writer.writeFloat(std::nanf(""), unit);
+	writer.writeVec2({ 123.4f, -999.9f }, world);
+	writer.writeBytes("block", 5);
+	writer.writeBits(5, 3);
+	const usize size = writer.finish();
+	REQUIRE_FALSE(writer.hasOverflowed());
+
+	BitReader reader(buffer, size);
+	CHECK(reader.readBool());
+	CHECK(reader.readVarint() == 0);
+	CHECK(reader.readVarint() == 127);
+	CHECK(reader.readVarint() == 128);
+	CHECK(reader.readVarint() == ~0ull);
+	CHECK(reader.readSignedVarint() == -1);
+	CHECK(reader.readSignedVarint() == -1234567);
+	CHECK(reader.readSignedVarint() == INT64_MIN);
+	CHECK(std::abs(reader.readFloat(unit) - 0.3f) <= unit.step * 0.5f);
+	// Clamped to the range, NaN included.
+	CHECK(reader.readFloat(unit) == 1.0f);
+	CHECK(reader.readFloat(unit) == -1.0f);
+	const math::Vec2f vec = reader.readVec2(world);
+	CHECK(std::abs(vec.x - 123.4f) <= world.step * 0.5f);
+	CHECK(std::abs(vec.y + 999.9f) <= world.step * 0.5f);
+	char block[5];
+	REQUIRE(reader.readBytes(block, 5));
+	CHECK(std::string(block, 5) == "block");
+	CHECK(reader.readBits(3) == 5);
+	CHECK_FALSE(reader.hasOverflowed());
+	CHECK(reader.bytesRemaining() == 0);
+}
+
+TEST_CASE("BitStream reports overflow on both ends", "[serialization][bitstream]")
+{
+	u8 buffer[12] = {};
+	BitWriter writer(buffer, sizeof(buffer));
+	for (u32 i = 0; i < 3; ++i)
+		writer.writeBits(0xffffffff, 32);
+	CHECK_FALSE(writer.hasOverflowed());
+	writer.writeBits(1, 1);
+	writer.finish();
+	CHECK(writer.hasOverflowed());
+
+	BitReader reader(buffer, sizeof(buffer));
+	CHECK(reader.readBits(64) == ~0ull);
+	CHECK(reader.readBits(32) == 0xffffffff);
+	CHECK_FALSE(reader.hasOverflowed());
+	CHECK(reader.readBits(8) == 0);
+	CHECK(reader.hasOverflowed());
+
+	// An unterminated varint fails instead of reading on forever.
+	const u8 endless[16] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+	BitReader varints(endless, sizeof(endless));
+	varints.readVarint();
+	CHECK(varints.hasOverflowed());
+
+	char block[4];
+	BitReader blocks(buffer, 3);
+	CHECK_FALSE(blocks.readBytes(block, 4));
+	CHECK(blocks.hasOverflowed());
+}
+
+namespace
+{
+	// Bytes per second of the fastest of several runs, which is what the stream costs once caches are warm.
+	template<typename Function>
+	f64 bytesPerSecond(usize bytes, Function function)
+	{
+		f64 best = 1e9;
+		for (u32 run = 0; run < 20; ++run)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			function();
+			best = std::min(best, std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count());
+		}
+		return static_cast<f64>(bytes) / best;
+	}
+}
+
+TEST_CASE("BitStream benchmark", "[serialization][bitstream][!benchmark]")
+{
+	constexpr usize k_count = 1 << 20;
+	std::mt19937_64 random(4);
+	std::vector<u64> values(k_count);
+	for (u64 &value : values)
+		value = random() & 0x3fff;
+	std::vector<u8> buffer(k_count * 2);
+
+	// 14 bit fields: 1.75 MiB either way.
+	const usize bytes = k_count * 14 / 8;
+	volatile u64 sink = 0;
+	const auto write = [&]
+	{
+		BitWriter writer(buffer.data(), buffer.size());
+		for (u64 value : values)
+			writer.writeBits(value, 14);
+		return writer.finish();
+	};
+	const auto read = [&]
+	{
+		BitReader reader(buffer.data(), buffer.size());
+		u64 sum = 0;
+		for (usize i = 0; i < k_count; ++i)
+			sum += reader.readBits(14);
+		return sum;
+	};
+
+	const f64 writeRate = bytesPerSecond(bytes, [&] { sink = write(); });
+	const f64 readRate = bytesPerSecond(bytes, [&] { sink = read(); });
+	WARN("14 bit fields: write " << writeRate / 1e9 << " GB/s, read " << readRate / 1e9 << " GB/s.");
+
+	BENCHMARK("write 1M 14 bit fields")
+	{
+		return write();
+	};
+
+	BENCHMARK("read 1M 14 bit fields")
+	{
+		return read();
+	};
+
+	BENCHMARK("write 1M varints")
+	{
+		BitWriter writer(buffer.data(), buffer.size());
+		for (u64 value : values)
+			writer.writeVarint(value);
+		return writer.finish();
+	};
+}
@@ -0,0 +1,125 @@
+#include "catch.hpp"
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Strings/StringId.hpp"
+
+using namespace core;
+using namespace core::literals;
+
+TEST_CASE("StringId hashes at compile time", "[strings][stringid]")
+{
+	static_assert(StringId("player") == "player"_sid);
+	static_assert(StringId("player") != StringId("Player"));
+	static_assert(!StringId().isValid());
+	static_assert(StringId("").hash() == 14695981039346656037ull);
+
+	// Known FNV-1a values.
+	static_assert(hashString("a", 1) == 0xaf63dc4c8601ec8cull);
+	static_assert(hashString("foobar", 6) == 0x85944171f73967e8ull);
+
+	const std::string runtime = "player";
+	CHECK(StringId::intern(runtime.c_str()) == "player"_sid);
+	CHECK(StringId(runtime.c_str(), runtime.size()) == "player"_sid);
+}
+
+#if CORE_STRINGID_TRACK
+TEST_CASE("StringId turns interned ids back into strings", "[strings][stringid]")
+{
+	const std::string name = "enemy_spawner";
+	const StringId id = StringId::intern(name.c_str());
+	REQUIRE(id.str() != nullptr);
+	CHECK(std::strcmp(id.str(), "enemy_spawner") == 0);
+
+	// Interning keeps its own copy, and constant ids find it too.
+	CHECK(std::strcmp("enemy_spawner"_sid.str(), "enemy_spawner") == 0);
+	CHECK("never_interned_name"_sid.str() == nullptr);
+
+	// Interning the same string again is not a collision.
+	const u32 collisions = StringId::collisionCount();
+	StringId::intern("enemy_spawner");
+	CHECK(StringId::collisionCount() == collisions);
+
+	// Nor is interning one that holds a NUL; the length comes from the table, not from the text.
+	const char nul[] = { 'n', 'a', '\0', 'm', 'e' };
+	const StringId withNul = StringId::intern(nul, sizeof(nul));
+	StringId::intern(nul, sizeof(nul));
+	CHECK(StringId::collisionCount() == collisions);
+	REQUIRE(withNul.str() != nullptr);
+	CHECK(std::memcmp(withNul.str(), nul, sizeof(nul)) == 0);
+}
+
+TEST_CASE("StringId interns from many threads", "[strings][stringid]")
+{
+	constexpr u32 k_threadCount = 4;
+	constexpr u32 k_nameCount = 2000;
+	const u32 collisions = StringId::collisionCount();
+
+	// Every thread interns the same names, so threads race on the same entries.
+	std::vector<std::thread> threads;
+	for (u32 t = 0; t < k_threadCount; ++t)
+	{
+		threads.emplace_back([]()
+		{
+			for (u32 i = 0; i < k_nameCount; ++i)
+			{
+				const std::string name = "thread_name_" + std::to_string(i);
+				StringId::intern(name.c_str(), name.size());
+			}
+		});
+	}
+	for (std::thread &thread : threads)
+		thread.join();
+
+	CHECK(StringId::collisionCount() == collisions);
+	for (u32 i = 0; i < k_nameCount; ++i)
+	{
+		const std::string name = "thread_name_" + std::to_string(i);
+		const char *text = StringId(name.c_str(), name.size()).str();
+		REQUIRE(text != nullptr);
+		CHECK(name == text);
+	}
+}
+#endif
+
+TEST_CASE("StringId works as a map key", "[strings][stringid]")
+{
+	std::unordered_map<StringId, u32> counts;
+	++counts["jump"_sid];
+	++counts["jump"_sid];
+	++counts[StringId::intern("land")];
+
+	CHECK(counts.size() == 2);
+	CHECK(counts["jump"_sid] == 2);
+	CHECK(counts[StringId("land")] == 1);
+}
+
+TEST_CASE("StringId benchmark", "[strings][stringid][!benchmark]")
+{
+	std::vector<std::string> names;
+	for (u32 i = 0; i < 1024; ++i)
+		names.push_back("resource/texture_" + std::to_string(i));
+	std::vector<StringId> ids;
+	for (const std::string &name : names)
+		ids.emplace_back(name.c_str(), name.size());
+
+	BENCHMARK("compare 1024 strings")
+	{
+		u32 matches = 0;
+		for (const std::string &name : names)
+			matches += name == names[512] ? 1 : 0;
+		return matches;
+	};
+
+	BENCHMARK("compare 1024 ids")
+	{
+		u32 matches = 0;
+		for (const StringId &id : ids)
+			matches += id == ids[512] ? 1 : 0;
+		return matches;
+	};
+}
@@ -0,0 +1,61 @@
+#include <chrono>
+#include <iostream>
+
+#include "Core/Modules/ModuleApi.hpp"
+
+// Gameplay, built as a module the engine reloads on every rebuild. Anything that must outlive a reload lives in
+// GameState; add fields at the end so a running game keeps its values.
+namespace
+{
+	// Placeholder until there is gameplay to keep the loop alive.
+	constexpr u64 k_frameLimit = 60 * 60;
+
+	struct GameState
+	{
+		u64 frameCount;
+		u32 loadCount;
+		// Folds in every input consumed, so a replay that feeds different input drifts from the recording.
+		u64 inputHash;
+	};
+
+	void load(void *data, const AngHostApi *, bool isReload)
+	{
+		GameState &state = *static_cast<GameState *>(data);
+		++state.loadCount;
+		if (isReload)
+			std::cout << "[Game] Reloaded at frame " << state.frameCount << "." << std::endl;
+	}
+
+	void unload(void *, const AngHostApi *, bool) {}
+
+	void update(void *data, const AngHostApi *host)
+	{
+		GameState &state = *static_cast<GameState *>(data);
+
+		usize inputSize = 0;
+		const u8 *input = static_cast<const u8 *>(host->input(host->context, &inputSize));
+		for (usize i = 0; i < inputSize; ++i)
+			state.inputHash = (state.inputHash ^ input[i]) * 0x100000001b3ull;
+
+		// The clock stands in for device input until there is some: it differs every run, so it is never read
+		// straight into the simulation.
+		const i64 now = std::chrono::steady_clock::now().time_since_epoch().count();
+		host->submitInput(host->context, &now, sizeof(now));
+
+		if (++state.frameCount == k_frameLimit)
+			host->requestExit(host->context);
+	}
+
+	const AngModuleApi k_api = {
+		k_angModuleApiVersion,
+		sizeof(GameState),
+		&load,
+		&unload,
+		&update,
+	};
+}
+
+ANG_MODULE_EXPORT const AngModuleApi *angGetModuleApi()
+{
+	return &k_api;
+}